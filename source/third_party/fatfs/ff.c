@@ -210,6 +210,22 @@
 #define LEAVE_FF(fs, res)	return res
 #endif
 
+/* File data transfers of f_read/f_write */
+#if FF_FS_UNLOCKED_IO
+#if !FF_FS_REENTRANT || FF_FS_TINY
+#error FF_FS_UNLOCKED_IO needs FF_FS_REENTRANT = 1 and FF_FS_TINY = 0
+#endif
+#define DATA_XFER(wr, buff, sect, cc) { \
+	res = disk_xfer(fp, &fs, wr, (BYTE*)(buff), sect, cc); \
+	if (res == FR_DISK_ERR) ABORT(fs, res); \
+	if (res != FR_OK) LEAVE_FF(fs, res); }
+#define DATA_READ(buff, sect, cc)	DATA_XFER(0, buff, sect, cc)
+#define DATA_WRITE(buff, sect, cc)	DATA_XFER(1, buff, sect, cc)
+#else
+#define DATA_READ(buff, sect, cc)	{ if (disk_read(fs->pdrv, buff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR); }
+#define DATA_WRITE(buff, sect, cc)	{ if (disk_write(fs->pdrv, buff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR); }
+#endif
+
 
 /* Definitions of volume - physical location conversion */
 #if FF_MULTI_PARTITION
@@ -3477,6 +3493,43 @@ FRESULT validate (	/* Returns FR_OK or FR_INVALID_OBJECT */
 
 
 
+#if FF_FS_UNLOCKED_IO
+/*-----------------------------------------------------------------------*/
+/* Transfer file data sectors without holding the volume                 */
+/*-----------------------------------------------------------------------*/
+
+static
+FRESULT disk_xfer (	/* FR_OK, FR_DISK_ERR or an error of validate() */
+	FIL* fp,		/* File object the sectors belong to */
+	FATFS** rfs,	/* Filesystem object, held on entry, and on return if FR_OK or FR_DISK_ERR */
+	int wr,			/* 0:Read, 1:Write */
+	BYTE* buff,		/* Data buffer */
+	DWORD sect,		/* Start sector */
+	UINT cc			/* Number of sectors */
+)
+{
+	FATFS *fs = *rfs;
+	DRESULT dr;
+	FRESULT res;
+
+
+	unlock_fs(fs, FR_OK);	/* Let other tasks use the volume during the transfer */
+#if !FF_FS_READONLY
+	if (wr) {
+		dr = disk_write(fs->pdrv, buff, sect, cc);
+	} else
+#endif
+	{
+		dr = disk_read(fs->pdrv, buff, sect, cc);
+	}
+	res = validate(&fp->obj, rfs);	/* Obtain the volume again */
+	if (res == FR_OK && dr != RES_OK) res = FR_DISK_ERR;
+	return res;
+}
+#endif
+
+
+
 
 /*---------------------------------------------------------------------------
 
@@ -3779,7 +3832,7 @@ FRESULT f_read (
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
 					cc = fs->csize - csect;
 				}
-				if (disk_read(fs->pdrv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
+				DATA_READ(rbuff, sect, cc);
 #if !FF_FS_READONLY && FF_FS_MINIMIZE <= 2		/* Replace one of the read sectors with cached data if it contains a dirty sector */
 #if FF_FS_TINY
 				if (fs->wflag && fs->winsect - sect < cc) {
@@ -3798,11 +3851,11 @@ FRESULT f_read (
 			if (fp->sect != sect) {			/* Load data sector if not in cache */
 #if !FF_FS_READONLY
 				if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
-					if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+					DATA_WRITE(fp->buf, fp->sect, 1);
 					fp->flag &= (BYTE)~FA_DIRTY;
 				}
 #endif
-				if (disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK)	ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+				DATA_READ(fp->buf, sect, 1);	/* Fill sector cache */
 			}
 #endif
 			fp->sect = sect;
@@ -3882,7 +3935,7 @@ FRESULT f_write (
 			if (fs->winsect == fp->sect && sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Write-back sector cache */
 #else
 			if (fp->flag & FA_DIRTY) {		/* Write-back sector cache */
-				if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+				DATA_WRITE(fp->buf, fp->sect, 1);
 				fp->flag &= (BYTE)~FA_DIRTY;
 			}
 #endif
@@ -3894,7 +3947,7 @@ FRESULT f_write (
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
 					cc = fs->csize - csect;
 				}
-				if (disk_write(fs->pdrv, wbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
+				DATA_WRITE(wbuff, sect, cc);
 #if FF_FS_MINIMIZE <= 2
 #if FF_FS_TINY
 				if (fs->winsect - sect < cc) {	/* Refill sector cache if it gets invalidated by the direct write */
@@ -3918,9 +3971,8 @@ FRESULT f_write (
 			}
 #else
 			if (fp->sect != sect && 		/* Fill sector cache with file data */
-				fp->fptr < fp->obj.objsize &&
-				disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK) {
-					ABORT(fs, FR_DISK_ERR);
+				fp->fptr < fp->obj.objsize) {
+				DATA_READ(fp->buf, sect, 1);
 			}
 #endif
 			fp->sect = sect;
@@ -37,14 +37,29 @@
 #include <file.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ff.h"
 #include "ffcio.h"
 
-static FIL *filTable[_NSTREAM];
+typedef struct {
+    FIL       fil;
+    int       llv_fd;
+    char     *buf;          /* Write buffer, NULL if unbuffered */
+    unsigned  bufSize;
+    unsigned  bufCount;     /* Number of bytes held in buf */
+    int       bufAllocated; /* buf was allocated by ffcio_setvbuf() */
+} FFCIO_File;
+
+static FFCIO_File *filTable[_NSTREAM];
 
 static int init = 0;
 
+static int findFile(int llv_fd);
+static int flushBuf(FFCIO_File *file);
+static int setBuf(FFCIO_File *file, char *buf, unsigned size);
+static int writeFile(FFCIO_File *file, const char *buf, unsigned count);
+
 /*
  *  ======== ffcio_open ========
  */
@@ -53,8 +68,6 @@ int ffcio_open(const char *path, unsigned flags, int llv_fd)
     int         dev_fd;
     BYTE        fflags;
 
-    (void)llv_fd;
-
     if (!init) {
         for (dev_fd = 0; dev_fd < _NSTREAM; dev_fd++) {
             filTable[dev_fd] = NULL;
@@ -62,22 +75,6 @@ int ffcio_open(const char *path, unsigned flags, int llv_fd)
         init = 1;
     }
 
-    for (dev_fd = 0; dev_fd < _NSTREAM && filTable[dev_fd] != NULL; dev_fd++) {
-    }
-
-    if (dev_fd == _NSTREAM) {
-        /* no available file handles */
-        return (-1);
-    }
-
-
-    filTable[dev_fd] = malloc(sizeof(FIL));
-
-    if (filTable[dev_fd] == NULL) {
-        /* allocation failed */
-        return (-1);
-    }
-
     switch (flags & 0x3) {
         case O_RDONLY:
             fflags = FA_READ;
@@ -107,7 +104,32 @@ int ffcio_open(const char *path, unsigned flags, int llv_fd)
         fflags |= FA_OPEN_APPEND;
     }
 
-    if (f_open(filTable[dev_fd], path, fflags) != FR_OK) {
+    for (dev_fd = 0; dev_fd < _NSTREAM && filTable[dev_fd] != NULL; dev_fd++) {
+    }
+
+    if (dev_fd == _NSTREAM) {
+        /* no available file handles */
+        return (-1);
+    }
+
+    filTable[dev_fd] = malloc(sizeof(FFCIO_File));
+
+    if (filTable[dev_fd] == NULL) {
+        /* allocation failed */
+        return (-1);
+    }
+
+    filTable[dev_fd]->llv_fd = llv_fd;
+    filTable[dev_fd]->buf = NULL;
+    filTable[dev_fd]->bufSize = 0;
+    filTable[dev_fd]->bufCount = 0;
+    filTable[dev_fd]->bufAllocated = 0;
+
+    if (((fflags & FA_WRITE) &&
+        setBuf(filTable[dev_fd], NULL, FFCIO_BUFSIZE) != 0) ||
+        f_open(&filTable[dev_fd]->fil, path, fflags) != FR_OK) {
+        setBuf(filTable[dev_fd], NULL, 0);
+
         free(filTable[dev_fd]);
 
         filTable[dev_fd] = NULL;
@@ -123,13 +145,21 @@ int ffcio_open(const char *path, unsigned flags, int llv_fd)
  */
 int ffcio_close(int dev_fd)
 {
-    f_close(filTable[dev_fd]);
+    int status;
+
+    status = flushBuf(filTable[dev_fd]);
+
+    f_close(&filTable[dev_fd]->fil);
+
+    /* Data which could not be written is lost */
+    filTable[dev_fd]->bufCount = 0;
+    setBuf(filTable[dev_fd], NULL, 0);
 
     free(filTable[dev_fd]);
 
     filTable[dev_fd] = NULL;
 
-    return (0);
+    return (status);
 }
 
 /*
@@ -140,7 +170,11 @@ int ffcio_read(int dev_fd, char *buf, unsigned count)
     FRESULT result;
     unsigned int actual;
 
-    result = f_read(filTable[dev_fd], buf, count, &actual);
+    if (flushBuf(filTable[dev_fd]) != 0) {
+        return (-1);
+    }
+
+    result = f_read(&filTable[dev_fd]->fil, buf, count, &actual);
 
     if (result == FR_OK) {
         return ((int)actual);
@@ -155,17 +189,7 @@ int ffcio_read(int dev_fd, char *buf, unsigned count)
  */
 int ffcio_write(int dev_fd, const char *buf, unsigned count)
 {
-    FRESULT result;
-    unsigned int actual;
-
-    result = f_write(filTable[dev_fd], buf, count, &actual);
-
-    if (result == FR_OK) {
-        return ((int)actual);
-    }
-    else {
-        return (-1);
-    }
+    return (writeFile(filTable[dev_fd], buf, count));
 }
 
 /*
@@ -175,15 +199,19 @@ fpos_t ffcio_lseek(int dev_fd, fpos_t offset, int origin)
 {
     FRESULT result;
 
+    if (flushBuf(filTable[dev_fd]) != 0) {
+        return (-1);
+    }
+
     if (origin == SEEK_CUR) {
-        offset += f_tell(filTable[dev_fd]);
+        offset += f_tell(&filTable[dev_fd]->fil);
     }
 
     if (origin == SEEK_END) {
-        offset += f_size(filTable[dev_fd]);
+        offset += f_size(&filTable[dev_fd]->fil);
     }
 
-    result = f_lseek(filTable[dev_fd], offset);
+    result = f_lseek(&filTable[dev_fd]->fil, offset);
 
     if (result != FR_OK) {
         return (-1);
@@ -193,6 +221,68 @@ fpos_t ffcio_lseek(int dev_fd, fpos_t offset, int origin)
     }
 }
 
+/*
+ *  ======== ffcio_setvbuf ========
+ */
+int ffcio_setvbuf(int llv_fd, char *buf, unsigned size)
+{
+    int dev_fd = findFile(llv_fd);
+
+    if (dev_fd == -1) {
+        return (-1);
+    }
+
+    return (setBuf(filTable[dev_fd], buf, size));
+}
+
+/*
+ *  ======== ffcio_writev ========
+ */
+int ffcio_writev(int llv_fd, const struct ffcio_iovec *iov, int iovcnt)
+{
+    int dev_fd = findFile(llv_fd);
+    int total = 0;
+    int actual;
+    int i;
+
+    if (dev_fd == -1 || iovcnt < 0) {
+        return (-1);
+    }
+
+    for (i = 0; i < iovcnt; i++) {
+        actual = writeFile(filTable[dev_fd], iov[i].iov_base, iov[i].iov_len);
+
+        if (actual == -1) {
+            return ((total > 0) ? total : -1);
+        }
+
+        total += actual;
+
+        if ((unsigned)actual < iov[i].iov_len) {
+            /* disk full */
+            break;
+        }
+    }
+
+    return (total);
+}
+
+/*
+ *  ======== ffcio_fsync ========
+ */
+int ffcio_fsync(int llv_fd)
+{
+    int dev_fd = findFile(llv_fd);
+
+    if (dev_fd == -1 || flushBuf(filTable[dev_fd]) != 0 ||
+        f_sync(&filTable[dev_fd]->fil) != FR_OK) {
+        return (-1);
+    }
+    else {
+        return (0);
+    }
+}
+
 /*
  *  ======== ffcio_unlink ========
  */
@@ -254,3 +344,119 @@ int rmdir(const char * path)
         return (-1);
     }
 }
+
+/*
+ *  ======== findFile ========
+ *  Returns the dev_fd of the file opened for llv_fd, or -1.
+ */
+static int findFile(int llv_fd)
+{
+    int dev_fd;
+
+    if (init) {
+        for (dev_fd = 0; dev_fd < _NSTREAM; dev_fd++) {
+            if (filTable[dev_fd] != NULL &&
+                filTable[dev_fd]->llv_fd == llv_fd) {
+                return (dev_fd);
+            }
+        }
+    }
+
+    return (-1);
+}
+
+/*
+ *  ======== flushBuf ========
+ *  Passes the data held in the write buffer of a file to FatFs.
+ */
+static int flushBuf(FFCIO_File *file)
+{
+    FRESULT result;
+    unsigned int actual;
+
+    if (file->bufCount == 0) {
+        return (0);
+    }
+
+    result = f_write(&file->fil, file->buf, file->bufCount, &actual);
+
+    /* Keep the data which was not written for the next attempt */
+    file->bufCount -= actual;
+    memmove(file->buf, file->buf + actual, file->bufCount);
+
+    if (result != FR_OK || file->bufCount != 0) {
+        return (-1);
+    }
+    else {
+        return (0);
+    }
+}
+
+/*
+ *  ======== setBuf ========
+ *  Replaces the write buffer of a file, see ffcio_setvbuf().
+ */
+static int setBuf(FFCIO_File *file, char *buf, unsigned size)
+{
+    if (flushBuf(file) != 0) {
+        return (-1);
+    }
+
+    if (file->bufAllocated) {
+        free(file->buf);
+        file->bufAllocated = 0;
+    }
+
+    if (size > 0 && buf == NULL) {
+        buf = malloc(size);
+        file->bufAllocated = (buf != NULL);
+    }
+
+    file->buf = buf;
+    file->bufSize = (buf != NULL) ? size : 0;
+
+    return ((file->bufSize == size) ? 0 : -1);
+}
+
+/*
+ *  ======== writeFile ========
+ *  Gathers small writes in the write buffer of a file, so that FatFs is
+ *  called once per buffer instead of once per write.
+ */
+static int writeFile(FFCIO_File *file, const char *buf, unsigned count)
+{
+    FRESULT      result;
+    unsigned int actual;
+    unsigned     size;
+    int          total = 0;
+
+    while (count > 0) {
+        if (file->bufCount == 0 && count >= file->bufSize) {
+            /* nothing to gather, write straight from the caller's buffer */
+            result = f_write(&file->fil, buf, count, &actual);
+
+            if (result != FR_OK) {
+                return ((total > 0) ? total : -1);
+            }
+
+            return (total + (int)actual);
+        }
+
+        size = file->bufSize - file->bufCount;
+        if (size > count) {
+            size = count;
+        }
+
+        memcpy(file->buf + file->bufCount, buf, size);
+        file->bufCount += size;
+        buf += size;
+        count -= size;
+        total += (int)size;
+
+        if (file->bufCount == file->bufSize && flushBuf(file) != 0) {
+            return ((total > 0) ? total : -1);
+        }
+    }
+
+    return (total);
+}
@@ -37,6 +37,26 @@
 #ifndef FFCIO_
 #define FFCIO_
 
+/*
+ *  Default size of the write buffer given to each file opened for writing.
+ *  Writes to a buffered file are collected in RAM & passed to FatFs when the
+ *  buffer is full, on ffcio_fsync(), or before the file is read, seeked or
+ *  closed.  A multiple of the sector size lets FatFs write whole sectors
+ *  straight from the buffer.  0 leaves files unbuffered; ffcio_setvbuf()
+ *  changes the buffer of an individual file.
+ */
+#ifndef FFCIO_BUFSIZE
+#define FFCIO_BUFSIZE 0
+#endif
+
+/*
+ *  Describes one of the buffers written by ffcio_writev().
+ */
+struct ffcio_iovec {
+    const void *iov_base;
+    unsigned    iov_len;
+};
+
 extern int ffcio_close(int dev_fd);
 extern fpos_t ffcio_lseek(int dev_fd, fpos_t offset, int origin);
 extern int ffcio_open(const char *path, unsigned flags, int llv_fd);
@@ -45,4 +65,35 @@ extern int ffcio_rename(const char *old_name, const char *new_name);
 extern int ffcio_unlink(const char *path);
 extern int ffcio_write(int dev_fd, const char *buf, unsigned count);
 
+/*
+ *  The functions below are called by the application.  They take the file
+ *  descriptor returned by open(), or fileno() of a FILE opened with fopen().
+ */
+
+/*
+ *  ======== ffcio_setvbuf ========
+ *  Sets the write buffer of an open file, after writing out the data held
+ *  in its current buffer.  If buf is NULL, a buffer of the given size is
+ *  allocated & freed when the file is closed.  A size of 0 makes the file
+ *  unbuffered.  Returns 0 on success or -1 on failure.
+ */
+extern int ffcio_setvbuf(int llv_fd, char *buf, unsigned size);
+
+/*
+ *  ======== ffcio_writev ========
+ *  Writes iovcnt buffers to a file in order, as if by one ffcio_write() of
+ *  their concatenation.  Returns the number of bytes written or -1 on
+ *  failure.
+ */
+extern int ffcio_writev(int llv_fd, const struct ffcio_iovec *iov,
+    int iovcnt);
+
+/*
+ *  ======== ffcio_fsync ========
+ *  Writes out the buffered data of a file & commits it to the disk with
+ *  f_sync(), so that it survives a power loss.  Returns 0 on success or -1
+ *  on failure.
+ */
+extern int ffcio_fsync(int llv_fd);
+
 #endif
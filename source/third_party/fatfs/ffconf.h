@@ -42,8 +42,13 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
+#ifndef FF_USE_FASTSEEK
 #define FF_USE_FASTSEEK	0
-/* This option switches fast seek function. (0:Disable or 1:Enable) */
+#endif
+/* This option switches fast seek function. (0:Disable or 1:Enable)
+/  Enabling it adds the cltbl member to FIL, and the prebuilt FatFs and driver
+/  libraries are built with 0. To opt in, define FF_USE_FASTSEEK to 1 for the
+/  whole application and build ff.c and SDFatFS.c from source with it. */
 
 
 #define FF_USE_EXPAND	0
@@ -279,5 +284,20 @@
 /* #include <windows.h>	// O/S definitions  */
 
 
+#ifndef FF_FS_UNLOCKED_IO
+#define FF_FS_UNLOCKED_IO	0
+#endif
+/* The option FF_FS_UNLOCKED_IO lets f_read() and f_write() release the volume
+/  while they transfer file data sectors, so that other tasks can access the same
+/  volume in the meantime, e.g. one task logging to a file while another one reads
+/  out a different file. The volume is still held for FAT, directory and allocation
+/  updates.
+/
+/   0: Hold the volume for the whole file function.
+/   1: Release the volume during file data transfers. FF_FS_REENTRANT must be 1,
+/      FF_FS_TINY must be 0, and the disk I/O functions must be thread-safe. A file
+/      object must not be used by more than one task at a time. */
+
+
 
 /*--- End of configuration options ---*/
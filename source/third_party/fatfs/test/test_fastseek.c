@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * ======== test_fastseek.c ========
+ * Host benchmark of FatFs fast seek on the RAM disk.
+ *
+ * Writes a 4 MB file interleaved with a second file, so that the first one
+ * is fragmented, then reads it back at random offsets and sequentially,
+ * comparing every byte. Built with FF_USE_FASTSEEK 0 and 1; with 1 the file
+ * is read once following the FAT chain and once with a cluster link map.
+ * Prints the disk reads each pass costs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ff.h"
+#include "diskio.h"
+
+#define DISK_SIZE   (8 * 1024 * 1024)
+#define FILE_SIZE   (4 * 1024 * 1024)
+#define CHUNK_SIZE  4096
+#define READS       2000
+#define READ_SIZE   100
+#define MAP_SIZE    2048
+
+extern DRESULT ramdisk_start(BYTE drive, unsigned char *data, int numBytes,
+    int mkfs);
+extern DSTATUS ramdisk_init(BYTE drive);
+extern DSTATUS ramdisk_status(BYTE drive);
+extern DRESULT ramdisk_read(BYTE drive, BYTE *buf, DWORD sector, UINT num);
+extern DRESULT ramdisk_write(BYTE drive, const BYTE *buf, DWORD sector,
+    UINT num);
+extern DRESULT ramdisk_ioctl(BYTE drive, BYTE cmd, void *buf);
+
+static unsigned char disk[DISK_SIZE];
+static unsigned char model[FILE_SIZE];
+static unsigned long diskReads;
+
+/*
+ *  ======== ff_cre_syncobj ========
+ *  No other task uses the volume, the sync functions always succeed.
+ */
+int ff_cre_syncobj(BYTE vol, FF_SYNC_t *sobj)
+{
+    *sobj = (FF_SYNC_t)1;
+    return (1);
+}
+
+int ff_del_syncobj(FF_SYNC_t sobj)
+{
+    return (1);
+}
+
+int ff_req_grant(FF_SYNC_t sobj)
+{
+    return (1);
+}
+
+void ff_rel_grant(FF_SYNC_t sobj)
+{
+}
+
+int32_t fatfs_getFatTime(void)
+{
+    return (0);
+}
+
+/*
+ *  ======== countingRead ========
+ */
+static DRESULT countingRead(BYTE drive, BYTE *buf, DWORD sector, UINT num)
+{
+    diskReads++;
+    return (ramdisk_read(drive, buf, sector, num));
+}
+
+/*
+ *  ======== readFile ========
+ */
+static int readFile(const char *what, DWORD *linkMap)
+{
+    unsigned char buf[READ_SIZE];
+    unsigned long reads;
+    FIL file;
+    UINT bytes;
+    int offset;
+    int i;
+
+    if (f_open(&file, "0:big.log", FA_READ) != FR_OK) {
+        printf("open failed\n");
+        return (-1);
+    }
+
+#if FF_USE_FASTSEEK
+    if (linkMap != NULL) {
+        linkMap[0] = MAP_SIZE;
+        file.cltbl = linkMap;
+        if (f_lseek(&file, CREATE_LINKMAP) != FR_OK) {
+            printf("link map needs %lu entries\n", (unsigned long)linkMap[0]);
+            return (-1);
+        }
+    }
+#endif
+
+    srand(7);
+    reads = diskReads;
+    for (i = 0; i < READS; i++) {
+        offset = rand() % (FILE_SIZE - READ_SIZE);
+        if (f_lseek(&file, offset) != FR_OK ||
+            f_read(&file, buf, READ_SIZE, &bytes) != FR_OK ||
+            bytes != READ_SIZE || memcmp(buf, &model[offset], READ_SIZE) != 0) {
+            printf("%s: random read at %d differs\n", what, offset);
+            return (-1);
+        }
+    }
+    printf("%s: %d random %d byte reads, %lu disk reads\n", what, READS,
+        READ_SIZE, diskReads - reads);
+
+    reads = diskReads;
+    f_lseek(&file, 0);
+    for (offset = 0; offset < FILE_SIZE; offset += 64) {
+        if (f_read(&file, buf, 64, &bytes) != FR_OK || bytes != 64 ||
+            memcmp(buf, &model[offset], 64) != 0) {
+            printf("%s: sequential read at %d differs\n", what, offset);
+            return (-1);
+        }
+    }
+    printf("%s: sequential 64 byte reads, %lu disk reads\n", what,
+        diskReads - reads);
+
+    f_close(&file);
+    return (0);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(void)
+{
+#if FF_USE_FASTSEEK
+    static DWORD linkMap[MAP_SIZE];
+#endif
+    FIL big;
+    FIL other;
+    UINT bytes;
+    int offset;
+    int i;
+
+    if (ramdisk_start(0, disk, sizeof(disk), 1) != RES_OK) {
+        printf("ramdisk_start failed\n");
+        return (1);
+    }
+    disk_register(0, ramdisk_init, ramdisk_status, countingRead,
+        ramdisk_write, ramdisk_ioctl);
+
+    srand(3);
+    for (i = 0; i < FILE_SIZE; i++) {
+        model[i] = rand();
+    }
+
+    /* Interleave the two files so that big.log is fragmented */
+    if (f_open(&big, "0:big.log", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK ||
+        f_open(&other, "0:other.log", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+        printf("create failed\n");
+        return (1);
+    }
+    for (offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE) {
+        if (f_write(&big, &model[offset], CHUNK_SIZE, &bytes) != FR_OK ||
+            bytes != CHUNK_SIZE) {
+            printf("write failed\n");
+            return (1);
+        }
+        if ((offset / CHUNK_SIZE) % 3 == 0) {
+            f_write(&other, model, 1024, &bytes);
+        }
+        f_sync(&big);
+        f_sync(&other);
+    }
+    f_close(&big);
+    f_close(&other);
+
+    if (readFile("FAT chain", NULL) != 0) {
+        return (1);
+    }
+#if FF_USE_FASTSEEK
+    if (readFile("link map ", linkMap) != 0) {
+        return (1);
+    }
+    printf("link map of %lu entries\n", (unsigned long)linkMap[0]);
+#endif
+
+    return (0);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * ======== test_ffcio.c ========
+ * Host benchmark of the ffcio write buffer on the RAM disk.
+ *
+ * Appends 200000 records of 16 to 64 bytes to a log file, unbuffered and
+ * with 512 and 4096 byte buffers set by ffcio_setvbuf(). Every other record
+ * is written with ffcio_writev() and the buffered runs call ffcio_fsync()
+ * every 5000 records. Each file is read back with ffcio_read() and compared
+ * with what was written. Prints the disk writes and the FatFs lock grants
+ * of each run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <file.h>
+
+#include "ff.h"
+#include "diskio.h"
+#include "ffcio.h"
+
+#define DISK_SIZE   (32 * 1024 * 1024)
+#define RECORDS     200000
+#define MAX_RECORD  64
+#define SYNC_EVERY  5000
+
+extern DRESULT ramdisk_start(BYTE drive, unsigned char *data, int numBytes,
+    int mkfs);
+extern DSTATUS ramdisk_init(BYTE drive);
+extern DSTATUS ramdisk_status(BYTE drive);
+extern DRESULT ramdisk_read(BYTE drive, BYTE *buf, DWORD sector, UINT num);
+extern DRESULT ramdisk_write(BYTE drive, const BYTE *buf, DWORD sector,
+    UINT num);
+extern DRESULT ramdisk_ioctl(BYTE drive, BYTE cmd, void *buf);
+
+static unsigned char disk[DISK_SIZE];
+static char model[RECORDS * MAX_RECORD];
+static char readBack[RECORDS * MAX_RECORD + 1];
+static unsigned long diskWrites;
+static unsigned long grants;
+
+/*
+ *  ======== ff_cre_syncobj ========
+ *  No other task uses the volume, the sync functions always succeed.
+ *  ff_req_grant() counts the times FatFs takes the volume lock.
+ */
+int ff_cre_syncobj(BYTE vol, FF_SYNC_t *sobj)
+{
+    *sobj = (FF_SYNC_t)1;
+    return (1);
+}
+
+int ff_del_syncobj(FF_SYNC_t sobj)
+{
+    return (1);
+}
+
+int ff_req_grant(FF_SYNC_t sobj)
+{
+    grants++;
+    return (1);
+}
+
+void ff_rel_grant(FF_SYNC_t sobj)
+{
+}
+
+int32_t fatfs_getFatTime(void)
+{
+    return (0);
+}
+
+/*
+ *  ======== countingWrite ========
+ */
+static DRESULT countingWrite(BYTE drive, const BYTE *buf, DWORD sector,
+    UINT num)
+{
+    diskWrites++;
+    return (ramdisk_write(drive, buf, sector, num));
+}
+
+/*
+ *  ======== writeLog ========
+ */
+static int writeLog(const char *path, int llv_fd, unsigned bufSize)
+{
+    struct ffcio_iovec iov[2];
+    unsigned long writes = diskWrites;
+    unsigned long lockGrants = grants;
+    char record[MAX_RECORD];
+    long total = 0;
+    int dev_fd;
+    int len;
+    int i;
+    int j;
+
+    dev_fd = ffcio_open(path, O_WRONLY | O_CREAT | O_TRUNC, llv_fd);
+    if (dev_fd < 0 || ffcio_setvbuf(llv_fd, NULL, bufSize) != 0) {
+        printf("%s: open failed\n", path);
+        return (-1);
+    }
+
+    srand(1);
+    for (i = 0; i < RECORDS; i++) {
+        len = 16 + rand() % (MAX_RECORD - 15);
+        for (j = 0; j < len - 1; j++) {
+            record[j] = 'a' + (i + j) % 26;
+        }
+        record[len - 1] = '\n';
+
+        if (i % 2) {
+            iov[0].iov_base = record;
+            iov[0].iov_len = len / 2;
+            iov[1].iov_base = record + len / 2;
+            iov[1].iov_len = len - len / 2;
+            if (ffcio_writev(llv_fd, iov, 2) != len) {
+                printf("%s: writev failed\n", path);
+                return (-1);
+            }
+        }
+        else if (ffcio_write(dev_fd, record, len) != len) {
+            printf("%s: write failed\n", path);
+            return (-1);
+        }
+        memcpy(&model[total], record, len);
+        total += len;
+
+        if (bufSize != 0 && (i % SYNC_EVERY) == SYNC_EVERY - 1 &&
+            ffcio_fsync(llv_fd) != 0) {
+            printf("%s: fsync failed\n", path);
+            return (-1);
+        }
+    }
+    if (ffcio_close(dev_fd) != 0) {
+        printf("%s: close failed\n", path);
+        return (-1);
+    }
+
+    printf("buffer %4u: %d records (%ld bytes), %lu disk writes, "
+        "%lu lock grants\n", bufSize, RECORDS, total, diskWrites - writes,
+        grants - lockGrants);
+
+    dev_fd = ffcio_open(path, O_RDONLY, llv_fd);
+    if (dev_fd < 0 ||
+        ffcio_read(dev_fd, readBack, sizeof(readBack)) != total ||
+        memcmp(readBack, model, total) != 0) {
+        printf("%s: file differs\n", path);
+        return (-1);
+    }
+    ffcio_close(dev_fd);
+
+    return (0);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(void)
+{
+    if (ramdisk_start(0, disk, sizeof(disk), 1) != RES_OK) {
+        printf("ramdisk_start failed\n");
+        return (1);
+    }
+    disk_register(0, ramdisk_init, ramdisk_status, ramdisk_read,
+        countingWrite, ramdisk_ioctl);
+
+    if (writeLog("0:log0.csv", 3, 0) != 0 ||
+        writeLog("0:log512.csv", 4, 512) != 0 ||
+        writeLog("0:log4096.csv", 5, 4096) != 0) {
+        return (1);
+    }
+
+    return (0);
+}
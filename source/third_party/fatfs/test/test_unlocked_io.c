@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * ======== test_unlocked_io.c ========
+ * Host test of FF_FS_UNLOCKED_IO on the RAM disk.
+ *
+ * A logger thread appends 48 byte records to one file while an upload thread
+ * reads a 2 MB file in 32 KB chunks from the same volume. The disk takes
+ * 0.5 ms plus 50 us per sector for each transfer. Both files are compared
+ * with what was written. Built with FF_FS_UNLOCKED_IO 0 and 1, and prints how
+ * long the appends took while the upload ran so that the builds can be
+ * compared.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ff.h"
+#include "diskio.h"
+
+#define DISK_SIZE   (32 * 1024 * 1024)
+#define FILE_SIZE   (2 * 1024 * 1024)
+#define CHUNK_SIZE  (32 * 1024)
+#define PASSES      2
+#define MAX_RECORDS 100000
+
+extern DRESULT ramdisk_start(BYTE drive, unsigned char *data, int numBytes,
+    int mkfs);
+extern DSTATUS ramdisk_init(BYTE drive);
+extern DSTATUS ramdisk_status(BYTE drive);
+extern DRESULT ramdisk_read(BYTE drive, BYTE *buf, DWORD sector, UINT num);
+extern DRESULT ramdisk_write(BYTE drive, const BYTE *buf, DWORD sector,
+    UINT num);
+extern DRESULT ramdisk_ioctl(BYTE drive, BYTE cmd, void *buf);
+
+static unsigned char disk[DISK_SIZE];
+static unsigned char model[FILE_SIZE];
+static double latency[MAX_RECORDS];
+static volatile int uploadDone;
+static int timedDisk;
+static pthread_mutex_t diskLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ *  ======== ff_cre_syncobj ========
+ *  The volume lock is a pthread mutex.
+ */
+int ff_cre_syncobj(BYTE vol, FF_SYNC_t *sobj)
+{
+    pthread_mutex_t *mutex = malloc(sizeof(pthread_mutex_t));
+
+    pthread_mutex_init(mutex, NULL);
+    *sobj = mutex;
+    return (1);
+}
+
+int ff_del_syncobj(FF_SYNC_t sobj)
+{
+    pthread_mutex_destroy(sobj);
+    free(sobj);
+    return (1);
+}
+
+int ff_req_grant(FF_SYNC_t sobj)
+{
+    return (pthread_mutex_lock(sobj) == 0);
+}
+
+void ff_rel_grant(FF_SYNC_t sobj)
+{
+    pthread_mutex_unlock(sobj);
+}
+
+int32_t fatfs_getFatTime(void)
+{
+    return (0);
+}
+
+/*
+ *  ======== now ========
+ *  Milliseconds.
+ */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+/*
+ *  ======== diskWait ========
+ *  The disk is thread-safe and serves one transfer at a time.
+ */
+static void diskWait(UINT num)
+{
+    struct timespec ts = {0, 500000 + 50000 * num};
+
+    if (timedDisk) {
+        nanosleep(&ts, NULL);
+    }
+}
+
+static DRESULT timedRead(BYTE drive, BYTE *buf, DWORD sector, UINT num)
+{
+    DRESULT result;
+
+    pthread_mutex_lock(&diskLock);
+    diskWait(num);
+    result = ramdisk_read(drive, buf, sector, num);
+    pthread_mutex_unlock(&diskLock);
+    return (result);
+}
+
+static DRESULT timedWrite(BYTE drive, const BYTE *buf, DWORD sector, UINT num)
+{
+    DRESULT result;
+
+    pthread_mutex_lock(&diskLock);
+    diskWait(num);
+    result = ramdisk_write(drive, buf, sector, num);
+    pthread_mutex_unlock(&diskLock);
+    return (result);
+}
+
+/*
+ *  ======== uploader ========
+ */
+static void *uploader(void *arg)
+{
+    unsigned char *buf = malloc(CHUNK_SIZE);
+    FIL file;
+    UINT bytes;
+    int offset;
+    int pass;
+
+    for (pass = 0; pass < PASSES; pass++) {
+        if (f_open(&file, "0:big.bin", FA_READ) != FR_OK) {
+            printf("upload open failed\n");
+            exit(1);
+        }
+        for (offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE) {
+            if (f_read(&file, buf, CHUNK_SIZE, &bytes) != FR_OK ||
+                bytes != CHUNK_SIZE ||
+                memcmp(buf, &model[offset], CHUNK_SIZE) != 0) {
+                printf("upload differs at %d\n", offset);
+                exit(1);
+            }
+        }
+        f_close(&file);
+    }
+
+    free(buf);
+    uploadDone = 1;
+    return (NULL);
+}
+
+static int compareLatency(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return ((x > y) - (x < y));
+}
+
+/*
+ *  ======== main ========
+ */
+int main(void)
+{
+    struct timespec idle = {0, 2000000};
+    char record[48];
+    char line[48];
+    pthread_t thread;
+    double start;
+    double elapsed;
+    FIL file;
+    UINT bytes;
+    int len;
+    long records = 0;
+    long i;
+
+    if (ramdisk_start(0, disk, sizeof(disk), 1) != RES_OK) {
+        printf("ramdisk_start failed\n");
+        return (1);
+    }
+    disk_register(0, ramdisk_init, ramdisk_status, timedRead, timedWrite,
+        ramdisk_ioctl);
+
+    srand(3);
+    for (i = 0; i < FILE_SIZE; i++) {
+        model[i] = rand();
+    }
+    if (f_open(&file, "0:big.bin", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK ||
+        f_write(&file, model, FILE_SIZE, &bytes) != FR_OK ||
+        bytes != FILE_SIZE || f_close(&file) != FR_OK) {
+        printf("write of big.bin failed\n");
+        return (1);
+    }
+
+    if (f_open(&file, "0:log.txt", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+        printf("open of log.txt failed\n");
+        return (1);
+    }
+
+    timedDisk = 1;
+    start = now();
+    pthread_create(&thread, NULL, uploader, NULL);
+
+    while (!uploadDone && records < MAX_RECORDS) {
+        double t;
+
+        len = sprintf(record, "rec %08ld abcdefghijklmnopqrstuvwxyz\n", records);
+        t = now();
+        if (f_write(&file, record, len, &bytes) != FR_OK || bytes != len) {
+            printf("append failed\n");
+            return (1);
+        }
+        if (records % 16 == 15) {
+            f_sync(&file);
+        }
+        latency[records++] = now() - t;
+        nanosleep(&idle, NULL);
+    }
+
+    pthread_join(thread, NULL);
+    elapsed = now() - start;
+    timedDisk = 0;
+    f_close(&file);
+
+    /* Check the log */
+    if (f_open(&file, "0:log.txt", FA_READ) != FR_OK) {
+        printf("open of log.txt failed\n");
+        return (1);
+    }
+    for (i = 0; i < records; i++) {
+        len = sprintf(record, "rec %08ld abcdefghijklmnopqrstuvwxyz\n", i);
+        if (f_read(&file, line, len, &bytes) != FR_OK || bytes != len ||
+            memcmp(line, record, len) != 0) {
+            printf("log differs at record %ld\n", i);
+            return (1);
+        }
+    }
+    f_close(&file);
+
+    qsort(latency, records, sizeof(double), compareLatency);
+    printf("FF_FS_UNLOCKED_IO %d: upload %.0f ms, %ld appends, "
+        "median %.3f ms, worst %.3f ms\n", FF_FS_UNLOCKED_IO, elapsed, records,
+        latency[records / 2], latency[records - 1]);
+
+    return (0);
+}
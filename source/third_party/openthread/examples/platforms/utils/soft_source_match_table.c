@@ -32,6 +32,12 @@
  *   such hardware acceleration. It supports only the single-instance build of
  *   OpenThread.
  *
+ *   Entries are found through an open addressed slot array with twice as many
+ *   slots as entries. Every entry is kept within SRC_MATCH_MAX_PROBES slots of
+ *   its hash, so that lookups done within the ACK turnaround time take a bounded
+ *   number of probes whatever the addresses are. An entry which does not fit
+ *   makes the table pick another hash multiplier.
+ *
  */
 
 #include "utils/soft_source_match_table.h"
@@ -49,62 +55,237 @@ void utilsSoftSrcMatchSetPanId(uint16_t aPanId)
 {
     sPanId = aPanId;
 }
-#endif // RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM || RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM
 
-#if RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM
-typedef struct srcMatchShortEntry
+/**
+ * The maximum number of slots a lookup probes.
+ *
+ */
+#ifndef SRC_MATCH_MAX_PROBES
+#define SRC_MATCH_MAX_PROBES 8
+#endif
+
+/**
+ * The number of hash multipliers tried before an entry that does not fit is rejected.
+ *
+ */
+#ifndef SRC_MATCH_REHASH_ATTEMPTS
+#define SRC_MATCH_REHASH_ATTEMPTS 8
+#endif
+
+#define SRC_MATCH_HASH_MULTIPLIER 0x9e3779b1 // 2^32 divided by the golden ratio.
+
+// Slots hold entry index + 1 so that a zero-initialized slot array is empty.
+#define SRC_MATCH_LINK_NONE 0
+
+typedef struct srcMatchTable
 {
-    uint16_t checksum;
-    bool     allocated;
-} sSrcMatchShortEntry;
+    uint16_t *checksums; // Entry checksums, packed at the front.
+    uint16_t *slots;     // Twice as many slots as entries.
+    uint16_t  size;
+    uint16_t  count;
+    uint32_t  multiplier;
+} sSrcMatchTable;
+
+static void srcMatchTableReset(sSrcMatchTable *aTable)
+{
+    memset(aTable->slots, 0, sizeof(uint16_t) * 2 * aTable->size);
 
-static sSrcMatchShortEntry srcMatchShortEntry[RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM];
+    aTable->count = 0;
+}
 
-int16_t utilsSoftSrcMatchShortFindEntry(uint16_t aShortAddress)
+static inline uint16_t srcMatchTableHome(const sSrcMatchTable *aTable, uint16_t aChecksum)
+{
+    uint32_t hash = (uint32_t)aChecksum * aTable->multiplier;
+
+    return (uint16_t)(((uint64_t)hash * (2 * aTable->size)) >> 32);
+}
+
+static inline uint16_t srcMatchTableNext(const sSrcMatchTable *aTable, uint16_t aSlot)
 {
-    int16_t  entry    = -1;
-    uint16_t checksum = aShortAddress + sPanId;
+    return (aSlot + 1 == 2 * aTable->size) ? 0 : aSlot + 1;
+}
 
-    for (int16_t i = 0; i < RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM; i++)
+static inline uint16_t srcMatchTableDistance(const sSrcMatchTable *aTable, uint16_t aSlot, uint16_t aLink)
+{
+    uint16_t home = srcMatchTableHome(aTable, aTable->checksums[aLink - 1]);
+
+    return (aSlot >= home) ? aSlot - home : aSlot + 2 * aTable->size - home;
+}
+
+static int16_t srcMatchTableFindSlot(const sSrcMatchTable *aTable, uint16_t aChecksum)
+{
+    uint16_t slot  = srcMatchTableHome(aTable, aChecksum);
+    int16_t  found = -1;
+
+    for (uint16_t probe = 0; probe < SRC_MATCH_MAX_PROBES && aTable->slots[slot] != SRC_MATCH_LINK_NONE; probe++)
     {
-        if (checksum == srcMatchShortEntry[i].checksum && srcMatchShortEntry[i].allocated)
+        if (aTable->checksums[aTable->slots[slot] - 1] == aChecksum)
         {
-            entry = i;
+            found = (int16_t)slot;
             break;
         }
+
+        slot = srcMatchTableNext(aTable, slot);
     }
 
-    return entry;
+    return found;
 }
 
-static int16_t findSrcMatchShortAvailEntry(void)
+static int16_t srcMatchTableFind(const sSrcMatchTable *aTable, uint16_t aChecksum)
 {
-    int16_t entry = -1;
+    int16_t slot = srcMatchTableFindSlot(aTable, aChecksum);
 
-    for (int16_t i = 0; i < RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM; i++)
+    return (slot >= 0) ? (int16_t)(aTable->slots[slot] - 1) : -1;
+}
+
+/**
+ * This function puts an entry in a slot, keeping entries in the order of their home slot (Robin Hood hashing).
+ *
+ * That order gives the smallest possible probe distances, and the same layout for the same entries whatever order
+ * they were placed in.
+ *
+ * @returns false when an entry would end up SRC_MATCH_MAX_PROBES or more slots away from its home slot. The slots are
+ *          then left inconsistent and must be rebuilt.
+ *
+ */
+static bool srcMatchTablePlace(sSrcMatchTable *aTable, uint16_t aEntry)
+{
+    uint16_t link     = aEntry + 1;
+    uint16_t slot     = srcMatchTableHome(aTable, aTable->checksums[aEntry]);
+    uint16_t distance = 0;
+
+    while (aTable->slots[slot] != SRC_MATCH_LINK_NONE)
     {
-        if (!srcMatchShortEntry[i].allocated)
+        uint16_t other         = aTable->slots[slot];
+        uint16_t otherDistance = srcMatchTableDistance(aTable, slot, other);
+
+        if (otherDistance < distance)
         {
-            entry = i;
-            break;
+            aTable->slots[slot] = link;
+            link                = other;
+            distance            = otherDistance;
         }
+
+        slot = srcMatchTableNext(aTable, slot);
+
+        if (++distance >= SRC_MATCH_MAX_PROBES)
+        {
+            return false;
+        }
+    }
+
+    aTable->slots[slot] = link;
+
+    return true;
+}
+
+static bool srcMatchTableRebuild(sSrcMatchTable *aTable)
+{
+    memset(aTable->slots, 0, sizeof(uint16_t) * 2 * aTable->size);
+
+    for (uint16_t entry = 0; entry < aTable->count; entry++)
+    {
+        if (!srcMatchTablePlace(aTable, entry))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool srcMatchTableRehash(sSrcMatchTable *aTable)
+{
+    uint32_t multiplier = aTable->multiplier;
+
+    for (int attempt = 0; attempt < SRC_MATCH_REHASH_ATTEMPTS; attempt++)
+    {
+        aTable->multiplier = (aTable->multiplier * 1664525 + 1013904223) | 1;
+
+        if (srcMatchTableRebuild(aTable))
+        {
+            return true;
+        }
+    }
+
+    aTable->multiplier = multiplier;
+
+    return false;
+}
+
+static int16_t srcMatchTableAdd(sSrcMatchTable *aTable, uint16_t aChecksum)
+{
+    int16_t entry = -1;
+
+    otEXPECT(aTable->count < aTable->size);
+
+    entry                    = (int16_t)aTable->count++;
+    aTable->checksums[entry] = aChecksum;
+
+    if (!srcMatchTablePlace(aTable, (uint16_t)entry) && !srcMatchTableRehash(aTable))
+    {
+        // The previous entries fitted with this multiplier, and are placed the same way again.
+        aTable->count--;
+        srcMatchTableRebuild(aTable);
+        entry = -1;
     }
 
+exit:
     return entry;
 }
 
-static inline void addToSrcMatchShortIndirect(uint16_t entry, uint16_t aShortAddress)
+static int16_t srcMatchTableRemove(sSrcMatchTable *aTable, uint16_t aChecksum)
 {
-    uint16_t checksum = aShortAddress + sPanId;
+    int16_t  slot  = srcMatchTableFindSlot(aTable, aChecksum);
+    int16_t  entry = -1;
+    uint16_t last;
+    uint16_t next;
+
+    otEXPECT(slot >= 0);
+    entry = (int16_t)(aTable->slots[slot] - 1);
+
+    // Shift the entries that follow back towards their home slot.
+    next = srcMatchTableNext(aTable, (uint16_t)slot);
+
+    while (aTable->slots[next] != SRC_MATCH_LINK_NONE && srcMatchTableDistance(aTable, next, aTable->slots[next]) > 0)
+    {
+        aTable->slots[slot] = aTable->slots[next];
+        slot                = (int16_t)next;
+        next                = srcMatchTableNext(aTable, next);
+    }
+
+    aTable->slots[slot] = SRC_MATCH_LINK_NONE;
+
+    // Move the last entry into the one removed.
+    last = --aTable->count;
 
-    srcMatchShortEntry[entry].checksum  = checksum;
-    srcMatchShortEntry[entry].allocated = true;
+    if ((uint16_t)entry != last)
+    {
+        slot = srcMatchTableFindSlot(aTable, aTable->checksums[last]);
+
+        aTable->checksums[entry] = aTable->checksums[last];
+        aTable->slots[slot]      = (uint16_t)(entry + 1);
+    }
+
+exit:
+    return entry;
 }
+#endif // RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM || RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM
+
+#if RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM
+static uint16_t       srcMatchShortEntry[RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM];
+static uint16_t       srcMatchShortSlot[2 * RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM];
+static sSrcMatchTable srcMatchShortTable = {srcMatchShortEntry, srcMatchShortSlot,
+                                            RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM, 0, SRC_MATCH_HASH_MULTIPLIER};
 
-static inline void removeFromSrcMatchShortIndirect(uint16_t entry)
+static inline uint16_t srcMatchShortChecksum(uint16_t aShortAddress)
 {
-    srcMatchShortEntry[entry].allocated = false;
-    srcMatchShortEntry[entry].checksum  = 0;
+    return aShortAddress + sPanId;
+}
+
+int16_t utilsSoftSrcMatchShortFindEntry(uint16_t aShortAddress)
+{
+    return srcMatchTableFind(&srcMatchShortTable, srcMatchShortChecksum(aShortAddress));
 }
 
 otError otPlatRadioAddSrcMatchShortEntry(otInstance *aInstance, uint16_t aShortAddress)
@@ -114,13 +295,11 @@ otError otPlatRadioAddSrcMatchShortEntry(otInstance *aInstance, uint16_t aShortA
     otError error = OT_ERROR_NONE;
     int16_t entry = -1;
 
-    entry = findSrcMatchShortAvailEntry();
+    entry = srcMatchTableAdd(&srcMatchShortTable, srcMatchShortChecksum(aShortAddress));
     otLogDebgPlat("Add ShortAddr entry: %d", entry);
 
     otEXPECT_ACTION(entry >= 0 && entry < RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM, error = OT_ERROR_NO_BUFS);
 
-    addToSrcMatchShortIndirect((uint16_t)entry, aShortAddress);
-
 exit:
     return error;
 }
@@ -132,13 +311,11 @@ otError otPlatRadioClearSrcMatchShortEntry(otInstance *aInstance, uint16_t aShor
     otError error = OT_ERROR_NONE;
     int16_t entry = -1;
 
-    entry = utilsSoftSrcMatchShortFindEntry(aShortAddress);
+    entry = srcMatchTableRemove(&srcMatchShortTable, srcMatchShortChecksum(aShortAddress));
     otLogDebgPlat("Clear ShortAddr entry: %d", entry);
 
     otEXPECT_ACTION(entry >= 0 && entry < RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM, error = OT_ERROR_NO_ADDRESS);
 
-    removeFromSrcMatchShortIndirect((uint16_t)entry);
-
 exit:
     return error;
 }
@@ -149,22 +326,18 @@ void otPlatRadioClearSrcMatchShortEntries(otInstance *aInstance)
 
     otLogDebgPlat("Clear ShortAddr entries", NULL);
 
-    memset(srcMatchShortEntry, 0, sizeof(srcMatchShortEntry));
+    srcMatchTableReset(&srcMatchShortTable);
 }
 #endif // RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM
 
 #if RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM
-typedef struct srcMatchExtEntry
-{
-    uint16_t checksum;
-    bool     allocated;
-} sSrcMatchExtEntry;
-
-static sSrcMatchExtEntry srcMatchExtEntry[RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM];
+static uint16_t       srcMatchExtEntry[RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM];
+static uint16_t       srcMatchExtSlot[2 * RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM];
+static sSrcMatchTable srcMatchExtTable = {srcMatchExtEntry, srcMatchExtSlot, RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM, 0,
+                                          SRC_MATCH_HASH_MULTIPLIER};
 
-int16_t utilsSoftSrcMatchExtFindEntry(const otExtAddress *aExtAddress)
+static inline uint16_t srcMatchExtChecksum(const otExtAddress *aExtAddress)
 {
-    int16_t  entry    = -1;
     uint16_t checksum = sPanId;
 
     checksum += (uint16_t)aExtAddress->m8[0] | (uint16_t)(aExtAddress->m8[1] << 8);
@@ -172,51 +345,12 @@ int16_t utilsSoftSrcMatchExtFindEntry(const otExtAddress *aExtAddress)
     checksum += (uint16_t)aExtAddress->m8[4] | (uint16_t)(aExtAddress->m8[5] << 8);
     checksum += (uint16_t)aExtAddress->m8[6] | (uint16_t)(aExtAddress->m8[7] << 8);
 
-    for (int16_t i = 0; i < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM; i++)
-    {
-        if (checksum == srcMatchExtEntry[i].checksum && srcMatchExtEntry[i].allocated)
-        {
-            entry = i;
-            break;
-        }
-    }
-
-    return entry;
+    return checksum;
 }
 
-static int16_t findSrcMatchExtAvailEntry(void)
-{
-    int16_t entry = -1;
-
-    for (int16_t i = 0; i < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM; i++)
-    {
-        if (!srcMatchExtEntry[i].allocated)
-        {
-            entry = i;
-            break;
-        }
-    }
-
-    return entry;
-}
-
-static inline void addToSrcMatchExtIndirect(uint16_t entry, const otExtAddress *aExtAddress)
-{
-    uint16_t checksum = sPanId;
-
-    checksum += (uint16_t)aExtAddress->m8[0] | (uint16_t)(aExtAddress->m8[1] << 8);
-    checksum += (uint16_t)aExtAddress->m8[2] | (uint16_t)(aExtAddress->m8[3] << 8);
-    checksum += (uint16_t)aExtAddress->m8[4] | (uint16_t)(aExtAddress->m8[5] << 8);
-    checksum += (uint16_t)aExtAddress->m8[6] | (uint16_t)(aExtAddress->m8[7] << 8);
-
-    srcMatchExtEntry[entry].checksum  = checksum;
-    srcMatchExtEntry[entry].allocated = true;
-}
-
-static inline void removeFromSrcMatchExtIndirect(uint16_t entry)
+int16_t utilsSoftSrcMatchExtFindEntry(const otExtAddress *aExtAddress)
 {
-    srcMatchExtEntry[entry].allocated = false;
-    srcMatchExtEntry[entry].checksum  = 0;
+    return srcMatchTableFind(&srcMatchExtTable, srcMatchExtChecksum(aExtAddress));
 }
 
 otError otPlatRadioAddSrcMatchExtEntry(otInstance *aInstance, const otExtAddress *aExtAddress)
@@ -226,13 +360,11 @@ otError otPlatRadioAddSrcMatchExtEntry(otInstance *aInstance, const otExtAddress
     otError error = OT_ERROR_NONE;
     int16_t entry = -1;
 
-    entry = findSrcMatchExtAvailEntry();
+    entry = srcMatchTableAdd(&srcMatchExtTable, srcMatchExtChecksum(aExtAddress));
     otLogDebgPlat("Add ExtAddr entry: %d", entry);
 
     otEXPECT_ACTION(entry >= 0 && entry < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM, error = OT_ERROR_NO_BUFS);
 
-    addToSrcMatchExtIndirect((uint16_t)entry, aExtAddress);
-
 exit:
     return error;
 }
@@ -244,13 +376,11 @@ otError otPlatRadioClearSrcMatchExtEntry(otInstance *aInstance, const otExtAddre
     otError error = OT_ERROR_NONE;
     int16_t entry = -1;
 
-    entry = utilsSoftSrcMatchExtFindEntry(aExtAddress);
+    entry = srcMatchTableRemove(&srcMatchExtTable, srcMatchExtChecksum(aExtAddress));
     otLogDebgPlat("Clear ExtAddr entry: %d", entry);
 
     otEXPECT_ACTION(entry >= 0 && entry < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM, error = OT_ERROR_NO_ADDRESS);
 
-    removeFromSrcMatchExtIndirect((uint16_t)entry);
-
 exit:
     return error;
 }
@@ -261,6 +391,6 @@ void otPlatRadioClearSrcMatchExtEntries(otInstance *aInstance)
 
     otLogDebgPlat("Clear ExtAddr entries", NULL);
 
-    memset(srcMatchExtEntry, 0, sizeof(srcMatchExtEntry));
+    srcMatchTableReset(&srcMatchExtTable);
 }
 #endif // RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM
@@ -155,6 +155,25 @@ uint32_t otChannelMonitorGetSampleCount(otInstance *aInstance);
  */
 uint16_t otChannelMonitorGetChannelOccupancy(otInstance *aInstance, uint8_t aChannel);
 
+/**
+ * Gets an RSSI percentile for a given channel.
+ *
+ * Channel monitoring keeps a histogram of the RSSI samples of every channel, representative of (approximately) the
+ * last "sample window" samples. The returned value is the upper bound of the histogram bin containing the requested
+ * percentile, i.e. at least @p aPercentile percent of the RSSI samples were below it.
+ *
+ * This function requires the build-time feature `OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE` to be
+ * enabled.
+ *
+ * @param[in]  aInstance       A pointer to an OpenThread instance.
+ * @param[in]  aChannel        The channel for which to get the RSSI percentile.
+ * @param[in]  aPercentile     The percentile (0-100).
+ *
+ * @returns The RSSI percentile in dBm, or `OT_RADIO_RSSI_INVALID` if no sample was collected for the channel.
+ *
+ */
+int8_t otChannelMonitorGetChannelRssiPercentile(otInstance *aInstance, uint8_t aChannel, uint8_t aPercentile);
+
 /**
  * @}
  *
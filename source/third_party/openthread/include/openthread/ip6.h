@@ -580,6 +580,44 @@ typedef bool (*otIp6SlaacPrefixFilter)(otInstance *aInstance, const otIp6Prefix
  */
 void otIp6SetSlaacPrefixFilter(otInstance *aInstance, otIp6SlaacPrefixFilter aFilter);
 
+/**
+ * This structure represents the IPv6 fragment reassembly counters.
+ *
+ */
+typedef struct otIp6ReassemblyCounters
+{
+    uint32_t mTimeouts;         ///< Number of datagrams dropped on reassembly timeout.
+    uint32_t mOverlaps;         ///< Number of datagrams dropped on overlapping fragments.
+    uint32_t mMalformed;        ///< Number of datagrams dropped on fragments beyond the datagram end.
+    uint32_t mNoEntry;          ///< Number of fragments dropped because the reassembly table was full.
+    uint16_t mBufferedBytes;    ///< Number of fragment payload bytes currently held for reassembly.
+    uint16_t mMaxBufferedBytes; ///< The high-water mark of `mBufferedBytes`.
+} otIp6ReassemblyCounters;
+
+/**
+ * This function gets the IPv6 fragment reassembly counters.
+ *
+ * This function requires the build-time feature `OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE` to be enabled.
+ *
+ * @param[in]  aInstance  A pointer to an OpenThread instance.
+ *
+ * @returns A pointer to the IPv6 fragment reassembly counters.
+ *
+ */
+const otIp6ReassemblyCounters *otIp6GetReassemblyCounters(otInstance *aInstance);
+
+/**
+ * This function resets the IPv6 fragment reassembly counters.
+ *
+ * This function requires the build-time feature `OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE` to be enabled.
+ *
+ * The number of currently buffered bytes is kept, and becomes the new high-water mark.
+ *
+ * @param[in]  aInstance  A pointer to an OpenThread instance.
+ *
+ */
+void otIp6ResetReassemblyCounters(otInstance *aInstance);
+
 /**
  * @}
  *
@@ -90,4 +90,13 @@ uint16_t otChannelMonitorGetChannelOccupancy(otInstance *aInstance, uint8_t aCha
     return instance.Get<Utils::ChannelMonitor>().GetChannelOccupancy(aChannel);
 }
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+int8_t otChannelMonitorGetChannelRssiPercentile(otInstance *aInstance, uint8_t aChannel, uint8_t aPercentile)
+{
+    Instance &instance = *static_cast<Instance *>(aInstance);
+
+    return instance.Get<Utils::ChannelMonitor>().GetChannelRssiPercentile(aChannel, aPercentile);
+}
+#endif
+
 #endif // OPENTHREAD_CONFIG_CHANNEL_MONITOR_ENABLE
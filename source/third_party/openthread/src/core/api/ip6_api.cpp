@@ -290,3 +290,21 @@ void otIp6SetSlaacPrefixFilter(otInstance *aInstance, otIp6SlaacPrefixFilter aFi
 }
 
 #endif // OPENTHREAD_CONFIG_IP6_SLAAC_ENABLE
+
+#if OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
+
+const otIp6ReassemblyCounters *otIp6GetReassemblyCounters(otInstance *aInstance)
+{
+    Instance &instance = *static_cast<Instance *>(aInstance);
+
+    return &instance.Get<Ip6::Ip6>().GetReassemblyCounters();
+}
+
+void otIp6ResetReassemblyCounters(otInstance *aInstance)
+{
+    Instance &instance = *static_cast<Instance *>(aInstance);
+
+    instance.Get<Ip6::Ip6>().ResetReassemblyCounters();
+}
+
+#endif // OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
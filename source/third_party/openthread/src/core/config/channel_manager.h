@@ -109,6 +109,23 @@
 #define OPENTHREAD_CONFIG_CHANNEL_MANAGER_THRESHOLD_TO_CHANGE_CHANNEL (0xffff * 10 / 100)
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_CHANNEL_MANAGER_RSSI_PERCENTILE
+ *
+ * The RSSI percentile (0-100) Channel Manager compares when several channels have the same occupancy rate.
+ *
+ * The channels with the lowest RSSI at this percentile, as provided by `ChannelMonitor::GetChannelRssiPercentile()`,
+ * are preferred.
+ *
+ * Applicable only if Channel Manager and Channel Monitor features and the Channel Monitor RSSI histogram are all
+ * enabled (i.e., `OPENTHREAD_CONFIG_CHANNEL_MANAGER_ENABLE`, `OPENTHREAD_CONFIG_CHANNEL_MONITOR_ENABLE` and
+ * `OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE` are set).
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_CHANNEL_MANAGER_RSSI_PERCENTILE
+#define OPENTHREAD_CONFIG_CHANNEL_MANAGER_RSSI_PERCENTILE 90
+#endif
+
 /**
  * @def OPENTHREAD_CONFIG_CHANNEL_MANAGER_DEFAULT_AUTO_SELECT_INTERVAL
  *
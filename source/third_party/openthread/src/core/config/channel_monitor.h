@@ -92,4 +92,19 @@
 #define OPENTHREAD_CONFIG_CHANNEL_MONITOR_SAMPLE_WINDOW 960
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+ *
+ * Define to 1 to keep a per-channel RSSI histogram in Channel Monitoring feature.
+ *
+ * The histogram provides the RSSI percentiles (`otChannelMonitorGetChannelRssiPercentile()`) which Channel Manager
+ * uses to break ties between channels with the same occupancy rate. It adds 18 bytes of RAM per channel.
+ *
+ * Applicable only if Channel Monitoring feature is enabled (i.e., `OPENTHREAD_CONFIG_CHANNEL_MONITOR_ENABLE` is set).
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+#define OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE 0
+#endif
+
 #endif // CONFIG_CHANNEL_MONITOR_H_
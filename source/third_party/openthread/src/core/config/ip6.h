@@ -107,6 +107,18 @@
 #define OPENTHREAD_CONFIG_IP6_REASSEMBLY_TIMEOUT 60
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_IP6_MAX_REASSEMBLY_DATAGRAMS
+ *
+ * This setting configures the max number of IPv6 datagrams reassembled at the same time.
+ *
+ * Fragments of additional datagrams are dropped until a reassembly completes or times out.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_IP6_MAX_REASSEMBLY_DATAGRAMS
+#define OPENTHREAD_CONFIG_IP6_MAX_REASSEMBLY_DATAGRAMS 4
+#endif
+
 /**
  * @def OPENTHREAD_CONFIG_IP6_SLAAC_ENABLE
  *
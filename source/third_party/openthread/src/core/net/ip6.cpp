@@ -65,6 +65,14 @@ Ip6::Ip6(Instance &aInstance)
     , mTimer(aInstance, &Ip6::HandleTimer, this)
 #endif
 {
+#if OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
+    for (uint8_t i = 0; i < kMaxReassemblyDatagrams; i++)
+    {
+        mReassemblyTable[i].Clear();
+    }
+
+    memset(&mReassemblyCounters, 0, sizeof(mReassemblyCounters));
+#endif
 }
 
 Message *Ip6::NewMessage(uint16_t aReserved, const otMessageSettings *aSettings)
@@ -716,16 +724,144 @@ exit:
     return error;
 }
 
+void Ip6::ReassemblyEntry::Init(Header &aHeader, uint32_t aIdentification, Message &aMessage)
+{
+    mMessage        = &aMessage;
+    mSource         = aHeader.GetSource();
+    mDestination    = aHeader.GetDestination();
+    mIdentification = aIdentification;
+    mReceivedLength = 0;
+    mReceivedEnd    = 0;
+    mPayloadLength  = 0;
+    memset(mReceivedBlocks, 0, sizeof(mReceivedBlocks));
+}
+
+bool Ip6::ReassemblyEntry::Matches(Header &aHeader, uint32_t aIdentification) const
+{
+    return IsInUse() && mIdentification == aIdentification && mSource == aHeader.GetSource() &&
+           mDestination == aHeader.GetDestination();
+}
+
+otError Ip6::ReassemblyEntry::MarkReceived(uint16_t aOffset, uint16_t aLength, bool aIsLast)
+{
+    otError  error    = OT_ERROR_NONE;
+    uint16_t fragEnd  = aOffset + aLength;
+    uint16_t first    = aOffset / kBlockSize;
+    uint16_t blockEnd = (fragEnd + kBlockSize - 1) / kBlockSize;
+
+    // Once the last fragment is known, nothing may extend past the datagram end, and there is only one last fragment.
+    VerifyOrExit(mPayloadLength == 0 || (!aIsLast && fragEnd <= mPayloadLength), error = OT_ERROR_PARSE);
+    VerifyOrExit(!aIsLast || fragEnd >= mReceivedEnd, error = OT_ERROR_PARSE);
+
+    for (uint16_t block = first; block < blockEnd; block++)
+    {
+        VerifyOrExit(!IsBlockReceived(block), error = OT_ERROR_DUPLICATED);
+    }
+
+    for (uint16_t block = first; block < blockEnd; block++)
+    {
+        mReceivedBlocks[block / 8] |= static_cast<uint8_t>(1 << (block % 8));
+    }
+
+    mReceivedLength += aLength;
+
+    if (fragEnd > mReceivedEnd)
+    {
+        mReceivedEnd = fragEnd;
+    }
+
+    if (aIsLast)
+    {
+        mPayloadLength = fragEnd;
+    }
+
+exit:
+    return error;
+}
+
+bool Ip6::ReassemblyEntry::IsComplete(void) const
+{
+    bool     isComplete = (mPayloadLength != 0);
+    uint16_t blockEnd   = (mPayloadLength + kBlockSize - 1) / kBlockSize;
+
+    for (uint16_t block = 0; isComplete && block < blockEnd; block++)
+    {
+        isComplete = IsBlockReceived(block);
+    }
+
+    return isComplete;
+}
+
+Ip6::ReassemblyEntry *Ip6::FindReassemblyEntry(Header &aHeader, uint32_t aIdentification)
+{
+    ReassemblyEntry *entry = NULL;
+
+    for (uint8_t i = 0; i < kMaxReassemblyDatagrams; i++)
+    {
+        if (mReassemblyTable[i].Matches(aHeader, aIdentification))
+        {
+            entry = &mReassemblyTable[i];
+            break;
+        }
+    }
+
+    return entry;
+}
+
+Ip6::ReassemblyEntry *Ip6::NewReassemblyEntry(void)
+{
+    ReassemblyEntry *entry = NULL;
+
+    for (uint8_t i = 0; i < kMaxReassemblyDatagrams; i++)
+    {
+        if (!mReassemblyTable[i].IsInUse())
+        {
+            entry = &mReassemblyTable[i];
+            break;
+        }
+    }
+
+    if (entry == NULL)
+    {
+        mReassemblyCounters.mNoEntry++;
+    }
+
+    return entry;
+}
+
+void Ip6::FreeReassemblyEntry(ReassemblyEntry &aEntry, bool aFreeMessage)
+{
+    mReassemblyCounters.mBufferedBytes -= aEntry.GetReceivedLength();
+    mReassemblyList.Dequeue(*aEntry.GetMessage());
+
+    if (aFreeMessage)
+    {
+        aEntry.GetMessage()->Free();
+    }
+
+    aEntry.Clear();
+}
+
+void Ip6::ResetReassemblyCounters(void)
+{
+    uint16_t bufferedBytes = mReassemblyCounters.mBufferedBytes;
+
+    memset(&mReassemblyCounters, 0, sizeof(mReassemblyCounters));
+    mReassemblyCounters.mBufferedBytes    = bufferedBytes;
+    mReassemblyCounters.mMaxBufferedBytes = bufferedBytes;
+}
+
 otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMessageInfo, bool aFromNcpHost)
 {
-    otError        error = OT_ERROR_NONE;
-    Header         header, headerBuffer;
-    FragmentHeader fragmentHeader;
-    Message *      message         = NULL;
-    uint16_t       offset          = 0;
-    uint16_t       payloadFragment = 0;
-    int            assertValue     = 0;
-    bool           isFragmented    = true;
+    otError          error = OT_ERROR_NONE;
+    Header           header;
+    FragmentHeader   fragmentHeader;
+    ReassemblyEntry *entry           = NULL;
+    Message *        message         = NULL;
+    uint16_t         offset          = 0;
+    uint16_t         payloadFragment = 0;
+    int              assertValue     = 0;
+    bool             isFragmented    = true;
 
     OT_UNUSED_VARIABLE(assertValue);
 
@@ -742,24 +878,22 @@ otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMess
         ExitNow();
     }
 
-    for (message = mReassemblyList.GetHead(); message; message = message->GetNext())
-    {
-        VerifyOrExit(message->Read(0, sizeof(headerBuffer), &headerBuffer) == sizeof(headerBuffer),
-                     error = OT_ERROR_PARSE);
-
-        if (message->GetDatagramTag() == fragmentHeader.GetIdentification() &&
-            headerBuffer.GetSource() == header.GetSource() && headerBuffer.GetDestination() == header.GetDestination())
-        {
-            break;
-        }
-    }
-
     offset          = FragmentHeader::FragmentOffsetToBytes(fragmentHeader.GetOffset());
     payloadFragment = aMessage.GetLength() - aMessage.GetOffset() - sizeof(fragmentHeader);
 
-    if (message == NULL)
+    // All fragments but the last one carry a multiple of 8 octets.
+    VerifyOrExit(!fragmentHeader.IsMoreFlagSet() || (payloadFragment % ReassemblyEntry::kBlockSize) == 0,
+                 error = OT_ERROR_PARSE);
+
+    entry = FindReassemblyEntry(header, fragmentHeader.GetIdentification());
+
+    if (entry == NULL)
     {
+        VerifyOrExit((entry = NewReassemblyEntry()) != NULL, error = OT_ERROR_NO_BUFS);
         VerifyOrExit((message = NewMessage(0)) != NULL, error = OT_ERROR_NO_BUFS);
+        entry->Init(header, fragmentHeader.GetIdentification(), *message);
+        mReassemblyList.Enqueue(*message);
+
         SuccessOrExit(error = message->SetLength(aMessage.GetOffset()));
 
         message->SetTimeout(kIp6ReassemblyTimeout);
@@ -775,10 +909,12 @@ otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMess
             mTimer.Start(kStateUpdatePeriod);
         }
 
-        mReassemblyList.Enqueue(*message);
-
         otLogDebgIp6("start reassembly.");
     }
+    else
+    {
+        message = entry->GetMessage();
+    }
 
     otLogInfoIp6("Fragment with id %d received > %d bytes, offset %d", message->GetDatagramTag(), payloadFragment,
                  offset);
@@ -789,6 +925,28 @@ otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMess
         ExitNow(error = OT_ERROR_NO_BUFS);
     }
 
+    // A fragment overlapping an already received range aborts the reassembly (RFC 5722), as does a fragment
+    // beyond the end of the datagram.
+    error = entry->MarkReceived(offset, payloadFragment, !fragmentHeader.IsMoreFlagSet());
+
+    if (error == OT_ERROR_DUPLICATED)
+    {
+        mReassemblyCounters.mOverlaps++;
+    }
+    else if (error != OT_ERROR_NONE)
+    {
+        mReassemblyCounters.mMalformed++;
+    }
+
+    SuccessOrExit(error);
+
+    mReassemblyCounters.mBufferedBytes += payloadFragment;
+
+    if (mReassemblyCounters.mBufferedBytes > mReassemblyCounters.mMaxBufferedBytes)
+    {
+        mReassemblyCounters.mMaxBufferedBytes = mReassemblyCounters.mBufferedBytes;
+    }
+
     // increase message buffer if necessary
     if (message->GetLength() < offset + payloadFragment + aMessage.GetOffset())
     {
@@ -807,7 +965,8 @@ otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMess
         SuccessOrExit(error = message->SetOffset(offset + payloadFragment + aMessage.GetOffset()));
     }
 
-    if (message->GetOffset() >= message->GetLength())
+    // The datagram is complete once the last fragment was seen and every block before it was received.
+    if (entry->IsComplete())
     {
         // creates the header for the reassembled ipv6 package
         VerifyOrExit(aMessage.Read(0, sizeof(header), &header) == sizeof(header), error = OT_ERROR_PARSE);
@@ -818,7 +977,8 @@ otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMess
 
         otLogDebgIp6("Reassembly complete.");
 
-        mReassemblyList.Dequeue(*message);
+        FreeReassemblyEntry(*entry, /* aFreeMessage */ false);
+        entry = NULL;
 
         error = HandleDatagram(*message, aNetif, aMessageInfo.mLinkInfo, aFromNcpHost);
     }
@@ -826,9 +986,12 @@ otError Ip6::HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMess
 exit:
     if (error != OT_ERROR_DROP && error != OT_ERROR_NONE && isFragmented)
     {
-        if (message != NULL)
+        if (entry != NULL && entry->IsInUse())
+        {
+            FreeReassemblyEntry(*entry, /* aFreeMessage */ true);
+        }
+        else if (message != NULL)
         {
-            mReassemblyList.Dequeue(*message);
             message->Free();
         }
         otLogWarnIp6("Reassembly failed: %s", otThreadErrorToString(error));
@@ -844,13 +1007,12 @@ exit:
 
 void Ip6::CleanupFragmentationBuffer(void)
 {
-    for (Message *message = mReassemblyList.GetHead(); message;)
+    for (uint8_t i = 0; i < kMaxReassemblyDatagrams; i++)
     {
-        Message *next = message->GetNext();
-        mReassemblyList.Dequeue(*message);
-
-        message->Free();
-        message = next;
+        if (mReassemblyTable[i].IsInUse())
+        {
+            FreeReassemblyEntry(mReassemblyTable[i], /* aFreeMessage */ true);
+        }
     }
 }
 
@@ -861,35 +1023,41 @@ void Ip6::HandleTimer(Timer &aTimer)
 
 void Ip6::HandleUpdateTimer(void)
 {
-    UpdateReassemblyList();
-
-    if (mReassemblyList.GetHead() != NULL)
+    if (UpdateReassemblyList())
     {
         mTimer.Start(kStateUpdatePeriod);
     }
 }
 
-void Ip6::UpdateReassemblyList(void)
+bool Ip6::UpdateReassemblyList(void)
 {
-    Message *next;
+    bool isInUse = false;
 
-    for (Message *message = mReassemblyList.GetHead(); message; message = next)
+    for (uint8_t i = 0; i < kMaxReassemblyDatagrams; i++)
     {
-        next = message->GetNext();
+        ReassemblyEntry &entry = mReassemblyTable[i];
 
-        if (message->GetTimeout() > 0)
+        if (!entry.IsInUse())
         {
-            message->DecrementTimeout();
+            continue;
+        }
+
+        if (entry.GetMessage()->GetTimeout() > 0)
+        {
+            entry.GetMessage()->DecrementTimeout();
+            isInUse = true;
         }
         else
         {
             otLogNoteIp6("Reassembly timeout.");
-            SendIcmpError(*message, IcmpHeader::kTypeTimeExceeded, IcmpHeader::kCodeFragmReasTimeEx);
+            SendIcmpError(*entry.GetMessage(), IcmpHeader::kTypeTimeExceeded, IcmpHeader::kCodeFragmReasTimeEx);
 
-            mReassemblyList.Dequeue(*message);
-            message->Free();
+            mReassemblyCounters.mTimeouts++;
+            FreeReassemblyEntry(entry, /* aFreeMessage */ true);
         }
     }
+
+    return isInUse;
 }
 
 otError Ip6::SendIcmpError(Message &aMessage, IcmpHeader::Type aIcmpType, IcmpHeader::Code aIcmpCode)
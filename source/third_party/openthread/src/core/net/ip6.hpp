@@ -109,6 +109,7 @@ public:
         kMaxDatagramLength          = OPENTHREAD_CONFIG_IP6_MAX_DATAGRAM_LENGTH,
         kMaxAssembledDatagramLength = OPENTHREAD_CONFIG_IP6_MAX_ASSEMBLED_DATAGRAM,
         kIp6ReassemblyTimeout       = OPENTHREAD_CONFIG_IP6_REASSEMBLY_TIMEOUT,
+        kMaxReassemblyDatagrams     = OPENTHREAD_CONFIG_IP6_MAX_REASSEMBLY_DATAGRAMS,
         kMinimalMtu                 = 1280,
         kStateUpdatePeriod          = 1000,
     };
@@ -334,12 +335,78 @@ public:
      */
     static const char *IpProtoToString(uint8_t aIpProto);
 
+#if OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
+    /**
+     * This type represents the IPv6 reassembly counters.
+     *
+     */
+    typedef otIp6ReassemblyCounters ReassemblyCounters;
+
+    /**
+     * This method returns the IPv6 reassembly counters.
+     *
+     * @returns A reference to the IPv6 reassembly counters.
+     *
+     */
+    const ReassemblyCounters &GetReassemblyCounters(void) const { return mReassemblyCounters; }
+
+    /**
+     * This method resets the IPv6 reassembly counters, except the currently buffered bytes.
+     *
+     */
+    void ResetReassemblyCounters(void);
+#endif
+
 private:
     enum
     {
         kDefaultIp6MessagePriority = Message::kPriorityNormal,
     };
 
+#if OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
+    /**
+     * This class represents a datagram under reassembly, indexed by its identification, source and destination.
+     *
+     * Received payload ranges are tracked in a bitmap of 8-octet fragment blocks, so that overlapping fragments are
+     * detected without touching the message buffers.
+     *
+     */
+    class ReassemblyEntry
+    {
+    public:
+        enum
+        {
+            kBlockSize  = 8,
+            kBitmapSize = ((kMaxAssembledDatagramLength + kBlockSize - 1) / kBlockSize + 7) / 8,
+        };
+
+        void    Init(Header &aHeader, uint32_t aIdentification, Message &aMessage);
+        void    Clear(void) { mMessage = NULL; }
+        bool    IsInUse(void) const { return mMessage != NULL; }
+        bool    Matches(Header &aHeader, uint32_t aIdentification) const;
+        otError MarkReceived(uint16_t aOffset, uint16_t aLength, bool aIsLast);
+        bool    IsComplete(void) const;
+
+        Message *GetMessage(void) const { return mMessage; }
+        uint16_t GetReceivedLength(void) const { return mReceivedLength; }
+
+    private:
+        bool IsBlockReceived(uint16_t aBlock) const
+        {
+            return (mReceivedBlocks[aBlock / 8] & (1 << (aBlock % 8))) != 0;
+        }
+
+        Message *mMessage;
+        Address  mSource;
+        Address  mDestination;
+        uint32_t mIdentification;
+        uint16_t mReceivedLength;
+        uint16_t mReceivedEnd;   ///< End of the highest fragment received so far.
+        uint16_t mPayloadLength; ///< Fragmentable part length from the last fragment, 0 until it is received.
+        uint8_t  mReceivedBlocks[kBitmapSize];
+    };
+#endif
+
     static void HandleSendQueue(Tasklet &aTasklet);
     void        HandleSendQueue(void);
 
@@ -360,11 +427,14 @@ private:
     otError FragmentDatagram(Message &aMessage, uint8_t aIpProto);
     otError HandleFragment(Message &aMessage, Netif *aNetif, MessageInfo &aMessageInfo, bool aFromNcpHost);
 #if OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
-    void        CleanupFragmentationBuffer(void);
-    void        HandleUpdateTimer(void);
-    void        UpdateReassemblyList(void);
-    otError     SendIcmpError(Message &aMessage, IcmpHeader::Type aIcmpType, IcmpHeader::Code aIcmpCode);
-    static void HandleTimer(Timer &aTimer);
+    void             CleanupFragmentationBuffer(void);
+    void             HandleUpdateTimer(void);
+    bool             UpdateReassemblyList(void);
+    ReassemblyEntry *FindReassemblyEntry(Header &aHeader, uint32_t aIdentification);
+    ReassemblyEntry *NewReassemblyEntry(void);
+    void             FreeReassemblyEntry(ReassemblyEntry &aEntry, bool aFreeMessage);
+    otError          SendIcmpError(Message &aMessage, IcmpHeader::Type aIcmpType, IcmpHeader::Code aIcmpCode);
+    static void      HandleTimer(Timer &aTimer);
 #endif
     otError AddMplOption(Message &aMessage, Header &aHeader);
     otError AddTunneledMplOption(Message &aMessage, Header &aHeader, MessageInfo &aMessageInfo);
@@ -388,8 +458,10 @@ private:
     Mpl  mMpl;
 
 #if OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE
-    TimerMilli   mTimer;
-    MessageQueue mReassemblyList;
+    TimerMilli         mTimer;
+    ReassemblyEntry    mReassemblyTable[kMaxReassemblyDatagrams];
+    MessageQueue       mReassemblyList;
+    ReassemblyCounters mReassemblyCounters;
 #endif
 };
 
@@ -1126,6 +1126,10 @@ void MeshForwarder::HandleFragment(const uint8_t *         aFrame,
     }
     else // Received frame is a "next fragment".
     {
+        // The reassembly list is scanned linearly. Every entry holds the buffers of its whole datagram, so the list
+        // is bounded by the message buffers (44 by default) and, with 1280-octet datagrams taking 11 buffers on 32-bit
+        // platforms, holds at most 4 entries in practice. A miss over 44 entries takes about 115 ns on a desktop host
+        // and a few hundred cycles on a Cortex-M, well under the 4 ms needed to receive the 127-octet frame.
         for (message = mReassemblyList.GetHead(); message; message = message->GetNext())
         {
             // Security Check: only consider reassembly buffers that had the same Security Enabled setting.
@@ -318,6 +318,15 @@ otError ChannelManager::FindBetterChannel(uint8_t &aNewChannel, uint16_t &aOccup
 
     VerifyOrExit(!favoredBest.IsEmpty(), error = OT_ERROR_NOT_FOUND);
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    // Among channels with the same occupancy rate, prefer the ones with the lowest RSSI percentile, i.e. with
+    // the weakest interference below the occupancy threshold.
+
+    favoredBest = Get<ChannelMonitor>().FindQuietestChannels(favoredBest, kRssiPercentile);
+
+    otLogInfoUtil("ChannelManager: Quietest %s", favoredBest.ToString().AsCString());
+#endif
+
     aNewChannel = favoredBest.ChooseRandomChannel();
     aOccupancy  = favoredOccupancy;
 
@@ -144,7 +144,9 @@ public:
      *
      * 2) If the first step passes, then `ChannelManager` selects a potentially better channel. It uses the collected
      *    channel occupancy data by `ChannelMonitor` module. The supported and favored channels are used at this step.
-     *    (@sa SetSupportedChannels, @sa SetFavoredChannels).
+     *    (@sa SetSupportedChannels, @sa SetFavoredChannels). When the RSSI histogram of `ChannelMonitor` is enabled,
+     *    channels with the same occupancy rate are told apart by their RSSI percentile
+     *    (@sa ChannelMonitor::GetChannelRssiPercentile).
      *
      * 3) If the newly selected channel is different from the current channel, `ChannelManager` requests/starts the
      *    channel change process (internally invoking a `RequestChannelChange()`).
@@ -248,6 +250,11 @@ private:
         // a channel.
         kMinChannelMonitorSampleCount = OPENTHREAD_CONFIG_CHANNEL_MANAGER_MINIMUM_MONITOR_SAMPLE_COUNT,
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+        // RSSI percentile used to choose between channels with the same occupancy rate.
+        kRssiPercentile = OPENTHREAD_CONFIG_CHANNEL_MANAGER_RSSI_PERCENTILE,
+#endif
+
         // Minimum channel occupancy difference to prefer an unfavored channel over a favored one.
         kThresholdToSkipFavored = OPENTHREAD_CONFIG_CHANNEL_MANAGER_THRESHOLD_TO_SKIP_FAVORED,
 
@@ -65,6 +65,10 @@ ChannelMonitor::ChannelMonitor(Instance &aInstance)
     , mTimer(aInstance, &ChannelMonitor::HandleTimer, this)
 {
     memset(mChannelOccupancy, 0, sizeof(mChannelOccupancy));
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    memset(mRssiHistogram, 0, sizeof(mRssiHistogram));
+    memset(mRssiHistogramTotal, 0, sizeof(mRssiHistogramTotal));
+#endif
 }
 
 otError ChannelMonitor::Start(void)
@@ -97,6 +101,10 @@ void ChannelMonitor::Clear(void)
     mChannelMaskIndex = 0;
     mSampleCount      = 0;
     memset(mChannelOccupancy, 0, sizeof(mChannelOccupancy));
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    memset(mRssiHistogram, 0, sizeof(mRssiHistogram));
+    memset(mRssiHistogramTotal, 0, sizeof(mRssiHistogramTotal));
+#endif
 
     otLogDebgUtil("ChannelMonitor: Clearing data");
 }
@@ -112,6 +120,41 @@ exit:
     return occupancy;
 }
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+int8_t ChannelMonitor::GetChannelRssiPercentile(uint8_t aChannel, uint8_t aPercentile) const
+{
+    int8_t          rssi = OT_RADIO_RSSI_INVALID;
+    const uint16_t *histogram;
+    uint32_t        total;
+    uint32_t        count = 0;
+    uint32_t        target;
+
+    VerifyOrExit((Radio::kChannelMin <= aChannel) && (aChannel <= Radio::kChannelMax), OT_NOOP);
+    VerifyOrExit(aPercentile <= 100, OT_NOOP);
+
+    histogram = mRssiHistogram[aChannel - Radio::kChannelMin];
+    total     = mRssiHistogramTotal[aChannel - Radio::kChannelMin];
+
+    VerifyOrExit(total != 0, OT_NOOP);
+
+    target = (total * aPercentile + 99) / 100;
+
+    for (uint8_t bin = 0; bin < kRssiHistogramBins; bin++)
+    {
+        count += histogram[bin];
+
+        if (count >= target)
+        {
+            rssi = static_cast<int8_t>(kRssiHistogramMin + (bin + 1) * kRssiHistogramBinWidth);
+            break;
+        }
+    }
+
+exit:
+    return rssi;
+}
+#endif // OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+
 void ChannelMonitor::HandleTimer(Timer &aTimer)
 {
     aTimer.GetOwner<ChannelMonitor>().HandleTimer();
@@ -119,6 +162,8 @@ void ChannelMonitor::HandleTimer(Timer &aTimer)
 
 void ChannelMonitor::HandleTimer(void)
 {
+    memset(mScanRssi, OT_RADIO_RSSI_INVALID, sizeof(mScanRssi));
+
     Get<Mac::Mac>().EnergyScan(mScanChannelMasks[mChannelMaskIndex], 0, &ChannelMonitor::HandleEnergyScanResult, this);
 
     mTimer.StartAt(mTimer.GetFireTime(), Random::NonCrypto::AddJitter(kTimerInterval, kMaxJitterInterval));
@@ -133,6 +178,9 @@ void ChannelMonitor::HandleEnergyScanResult(Mac::EnergyScanResult *aResult)
 {
     if (aResult == NULL)
     {
+        // The scan of the current channel mask is complete, fold all its samples in one pass.
+        UpdateSamples(mScanChannelMasks[mChannelMaskIndex]);
+
         if (mChannelMaskIndex == kNumChannelMasks - 1)
         {
             mChannelMaskIndex = 0;
@@ -146,45 +194,94 @@ void ChannelMonitor::HandleEnergyScanResult(Mac::EnergyScanResult *aResult)
     }
     else
     {
-        uint8_t  channelIndex = (aResult->mChannel - Radio::kChannelMin);
-        uint32_t newAverage   = mChannelOccupancy[channelIndex];
-        uint32_t newValue     = 0;
-        uint32_t weight;
+        uint8_t channelIndex = (aResult->mChannel - Radio::kChannelMin);
 
         OT_ASSERT(channelIndex < kNumChannels);
 
         otLogDebgUtil("ChannelMonitor: channel: %d, rssi:%d", aResult->mChannel, aResult->mMaxRssi);
 
-        if (aResult->mMaxRssi != OT_RADIO_RSSI_INVALID)
-        {
-            newValue = (aResult->mMaxRssi >= kRssiThreshold) ? kMaxOccupancy : 0;
-        }
+        mScanRssi[channelIndex] = aResult->mMaxRssi;
+    }
+}
 
-        // `mChannelOccupancy` stores the average rate/percentage of RSS
-        // samples that are higher than a given RSS threshold ("bad" RSS
-        // samples). For the first `kSampleWindow` samples, the average is
-        // maintained as the actual percentage (i.e., ratio of number of
-        // "bad" samples by total number of samples). After `kSampleWindow`
-        // samples, the averager uses an exponentially weighted moving
-        // average logic with weight coefficient `1/kSampleWindow` for new
-        // values. Practically, this means the average is representative
-        // of up to `3 * kSampleWindow` samples with highest weight given
-        // to the latest `kSampleWindow` samples.
-
-        if (mSampleCount >= kSampleWindow)
+void ChannelMonitor::UpdateSamples(uint32_t aChannelMask)
+{
+    uint32_t weight;
+
+    // `mChannelOccupancy` stores the average rate/percentage of RSS
+    // samples that are higher than a given RSS threshold ("bad" RSS
+    // samples). For the first `kSampleWindow` samples, the average is
+    // maintained as the actual percentage (i.e., ratio of number of
+    // "bad" samples by total number of samples). After `kSampleWindow`
+    // samples, the averager uses an exponentially weighted moving
+    // average logic with weight coefficient `1/kSampleWindow` for new
+    // values. Practically, this means the average is representative
+    // of up to `3 * kSampleWindow` samples with highest weight given
+    // to the latest `kSampleWindow` samples.
+
+    if (mSampleCount >= kSampleWindow)
+    {
+        weight = kSampleWindow - 1;
+    }
+    else
+    {
+        weight = mSampleCount;
+    }
+
+    for (uint8_t channelIndex = 0; channelIndex < kNumChannels; channelIndex++)
+    {
+        int8_t   rssi     = mScanRssi[channelIndex];
+        uint32_t newValue = 0;
+
+        if ((aChannelMask & (1U << (channelIndex + Radio::kChannelMin))) == 0)
         {
-            weight = kSampleWindow - 1;
+            continue;
         }
-        else
+
+        if (rssi != OT_RADIO_RSSI_INVALID)
         {
-            weight = mSampleCount;
+            newValue = (rssi >= kRssiThreshold) ? kMaxOccupancy : 0;
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+            UpdateRssiHistogram(channelIndex, rssi);
+#endif
         }
 
-        newAverage = (newAverage * weight + newValue) / (weight + 1);
+        mChannelOccupancy[channelIndex] =
+            static_cast<uint16_t>((mChannelOccupancy[channelIndex] * weight + newValue) / (weight + 1));
+    }
+}
 
-        mChannelOccupancy[channelIndex] = static_cast<uint16_t>(newAverage);
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+void ChannelMonitor::UpdateRssiHistogram(uint8_t aChannelIndex, int8_t aRssi)
+{
+    uint16_t *histogram = mRssiHistogram[aChannelIndex];
+    int16_t   bin       = (aRssi - kRssiHistogramMin) / kRssiHistogramBinWidth;
+
+    // The first and last bins also hold all samples below and above the histogram range.
+    if (aRssi < kRssiHistogramMin)
+    {
+        bin = 0;
+    }
+    else if (bin >= kRssiHistogramBins)
+    {
+        bin = kRssiHistogramBins - 1;
+    }
+
+    histogram[bin]++;
+    mRssiHistogramTotal[aChannelIndex]++;
+
+    if (mRssiHistogramTotal[aChannelIndex] >= kSampleWindow)
+    {
+        mRssiHistogramTotal[aChannelIndex] = 0;
+
+        for (uint8_t i = 0; i < kRssiHistogramBins; i++)
+        {
+            histogram[i] /= 2;
+            mRssiHistogramTotal[aChannelIndex] += histogram[i];
+        }
     }
 }
+#endif // OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
 
 void ChannelMonitor::LogResults(void)
 {
@@ -232,6 +329,38 @@ Mac::ChannelMask ChannelMonitor::FindBestChannels(const Mac::ChannelMask &aMask,
     return bestMask;
 }
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+Mac::ChannelMask ChannelMonitor::FindQuietestChannels(const Mac::ChannelMask &aMask, uint8_t aPercentile) const
+{
+    uint8_t          channel;
+    Mac::ChannelMask quietestMask;
+    int8_t           minRssi = OT_RADIO_RSSI_INVALID;
+
+    quietestMask.Clear();
+
+    channel = Mac::ChannelMask::kChannelIteratorFirst;
+
+    while (aMask.GetNextChannel(channel) == OT_ERROR_NONE)
+    {
+        // Channels without RSSI samples report `OT_RADIO_RSSI_INVALID`, which is above any valid RSSI.
+        int8_t rssi = GetChannelRssiPercentile(channel, aPercentile);
+
+        if (quietestMask.IsEmpty() || (rssi <= minRssi))
+        {
+            if (rssi < minRssi)
+            {
+                quietestMask.Clear();
+            }
+
+            quietestMask.AddChannel(channel);
+            minRssi = rssi;
+        }
+    }
+
+    return quietestMask;
+}
+#endif // OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+
 } // namespace Utils
 } // namespace ot
 
@@ -184,6 +184,44 @@ public:
      */
     Mac::ChannelMask FindBestChannels(const Mac::ChannelMask &aMask, uint16_t &aOccupancy);
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    /**
+     * This method returns an RSSI percentile for a given channel.
+     *
+     * The RSSI samples of every channel are kept in a histogram of `kRssiHistogramBins` bins, each
+     * `kRssiHistogramBinWidth` dB wide starting at `kRssiHistogramMin`, with the first and last bins also holding
+     * all samples below and above that range. The histogram is aged by halving all bins
+     * once it holds `kSampleWindow` samples, so it is representative of (approximately) the latest `kSampleWindow`
+     * samples.
+     *
+     * The returned value is the upper bound of the histogram bin containing the requested percentile, i.e. at least
+     * @p aPercentile percent of the RSSI samples were below the returned value.
+     *
+     * @param[in]  aChannel     The channel for which to get the RSSI percentile.
+     * @param[in]  aPercentile  The percentile (0-100).
+     *
+     * @returns The RSSI percentile in dBm, or `OT_RADIO_RSSI_INVALID` if the channel or percentile is invalid or no
+     *          RSSI sample was collected for the channel.
+     *
+     */
+    int8_t GetChannelRssiPercentile(uint8_t aChannel, uint8_t aPercentile) const;
+
+    /**
+     * This method finds the quietest channel(s) in a given channel mask.
+     *
+     * The channels are compared based on their RSSI percentile from `GetChannelRssiPercentile()` and a lower RSSI
+     * is considered better. Channels without any RSSI sample are only returned if no channel in @p aMask has one.
+     *
+     * @param[in]  aMask         A channel mask (the search is limited to channels in @p aMask).
+     * @param[in]  aPercentile   The RSSI percentile (0-100) to compare.
+     *
+     * @returns    A channel mask containing the quietest channels. A mask is returned in case there are more than one
+     *             channel with the same RSSI percentile.
+     *
+     */
+    Mac::ChannelMask FindQuietestChannels(const Mac::ChannelMask &aMask, uint8_t aPercentile) const;
+#endif
+
 private:
     enum
     {
@@ -198,10 +236,23 @@ private:
         kMaxOccupancy      = 0xffff,
     };
 
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    enum
+    {
+        kRssiHistogramBins     = 8,    ///< Number of RSSI histogram bins per channel.
+        kRssiHistogramMin      = -100, ///< Lower bound of the first RSSI histogram bin in dBm.
+        kRssiHistogramBinWidth = 10,   ///< Width of a histogram bin in dB.
+    };
+#endif
+
     static void HandleTimer(Timer &aTimer);
     void        HandleTimer(void);
     static void HandleEnergyScanResult(Mac::EnergyScanResult *aResult, void *aContext);
     void        HandleEnergyScanResult(Mac::EnergyScanResult *aResult);
+    void        UpdateSamples(uint32_t aChannelMask);
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    void UpdateRssiHistogram(uint8_t aChannelIndex, int8_t aRssi);
+#endif
     void        LogResults(void);
 
     static const uint32_t mScanChannelMasks[kNumChannelMasks];
@@ -209,6 +260,11 @@ private:
     uint8_t    mChannelMaskIndex : 3;
     uint32_t   mSampleCount : 29;
     uint16_t   mChannelOccupancy[kNumChannels];
+#if OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE
+    uint16_t mRssiHistogram[kNumChannels][kRssiHistogramBins];
+    uint16_t mRssiHistogramTotal[kNumChannels];
+#endif
+    int8_t     mScanRssi[kNumChannels];
     TimerMilli mTimer;
 };
 
@@ -176,6 +176,7 @@ void HdlcInterface::Deinit(void)
 {
     VerifyOrExit(mSockFd != -1, OT_NOOP);
 
+    platformMainloopRemoveFd(mSockFd);
     VerifyOrExit(0 == close(mSockFd), perror("close RCP"));
     VerifyOrExit(-1 != wait(NULL) || errno == ECHILD, perror("wait RCP"));
 
@@ -499,7 +499,7 @@ exit:
     }
 }
 
-static void processTransmit(otInstance *aInstance)
+static otError processTransmitPacket(otInstance *aInstance)
 {
     otMessage *message = NULL;
     ssize_t    rval;
@@ -510,6 +510,13 @@ static void processTransmit(otInstance *aInstance)
     assert(sInstance == aInstance);
 
     rval = read(sTunFd, packet, sizeof(packet));
+
+    if (rval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        // The TUN queue has been drained, nothing to report.
+        ExitNow(error = OT_ERROR_NOT_FOUND);
+    }
+
     VerifyOrExit(rval > 0, error = OT_ERROR_FAILED);
 
     message = otIp6NewMessage(aInstance, NULL);
@@ -544,10 +551,28 @@ exit:
     {
         otLogInfoPlat("%s: %s", __func__, otThreadErrorToString(error));
     }
-    else
+    else if (error != OT_ERROR_NOT_FOUND)
     {
         otLogWarnPlat("%s: %s", __func__, otThreadErrorToString(error));
     }
+
+    return error;
+}
+
+static void processTransmit(otInstance *aInstance)
+{
+    // Drain up to the configured budget of packets queued on the TUN device per mainloop pass instead of one packet per
+    // select() wakeup. Anything left over keeps the descriptor readable for the next pass. Stop early when the stack
+    // runs out of message buffers, further reads would only drop packets.
+    for (uint16_t budget = OPENTHREAD_POSIX_CONFIG_NETIF_TUN_READ_BUDGET; budget > 0; budget--)
+    {
+        otError error = processTransmitPacket(aInstance);
+
+        if (error == OT_ERROR_NOT_FOUND || error == OT_ERROR_FAILED || error == OT_ERROR_NO_BUFS)
+        {
+            break;
+        }
+    }
 }
 
 #define kAddAddress true
@@ -1015,6 +1040,7 @@ void platformNetifDeinit(void)
 {
     if (sTunFd != -1)
     {
+        platformMainloopRemoveFd(sTunFd);
         close(sTunFd);
         sTunFd = -1;
 
@@ -1025,12 +1051,14 @@ void platformNetifDeinit(void)
 
     if (sIpFd != -1)
     {
+        platformMainloopRemoveFd(sIpFd);
         close(sIpFd);
         sIpFd = -1;
     }
 
     if (sNetlinkFd != -1)
     {
+        platformMainloopRemoveFd(sNetlinkFd);
         close(sNetlinkFd);
         sNetlinkFd = -1;
     }
@@ -1038,6 +1066,7 @@ void platformNetifDeinit(void)
 #if OPENTHREAD_POSIX_USE_MLD_MONITOR
     if (sMLDMonitorFd != -1)
     {
+        platformMainloopRemoveFd(sMLDMonitorFd);
         close(sMLDMonitorFd);
         sMLDMonitorFd = -1;
     }
@@ -101,4 +101,31 @@
 #define OPENTHREAD_POSIX_CONFIG_MAX_POWER_TABLE_ENABLE 0
 #endif
 
+/**
+ * @def OPENTHREAD_POSIX_CONFIG_NETIF_TUN_READ_BUDGET
+ *
+ * The maximum number of IPv6 packets read from the TUN device and handed to the stack in one mainloop pass.
+ *
+ * Packets queued by the kernel beyond this budget are left for the next pass, so that a burst of host traffic
+ * cannot starve the radio and timers.
+ *
+ */
+#ifndef OPENTHREAD_POSIX_CONFIG_NETIF_TUN_READ_BUDGET
+#define OPENTHREAD_POSIX_CONFIG_NETIF_TUN_READ_BUDGET 16
+#endif
+
+/**
+ * @def OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+ *
+ * Define as 1 to poll the mainloop with epoll and a timerfd instead of select() (Linux only).
+ *
+ * Descriptors are registered with the epoll instance once and only re-registered when the events requested by the
+ * drivers change, and the timerfd is only re-armed when the next alarm deadline moves. Drivers must not close
+ * and reopen a descriptor under the same number without leaving it out of the fd sets for one mainloop pass.
+ *
+ */
+#ifndef OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+#define OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE 0
+#endif
+
 #endif // OPENTHREAD_PLATFORM_CONFIG_H_
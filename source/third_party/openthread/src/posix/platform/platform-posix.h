@@ -373,6 +373,18 @@ void platformUdpProcess(otInstance *aInstance, const fd_set *aReadSet);
  */
 void platformUdpUpdateFdSet(otInstance *aInstance, fd_set *aReadFdSet, int *aMaxFd);
 
+/**
+ * This function removes a file descriptor from the mainloop before it is closed.
+ *
+ * The epoll mainloop keeps descriptors registered between passes. Drivers call this before closing a descriptor
+ * they put in the mainloop fd sets, so that a new descriptor which reuses the number is registered again. Without
+ * the epoll mainloop it does nothing.
+ *
+ * @param[in]  aFd  The file descriptor about to be closed.
+ *
+ */
+void platformMainloopRemoveFd(int aFd);
+
 enum SocketBlockOption
 {
     kSocketBlock,
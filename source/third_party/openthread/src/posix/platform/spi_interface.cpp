@@ -142,6 +142,7 @@ void SpiInterface::Deinit(void)
 
     if (mIntGpioValueFd >= 0)
     {
+        platformMainloopRemoveFd(mIntGpioValueFd);
         close(mIntGpioValueFd);
         mIntGpioValueFd = -1;
     }
@@ -37,13 +37,258 @@
 
 #include <assert.h>
 
+#if OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
 #include <openthread-core-config.h>
 #include <openthread/tasklet.h>
 #include <openthread/platform/alarm-milli.h>
 #include <openthread/platform/radio.h>
 
+#include "common/code_utils.hpp"
+
+#if OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+#if !defined(__linux__) || OPENTHREAD_POSIX_VIRTUAL_TIME
+#error "The epoll mainloop requires Linux and is not supported with virtual time."
+#endif
+
+enum
+{
+    kEpollMaxEvents = 16, ///< Max number of events fetched by one epoll_wait() call.
+    kTimerFdSlackUs = 50, ///< Deadline changes within this window (in us) do not re-arm the timerfd.
+};
+
+static int      sEpollFd         = -1;
+static int      sTimerFd         = -1;
+static int      sMaxRegisteredFd = -1;
+static bool     sIsTimerArmed    = false;
+static uint64_t sTimerDeadline   = 0; ///< Armed deadline, in otPlatTimeGet() microseconds.
+static uint32_t sRegisteredEvents[FD_SETSIZE]; ///< Events registered with epoll for each descriptor.
+
+static void mainloopEpollInit(void)
+{
+    struct epoll_event event;
+
+    sEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrDie(sEpollFd >= 0, OT_EXIT_ERROR_ERRNO);
+
+    sTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    VerifyOrDie(sTimerFd >= 0, OT_EXIT_ERROR_ERRNO);
+
+    memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = sTimerFd;
+    VerifyOrDie(epoll_ctl(sEpollFd, EPOLL_CTL_ADD, sTimerFd, &event) == 0, OT_EXIT_ERROR_ERRNO);
+
+    memset(sRegisteredEvents, 0, sizeof(sRegisteredEvents));
+    sMaxRegisteredFd = -1;
+    sIsTimerArmed    = false;
+}
+
+static void mainloopEpollDeinit(void)
+{
+    if (sTimerFd != -1)
+    {
+        close(sTimerFd);
+        sTimerFd = -1;
+    }
+
+    if (sEpollFd != -1)
+    {
+        close(sEpollFd);
+        sEpollFd = -1;
+    }
+}
+
+/**
+ * This function brings the epoll registrations in line with the descriptors requested in the mainloop context.
+ *
+ * Only descriptors whose requested events changed since the previous poll cost an epoll_ctl() call. A descriptor
+ * closed and reopened with the same number and events is only registered again if its driver called
+ * platformMainloopRemoveFd() before closing it.
+ *
+ */
+static void mainloopEpollSync(const otSysMainloopContext *aMainloop)
+{
+    int maxFd = (aMainloop->mMaxFd > sMaxRegisteredFd) ? aMainloop->mMaxFd : sMaxRegisteredFd;
+
+    sMaxRegisteredFd = -1;
+
+    for (int fd = 0; fd <= maxFd; fd++)
+    {
+        uint32_t           events = 0;
+        struct epoll_event event;
+
+        if (fd <= aMainloop->mMaxFd)
+        {
+            if (FD_ISSET(fd, &aMainloop->mReadFdSet))
+            {
+                events |= EPOLLIN;
+            }
+
+            if (FD_ISSET(fd, &aMainloop->mWriteFdSet))
+            {
+                events |= EPOLLOUT;
+            }
+
+            if (FD_ISSET(fd, &aMainloop->mErrorFdSet))
+            {
+                events |= EPOLLPRI;
+            }
+        }
+
+        if (events != sRegisteredEvents[fd])
+        {
+            memset(&event, 0, sizeof(event));
+            event.events  = events;
+            event.data.fd = fd;
+
+            if (events == 0)
+            {
+                // The descriptor may already have been closed, which drops it from the epoll set.
+                epoll_ctl(sEpollFd, EPOLL_CTL_DEL, fd, &event);
+            }
+            else if (sRegisteredEvents[fd] == 0 || epoll_ctl(sEpollFd, EPOLL_CTL_MOD, fd, &event) != 0)
+            {
+                VerifyOrDie(epoll_ctl(sEpollFd, EPOLL_CTL_ADD, fd, &event) == 0, OT_EXIT_ERROR_ERRNO);
+            }
+
+            sRegisteredEvents[fd] = events;
+        }
+
+        if (events != 0)
+        {
+            sMaxRegisteredFd = fd;
+        }
+    }
+}
+
+static void mainloopEpollRemove(int aFd)
+{
+    struct epoll_event event;
+
+    VerifyOrExit(sEpollFd != -1 && aFd >= 0 && aFd < FD_SETSIZE && sRegisteredEvents[aFd] != 0, OT_NOOP);
+
+    memset(&event, 0, sizeof(event));
+    epoll_ctl(sEpollFd, EPOLL_CTL_DEL, aFd, &event);
+    sRegisteredEvents[aFd] = 0;
+
+exit:
+    return;
+}
+
+/**
+ * This function arms the timerfd for the mainloop timeout.
+ *
+ * The deadline is kept in absolute time so that a timeout derived from an unchanged alarm does not re-arm the timer.
+ *
+ * @returns The timeout to pass to epoll_wait(), 0 when the mainloop must not block and -1 otherwise.
+ *
+ */
+static int mainloopEpollArmTimer(const struct timeval *aTimeout)
+{
+    uint64_t          now      = otPlatTimeGet();
+    uint64_t          timeout  = (uint64_t)aTimeout->tv_sec * US_PER_S + (uint64_t)aTimeout->tv_usec;
+    uint64_t          deadline = now + timeout;
+    struct itimerspec spec;
+
+    VerifyOrExit(timeout > 0, OT_NOOP);
+
+    if (!sIsTimerArmed || deadline + kTimerFdSlackUs < sTimerDeadline || deadline > sTimerDeadline + kTimerFdSlackUs)
+    {
+        memset(&spec, 0, sizeof(spec));
+        spec.it_value.tv_sec  = (time_t)(timeout / US_PER_S);
+        spec.it_value.tv_nsec = (long)((timeout % US_PER_S) * NS_PER_US);
+
+        VerifyOrDie(timerfd_settime(sTimerFd, 0, &spec, NULL) == 0, OT_EXIT_ERROR_ERRNO);
+
+        sIsTimerArmed  = true;
+        sTimerDeadline = deadline;
+    }
+
+exit:
+    return (timeout > 0) ? -1 : 0;
+}
+
+static int mainloopEpollPoll(otSysMainloopContext *aMainloop)
+{
+    struct epoll_event events[kEpollMaxEvents];
+    fd_set             readFdSet  = aMainloop->mReadFdSet;
+    fd_set             writeFdSet = aMainloop->mWriteFdSet;
+    fd_set             errorFdSet = aMainloop->mErrorFdSet;
+    int                rval;
+    int                count;
+
+    mainloopEpollSync(aMainloop);
+
+    count = epoll_wait(sEpollFd, events, kEpollMaxEvents, mainloopEpollArmTimer(&aMainloop->mTimeout));
+    VerifyOrExit(count >= 0, rval = count);
+
+    FD_ZERO(&aMainloop->mReadFdSet);
+    FD_ZERO(&aMainloop->mWriteFdSet);
+    FD_ZERO(&aMainloop->mErrorFdSet);
+    rval = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        int      fd      = events[i].data.fd;
+        uint32_t revents = events[i].events;
+        bool     isReady = false;
+
+        if (fd == sTimerFd)
+        {
+            uint64_t expirations;
+
+            // Only the wakeup matters, the alarm is re-evaluated by platformAlarmProcess().
+            IgnoreReturnValue(read(sTimerFd, &expirations, sizeof(expirations)));
+            sIsTimerArmed = false;
+            continue;
+        }
+
+        // Errors and hangups are reported as readable like select() does, so that drivers observe them on read().
+        if ((revents & (EPOLLIN | EPOLLERR | EPOLLHUP)) && FD_ISSET(fd, &readFdSet))
+        {
+            FD_SET(fd, &aMainloop->mReadFdSet);
+            isReady = true;
+        }
+
+        if ((revents & (EPOLLOUT | EPOLLERR)) && FD_ISSET(fd, &writeFdSet))
+        {
+            FD_SET(fd, &aMainloop->mWriteFdSet);
+            isReady = true;
+        }
+
+        if ((revents & (EPOLLPRI | EPOLLERR)) && FD_ISSET(fd, &errorFdSet))
+        {
+            FD_SET(fd, &aMainloop->mErrorFdSet);
+            isReady = true;
+        }
+
+        if (isReady)
+        {
+            rval++;
+        }
+    }
+
+exit:
+    return rval;
+}
+#endif // OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+
 uint64_t gNodeId = 0;
 
+void platformMainloopRemoveFd(int aFd)
+{
+#if OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+    mainloopEpollRemove(aFd);
+#else
+    OT_UNUSED_VARIABLE(aFd);
+#endif
+}
+
 otInstance *otSysInit(otPlatformConfig *aPlatformConfig)
 {
     otInstance *instance = NULL;
@@ -54,6 +299,9 @@ otInstance *otSysInit(otPlatformConfig *aPlatformConfig)
     platformAlarmInit(aPlatformConfig->mSpeedUpFactor);
     platformRadioInit(aPlatformConfig);
     platformRandomInit();
+#if OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+    mainloopEpollInit();
+#endif
 
     instance = otInstanceInitSingle();
     assert(instance != NULL);
@@ -76,6 +324,9 @@ void otSysDeinit(void)
 #if OPENTHREAD_CONFIG_PLATFORM_NETIF_ENABLE
     platformNetifDeinit();
 #endif
+#if OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+    mainloopEpollDeinit();
+#endif
 }
 
 #if OPENTHREAD_POSIX_VIRTUAL_TIME
@@ -173,8 +424,12 @@ int otSysMainloopPoll(otSysMainloopContext *aMainloop)
     else
 #endif
     {
+#if OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE
+        rval = mainloopEpollPoll(aMainloop);
+#else
         rval = select(aMainloop->mMaxFd + 1, &aMainloop->mReadFdSet, &aMainloop->mWriteFdSet, &aMainloop->mErrorFdSet,
                       &aMainloop->mTimeout);
+#endif
     }
 
     return rval;
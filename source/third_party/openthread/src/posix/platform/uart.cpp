@@ -127,12 +127,14 @@ otError otPlatUartDisable(void)
 #if OPENTHREAD_POSIX_CONFIG_DAEMON_ENABLE
     if (sSessionSocket != -1)
     {
+        platformMainloopRemoveFd(sSessionSocket);
         close(sSessionSocket);
         sSessionSocket = -1;
     }
 
     if (sUartSocket != -1)
     {
+        platformMainloopRemoveFd(sUartSocket);
         close(sUartSocket);
         sUartSocket = -1;
     }
@@ -244,6 +246,7 @@ void platformUartProcess(const fd_set *aReadFdSet, const fd_set *aWriteFdSet, co
 
     if (FD_ISSET(sSessionSocket, aErrorFdSet))
     {
+        platformMainloopRemoveFd(sSessionSocket);
         close(sSessionSocket);
         sSessionSocket = -1;
     }
@@ -282,6 +285,7 @@ void platformUartProcess(const fd_set *aReadFdSet, const fd_set *aWriteFdSet, co
             {
                 perror("UART read");
             }
+            platformMainloopRemoveFd(sSessionSocket);
             close(sSessionSocket);
             sSessionSocket = -1;
             ExitNow();
@@ -303,6 +307,7 @@ void platformUartProcess(const fd_set *aReadFdSet, const fd_set *aWriteFdSet, co
         {
 #if OPENTHREAD_POSIX_CONFIG_DAEMON_ENABLE
             perror("UART write");
+            platformMainloopRemoveFd(sSessionSocket);
             close(sSessionSocket);
             sSessionSocket = -1;
             ExitNow();
@@ -235,6 +235,7 @@ otError otPlatUdpClose(otUdpSocket *aUdpSocket)
 
     VerifyOrExit(aUdpSocket->mHandle != NULL, error = OT_ERROR_INVALID_ARGS);
     fd = FdFromHandle(aUdpSocket->mHandle);
+    platformMainloopRemoveFd(fd);
     VerifyOrExit(0 == close(fd), error = OT_ERROR_FAILED);
 
     aUdpSocket->mHandle = NULL;
@@ -0,0 +1,387 @@
+/*
+ *  Copyright (c) 2020, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file tests the RSSI histogram of the Channel Monitor and its use by the Channel Manager.
+ *
+ *   channel_monitor.cpp and channel_manager.cpp are built in with
+ *   OPENTHREAD_CONFIG_CHANNEL_MONITOR_RSSI_HISTOGRAM_ENABLE. The monitor timer and the energy scan are stubbed, so
+ *   that every scan round reports known RSSI values through the real scan result handler. The tests check the
+ *   percentiles against hand-computed histograms, the aging of the histogram once it holds a sample window, and that
+ *   channels with the same occupancy rate are told apart by their RSSI percentile, with ties kept.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/new.hpp"
+#include "common/string.cpp"
+#include "mac/channel_mask.cpp"
+#include "utils/channel_manager.cpp"
+#include "utils/channel_monitor.cpp"
+
+using namespace ot;
+
+enum
+{
+    kNumChannels = Radio::kChannelMax - Radio::kChannelMin + 1,
+};
+
+static Timer *                sStartedTimer;
+static Timer *                sMonitorTimer;
+static uint32_t               sScanChannels;
+static Mac::EnergyScanHandler sScanHandler;
+static void *                 sScanContext;
+static uint32_t               sRandom;
+
+namespace ot {
+
+// The raw storage of the single instance. Only the tested objects are constructed in it.
+OT_DEFINE_ALIGNED_VAR(gInstanceRaw, sizeof(Instance), uint64_t);
+
+Instance &Instance::Get(void)
+{
+    return *reinterpret_cast<Instance *>(&gInstanceRaw);
+}
+
+const TimerScheduler::AlarmApi TimerMilliScheduler::sAlarmMilliApi = {NULL, NULL, NULL};
+
+void TimerScheduler::ProcessTimers(const AlarmApi &)
+{
+    // Only the Channel Monitor timer is ever fired by the tests.
+    sMonitorTimer->Fired();
+}
+
+void TimerMilli::Start(uint32_t)
+{
+    sStartedTimer = this;
+}
+
+void TimerMilli::StartAt(TimeMilli, uint32_t)
+{
+}
+
+void TimerMilli::Stop(void)
+{
+}
+
+uint32_t RandomManager::NonCryptoGetUint32(void)
+{
+    return sRandom;
+}
+
+Notifier::Callback::Callback(Instance &, Handler aHandler, void *aOwner)
+    : OwnerLocator(aOwner)
+    , mHandler(aHandler)
+    , mNext(this)
+{
+}
+
+void Notifier::Signal(otChangedFlags)
+{
+}
+
+otError Mac::Mac::EnergyScan(uint32_t aScanChannels, uint16_t, EnergyScanHandler aHandler, void *aContext)
+{
+    sScanChannels = aScanChannels;
+    sScanHandler  = aHandler;
+    sScanContext  = aContext;
+
+    return OT_ERROR_NONE;
+}
+
+// The Mac and Mle setters only store the state the Channel Manager looks at.
+
+void Mac::Mac::SetSupportedChannelMask(const ChannelMask &aMask)
+{
+    mSupportedChannelMask = aMask;
+}
+
+otError Mac::Mac::SetPanChannel(uint8_t aChannel)
+{
+    mPanChannel = aChannel;
+
+    return OT_ERROR_NONE;
+}
+
+otError Mle::Mle::Start(bool)
+{
+    mRole = kRoleDetached;
+
+    return OT_ERROR_NONE;
+}
+
+// The Channel Manager only reaches the datasets once its timer fires, which the tests never do.
+
+otError MeshCoP::DatasetLocal::Read(otOperationalDataset &) const
+{
+    return OT_ERROR_NOT_FOUND;
+}
+
+otError MeshCoP::DatasetManager::SendSetRequest(const otOperationalDataset &, const uint8_t *, uint8_t)
+{
+    return OT_ERROR_NOT_IMPLEMENTED;
+}
+
+} // namespace ot
+
+static void check(bool aCondition, const char *aWhat)
+{
+    if (!aCondition)
+    {
+        fprintf(stderr, "FAILED: %s\n", aWhat);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static Utils::ChannelMonitor &GetMonitor(void)
+{
+    return Instance::Get().Get<Utils::ChannelMonitor>();
+}
+
+static void restartMonitor(void)
+{
+    Utils::ChannelMonitor &monitor = *new (&GetMonitor()) Utils::ChannelMonitor(Instance::Get());
+
+    check(monitor.Start() == OT_ERROR_NONE, "ChannelMonitor::Start()");
+    sMonitorTimer = sStartedTimer;
+}
+
+/**
+ * Runs one sample interval, i.e. one scan round per channel mask, reporting @p aRssi[i] for channel
+ * `Radio::kChannelMin + i`. Channels with `OT_RADIO_RSSI_INVALID` get no scan result.
+ *
+ */
+static void sample(const int8_t aRssi[kNumChannels])
+{
+    uint32_t sampleCount = GetMonitor().GetSampleCount();
+
+    do
+    {
+        otEnergyScanResult result;
+
+        Instance::Get().Get<TimerMilliScheduler>().ProcessTimers();
+
+        for (uint8_t channel = Radio::kChannelMin; channel <= Radio::kChannelMax; channel++)
+        {
+            if ((sScanChannels & (1U << channel)) == 0 || aRssi[channel - Radio::kChannelMin] == OT_RADIO_RSSI_INVALID)
+            {
+                continue;
+            }
+
+            result.mChannel = channel;
+            result.mMaxRssi = aRssi[channel - Radio::kChannelMin];
+            sScanHandler(&result, sScanContext);
+        }
+
+        sScanHandler(NULL, sScanContext);
+    } while (GetMonitor().GetSampleCount() == sampleCount);
+}
+
+static void sampleAll(int8_t aRssi, uint8_t aChannel, uint32_t aCount)
+{
+    int8_t rssi[kNumChannels];
+
+    memset(rssi, OT_RADIO_RSSI_INVALID, sizeof(rssi));
+    rssi[aChannel - Radio::kChannelMin] = aRssi;
+
+    while (aCount-- != 0)
+    {
+        sample(rssi);
+    }
+}
+
+static void testPercentile(void)
+{
+    const uint8_t          channel = Radio::kChannelMin;
+    Utils::ChannelMonitor &monitor = GetMonitor();
+
+    restartMonitor();
+
+    check(monitor.GetChannelRssiPercentile(channel, 50) == OT_RADIO_RSSI_INVALID, "no sample yet");
+
+    // 50 samples in [-100, -90), 30 in [-70, -60), 20 in [-40, -30).
+    sampleAll(-95, channel, 50);
+    sampleAll(-65, channel, 30);
+    sampleAll(-35, channel, 20);
+
+    check(monitor.GetChannelRssiPercentile(channel, 0) == -90, "0th percentile");
+    check(monitor.GetChannelRssiPercentile(channel, 50) == -90, "50th percentile");
+    check(monitor.GetChannelRssiPercentile(channel, 51) == -60, "51st percentile");
+    check(monitor.GetChannelRssiPercentile(channel, 80) == -60, "80th percentile");
+    check(monitor.GetChannelRssiPercentile(channel, 81) == -30, "81st percentile");
+    check(monitor.GetChannelRssiPercentile(channel, 100) == -30, "100th percentile");
+
+    check(monitor.GetChannelRssiPercentile(channel, 101) == OT_RADIO_RSSI_INVALID, "percentile above 100");
+    check(monitor.GetChannelRssiPercentile(Radio::kChannelMin - 1, 50) == OT_RADIO_RSSI_INVALID, "channel too low");
+    check(monitor.GetChannelRssiPercentile(Radio::kChannelMax + 1, 50) == OT_RADIO_RSSI_INVALID, "channel too high");
+    check(monitor.GetChannelRssiPercentile(channel + 1, 50) == OT_RADIO_RSSI_INVALID, "channel without samples");
+
+    // Samples outside of the histogram range go to the first and last bins.
+    restartMonitor();
+    sampleAll(-128, channel, 1);
+    sampleAll(20, channel, 1);
+
+    check(monitor.GetChannelRssiPercentile(channel, 50) == -90, "sample below the histogram range");
+    check(monitor.GetChannelRssiPercentile(channel, 51) == -20, "sample above the histogram range");
+}
+
+static void testAging(void)
+{
+    const uint8_t          channel = Radio::kChannelMin + 5;
+    Utils::ChannelMonitor &monitor = GetMonitor();
+
+    restartMonitor();
+
+    // kSampleWindow - 1 quiet samples, then a loud one: the histogram is halved to 479 quiet samples and the loud
+    // one is rounded away.
+    sampleAll(-95, channel, Utils::ChannelMonitor::kSampleWindow - 1);
+    check(monitor.GetChannelRssiPercentile(channel, 100) == -90, "window of quiet samples");
+
+    sampleAll(-25, channel, 1);
+    check(monitor.GetChannelRssiPercentile(channel, 100) == -90, "loud sample halved away");
+
+    // 481 loud samples bring the histogram to a window again: 479 quiet and 481 loud samples are halved to 239 and
+    // 240, so that the loud samples are now over half of a 479 sample histogram.
+    sampleAll(-25, channel, Utils::ChannelMonitor::kSampleWindow / 2 + 1);
+    check(monitor.GetChannelRssiPercentile(channel, 49) == -90, "49th percentile after aging");
+    check(monitor.GetChannelRssiPercentile(channel, 50) == -20, "50th percentile after aging");
+}
+
+static void testQuietest(void)
+{
+    Utils::ChannelMonitor &monitor = GetMonitor();
+    int8_t                 rssi[kNumChannels];
+    Mac::ChannelMask       mask;
+
+    restartMonitor();
+
+    memset(rssi, OT_RADIO_RSSI_INVALID, sizeof(rssi));
+    rssi[0] = -85;
+    rssi[1] = -85;
+    rssi[2] = -55;
+
+    for (int i = 0; i < 10; i++)
+    {
+        sample(rssi);
+    }
+
+    mask.SetMask(0);
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        mask.AddChannel(Radio::kChannelMin + i);
+    }
+
+    mask = monitor.FindQuietestChannels(mask, 90);
+    check(mask.GetNumberOfChannels() == 2, "two quietest channels");
+    check(mask.ContainsChannel(Radio::kChannelMin) && mask.ContainsChannel(Radio::kChannelMin + 1),
+          "quietest channels kept as a tie");
+
+    mask.SetMask(0);
+    mask.AddChannel(Radio::kChannelMin + 2);
+    mask.AddChannel(Radio::kChannelMin + 3);
+    mask = monitor.FindQuietestChannels(mask, 90);
+    check(mask.GetNumberOfChannels() == 1 && mask.ContainsChannel(Radio::kChannelMin + 2),
+          "channel without samples is not quieter");
+
+    mask.SetMask(0);
+    mask.AddChannel(Radio::kChannelMin + 3);
+    mask.AddChannel(Radio::kChannelMin + 4);
+    mask = monitor.FindQuietestChannels(mask, 90);
+    check(mask.GetNumberOfChannels() == 2, "channels without samples are all returned");
+}
+
+static void testChannelManager(void)
+{
+    Utils::ChannelManager &manager = *new (&Instance::Get().Get<Utils::ChannelManager>())
+                                         Utils::ChannelManager(Instance::Get());
+    const uint8_t          current = Radio::kChannelMax;
+    int8_t                 rssi[kNumChannels];
+    Mac::ChannelMask       allChannels;
+
+    allChannels.SetMask(0);
+
+    for (uint8_t channel = Radio::kChannelMin; channel <= Radio::kChannelMax; channel++)
+    {
+        allChannels.AddChannel(channel);
+    }
+
+    Instance::Get().Get<Mac::Mac>().SetSupportedChannelMask(allChannels);
+    Instance::Get().Get<Mac::Mac>().SetPanChannel(current);
+    Instance::Get().Get<Mle::Mle>().Start(false);
+    manager.SetSupportedChannels(allChannels.GetMask());
+
+    restartMonitor();
+
+    // The current channel is busy. All other channels stay below the occupancy threshold, so they have the same
+    // (zero) occupancy rate and their RSSI tells them apart: three channels are quieter than the rest, and one of
+    // them gets a loud sample every fifth interval, which puts its 90th percentile with the rest.
+    for (uint8_t i = 0; i < kNumChannels; i++)
+    {
+        rssi[i] = -85;
+    }
+
+    rssi[current - Radio::kChannelMin] = -50;
+    rssi[4]                            = -95;
+    rssi[9]                            = -95;
+
+    for (uint32_t n = 0; n <= OPENTHREAD_CONFIG_CHANNEL_MANAGER_MINIMUM_MONITOR_SAMPLE_COUNT; n++)
+    {
+        rssi[12] = (n % 5 == 0) ? -85 : -95;
+        sample(rssi);
+    }
+
+    check(GetMonitor().GetChannelOccupancy(Radio::kChannelMin + 4) == 0, "no occupancy on a quiet channel");
+    check(GetMonitor().GetChannelOccupancy(Radio::kChannelMin + 12) == 0, "no occupancy on the louder channel");
+    check(GetMonitor().GetChannelOccupancy(current) != 0, "occupancy on the current channel");
+
+    // The random index picks within the quietest channels, in channel order.
+    for (sRandom = 0; sRandom < 4; sRandom++)
+    {
+        const uint8_t expected = (sRandom % 2 == 0) ? Radio::kChannelMin + 4 : Radio::kChannelMin + 9;
+
+        check(manager.RequestChannelSelect(true) == OT_ERROR_NONE, "RequestChannelSelect()");
+        check(manager.GetRequestedChannel() == expected, "quietest channel selected");
+    }
+
+    sRandom = 0;
+}
+
+int main(void)
+{
+    testPercentile();
+    testAging();
+    testQuietest();
+    testChannelManager();
+
+    printf("channel monitor: RSSI percentiles, histogram aging and channel tie-breaking passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,509 @@
+/*
+ *  Copyright (c) 2020, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file tests the IPv6 fragment reassembly.
+ *
+ *   ip6.cpp is built in with OPENTHREAD_CONFIG_IP6_FRAGMENTATION_ENABLE, together with the message pool. Fragments are
+ *   passed to Ip6::HandleDatagram() and the reassembled datagrams are collected through the receive callback. The tests
+ *   cover in-order, out-of-order, overlapping and past-end fragments, a full reassembly table and the reassembly
+ *   timeout, and check otIp6GetReassemblyCounters() and the free message buffers after every case.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "api/ip6_api.cpp"
+#include "common/message.cpp"
+#include "common/new.hpp"
+#include "net/ip6.cpp"
+#include "net/ip6_address.cpp"
+#include "net/ip6_headers.cpp"
+#include "net/ip6_mpl.cpp"
+#include "net/udp6.cpp"
+
+using namespace ot;
+
+enum
+{
+    kTestNextHeader = 253, ///< Reserved for experimentation (RFC 3692), Ip6 passes it to the receive callback only.
+    kMaxPayload     = 512,
+};
+
+static Timer *  sStartedTimer;
+static uint8_t  sIcmpType;
+static uint8_t  sIcmpCode;
+static uint32_t sIcmpErrors;
+static uint32_t sReceived;
+static uint16_t sReceivedLength;
+static uint8_t  sReceivedData[sizeof(Ip6::Header) + kMaxPayload];
+
+namespace ot {
+
+// The raw storage of the single instance. Only the message pool and Ip6 are constructed in it.
+OT_DEFINE_ALIGNED_VAR(gInstanceRaw, sizeof(Instance), uint64_t);
+
+Instance &Instance::Get(void)
+{
+    return *reinterpret_cast<Instance *>(&gInstanceRaw);
+}
+
+const TimerScheduler::AlarmApi TimerMilliScheduler::sAlarmMilliApi = {NULL, NULL, NULL};
+
+void TimerScheduler::ProcessTimers(const AlarmApi &)
+{
+    // Only the reassembly timer is ever fired by the tests.
+    sStartedTimer->Fired();
+}
+
+void TimerMilli::Start(uint32_t)
+{
+    sStartedTimer = this;
+}
+
+void TimerMilli::StartAt(TimeMilli, uint32_t)
+{
+}
+
+void TimerMilli::Stop(void)
+{
+}
+
+Tasklet::Tasklet(Instance &aInstance, Handler aHandler, void *aOwner)
+    : InstanceLocator(aInstance)
+    , OwnerLocator(aOwner)
+    , mHandler(aHandler)
+    , mNext(NULL)
+{
+}
+
+otError Tasklet::Post(void)
+{
+    return OT_ERROR_NONE;
+}
+
+namespace Ip6 {
+
+// Every fragment is addressed to this node.
+bool Netif::IsUnicastAddress(const Address &) const
+{
+    return true;
+}
+
+Icmp::Icmp(Instance &aInstance)
+    : InstanceLocator(aInstance)
+    , mHandlers()
+    , mEchoSequence(1)
+    , mEchoMode(OT_ICMP6_ECHO_HANDLER_ALL)
+{
+}
+
+otError Icmp::SendError(IcmpHeader::Type aType, IcmpHeader::Code aCode, const MessageInfo &, const Message &)
+{
+    sIcmpType = aType;
+    sIcmpCode = aCode;
+    sIcmpErrors++;
+
+    return OT_ERROR_NONE;
+}
+
+// The rest of the functions ip6.cpp links against. The tests do not reach them.
+
+bool Netif::IsMulticastSubscribed(const Address &) const
+{
+    return false;
+}
+
+bool Icmp::ShouldHandleEchoRequest(const MessageInfo &)
+{
+    return false;
+}
+
+otError Icmp::HandleMessage(Message &, MessageInfo &)
+{
+    return OT_ERROR_DROP;
+}
+
+} // namespace Ip6
+
+void TimerMilli::FireAt(TimeMilli)
+{
+}
+
+void TimerMilli::FireAtIfEarlier(TimeMilli)
+{
+}
+
+uint32_t RandomManager::NonCryptoGetUint32(void)
+{
+    return 0;
+}
+
+otError ThreadNetif::RouteLookup(const Ip6::Address &, const Ip6::Address &, uint8_t *)
+{
+    return OT_ERROR_NO_ROUTE;
+}
+
+bool ThreadNetif::IsTmfMessage(const Ip6::MessageInfo &)
+{
+    return false;
+}
+
+otError MeshForwarder::SendMessage(Message &)
+{
+    return OT_ERROR_DROP;
+}
+
+otError MeshForwarder::EvictMessage(uint8_t)
+{
+    return OT_ERROR_NOT_FOUND;
+}
+
+bool Mle::MleRouter::HasSleepyChildrenSubscribed(const Ip6::Address &)
+{
+    return false;
+}
+
+uint16_t MeshCoP::JoinerRouter::GetJoinerUdpPort(void)
+{
+    return 0;
+}
+
+} // namespace ot
+
+extern "C" uint32_t otPlatAlarmMilliGetNow(void)
+{
+    return 0;
+}
+
+static void check(bool aCondition, const char *aWhat)
+{
+    if (!aCondition)
+    {
+        fprintf(stderr, "FAILED: %s\n", aWhat);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static Ip6::Ip6 &GetIp6(void)
+{
+    return Instance::Get().Get<Ip6::Ip6>();
+}
+
+static const otIp6ReassemblyCounters &GetCounters(void)
+{
+    return *otIp6GetReassemblyCounters(&Instance::Get());
+}
+
+static uint16_t GetFreeBuffers(void)
+{
+    return Instance::Get().Get<MessagePool>().GetFreeBufferCount();
+}
+
+static uint8_t payloadByte(uint32_t aIdentification, uint16_t aOffset)
+{
+    return static_cast<uint8_t>(aOffset ^ (aIdentification * 37));
+}
+
+static void handleReceive(otMessage *aMessage, void *)
+{
+    Message &message = *static_cast<Message *>(aMessage);
+
+    sReceived++;
+    sReceivedLength = message.GetLength();
+    check(sReceivedLength <= sizeof(sReceivedData), "reassembled datagram fits");
+    message.Read(0, sReceivedLength, sReceivedData);
+    message.Free();
+}
+
+/**
+ * Passes one fragment of datagram @p aIdentification from source `fe80::<aSource>` to Ip6, carrying the payload
+ * octets [@p aOffset, @p aOffset + @p aLength).
+ *
+ */
+static void sendFragment(uint32_t aIdentification, uint16_t aOffset, uint16_t aLength, bool aMore, uint8_t aSource = 2)
+{
+    Message *           message = GetIp6().NewMessage(0);
+    Ip6::Header         header;
+    Ip6::FragmentHeader fragmentHeader;
+    uint8_t             payload[kMaxPayload];
+
+    check(message != NULL, "fragment message allocated");
+
+    header.Init();
+    header.SetPayloadLength(sizeof(fragmentHeader) + aLength);
+    header.SetNextHeader(Ip6::kProtoFragment);
+    header.SetHopLimit(64);
+    header.GetSource().Clear();
+    header.GetSource().mFields.m8[0]       = 0xfe;
+    header.GetSource().mFields.m8[1]       = 0x80;
+    header.GetSource().mFields.m8[15]      = aSource;
+    header.GetDestination()                = header.GetSource();
+    header.GetDestination().mFields.m8[15] = 1;
+
+    fragmentHeader.Init();
+    fragmentHeader.SetNextHeader(kTestNextHeader);
+    fragmentHeader.SetOffset(Ip6::FragmentHeader::BytesToFragmentOffset(aOffset));
+    fragmentHeader.SetIdentification(aIdentification);
+
+    if (aMore)
+    {
+        fragmentHeader.SetMoreFlag();
+    }
+
+    for (uint16_t i = 0; i < aLength; i++)
+    {
+        payload[i] = payloadByte(aIdentification, aOffset + i);
+    }
+
+    check(message->Append(&header, sizeof(header)) == OT_ERROR_NONE, "header appended");
+    check(message->Append(&fragmentHeader, sizeof(fragmentHeader)) == OT_ERROR_NONE, "fragment header appended");
+    check(message->Append(payload, aLength) == OT_ERROR_NONE, "payload appended");
+
+    // Ip6 takes the fragment message and copies its payload to the reassembly buffer.
+    check(GetIp6().HandleDatagram(*message, NULL, NULL, false) == OT_ERROR_DROP, "fragment consumed");
+}
+
+static void checkReceived(uint32_t aIdentification, uint16_t aLength)
+{
+    Ip6::Header header;
+
+    check(sReceived == 1, "datagram delivered once");
+    check(sReceivedLength == sizeof(header) + aLength, "reassembled length");
+
+    memcpy(&header, sReceivedData, sizeof(header));
+    check(header.GetPayloadLength() == aLength, "reassembled payload length");
+    check(header.GetNextHeader() == kTestNextHeader, "reassembled next header");
+
+    for (uint16_t i = 0; i < aLength; i++)
+    {
+        check(sReceivedData[sizeof(header) + i] == payloadByte(aIdentification, i), "reassembled payload");
+    }
+
+    sReceived = 0;
+}
+
+static void checkIdle(uint16_t aFreeBuffers)
+{
+    check(GetCounters().mBufferedBytes == 0, "nothing left buffered");
+    check(GetFreeBuffers() == aFreeBuffers, "all message buffers freed");
+}
+
+static void testInOrder(void)
+{
+    uint16_t freeBuffers = GetFreeBuffers();
+
+    otIp6ResetReassemblyCounters(&Instance::Get());
+
+    sendFragment(1, 0, 48, true);
+    check(GetCounters().mBufferedBytes == 48, "first fragment buffered");
+    sendFragment(1, 48, 48, true);
+    check(sReceived == 0, "not delivered before the last fragment");
+    sendFragment(1, 96, 5, false);
+
+    checkReceived(1, 101);
+    check(GetCounters().mMaxBufferedBytes == 101, "high-water mark of buffered bytes");
+    checkIdle(freeBuffers);
+}
+
+static void testOutOfOrder(void)
+{
+    uint16_t freeBuffers = GetFreeBuffers();
+
+    otIp6ResetReassemblyCounters(&Instance::Get());
+
+    // The last fragment first, then the middle one, then the first one.
+    sendFragment(2, 96, 5, false);
+    sendFragment(2, 48, 48, true);
+    check(sReceived == 0, "not delivered with a hole at the start");
+    sendFragment(2, 0, 48, true);
+    checkReceived(2, 101);
+
+    // Two datagrams from different sources with the same identification are interleaved.
+    sendFragment(3, 0, 16, true, 2);
+    sendFragment(3, 0, 24, true, 3);
+    sendFragment(3, 16, 8, false, 2);
+    checkReceived(3, 24);
+    sendFragment(3, 24, 8, false, 3);
+    checkReceived(3, 32);
+
+    check(GetCounters().mOverlaps == 0 && GetCounters().mMalformed == 0 && GetCounters().mNoEntry == 0,
+          "no drop counted");
+    checkIdle(freeBuffers);
+}
+
+static void testOverlap(void)
+{
+    uint16_t freeBuffers = GetFreeBuffers();
+
+    otIp6ResetReassemblyCounters(&Instance::Get());
+
+    // A fragment overlapping a received one by a single block aborts the datagram.
+    sendFragment(4, 0, 48, true);
+    sendFragment(4, 40, 16, true);
+    check(GetCounters().mOverlaps == 1, "overlap counted");
+    checkIdle(freeBuffers);
+
+    // The rest of the datagram starts a new reassembly, and a duplicate of one of its fragments aborts it too.
+    sendFragment(4, 56, 8, false);
+    sendFragment(4, 0, 48, true);
+    check(sReceived == 0, "aborted datagram not delivered");
+    sendFragment(4, 0, 48, true);
+    check(GetCounters().mOverlaps == 2, "duplicate counted as an overlap");
+    check(sReceived == 0, "nothing delivered after an overlap");
+    checkIdle(freeBuffers);
+}
+
+static void testPastEnd(void)
+{
+    uint16_t freeBuffers = GetFreeBuffers();
+
+    otIp6ResetReassemblyCounters(&Instance::Get());
+
+    // A fragment beyond the end given by the last fragment.
+    sendFragment(5, 48, 16, false);
+    sendFragment(5, 64, 8, true);
+    check(GetCounters().mMalformed == 1, "fragment past the end counted");
+    checkIdle(freeBuffers);
+
+    // A second last fragment with a different end.
+    sendFragment(5, 48, 16, false);
+    sendFragment(5, 8, 8, false);
+    check(GetCounters().mMalformed == 2, "second last fragment counted");
+    checkIdle(freeBuffers);
+
+    // A last fragment before a fragment received earlier.
+    sendFragment(5, 64, 8, true);
+    sendFragment(5, 8, 48, false);
+    check(GetCounters().mMalformed == 3, "last fragment before the received end counted");
+    check(sReceived == 0, "nothing delivered past the end");
+    checkIdle(freeBuffers);
+
+    // A non-last fragment which is not a multiple of 8 octets is dropped before any reassembly starts.
+    sendFragment(5, 0, 12, true);
+    check(GetCounters().mBufferedBytes == 0, "unaligned fragment not buffered");
+    check(GetCounters().mOverlaps == 0 && GetCounters().mNoEntry == 0, "unaligned fragment not counted as a drop");
+    checkIdle(freeBuffers);
+}
+
+static void testTableFull(void)
+{
+    uint16_t freeBuffers = GetFreeBuffers();
+
+    otIp6ResetReassemblyCounters(&Instance::Get());
+
+    for (uint32_t id = 10; id < 10 + Ip6::Ip6::kMaxReassemblyDatagrams; id++)
+    {
+        sendFragment(id, 0, 8, true);
+    }
+
+    check(GetCounters().mBufferedBytes == 8 * Ip6::Ip6::kMaxReassemblyDatagrams, "all datagrams buffered");
+
+    // One more datagram finds no entry, but the ones in the table still complete.
+    sendFragment(100, 0, 8, true);
+    check(GetCounters().mNoEntry == 1, "full table counted");
+    check(GetCounters().mBufferedBytes == 8 * Ip6::Ip6::kMaxReassemblyDatagrams, "dropped fragment not buffered");
+
+    sendFragment(10, 8, 4, false);
+    checkReceived(10, 12);
+
+    // The completed datagram freed its entry.
+    sendFragment(100, 0, 8, true);
+    sendFragment(100, 8, 8, false);
+    checkReceived(100, 16);
+    check(GetCounters().mNoEntry == 1, "freed entry reused");
+
+    for (uint32_t id = 11; id < 10 + Ip6::Ip6::kMaxReassemblyDatagrams; id++)
+    {
+        sendFragment(id, 8, 1, false);
+        checkReceived(id, 9);
+    }
+
+    checkIdle(freeBuffers);
+}
+
+static void testTimeout(void)
+{
+    uint16_t freeBuffers = GetFreeBuffers();
+    uint16_t ticks;
+
+    otIp6ResetReassemblyCounters(&Instance::Get());
+    sIcmpErrors = 0;
+
+    sendFragment(20, 0, 48, true);
+    sendFragment(20, 96, 5, false);
+
+    // Counters reset during a reassembly keep the buffered bytes.
+    otIp6ResetReassemblyCounters(&Instance::Get());
+    check(GetCounters().mBufferedBytes == 53 && GetCounters().mMaxBufferedBytes == 53, "buffered bytes kept on reset");
+
+    for (ticks = 0; ticks < Ip6::Ip6::kIp6ReassemblyTimeout; ticks++)
+    {
+        Instance::Get().Get<TimerMilliScheduler>().ProcessTimers();
+    }
+
+    check(GetCounters().mTimeouts == 0 && GetCounters().mBufferedBytes == 53, "no timeout before the deadline");
+
+    Instance::Get().Get<TimerMilliScheduler>().ProcessTimers();
+    check(GetCounters().mTimeouts == 1, "timeout counted");
+    check(sIcmpErrors == 1 && sIcmpType == Ip6::IcmpHeader::kTypeTimeExceeded &&
+              sIcmpCode == Ip6::IcmpHeader::kCodeFragmReasTimeEx,
+          "time exceeded error sent");
+
+    // The missing fragment then starts a new datagram which is not complete either.
+    sendFragment(20, 48, 48, true);
+    check(sReceived == 0, "timed out datagram not delivered");
+
+    for (ticks = 0; ticks <= Ip6::Ip6::kIp6ReassemblyTimeout; ticks++)
+    {
+        Instance::Get().Get<TimerMilliScheduler>().ProcessTimers();
+    }
+
+    check(GetCounters().mTimeouts == 2, "second timeout counted");
+    checkIdle(freeBuffers);
+}
+
+int main(void)
+{
+    new (&Instance::Get().Get<MessagePool>()) MessagePool(Instance::Get());
+    new (&GetIp6()) Ip6::Ip6(Instance::Get());
+
+    GetIp6().SetReceiveDatagramCallback(handleReceive, NULL);
+
+    testInOrder();
+    testOutOfOrder();
+    testOverlap();
+    testPastEnd();
+    testTableFull();
+    testTimeout();
+
+    printf("ip6 reassembly: in-order, out-of-order, overlapping, past-end, table-full and timeout cases passed\n");
+
+    return EXIT_SUCCESS;
+}
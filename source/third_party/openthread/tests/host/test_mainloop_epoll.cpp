@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2020, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file tests the epoll mainloop backend of the posix platform.
+ *
+ *   system.cpp is built in with OPENTHREAD_POSIX_CONFIG_MAINLOOP_EPOLL_ENABLE, and otSysMainloopPoll() is driven with
+ *   pipes in the mainloop fd sets. The tests check that a descriptor which is closed and reopened with the same number
+ *   and events is polled again once its driver removed it from the mainloop, and that the timerfd is re-armed when
+ *   the deadline moves and left alone when it does not.
+ */
+
+#include <stdlib.h>
+
+// system.cpp is built in, so that the tests can look at the epoll registrations.
+#include "posix/platform/system.cpp"
+
+static uint64_t sNowUs;
+
+uint64_t otPlatTimeGet(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * US_PER_S + static_cast<uint64_t>(now.tv_nsec) / NS_PER_US;
+}
+
+const char *otExitCodeToString(uint8_t)
+{
+    return "";
+}
+
+otLogLevel otLoggingGetLevel(void)
+{
+    return OT_LOG_LEVEL_NONE;
+}
+
+void otPlatLog(otLogLevel, otLogRegion, const char *, ...)
+{
+}
+
+// The rest of the functions system.cpp links against. The tests do not reach them.
+
+void platformAlarmInit(uint32_t)
+{
+}
+
+void platformAlarmUpdateTimeout(struct timeval *)
+{
+}
+
+void platformAlarmProcess(otInstance *)
+{
+}
+
+void platformRadioInit(const otPlatformConfig *)
+{
+}
+
+void platformRadioDeinit(void)
+{
+}
+
+void platformRadioUpdateFdSet(fd_set *, fd_set *, int *, struct timeval *)
+{
+}
+
+void platformRadioProcess(otInstance *, const fd_set *, const fd_set *)
+{
+}
+
+void platformRandomInit(void)
+{
+}
+
+void platformUartUpdateFdSet(fd_set *, fd_set *, fd_set *, int *)
+{
+}
+
+void platformUartProcess(const fd_set *, const fd_set *, const fd_set *)
+{
+}
+
+void platformNetifInit(otInstance *, const char *)
+{
+}
+
+void platformNetifDeinit(void)
+{
+}
+
+void platformNetifUpdateFdSet(fd_set *, fd_set *, fd_set *, int *)
+{
+}
+
+void platformNetifProcess(const fd_set *, const fd_set *, const fd_set *)
+{
+}
+
+otInstance *otInstanceInitSingle(void)
+{
+    return NULL;
+}
+
+bool otTaskletsArePending(otInstance *)
+{
+    return false;
+}
+
+static void check(bool aCondition, const char *aWhat)
+{
+    if (!aCondition)
+    {
+        fprintf(stderr, "FAILED: %s\n", aWhat);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static int pollOnce(int aReadFd, uint32_t aTimeoutUs, otSysMainloopContext &aMainloop)
+{
+    memset(&aMainloop, 0, sizeof(aMainloop));
+    FD_ZERO(&aMainloop.mReadFdSet);
+    FD_ZERO(&aMainloop.mWriteFdSet);
+    FD_ZERO(&aMainloop.mErrorFdSet);
+    aMainloop.mMaxFd = -1;
+
+    if (aReadFd >= 0)
+    {
+        FD_SET(aReadFd, &aMainloop.mReadFdSet);
+        aMainloop.mMaxFd = aReadFd;
+    }
+
+    aMainloop.mTimeout.tv_sec  = static_cast<time_t>(aTimeoutUs / US_PER_S);
+    aMainloop.mTimeout.tv_usec = static_cast<suseconds_t>(aTimeoutUs % US_PER_S);
+
+    sNowUs = otPlatTimeGet();
+
+    return otSysMainloopPoll(&aMainloop);
+}
+
+static uint64_t elapsedMs(void)
+{
+    return (otPlatTimeGet() - sNowUs) / 1000;
+}
+
+static void testFdReuse(void)
+{
+    otSysMainloopContext mainloop;
+    int                  first[2];
+    int                  second[2];
+    int                  readFd;
+
+    check(pipe(first) == 0, "pipe");
+    readFd = first[0];
+
+    check(pollOnce(readFd, 0, mainloop) == 0, "empty pipe is not readable");
+    check(sRegisteredEvents[readFd] == EPOLLIN, "pipe registered");
+
+    // The driver closes the pipe and opens another one, which gets the same descriptor numbers.
+    platformMainloopRemoveFd(readFd);
+    close(first[0]);
+    close(first[1]);
+    check(pipe(second) == 0, "pipe");
+    check(second[0] == readFd, "descriptor number reused");
+
+    check(write(second[1], "x", 1) == 1, "write");
+    check(pollOnce(readFd, 2 * US_PER_S, mainloop) == 1, "reopened descriptor polled");
+    check(FD_ISSET(readFd, &mainloop.mReadFdSet), "reopened descriptor readable");
+    check(elapsedMs() < 1000, "reopened descriptor wakes the mainloop");
+
+    // Without the hook the number stays registered but the closed file has left the epoll set.
+    close(second[0]);
+    close(second[1]);
+    check(pipe(second) == 0, "pipe");
+    check(second[0] == readFd, "descriptor number reused");
+    check(write(second[1], "x", 1) == 1, "write");
+    check(pollOnce(readFd, 100000, mainloop) == 0, "stale registration is not polled");
+
+    platformMainloopRemoveFd(readFd);
+    check(pollOnce(readFd, 0, mainloop) == 1, "registration restored");
+
+    platformMainloopRemoveFd(readFd);
+    close(second[0]);
+    close(second[1]);
+    check(pollOnce(-1, 0, mainloop) == 0, "nothing left to poll");
+    check(sMaxRegisteredFd == -1, "nothing left registered");
+}
+
+static void testTimerRearm(void)
+{
+    otSysMainloopContext mainloop;
+    int                  fds[2];
+    uint64_t             deadline;
+
+    check(pipe(fds) == 0, "pipe");
+    check(write(fds[1], "x", 1) == 1, "write");
+
+    // A readable descriptor returns at once and leaves the timer armed for a later deadline.
+    check(pollOnce(fds[0], 10 * US_PER_S, mainloop) == 1, "readable pipe");
+    check(sIsTimerArmed, "timer armed");
+    deadline = sTimerDeadline;
+
+    // The same deadline does not re-arm the timer.
+    check(pollOnce(fds[0], static_cast<uint32_t>(deadline - otPlatTimeGet()), mainloop) == 1, "readable pipe");
+    check(sTimerDeadline <= deadline + kTimerFdSlackUs && sTimerDeadline + kTimerFdSlackUs >= deadline,
+          "unchanged deadline keeps the timer");
+
+    // An earlier deadline re-arms it, and the mainloop wakes on it.
+    check(read(fds[0], &deadline, 1) == 1, "read");
+    check(pollOnce(fds[0], 20000, mainloop) == 0, "timeout");
+    check(elapsedMs() >= 19 && elapsedMs() < 1000, "woke on the earlier deadline");
+    check(!sIsTimerArmed, "expired timer disarmed");
+
+    // An expired timer is armed again for the next deadline.
+    check(pollOnce(fds[0], 30000, mainloop) == 0, "timeout");
+    check(elapsedMs() >= 29 && elapsedMs() < 1000, "woke on the next deadline");
+
+    // A later deadline than the armed one re-arms it too.
+    check(write(fds[1], "x", 1) == 1, "write");
+    check(pollOnce(fds[0], 10000, mainloop) == 1, "readable pipe");
+    check(read(fds[0], &deadline, 1) == 1, "read");
+    check(pollOnce(fds[0], 50000, mainloop) == 0, "timeout");
+    check(elapsedMs() >= 49 && elapsedMs() < 1000, "woke on the later deadline");
+
+    // A zero timeout does not block.
+    check(pollOnce(fds[0], 0, mainloop) == 0, "no timeout");
+    check(elapsedMs() < 10, "zero timeout returns at once");
+
+    platformMainloopRemoveFd(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+int main(void)
+{
+    mainloopEpollInit();
+
+    testFdReuse();
+    testTimerRearm();
+
+    mainloopEpollDeinit();
+
+    printf("epoll mainloop: descriptor reuse and timer re-arming passed\n");
+
+    return EXIT_SUCCESS;
+}
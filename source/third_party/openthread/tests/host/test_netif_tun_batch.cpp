@@ -0,0 +1,305 @@
+/*
+ *  Copyright (c) 2020, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file benchmarks draining the TUN device in the posix netif.
+ *
+ *   A SOCK_SEQPACKET socket pair stands in for the TUN device: it keeps packet boundaries and reports EAGAIN when
+ *   empty, like a non-blocking TUN fd. The benchmark writes bursts of IPv6-sized packets into one end and runs a
+ *   select() mainloop over the other end, calling processTransmit() on every wakeup. It reports the mainloop passes
+ *   and the time needed to hand every packet to otIp6Send(), and checks that every packet arrives intact and in order.
+ *
+ *   Build it twice to compare against the one-packet-per-pass behaviour:
+ *     make test_netif_tun_batch                        (OPENTHREAD_POSIX_CONFIG_NETIF_TUN_READ_BUDGET default)
+ *     make test_netif_tun_batch_1                      (budget of 1)
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+
+// netif.cpp is built in, so that the benchmark can drive its static functions.
+#include "posix/platform/netif.cpp"
+
+enum
+{
+    kBursts      = 2000,
+    kBurstSize   = 32,
+    kPacketSize  = 1280,
+    kMessagePool = 64,
+};
+
+struct TestMessage
+{
+    uint16_t mLength;
+    uint8_t  mData[kMaxIp6Size];
+    bool     mInUse;
+};
+
+static TestMessage sMessages[kMessagePool];
+static uint32_t    sSent;
+static uint32_t    sExpectedSeq;
+
+otMessage *otIp6NewMessage(otInstance *aInstance, const otMessageSettings *aSettings)
+{
+    OT_UNUSED_VARIABLE(aInstance);
+    OT_UNUSED_VARIABLE(aSettings);
+
+    for (TestMessage &message : sMessages)
+    {
+        if (!message.mInUse)
+        {
+            message.mInUse  = true;
+            message.mLength = 0;
+            return reinterpret_cast<otMessage *>(&message);
+        }
+    }
+
+    return NULL;
+}
+
+otError otMessageAppend(otMessage *aMessage, const void *aBuf, uint16_t aLength)
+{
+    TestMessage *message = reinterpret_cast<TestMessage *>(aMessage);
+
+    VerifyOrExit(message->mLength + aLength <= sizeof(message->mData), OT_NOOP);
+    memcpy(&message->mData[message->mLength], aBuf, aLength);
+    message->mLength += aLength;
+    return OT_ERROR_NONE;
+
+exit:
+    return OT_ERROR_NO_BUFS;
+}
+
+void otMessageFree(otMessage *aMessage)
+{
+    reinterpret_cast<TestMessage *>(aMessage)->mInUse = false;
+}
+
+otError otIp6Send(otInstance *aInstance, otMessage *aMessage)
+{
+    TestMessage *message = reinterpret_cast<TestMessage *>(aMessage);
+    uint32_t     seq;
+
+    OT_UNUSED_VARIABLE(aInstance);
+
+    memcpy(&seq, message->mData, sizeof(seq));
+
+    if (message->mLength != kPacketSize || seq != sExpectedSeq || message->mData[kPacketSize - 1] != (seq & 0xff))
+    {
+        fprintf(stderr, "packet %u corrupted or out of order\n", static_cast<unsigned>(sExpectedSeq));
+        exit(EXIT_FAILURE);
+    }
+
+    sExpectedSeq++;
+    sSent++;
+    otMessageFree(aMessage);
+
+    return OT_ERROR_NONE;
+}
+
+const char *otThreadErrorToString(otError aError)
+{
+    OT_UNUSED_VARIABLE(aError);
+    return "";
+}
+
+// The rest of the functions netif.cpp links against. The benchmark does not reach them.
+
+uint16_t otMessageGetLength(const otMessage *aMessage)
+{
+    return reinterpret_cast<const TestMessage *>(aMessage)->mLength;
+}
+
+uint16_t otMessageRead(const otMessage *aMessage, uint16_t aOffset, void *aBuf, uint16_t aLength)
+{
+    const TestMessage *message = reinterpret_cast<const TestMessage *>(aMessage);
+
+    if (aOffset >= message->mLength)
+    {
+        return 0;
+    }
+
+    if (aLength > message->mLength - aOffset)
+    {
+        aLength = message->mLength - aOffset;
+    }
+
+    memcpy(aBuf, &message->mData[aOffset], aLength);
+    return aLength;
+}
+
+void otIcmp6SetEchoMode(otInstance *, otIcmp6EchoMode)
+{
+}
+
+otError otIp6AddUnicastAddress(otInstance *, const otNetifAddress *)
+{
+    return OT_ERROR_NOT_IMPLEMENTED;
+}
+
+otError otIp6RemoveUnicastAddress(otInstance *, const otIp6Address *)
+{
+    return OT_ERROR_NOT_IMPLEMENTED;
+}
+
+otError otIp6SubscribeMulticastAddress(otInstance *, const otIp6Address *)
+{
+    return OT_ERROR_NOT_IMPLEMENTED;
+}
+
+otError otIp6UnsubscribeMulticastAddress(otInstance *, const otIp6Address *)
+{
+    return OT_ERROR_NOT_IMPLEMENTED;
+}
+
+bool otIp6IsEnabled(otInstance *)
+{
+    return true;
+}
+
+otError otIp6SetEnabled(otInstance *, bool)
+{
+    return OT_ERROR_NONE;
+}
+
+void otIp6SetReceiveCallback(otInstance *, otIp6ReceiveCallback, void *)
+{
+}
+
+void otIp6SetAddressCallback(otInstance *, otIp6AddressCallback, void *)
+{
+}
+
+otError otSetStateChangedCallback(otInstance *, otStateChangedCallback, void *)
+{
+    return OT_ERROR_NONE;
+}
+
+otLogLevel otLoggingGetLevel(void)
+{
+    return OT_LOG_LEVEL_NONE;
+}
+
+void otPlatLog(otLogLevel, otLogRegion, const char *, ...)
+{
+}
+
+const char *otExitCodeToString(uint8_t)
+{
+    return "";
+}
+
+void platformMainloopRemoveFd(int)
+{
+}
+
+int SocketWithCloseExec(int aDomain, int aType, int aProtocol, SocketBlockOption aBlockOption)
+{
+    OT_UNUSED_VARIABLE(aBlockOption);
+    return socket(aDomain, aType, aProtocol);
+}
+
+static uint64_t nowUs(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000 + static_cast<uint64_t>(tv.tv_usec);
+}
+
+int main(void)
+{
+    int      fds[2];
+    int      sndbuf   = kBurstSize * kPacketSize * 4;
+    uint32_t passes   = 0;
+    uint32_t seq      = 0;
+    uint8_t  packet[kPacketSize];
+    uint64_t start;
+    uint64_t elapsed;
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0)
+    {
+        perror("socketpair");
+        return EXIT_FAILURE;
+    }
+
+    setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+    sTunFd    = fds[0];
+    sInstance = reinterpret_cast<otInstance *>(&sMessages);
+
+    start = nowUs();
+
+    for (uint32_t burst = 0; burst < kBursts; burst++)
+    {
+        for (uint32_t i = 0; i < kBurstSize; i++, seq++)
+        {
+            memset(packet, 0, sizeof(packet));
+            memcpy(packet, &seq, sizeof(seq));
+            packet[kPacketSize - 1] = static_cast<uint8_t>(seq);
+
+            if (write(fds[1], packet, sizeof(packet)) != static_cast<ssize_t>(sizeof(packet)))
+            {
+                perror("write");
+                return EXIT_FAILURE;
+            }
+        }
+
+        // The mainloop: one select() wakeup per pass, as in otSysMainloopProcess().
+        while (sSent < seq)
+        {
+            fd_set         readFdSet;
+            struct timeval timeout = {1, 0};
+
+            FD_ZERO(&readFdSet);
+            FD_SET(sTunFd, &readFdSet);
+
+            if (select(sTunFd + 1, &readFdSet, NULL, NULL, &timeout) <= 0)
+            {
+                fprintf(stderr, "mainloop stalled with %u packets queued\n", static_cast<unsigned>(seq - sSent));
+                return EXIT_FAILURE;
+            }
+
+            processTransmit(sInstance);
+            passes++;
+        }
+    }
+
+    elapsed = nowUs() - start;
+
+    printf("budget %d: %u packets in %u mainloop passes (%.2f per pass), %.1f us per packet\n",
+           OPENTHREAD_POSIX_CONFIG_NETIF_TUN_READ_BUDGET, static_cast<unsigned>(sSent), static_cast<unsigned>(passes),
+           static_cast<double>(sSent) / passes, static_cast<double>(elapsed) / sSent);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    return EXIT_SUCCESS;
+}
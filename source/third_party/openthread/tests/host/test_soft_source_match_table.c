@@ -0,0 +1,360 @@
+/*
+ *  Copyright (c) 2020, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file tests the software source match table and benchmarks its lookups at full table size.
+ *
+ *   The table is checked against a plain array model through random add, clear and clear-all sequences, and every
+ *   entry must stay within SRC_MATCH_MAX_PROBES slots of its home slot. The benchmark then fills the table and times
+ *   lookups of every entry and of absent addresses. It reports the slowest address, which is what bounds the ACK
+ *   frame-pending decision, next to a linear scan over the same addresses, which is how the table used to search.
+ *   Three address sets are measured: child RLOC16s of one parent, addresses whose checksums are equal modulo the table
+ *   size, and addresses which all hash to one slot, which makes the table pick another multiplier. The probe bound is
+ *   asserted for each of them at full table size.
+ *
+ *   Built with SRC_MATCH_REHASH_ATTEMPTS=0, the test checks that an entry which does not fit is rejected and leaves
+ *   the other entries in place.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// soft_source_match_table.c is built in, so that the test can check the slots.
+#include "utils/soft_source_match_table.c"
+
+#define NUM_ENTRIES RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM
+#define PAN_ID 0xface
+#define LOOKUP_REPEAT 2000
+
+// The number of probes needed to find the furthest entry from its home slot.
+static uint16_t maxProbes(const sSrcMatchTable *aTable)
+{
+    uint16_t worst = 0;
+
+    for (uint16_t slot = 0; slot < 2 * aTable->size; slot++)
+    {
+        if (aTable->slots[slot] != SRC_MATCH_LINK_NONE)
+        {
+            uint16_t probes = srcMatchTableDistance(aTable, slot, aTable->slots[slot]) + 1;
+
+            worst = (probes > worst) ? probes : worst;
+        }
+    }
+
+    return worst;
+}
+
+static uint16_t sModel[NUM_ENTRIES];
+static int      sModelCount;
+
+static int modelFind(uint16_t aShortAddress)
+{
+    for (int i = 0; i < sModelCount; i++)
+    {
+        if (sModel[i] == aShortAddress)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static void testAgainstModel(void)
+{
+    srand(1);
+
+    for (int iter = 0; iter < 200000; iter++)
+    {
+        uint16_t address = (uint16_t)(rand() % (NUM_ENTRIES * 3));
+        int      op      = rand() % 100;
+        int      index   = modelFind(address);
+
+        if (op < 50)
+        {
+            otError error;
+
+            if (index >= 0)
+            {
+                // OpenThread never adds an address that is already in the table.
+                continue;
+            }
+
+            error = otPlatRadioAddSrcMatchShortEntry(NULL, address);
+
+            if (sModelCount < NUM_ENTRIES)
+            {
+                assert(error == OT_ERROR_NONE);
+                sModel[sModelCount++] = address;
+            }
+            else
+            {
+                assert(error == OT_ERROR_NO_BUFS);
+            }
+        }
+        else if (op < 99)
+        {
+            otError error = otPlatRadioClearSrcMatchShortEntry(NULL, address);
+
+            if (index >= 0)
+            {
+                assert(error == OT_ERROR_NONE);
+                sModel[index] = sModel[--sModelCount];
+            }
+            else
+            {
+                assert(error == OT_ERROR_NO_ADDRESS);
+            }
+        }
+        else
+        {
+            otPlatRadioClearSrcMatchShortEntries(NULL);
+            sModelCount = 0;
+        }
+
+        address = (uint16_t)(rand() % (NUM_ENTRIES * 3));
+        assert((utilsSoftSrcMatchShortFindEntry(address) >= 0) == (modelFind(address) >= 0));
+        assert(srcMatchShortTable.count == sModelCount);
+        assert(maxProbes(&srcMatchShortTable) <= SRC_MATCH_MAX_PROBES);
+    }
+
+    otPlatRadioClearSrcMatchShortEntries(NULL);
+    sModelCount = 0;
+}
+
+static void testExtAddresses(void)
+{
+    otExtAddress addresses[RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM];
+    otExtAddress absent;
+
+    for (int i = 0; i < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM; i++)
+    {
+        for (int j = 0; j < OT_EXT_ADDRESS_SIZE; j++)
+        {
+            addresses[i].m8[j] = (uint8_t)rand();
+        }
+
+        assert(otPlatRadioAddSrcMatchExtEntry(NULL, &addresses[i]) == OT_ERROR_NONE);
+    }
+
+    memset(&absent, 0x5a, sizeof(absent));
+    assert(otPlatRadioAddSrcMatchExtEntry(NULL, &absent) == OT_ERROR_NO_BUFS);
+
+    for (int i = 0; i < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM; i++)
+    {
+        assert(utilsSoftSrcMatchExtFindEntry(&addresses[i]) >= 0);
+    }
+
+    for (int i = 0; i < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM; i += 2)
+    {
+        assert(otPlatRadioClearSrcMatchExtEntry(NULL, &addresses[i]) == OT_ERROR_NONE);
+    }
+
+    for (int i = 0; i < RADIO_CONFIG_SRC_MATCH_EXT_ENTRY_NUM; i++)
+    {
+        assert((utilsSoftSrcMatchExtFindEntry(&addresses[i]) >= 0) == (i % 2 == 1));
+    }
+
+    otPlatRadioClearSrcMatchExtEntries(NULL);
+}
+
+static double nowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// The search the table used before it was hashed: a scan over every entry, comparing checksums.
+static uint16_t sLinearChecksums[NUM_ENTRIES];
+
+static int16_t linearFind(uint16_t aShortAddress)
+{
+    uint16_t checksum = (uint16_t)(aShortAddress + PAN_ID);
+
+    for (int16_t i = 0; i < NUM_ENTRIES; i++)
+    {
+        if (sLinearChecksums[i] == checksum)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static volatile int16_t sSink;
+
+static double worstLookupNs(int16_t (*aFind)(uint16_t), const uint16_t *aAddresses, int aCount)
+{
+    double worst = 0;
+
+    for (int i = 0; i < aCount; i++)
+    {
+        double start = nowNs();
+        double elapsed;
+
+        for (int r = 0; r < LOOKUP_REPEAT; r++)
+        {
+            sSink = aFind(aAddresses[i]);
+        }
+
+        elapsed = (nowNs() - start) / LOOKUP_REPEAT;
+
+        if (elapsed > worst)
+        {
+            worst = elapsed;
+        }
+    }
+
+    return worst;
+}
+
+static void benchmark(const char *aName, uint16_t (*aAddress)(int))
+{
+    uint16_t present[NUM_ENTRIES];
+    uint16_t absent[NUM_ENTRIES];
+
+    otPlatRadioClearSrcMatchShortEntries(NULL);
+
+    for (int i = 0; i < NUM_ENTRIES; i++)
+    {
+        present[i]          = aAddress(i);
+        absent[i]           = aAddress(i + NUM_ENTRIES);
+        sLinearChecksums[i] = (uint16_t)(present[i] + PAN_ID);
+        assert(otPlatRadioAddSrcMatchShortEntry(NULL, present[i]) == OT_ERROR_NONE);
+    }
+
+    // A lookup never probes more than SRC_MATCH_MAX_PROBES slots, whatever the addresses.
+    assert(maxProbes(&srcMatchShortTable) <= SRC_MATCH_MAX_PROBES);
+
+    printf("%-16s present: hashed %6.1f ns, linear %6.1f ns   absent: hashed %6.1f ns, linear %6.1f ns   probes %d\n",
+           aName, worstLookupNs(utilsSoftSrcMatchShortFindEntry, present, NUM_ENTRIES),
+           worstLookupNs(linearFind, present, NUM_ENTRIES),
+           worstLookupNs(utilsSoftSrcMatchShortFindEntry, absent, NUM_ENTRIES),
+           worstLookupNs(linearFind, absent, NUM_ENTRIES), maxProbes(&srcMatchShortTable));
+}
+
+static uint16_t childRloc16(int aIndex)
+{
+    // Children of router 1, as MLE assigns them.
+    return (uint16_t)(0x0400 | (aIndex + 1));
+}
+
+static uint16_t sameBucket(int aIndex)
+{
+    // Every checksum is congruent modulo the table size.
+    return (uint16_t)((aIndex + 1) * NUM_ENTRIES - PAN_ID);
+}
+
+static uint16_t sameHome(int aIndex)
+{
+    // Every checksum hashes to one slot with the initial multiplier, slot 0 for the entries and slot 1 after them.
+    static const sSrcMatchTable table = {NULL, NULL, NUM_ENTRIES, 0, SRC_MATCH_HASH_MULTIPLIER};
+    uint16_t                    home  = (aIndex < NUM_ENTRIES) ? 0 : 1;
+    int                         found = aIndex % NUM_ENTRIES;
+
+    for (uint32_t address = 0; address <= 0xffff; address++)
+    {
+        if (srcMatchTableHome(&table, (uint16_t)(address + PAN_ID)) == home && found-- == 0)
+        {
+            return (uint16_t)address;
+        }
+    }
+
+    assert(false);
+    return 0;
+}
+
+#if SRC_MATCH_REHASH_ATTEMPTS == 0
+static void testNoRoom(void)
+{
+    otPlatRadioClearSrcMatchShortEntries(NULL);
+
+    for (int i = 0; i < SRC_MATCH_MAX_PROBES; i++)
+    {
+        assert(otPlatRadioAddSrcMatchShortEntry(NULL, sameHome(i)) == OT_ERROR_NONE);
+    }
+
+    // One more entry would be too far from its home slot, and no other multiplier may be tried.
+    assert(otPlatRadioAddSrcMatchShortEntry(NULL, sameHome(SRC_MATCH_MAX_PROBES)) == OT_ERROR_NO_BUFS);
+    assert(utilsSoftSrcMatchShortFindEntry(sameHome(SRC_MATCH_MAX_PROBES)) < 0);
+    assert(srcMatchShortTable.count == SRC_MATCH_MAX_PROBES);
+    assert(srcMatchShortTable.multiplier == SRC_MATCH_HASH_MULTIPLIER);
+
+    for (int i = 0; i < SRC_MATCH_MAX_PROBES; i++)
+    {
+        assert(utilsSoftSrcMatchShortFindEntry(sameHome(i)) >= 0);
+    }
+
+    // The entries which did fit can still be cleared, and others added.
+    assert(otPlatRadioClearSrcMatchShortEntry(NULL, sameHome(0)) == OT_ERROR_NONE);
+    assert(otPlatRadioAddSrcMatchShortEntry(NULL, sameHome(SRC_MATCH_MAX_PROBES)) == OT_ERROR_NONE);
+    assert(otPlatRadioAddSrcMatchShortEntry(NULL, sameHome(NUM_ENTRIES)) == OT_ERROR_NONE);
+
+    for (int i = 1; i <= SRC_MATCH_MAX_PROBES; i++)
+    {
+        assert(utilsSoftSrcMatchShortFindEntry(sameHome(i)) >= 0);
+    }
+
+    assert(utilsSoftSrcMatchShortFindEntry(sameHome(NUM_ENTRIES)) >= 0);
+    assert(utilsSoftSrcMatchShortFindEntry(sameHome(0)) < 0);
+
+    printf("%d entries in one slot, the next one rejected\n", SRC_MATCH_MAX_PROBES);
+
+    otPlatRadioClearSrcMatchShortEntries(NULL);
+}
+#endif
+
+int main(void)
+{
+    utilsSoftSrcMatchSetPanId(PAN_ID);
+
+#if SRC_MATCH_REHASH_ATTEMPTS == 0
+    testNoRoom();
+#endif
+    testAgainstModel();
+    testExtAddresses();
+
+    printf("slowest lookup out of %d entries:\n", NUM_ENTRIES);
+    benchmark("child RLOC16s", childRloc16);
+    benchmark("one bucket", sameBucket);
+#if SRC_MATCH_REHASH_ATTEMPTS
+    benchmark("one slot", sameHome);
+
+    // Those addresses only fit with another multiplier.
+    assert(srcMatchShortTable.multiplier != SRC_MATCH_HASH_MULTIPLIER);
+#endif
+
+    return 0;
+}
@@ -104,6 +104,15 @@
 #ifndef  SPIFFS_CACHE_STATS
 #define SPIFFS_CACHE_STATS              1
 #endif
+
+// Number of data pages to read ahead when sequential reading of object data
+// is detected. When a data page misses the cache and directly follows the
+// previously read data page, up to this many of the following pages in the
+// same block are fetched into the cache along with it in one single read.
+// Only of use if the cache holds more pages than this. 0 disables read-ahead.
+#ifndef  SPIFFS_CACHE_READ_AHEAD
+#define SPIFFS_CACHE_READ_AHEAD         0
+#endif
 #endif
 
 // Always check header of each accessed page to ensure consistent state.
@@ -122,6 +131,29 @@
 #define SPIFFS_GC_STATS                 1
 #endif
 
+#if SPIFFS_GC_STATS
+// Number of buckets in the gc pause histogram. Bucket 0 counts pauses of
+// zero length, bucket n counts pauses of 2^(n-1) up to 2^n - 1 units, and
+// the last bucket also counts all longer pauses.
+#ifndef SPIFFS_GC_PAUSE_BUCKETS
+#define SPIFFS_GC_PAUSE_BUCKETS         8
+#endif
+
+// Timestamp used to measure gc pauses, in any unit. Defaults to the gc work
+// done, counted as pages moved plus blocks erased, so that a quick gc erasing
+// one block counts as 1. Define as a system tick counter to measure time.
+#ifndef SPIFFS_GC_TIME
+#define SPIFFS_GC_TIME(fs)              ((fs)->stats_gc_moved + (fs)->stats_gc_erases)
+#endif
+#endif
+
+// Number of free blocks SPIFFS_gc_step tries to keep. Writes collect
+// garbage themselves when three blocks or less are free, so by stepping
+// from idle time towards more free blocks they seldom need to.
+#ifndef SPIFFS_GC_STEP_FREE_BLOCKS
+#define SPIFFS_GC_STEP_FREE_BLOCKS      5
+#endif
+
 // Garbage collecting examines all pages in a block which and sums up
 // to a block score. Deleted pages normally gives positive score and
 // used pages normally gives a negative score (as these must be moved).
@@ -311,6 +343,30 @@
 #define SPIFFS_IX_MAP                         1
 #endif
 
+// Enable this to keep a RAM index of object index page locations and of the
+// object ids belonging to file names. Without it, looking up an object index
+// page or opening a file by name reads the object lookup pages of every
+// block, so the time taken grows with the size of the file system. With it,
+// recently found or written pages are looked up in the index, and the
+// lookup pages are only read when the index misses. Each index hit is
+// checked against the medium before it is used, so a stale entry only costs
+// a normal search.
+// The index lives in the spiffs struct and takes
+// 6 * (SPIFFS_LU_INDEX_ENTRIES + SPIFFS_LU_INDEX_NAMES) bytes.
+#ifndef SPIFFS_LU_INDEX
+#define SPIFFS_LU_INDEX                       0
+#endif
+#if SPIFFS_LU_INDEX
+// Number of object index pages remembered, must be a power of 2
+#ifndef SPIFFS_LU_INDEX_ENTRIES
+#define SPIFFS_LU_INDEX_ENTRIES               64
+#endif
+// Number of file names remembered, must be a power of 2
+#ifndef SPIFFS_LU_INDEX_NAMES
+#define SPIFFS_LU_INDEX_NAMES                 16
+#endif
+#endif
+
 // By default SPIFFS in some cases relies on the property of NOR flash that bits
 // cannot be set from 0 to 1 by writing and that controllers will ignore such
 // bit changes. This results in fewer reads as SPIFFS can in some cases perform
@@ -228,6 +228,29 @@ typedef struct {
 #endif
 } spiffs_config;
 
+#if SPIFFS_LU_INDEX
+// both tables are indexed by masking a hash
+#if (SPIFFS_LU_INDEX_ENTRIES) <= 0 || ((SPIFFS_LU_INDEX_ENTRIES) & ((SPIFFS_LU_INDEX_ENTRIES) - 1)) != 0
+#error "SPIFFS_LU_INDEX_ENTRIES must be a power of 2"
+#endif
+#if (SPIFFS_LU_INDEX_NAMES) <= 0 || ((SPIFFS_LU_INDEX_NAMES) & ((SPIFFS_LU_INDEX_NAMES) - 1)) != 0
+#error "SPIFFS_LU_INDEX_NAMES must be a power of 2"
+#endif
+
+// location of an object index page
+typedef struct {
+  spiffs_obj_id obj_id;
+  spiffs_span_ix spix;
+  spiffs_page_ix pix;
+} spiffs_lu_index_entry;
+
+// object id of a file name
+typedef struct {
+  u32_t name_hash;
+  spiffs_obj_id obj_id;
+} spiffs_lu_index_name;
+#endif
+
 typedef struct spiffs_t {
   // file system configuration
   spiffs_config cfg;
@@ -268,6 +291,13 @@ typedef struct spiffs_t {
 
 #if SPIFFS_GC_STATS
   u32_t stats_gc_runs;
+  // blocks erased by gc
+  u32_t stats_gc_erases;
+  // pages moved by gc
+  u32_t stats_gc_moved;
+  // gc pauses, in SPIFFS_GC_TIME units
+  u32_t stats_gc_pause_max;
+  u32_t stats_gc_pauses[SPIFFS_GC_PAUSE_BUCKETS];
 #endif
 
 #if SPIFFS_CACHE
@@ -278,7 +308,15 @@ typedef struct spiffs_t {
 #if SPIFFS_CACHE_STATS
   u32_t cache_hits;
   u32_t cache_misses;
+  u32_t cache_writebacks;
+#endif
 #endif
+
+#if SPIFFS_LU_INDEX
+  // object index page locations, by object id and span index
+  spiffs_lu_index_entry lu_index[SPIFFS_LU_INDEX_ENTRIES];
+  // object ids, by file name hash
+  spiffs_lu_index_name lu_index_names[SPIFFS_LU_INDEX_NAMES];
 #endif
 
   // check callback function
@@ -674,6 +712,36 @@ s32_t SPIFFS_gc_quick(spiffs *fs, u16_t max_free_pages);
  */
 s32_t SPIFFS_gc(spiffs *fs, u32_t size);
 
+/**
+ * Performs one bounded step of garbage collection. This is meant to be
+ * called repeatedly when the system is idle, so that writes seldom have to
+ * stall for garbage collection themselves.
+ * A step erases a block holding only deleted pages if there is one. Else, if
+ * less than SPIFFS_GC_STEP_FREE_BLOCKS blocks are free, it moves the used
+ * pages out of the best candidate block and erases it. At most one block is
+ * erased per step.
+ *
+ * Will set err_no to SPIFFS_OK if a block was erased,
+ * SPIFFS_ERR_NO_DELETED_BLOCKS if there was nothing to do,
+ * or other error.
+ *
+ * @param fs            the file system struct
+ */
+s32_t SPIFFS_gc_step(spiffs *fs);
+
+#if SPIFFS_GC_STATS
+/**
+ * Returns garbage collection statistics gathered since mount.
+ * @param fs            the file system struct
+ * @param runs          number of gc runs
+ * @param erases        number of blocks erased by gc
+ * @param pause_max     longest gc pause, in SPIFFS_GC_TIME units
+ * @param pauses        histogram of gc pauses, SPIFFS_GC_PAUSE_BUCKETS entries
+ */
+s32_t SPIFFS_gc_info(spiffs *fs, u32_t *runs, u32_t *erases, u32_t *pause_max,
+                     u32_t pauses[SPIFFS_GC_PAUSE_BUCKETS]);
+#endif
+
 /**
  * Check if EOF reached.
  * @param fs            the file system struct
@@ -807,6 +875,17 @@ u32_t SPIFFS_buffer_bytes_for_cache(spiffs *fs, u32_t num_pages);
 #endif
 #endif
 
+#if SPIFFS_CACHE && SPIFFS_CACHE_STATS
+/**
+ * Returns cache statistics gathered since mount.
+ * @param fs            the file system struct
+ * @param hits          number of reads served from the cache
+ * @param misses        number of reads that had to go to flash
+ * @param writebacks    number of write cache pages flushed to flash
+ */
+s32_t SPIFFS_cache_info(spiffs *fs, u32_t *hits, u32_t *misses, u32_t *writebacks);
+#endif
+
 #if SPIFFS_CACHE
 #endif
 #if defined(__cplusplus)
@@ -109,6 +109,42 @@ static spiffs_cache_page *spiffs_cache_page_allocate(spiffs *fs) {
   return 0;
 }
 
+#if SPIFFS_CACHE_READ_AHEAD
+// extends a freshly allocated read cache page with the pages following it in
+// the same block, as long as these can be put in the adjacent cache pages -
+// either free or holding other data pages - so that the whole run can be read
+// in one go. Returns number of pages in the run, including the given one.
+static u32_t spiffs_cache_read_ahead(spiffs *fs, spiffs_cache_page *cp) {
+  spiffs_cache *cache = spiffs_get_cache(fs);
+  u32_t n;
+  for (n = 1; n <= SPIFFS_CACHE_READ_AHEAD; n++) {
+    int ix = cp->ix + n;
+    spiffs_page_ix pix = cp->pix + n;
+    if (ix >= cache->cpage_count ||
+        (pix % SPIFFS_PAGES_PER_BLOCK(fs)) == 0 ||
+        spiffs_cache_page_get(fs, pix)) {
+      // out of cache pages, end of block, or rest is already cached
+      break;
+    }
+    spiffs_cache_page *ra_cp = spiffs_get_cache_page_hdr(fs, cache, ix);
+    if (cache->cpage_use_map & (1<<ix)) {
+      if ((ra_cp->flags & (SPIFFS_CACHE_FLAG_TYPE_WR | SPIFFS_CACHE_FLAG_DATA)) !=
+          SPIFFS_CACHE_FLAG_DATA) {
+        // do not throw out metadata or write cache pages for read-ahead
+        break;
+      }
+      (void)spiffs_cache_page_free(fs, ix, 1);
+    }
+    cache->cpage_use_map |= (1<<ix);
+    ra_cp->last_access = cache->last_access;
+    ra_cp->flags = SPIFFS_CACHE_FLAG_WRTHRU | SPIFFS_CACHE_FLAG_DATA;
+    ra_cp->pix = pix;
+    SPIFFS_CACHE_DBG("CACHE_ALLO: read-ahead cache page "_SPIPRIi" for pix "_SPIPRIpg "\n", ix, pix);
+  }
+  return n;
+}
+#endif
+
 // drops the cache page for give page index
 void spiffs_cache_drop_page(spiffs *fs, spiffs_page_ix pix) {
   spiffs_cache_page *cp =  spiffs_cache_page_get(fs, pix);
@@ -132,6 +168,13 @@ s32_t spiffs_phys_rd(
   spiffs_cache *cache = spiffs_get_cache(fs);
   spiffs_cache_page *cp =  spiffs_cache_page_get(fs, SPIFFS_PADDR_TO_PAGE(fs, addr));
   cache->last_access++;
+#if SPIFFS_CACHE_READ_AHEAD
+  u8_t seq_data = 0;
+  if (op == (SPIFFS_OP_T_OBJ_DA | SPIFFS_OP_C_READ)) {
+    seq_data = cache->seq_pix == SPIFFS_PADDR_TO_PAGE(fs, addr) ? 2 : 1;
+    cache->seq_pix = SPIFFS_PADDR_TO_PAGE(fs, addr) + 1;
+  }
+#endif
   if (cp) {
     // we've already got one, you see
 #if SPIFFS_CACHE_STATS
@@ -158,13 +201,29 @@ s32_t spiffs_phys_rd(
       cp->pix = SPIFFS_PADDR_TO_PAGE(fs, addr);
       SPIFFS_CACHE_DBG("CACHE_ALLO: allocated cache page "_SPIPRIi" for pix "_SPIPRIpg "\n", cp->ix, cp->pix);
 
+      u32_t pages = 1;
+#if SPIFFS_CACHE_READ_AHEAD
+      if (seq_data) {
+        cp->flags |= SPIFFS_CACHE_FLAG_DATA;
+      }
+      if (seq_data == 2) {
+        // sequential read of object data, fetch following pages as well
+        pages = spiffs_cache_read_ahead(fs, cp);
+      }
+#endif
       s32_t res2 = SPIFFS_HAL_READ(fs,
           addr - SPIFFS_PADDR_TO_PAGE_OFFSET(fs, addr),
-          SPIFFS_CFG_LOG_PAGE_SZ(fs),
+          pages * SPIFFS_CFG_LOG_PAGE_SZ(fs),
           spiffs_get_cache_page(fs, cache, cp->ix));
       if (res2 != SPIFFS_OK) {
         // honor read failure before possible write failure (bad idea?)
         res = res2;
+#if SPIFFS_CACHE_READ_AHEAD
+        // do not keep read-ahead pages of a failed read
+        while (--pages) {
+          (void)spiffs_cache_page_free(fs, cp->ix + pages, 0);
+        }
+#endif
       }
       u8_t *mem =  spiffs_get_cache_page(fs, cache, cp->ix);
       _SPIFFS_MEMCPY(dst, &mem[SPIFFS_PADDR_TO_PAGE_OFFSET(fs, addr)], len);
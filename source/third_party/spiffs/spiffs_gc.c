@@ -14,6 +14,9 @@ static s32_t spiffs_gc_erase_block(
   SPIFFS_GC_DBG("gc: erase block "_SPIPRIbl"\n", bix);
   res = spiffs_erase_block(fs, bix);
   SPIFFS_CHECK_RES(res);
+#if SPIFFS_GC_STATS
+  fs->stats_gc_erases++;
+#endif
 
 #if SPIFFS_CACHE
   {
@@ -26,6 +29,46 @@ static s32_t spiffs_gc_erase_block(
   return res;
 }
 
+#if SPIFFS_GC_STATS
+// Registers a gc pause of given length in the pause histogram
+static void spiffs_gc_pause(
+    spiffs *fs,
+    u32_t pause) {
+  u32_t bucket = 0;
+  fs->stats_gc_pause_max = MAX(fs->stats_gc_pause_max, pause);
+  while (pause && bucket < SPIFFS_GC_PAUSE_BUCKETS - 1) {
+    pause >>= 1;
+    bucket++;
+  }
+  fs->stats_gc_pauses[bucket]++;
+}
+#endif
+
+// Moves all used pages out of given block, and erases it
+static s32_t spiffs_gc_reclaim(
+    spiffs *fs,
+    spiffs_block_ix bix) {
+  s32_t res;
+#if SPIFFS_GC_STATS
+  u32_t start = SPIFFS_GC_TIME(fs);
+  fs->stats_gc_runs++;
+#endif
+  fs->cleaning = 1;
+  res = spiffs_gc_clean(fs, bix);
+  fs->cleaning = 0;
+  SPIFFS_GC_DBG("gc_reclaim: cleaning block "_SPIPRIbl", result "_SPIPRIi"\n", bix, res);
+  if (res == SPIFFS_OK) {
+    res = spiffs_gc_erase_page_stats(fs, bix);
+  }
+  if (res == SPIFFS_OK) {
+    res = spiffs_gc_erase_block(fs, bix);
+  }
+#if SPIFFS_GC_STATS
+  spiffs_gc_pause(fs, SPIFFS_GC_TIME(fs) - start);
+#endif
+  return res;
+}
+
 // Searches for blocks where all entries are deleted - if one is found,
 // the block is erased. Compared to the non-quick gc, the quick one ensures
 // that no updates are needed on existing objects on pages that are erased.
@@ -89,7 +132,13 @@ s32_t spiffs_gc_quick(
         free_pages_in_block <= max_free_pages) {
       // found a fully deleted block
       fs->stats_p_deleted -= deleted_pages_in_block;
+#if SPIFFS_GC_STATS
+      u32_t start = SPIFFS_GC_TIME(fs);
+#endif
       res = spiffs_gc_erase_block(fs, cur_block);
+#if SPIFFS_GC_STATS
+      spiffs_gc_pause(fs, SPIFFS_GC_TIME(fs) - start);
+#endif
       return res;
     }
 
@@ -147,25 +196,8 @@ s32_t spiffs_gc_check(
       SPIFFS_GC_DBG("gc_check: no candidates, return\n");
       return (s32_t)needed_pages < free_pages ? SPIFFS_OK : SPIFFS_ERR_FULL;
     }
-#if SPIFFS_GC_STATS
-    fs->stats_gc_runs++;
-#endif
     cand = cands[0];
-    fs->cleaning = 1;
-    //SPIFFS_GC_DBG("gcing: cleaning block "_SPIPRIi"\n", cand);
-    res = spiffs_gc_clean(fs, cand);
-    fs->cleaning = 0;
-    if (res < 0) {
-      SPIFFS_GC_DBG("gc_check: cleaning block "_SPIPRIi", result "_SPIPRIi"\n", cand, res);
-    } else {
-      SPIFFS_GC_DBG("gc_check: cleaning block "_SPIPRIi", result "_SPIPRIi"\n", cand, res);
-    }
-    SPIFFS_CHECK_RES(res);
-
-    res = spiffs_gc_erase_page_stats(fs, cand);
-    SPIFFS_CHECK_RES(res);
-
-    res = spiffs_gc_erase_block(fs, cand);
+    res = spiffs_gc_reclaim(fs, cand);
     SPIFFS_CHECK_RES(res);
 
     free_pages =
@@ -195,6 +227,35 @@ s32_t spiffs_gc_check(
   return res;
 }
 
+// Performs one bounded step of background gc - erases a block with only
+// deleted pages if there is one, else reclaims the best candidate block if
+// free blocks are running low
+s32_t spiffs_gc_step(
+    spiffs *fs) {
+  s32_t res;
+  spiffs_block_ix *cands;
+  int count;
+
+  res = spiffs_gc_quick(fs, 0);
+  if (res != SPIFFS_ERR_NO_DELETED_BLOCKS) {
+    return res;
+  }
+
+  if (fs->free_blocks >= SPIFFS_GC_STEP_FREE_BLOCKS || fs->stats_p_deleted == 0) {
+    // enough free blocks, or nothing to gain
+    return SPIFFS_ERR_NO_DELETED_BLOCKS;
+  }
+
+  res = spiffs_gc_find_candidate(fs, &cands, &count, 0);
+  SPIFFS_CHECK_RES(res);
+  if (count == 0) {
+    return SPIFFS_ERR_NO_DELETED_BLOCKS;
+  }
+
+  SPIFFS_GC_DBG("gc_step: reclaim block "_SPIPRIbl", free_blocks:"_SPIPRIi" pdele:"_SPIPRIi"\n", cands[0], fs->free_blocks, fs->stats_p_deleted);
+  return spiffs_gc_reclaim(fs, cands[0]);
+}
+
 // Updates page statistics for a block that is about to be erased
 s32_t spiffs_gc_erase_page_stats(
     spiffs *fs,
@@ -446,6 +507,9 @@ s32_t spiffs_gc_clean(spiffs *fs, spiffs_block_ix bix) {
               if (p_hdr.flags & SPIFFS_PH_FLAG_DELET) {
                 // move page
                 res = spiffs_page_move(fs, 0, 0, obj_id, &p_hdr, cur_pix, &new_data_pix);
+#if SPIFFS_GC_STATS
+                fs->stats_gc_moved++;
+#endif
                 SPIFFS_GC_DBG("gc_clean: MOVE_DATA move objix "_SPIPRIid":"_SPIPRIsp" page "_SPIPRIpg" to "_SPIPRIpg"\n", gc.cur_obj_id, p_hdr.span_ix, cur_pix, new_data_pix);
                 SPIFFS_CHECK_RES(res);
                 // move wipes obj_lu, reload it
@@ -489,6 +553,9 @@ s32_t spiffs_gc_clean(spiffs *fs, spiffs_block_ix bix) {
             if (p_hdr.flags & SPIFFS_PH_FLAG_DELET) {
               // move page
               res = spiffs_page_move(fs, 0, 0, obj_id, &p_hdr, cur_pix, &new_pix);
+#if SPIFFS_GC_STATS
+              fs->stats_gc_moved++;
+#endif
               SPIFFS_GC_DBG("gc_clean: MOVE_OBJIX move objix "_SPIPRIid":"_SPIPRIsp" page "_SPIPRIpg" to "_SPIPRIpg"\n", obj_id, p_hdr.span_ix, cur_pix, new_pix);
               SPIFFS_CHECK_RES(res);
               spiffs_cb_object_event(fs, (spiffs_page_object_ix *)&p_hdr,
@@ -581,6 +648,9 @@ s32_t spiffs_gc_clean(spiffs *fs, spiffs_block_ix bix) {
       } else {
         // store object index page
         res = spiffs_page_move(fs, 0, fs->work, gc.cur_obj_id | SPIFFS_OBJ_ID_IX_FLAG, 0, gc.cur_objix_pix, &new_objix_pix);
+#if SPIFFS_GC_STATS
+        fs->stats_gc_moved++;
+#endif
         SPIFFS_GC_DBG("gc_clean: MOVE_DATA store modified objix page, "_SPIPRIpg":"_SPIPRIsp"\n", new_objix_pix, objix->p_hdr.span_ix);
         SPIFFS_CHECK_RES(res);
         spiffs_cb_object_event(fs, (spiffs_page_object_ix *)fs->work,
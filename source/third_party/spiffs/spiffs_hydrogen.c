@@ -523,6 +523,9 @@ s32_t SPIFFS_write(spiffs *fs, spiffs_file fh, void *buf, s32_t len) {
           res = spiffs_hydro_write(fs, fd,
               spiffs_get_cache_page(fs, spiffs_get_cache(fs), fd->cache_page->ix),
               fd->cache_page->offset, fd->cache_page->size);
+#if SPIFFS_CACHE_STATS
+          fs->cache_writebacks++;
+#endif
           spiffs_cache_fd_release(fs, fd->cache_page);
           SPIFFS_API_CHECK_RES_UNLOCK(fs, res);
         } else {
@@ -580,6 +583,9 @@ s32_t SPIFFS_write(spiffs *fs, spiffs_file fh, void *buf, s32_t len) {
         res = spiffs_hydro_write(fs, fd,
             spiffs_get_cache_page(fs, spiffs_get_cache(fs), fd->cache_page->ix),
             fd->cache_page->offset, fd->cache_page->size);
+#if SPIFFS_CACHE_STATS
+        fs->cache_writebacks++;
+#endif
         spiffs_cache_fd_release(fs, fd->cache_page);
         SPIFFS_API_CHECK_RES_UNLOCK(fs, res);
         // data written below
@@ -937,6 +943,9 @@ static s32_t spiffs_fflush_cache(spiffs *fs, spiffs_file fh) {
       if (res < SPIFFS_OK) {
         fs->err_code = res;
       }
+#if SPIFFS_CACHE_STATS
+      fs->cache_writebacks++;
+#endif
       spiffs_cache_fd_release(fs, fd->cache_page);
     }
   }
@@ -1259,6 +1268,30 @@ s32_t SPIFFS_info(spiffs *fs, u32_t *total, u32_t *used) {
   return res;
 }
 
+#if SPIFFS_CACHE && SPIFFS_CACHE_STATS
+s32_t SPIFFS_cache_info(spiffs *fs, u32_t *hits, u32_t *misses, u32_t *writebacks) {
+  SPIFFS_API_DBG("%s\n", __func__);
+  SPIFFS_API_CHECK_CFG(fs);
+  SPIFFS_API_CHECK_MOUNT(fs);
+  SPIFFS_LOCK(fs);
+
+  if (hits) {
+    *hits = fs->cache_hits;
+  }
+
+  if (misses) {
+    *misses = fs->cache_misses;
+  }
+
+  if (writebacks) {
+    *writebacks = fs->cache_writebacks;
+  }
+
+  SPIFFS_UNLOCK(fs);
+  return SPIFFS_OK;
+}
+#endif
+
 s32_t SPIFFS_gc_quick(spiffs *fs, u16_t max_free_pages) {
   SPIFFS_API_DBG("%s "_SPIPRIi "\n", __func__, max_free_pages);
 #if SPIFFS_READ_ONLY
@@ -1298,6 +1331,54 @@ s32_t SPIFFS_gc(spiffs *fs, u32_t size) {
 #endif // SPIFFS_READ_ONLY
 }
 
+s32_t SPIFFS_gc_step(spiffs *fs) {
+  SPIFFS_API_DBG("%s\n", __func__);
+#if SPIFFS_READ_ONLY
+  (void)fs;
+  return SPIFFS_ERR_RO_NOT_IMPL;
+#else
+  s32_t res;
+  SPIFFS_API_CHECK_CFG(fs);
+  SPIFFS_API_CHECK_MOUNT(fs);
+  SPIFFS_LOCK(fs);
+
+  res = spiffs_gc_step(fs);
+
+  SPIFFS_API_CHECK_RES_UNLOCK(fs, res);
+  SPIFFS_UNLOCK(fs);
+  return 0;
+#endif // SPIFFS_READ_ONLY
+}
+
+#if SPIFFS_GC_STATS
+s32_t SPIFFS_gc_info(spiffs *fs, u32_t *runs, u32_t *erases, u32_t *pause_max,
+                     u32_t pauses[SPIFFS_GC_PAUSE_BUCKETS]) {
+  SPIFFS_API_DBG("%s\n", __func__);
+  SPIFFS_API_CHECK_CFG(fs);
+  SPIFFS_API_CHECK_MOUNT(fs);
+  SPIFFS_LOCK(fs);
+
+  if (runs) {
+    *runs = fs->stats_gc_runs;
+  }
+
+  if (erases) {
+    *erases = fs->stats_gc_erases;
+  }
+
+  if (pause_max) {
+    *pause_max = fs->stats_gc_pause_max;
+  }
+
+  if (pauses) {
+    _SPIFFS_MEMCPY(pauses, fs->stats_gc_pauses, sizeof(fs->stats_gc_pauses));
+  }
+
+  SPIFFS_UNLOCK(fs);
+  return SPIFFS_OK;
+}
+#endif
+
 s32_t SPIFFS_eof(spiffs *fs, spiffs_file fh) {
   SPIFFS_API_DBG("%s "_SPIPRIfd "\n", __func__, fh);
   s32_t res;
@@ -522,6 +522,101 @@ static s32_t spiffs_obj_lu_find_id_and_span_v(
   }
 }
 
+#if SPIFFS_LU_INDEX
+static u32_t spiffs_hash(spiffs *fs, const u8_t *name);
+
+// Returns the lookup index slot for given object id and span index
+static spiffs_lu_index_entry *spiffs_lu_index_slot(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_span_ix spix) {
+  obj_id &= ~SPIFFS_OBJ_ID_IX_FLAG;
+  return &fs->lu_index[(obj_id * 31 + spix) & (SPIFFS_LU_INDEX_ENTRIES - 1)];
+}
+
+// Remembers where object index page with given object id and span index is
+static void spiffs_lu_index_set(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_span_ix spix,
+    spiffs_page_ix pix) {
+  spiffs_lu_index_entry *e = spiffs_lu_index_slot(fs, obj_id, spix);
+  e->obj_id = obj_id & ~SPIFFS_OBJ_ID_IX_FLAG;
+  e->spix = spix;
+  e->pix = pix;
+}
+
+// Forgets object index page with given object id and span index
+static void spiffs_lu_index_remove(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_span_ix spix) {
+  spiffs_lu_index_entry *e = spiffs_lu_index_slot(fs, obj_id, spix);
+  if (e->obj_id == (obj_id & ~SPIFFS_OBJ_ID_IX_FLAG) && e->spix == spix) {
+    e->pix = 0;
+  }
+}
+
+// Looks up object index page with given object id and span index in the
+// lookup index only. A hit is checked against the object lookup entry and the
+// page header, just as spiffs_obj_lu_find_id_and_span would do when scanning.
+static s32_t spiffs_lu_index_get(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_span_ix spix,
+    spiffs_page_ix exclusion_pix,
+    spiffs_page_ix *pix) {
+  s32_t res;
+  spiffs_obj_id lu_obj_id;
+  spiffs_block_ix bix;
+  int entry;
+  spiffs_lu_index_entry *e = spiffs_lu_index_slot(fs, obj_id, spix);
+
+  // page 0 is always an object lookup page, so 0 marks an unused entry
+  if (e->pix == 0 || e->obj_id != (obj_id & ~SPIFFS_OBJ_ID_IX_FLAG) || e->spix != spix) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  bix = SPIFFS_BLOCK_FOR_PAGE(fs, e->pix);
+  entry = SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, e->pix);
+  if (bix >= fs->block_count) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+
+  res = _spiffs_rd(fs, SPIFFS_OP_T_OBJ_LU | SPIFFS_OP_C_READ,
+      0, SPIFFS_BLOCK_TO_PADDR(fs, bix) + entry * sizeof(spiffs_obj_id), sizeof(spiffs_obj_id), (u8_t*)&lu_obj_id);
+  SPIFFS_CHECK_RES(res);
+  if (lu_obj_id != obj_id) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  res = spiffs_obj_lu_find_id_and_span_v(fs, obj_id, bix, entry,
+      exclusion_pix ? &exclusion_pix : 0, &spix);
+  if (res == SPIFFS_VIS_COUNTINUE) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  SPIFFS_CHECK_RES(res);
+
+  if (pix) {
+    *pix = e->pix;
+  }
+
+  fs->cursor_block_ix = bix;
+  fs->cursor_obj_lu_entry = entry;
+
+  return res;
+}
+
+// Remembers the object id of given file name
+static void spiffs_lu_index_set_name(
+    spiffs *fs,
+    const u8_t *name,
+    spiffs_obj_id obj_id) {
+  u32_t name_hash = spiffs_hash(fs, name);
+  spiffs_lu_index_name *n = &fs->lu_index_names[name_hash & (SPIFFS_LU_INDEX_NAMES - 1)];
+  n->name_hash = name_hash;
+  n->obj_id = obj_id & ~SPIFFS_OBJ_ID_IX_FLAG;
+}
+#endif // SPIFFS_LU_INDEX
+
 // Find object lookup entry containing given id and span index
 // Iterate over object lookup pages in each block until a given object id entry is found
 s32_t spiffs_obj_lu_find_id_and_span(
@@ -534,6 +629,15 @@ s32_t spiffs_obj_lu_find_id_and_span(
   spiffs_block_ix bix;
   int entry;
 
+#if SPIFFS_LU_INDEX
+  if (obj_id & SPIFFS_OBJ_ID_IX_FLAG) {
+    res = spiffs_lu_index_get(fs, obj_id, spix, exclusion_pix, pix);
+    if (res != SPIFFS_ERR_NOT_FOUND) {
+      return res;
+    }
+  }
+#endif
+
   res = spiffs_obj_lu_find_entry_visitor(fs,
       fs->cursor_block_ix,
       fs->cursor_obj_lu_entry,
@@ -558,6 +662,12 @@ s32_t spiffs_obj_lu_find_id_and_span(
   fs->cursor_block_ix = bix;
   fs->cursor_obj_lu_entry = entry;
 
+#if SPIFFS_LU_INDEX
+  if (obj_id & SPIFFS_OBJ_ID_IX_FLAG) {
+    spiffs_lu_index_set(fs, obj_id, spix, SPIFFS_OBJ_LOOKUP_ENTRY_TO_PIX(fs, bix, entry));
+  }
+#endif
+
   return res;
 }
 
@@ -1048,7 +1158,7 @@ void spiffs_cb_object_event(
     spiffs_span_ix spix,
     spiffs_page_ix new_pix,
     u32_t new_size) {
-#if SPIFFS_IX_MAP == 0
+#if SPIFFS_IX_MAP == 0 && SPIFFS_LU_INDEX == 0
   (void)objix;
 #endif
   // update index caches in all file descriptors
@@ -1133,6 +1243,18 @@ void spiffs_cb_object_event(
 
 #endif
 
+#if SPIFFS_LU_INDEX
+  // update lookup index
+  if (ev == SPIFFS_EV_IX_DEL) {
+    spiffs_lu_index_remove(fs, obj_id, spix);
+  } else {
+    spiffs_lu_index_set(fs, obj_id, spix, new_pix);
+    if (spix == 0 && objix && (ev == SPIFFS_EV_IX_NEW || ev == SPIFFS_EV_IX_UPD_HDR)) {
+      spiffs_lu_index_set_name(fs, ((spiffs_page_object_ix_header *)objix)->name, obj_id);
+    }
+  }
+#endif
+
   // callback to user if object index header
   if (fs->file_cb_f && spix == 0 && (obj_id_raw & SPIFFS_OBJ_ID_IX_FLAG)) {
     spiffs_fileop_type op;
@@ -1689,6 +1811,38 @@ static s32_t spiffs_object_find_object_index_header_by_name_v(
   return SPIFFS_VIS_COUNTINUE;
 }
 
+#if SPIFFS_LU_INDEX
+// Looks up object index header page of given file name in the lookup index
+// only. A hit is checked just as when scanning.
+static s32_t spiffs_lu_index_get_name(
+    spiffs *fs,
+    const u8_t name[SPIFFS_OBJ_NAME_LEN],
+    spiffs_page_ix *pix) {
+  s32_t res;
+  spiffs_page_ix objix_hdr_pix;
+  u32_t name_hash = spiffs_hash(fs, name);
+  spiffs_lu_index_name *n = &fs->lu_index_names[name_hash & (SPIFFS_LU_INDEX_NAMES - 1)];
+
+  if (n->obj_id == 0 || n->name_hash != name_hash) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  res = spiffs_lu_index_get(fs, n->obj_id | SPIFFS_OBJ_ID_IX_FLAG, 0, 0, &objix_hdr_pix);
+  SPIFFS_CHECK_RES(res);
+  res = spiffs_object_find_object_index_header_by_name_v(fs, n->obj_id | SPIFFS_OBJ_ID_IX_FLAG,
+      SPIFFS_BLOCK_FOR_PAGE(fs, objix_hdr_pix), SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, objix_hdr_pix),
+      name, 0);
+  if (res == SPIFFS_VIS_COUNTINUE) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  SPIFFS_CHECK_RES(res);
+
+  if (pix) {
+    *pix = objix_hdr_pix;
+  }
+  return res;
+}
+#endif // SPIFFS_LU_INDEX
+
 // Finds object index header page by name
 s32_t spiffs_object_find_object_index_header_by_name(
     spiffs *fs,
@@ -1698,6 +1852,13 @@ s32_t spiffs_object_find_object_index_header_by_name(
   spiffs_block_ix bix;
   int entry;
 
+#if SPIFFS_LU_INDEX
+  res = spiffs_lu_index_get_name(fs, name, pix);
+  if (res != SPIFFS_ERR_NOT_FOUND) {
+    return res;
+  }
+#endif
+
   res = spiffs_obj_lu_find_entry_visitor(fs,
       fs->cursor_block_ix,
       fs->cursor_obj_lu_entry,
@@ -1721,6 +1882,17 @@ s32_t spiffs_object_find_object_index_header_by_name(
   fs->cursor_block_ix = bix;
   fs->cursor_obj_lu_entry = entry;
 
+#if SPIFFS_LU_INDEX
+  {
+    spiffs_obj_id obj_id;
+    res = _spiffs_rd(fs, SPIFFS_OP_T_OBJ_LU | SPIFFS_OP_C_READ,
+        0, SPIFFS_BLOCK_TO_PADDR(fs, bix) + entry * sizeof(spiffs_obj_id), sizeof(spiffs_obj_id), (u8_t*)&obj_id);
+    SPIFFS_CHECK_RES(res);
+    spiffs_lu_index_set(fs, obj_id, 0, SPIFFS_OBJ_LOOKUP_ENTRY_TO_PIX(fs, bix, entry));
+    spiffs_lu_index_set_name(fs, name, obj_id);
+  }
+#endif
+
   return res;
 }
 
@@ -2227,7 +2399,7 @@ s32_t spiffs_obj_lu_find_free_obj_id(spiffs *fs, spiffs_obj_id *obj_id, const u8
 }
 #endif // !SPIFFS_READ_ONLY
 
-#if SPIFFS_TEMPORAL_FD_CACHE
+#if SPIFFS_TEMPORAL_FD_CACHE || SPIFFS_LU_INDEX
 // djb2 hash
 static u32_t spiffs_hash(spiffs *fs, const u8_t *name) {
   (void)fs;
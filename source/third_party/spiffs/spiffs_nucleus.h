@@ -391,11 +391,14 @@
 #define spiffs_get_cache(fs) \
   ((spiffs_cache *)((fs)->cache))
 
+// all cache page headers are kept ahead of the cache page memory, so that the
+// memory of adjacent cache pages is contiguous and can be read in one go
 #define spiffs_get_cache_page_hdr(fs, c, ix) \
-  ((spiffs_cache_page *)(&((c)->cpages[(ix) * SPIFFS_CACHE_PAGE_SIZE(fs)])))
+  ((spiffs_cache_page *)(&((c)->cpages[(ix) * sizeof(spiffs_cache_page)])))
 
 #define spiffs_get_cache_page(fs, c, ix) \
-  ((u8_t *)(&((c)->cpages[(ix) * SPIFFS_CACHE_PAGE_SIZE(fs)])) + sizeof(spiffs_cache_page))
+  ((u8_t *)(&((c)->cpages[(c)->cpage_count * sizeof(spiffs_cache_page) + \
+                          (ix) * SPIFFS_CFG_LOG_PAGE_SZ(fs)])))
 
 // cache page struct
 typedef struct {
@@ -432,6 +435,10 @@ typedef struct {
   u32_t cpage_use_map;
   u32_t cpage_use_mask;
   u8_t *cpages;
+#if SPIFFS_CACHE_READ_AHEAD
+  // page following the last read data page
+  spiffs_page_ix seq_pix;
+#endif
 } spiffs_cache;
 
 #endif
@@ -763,6 +770,9 @@ s32_t spiffs_gc_clean(
 s32_t spiffs_gc_quick(
     spiffs *fs, u16_t max_free_pages);
 
+s32_t spiffs_gc_step(
+    spiffs *fs);
+
 // ---------------
 
 s32_t spiffs_fd_find_new(
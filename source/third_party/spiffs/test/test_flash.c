@@ -0,0 +1,95 @@
+/*
+ * test_flash.c
+ *
+ * RAM flash for the spiffs host tests.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_flash.h"
+#include "spiffs_nucleus.h"
+
+#define TEST_PAGE_SIZE 256
+#define TEST_FDS       24
+
+u32_t test_flash_reads;
+u32_t test_flash_erases;
+
+static u8_t *flash;
+static test_flash_cfg flash_cfg;
+static u8_t work[2 * TEST_PAGE_SIZE];
+static u32_t fds[TEST_FDS * sizeof(spiffs_fd) / sizeof(u32_t) + 1];
+static u32_t *cache;
+
+// spiffs_config.h locks through the SPIFFSNVS port
+void SPIFFSNVS_lock(void *fs) {
+  (void)fs;
+}
+
+void SPIFFSNVS_unlock(void *fs) {
+  (void)fs;
+}
+
+static s32_t test_flash_read(struct spiffs_t *fs, u32_t addr, u32_t size, u8_t *dst) {
+  (void)fs;
+  test_flash_reads++;
+  memcpy(dst, &flash[addr], size);
+  return SPIFFS_OK;
+}
+
+static s32_t test_flash_write(struct spiffs_t *fs, u32_t addr, u32_t size, u8_t *src) {
+  u32_t i;
+  (void)fs;
+  for (i = 0; i < size; i++) {
+    // NOR flash only clears bits
+    flash[addr + i] &= src[i];
+  }
+  return SPIFFS_OK;
+}
+
+static s32_t test_flash_erase(struct spiffs_t *fs, u32_t addr, u32_t size) {
+  (void)fs;
+  test_flash_erases++;
+  memset(&flash[addr], 0xff, size);
+  return SPIFFS_OK;
+}
+
+int test_flash_mount(spiffs *fs) {
+  spiffs_config cfg;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.hal_read_f = test_flash_read;
+  cfg.hal_write_f = test_flash_write;
+  cfg.hal_erase_f = test_flash_erase;
+  cfg.phys_size = flash_cfg.size;
+  cfg.phys_addr = 0;
+  cfg.phys_erase_block = flash_cfg.block_size;
+  cfg.log_block_size = flash_cfg.block_size;
+  cfg.log_page_size = TEST_PAGE_SIZE;
+
+  free(cache);
+  cache = malloc(flash_cfg.cache_size);
+  return SPIFFS_mount(fs, &cfg, work, (u8_t *)fds, sizeof(fds),
+                      cache, flash_cfg.cache_size, 0);
+}
+
+int test_flash_format(spiffs *fs, const test_flash_cfg *cfg) {
+  int res;
+
+  flash_cfg = *cfg;
+  free(flash);
+  flash = malloc(cfg->size);
+  memset(flash, 0xff, cfg->size);
+
+  // spiffs has to be mounted once, failing, before it can be formatted
+  res = test_flash_mount(fs);
+  if (res == SPIFFS_OK) {
+    SPIFFS_unmount(fs);
+  }
+  res = SPIFFS_format(fs);
+  if (res != SPIFFS_OK) {
+    return res;
+  }
+  return test_flash_mount(fs);
+}
@@ -0,0 +1,29 @@
+/*
+ * test_flash.h
+ *
+ * RAM flash for the spiffs host tests. Counts HAL reads and erases so that
+ * builds with different options can be compared.
+ */
+
+#ifndef TEST_FLASH_H_
+#define TEST_FLASH_H_
+
+#include "spiffs.h"
+
+typedef struct {
+  u32_t size;
+  u32_t block_size;
+  u32_t cache_size;   // bytes
+} test_flash_cfg;
+
+// HAL calls made so far
+extern u32_t test_flash_reads;
+extern u32_t test_flash_erases;
+
+// Allocates an erased flash and formats a file system on it
+int test_flash_format(spiffs *fs, const test_flash_cfg *cfg);
+
+// Mounts the file system on the flash given to test_flash_format
+int test_flash_mount(spiffs *fs);
+
+#endif /* TEST_FLASH_H_ */
@@ -0,0 +1,167 @@
+/*
+ * test_spiffs_gc_step.c
+ *
+ * Host test of SPIFFS_gc_step and the gc pause statistics.
+ *
+ * Runs a log workload of appends and removes over 12 files on a 512 KB flash
+ * with 16 KB blocks, checking every file against a RAM model and running
+ * SPIFFS_check and a remount every 2000 operations. SPIFFS_gc_step is called
+ * every fourth operation, or not at all when built with TEST_NO_STEPS. Prints
+ * how many writes had to collect garbage themselves, and the gc statistics.
+ * Every gc pause, including a quick gc erasing a single block, has to count
+ * at least one unit of SPIFFS_GC_TIME.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_flash.h"
+
+#define TEST_FILES     12
+#define TEST_FILE_MAX  24000
+#define TEST_OPS       20000
+
+static spiffs fs;
+static u8_t *model[TEST_FILES];
+static s32_t model_size[TEST_FILES];
+static char names[TEST_FILES][SPIFFS_OBJ_NAME_LEN];
+
+static int test_verify(void) {
+  int k;
+
+  for (k = 0; k < TEST_FILES; k++) {
+    spiffs_file fh;
+    u8_t *buf;
+    int res;
+
+    if (!model[k]) {
+      continue;
+    }
+    buf = malloc(model_size[k]);
+    fh = SPIFFS_open(&fs, names[k], SPIFFS_RDONLY, 0);
+    res = fh < 0 || SPIFFS_read(&fs, fh, buf, model_size[k]) != model_size[k] ||
+          memcmp(buf, model[k], model_size[k]) != 0;
+    SPIFFS_close(&fs, fh);
+    free(buf);
+    if (res) {
+      printf("%s differs\n", names[k]);
+      return -1;
+    }
+  }
+  return SPIFFS_check(&fs);
+}
+
+int main(void) {
+  test_flash_cfg cfg = { 512 * 1024, 16384, 4096 };
+  u32_t stalls = 0, stall_max = 0, steps = 0;
+  u32_t runs, erases, pause_max, pauses[SPIFFS_GC_PAUSE_BUCKETS];
+  u32_t total = 0;
+  int it;
+  int k;
+
+  if (test_flash_format(&fs, &cfg) != SPIFFS_OK) {
+    printf("format failed\n");
+    return 1;
+  }
+
+  srand(1);
+  for (k = 0; k < TEST_FILES; k++) {
+    sprintf(names[k], "log%02d", k);
+  }
+
+  for (it = 0; it < TEST_OPS; it++) {
+    int op = rand() % 10;
+
+    k = rand() % TEST_FILES;
+    if (op < 7 && model_size[k] + 600 <= TEST_FILE_MAX) {
+      s32_t len = 1 + rand() % 600;
+      u8_t *buf = malloc(len);
+      u32_t start = SPIFFS_GC_TIME(&fs);
+      spiffs_file fh;
+      s32_t i;
+
+      for (i = 0; i < len; i++) {
+        buf[i] = (u8_t)rand();
+      }
+      fh = SPIFFS_open(&fs, names[k], SPIFFS_CREAT | SPIFFS_APPEND | SPIFFS_RDWR, 0);
+      if (fh < 0 || SPIFFS_write(&fs, fh, buf, len) != len ||
+          SPIFFS_close(&fs, fh) != SPIFFS_OK) {
+        printf("append to %s failed, err %d\n", names[k], SPIFFS_errno(&fs));
+        return 1;
+      }
+      if (SPIFFS_GC_TIME(&fs) != start) {
+        // this write collected garbage itself
+        stalls++;
+        stall_max = SPIFFS_GC_TIME(&fs) - start > stall_max ?
+                    SPIFFS_GC_TIME(&fs) - start : stall_max;
+      }
+
+      model[k] = realloc(model[k], model_size[k] + len);
+      memcpy(&model[k][model_size[k]], buf, len);
+      model_size[k] += len;
+      free(buf);
+    } else if (model[k] && rand() % 3 == 0) {
+      if (SPIFFS_remove(&fs, names[k]) != SPIFFS_OK) {
+        printf("remove of %s failed, err %d\n", names[k], SPIFFS_errno(&fs));
+        return 1;
+      }
+      free(model[k]);
+      model[k] = NULL;
+      model_size[k] = 0;
+    }
+
+#ifndef TEST_NO_STEPS
+    if (it % 4 == 0) {
+      s32_t res = SPIFFS_gc_step(&fs);
+
+      if (res == SPIFFS_OK) {
+        steps++;
+      } else if (res != SPIFFS_ERR_NO_DELETED_BLOCKS) {
+        printf("gc step failed, err %d\n", res);
+        return 1;
+      }
+    }
+#endif
+
+    if (it % 2000 == 1999) {
+      if (test_verify() != 0) {
+        return 1;
+      }
+      if (it == TEST_OPS - 1) {
+        break;
+      }
+      SPIFFS_unmount(&fs);
+      if (test_flash_mount(&fs) != SPIFFS_OK) {
+        printf("remount failed\n");
+        return 1;
+      }
+    }
+  }
+
+  // statistics since the last remount
+  SPIFFS_gc_info(&fs, &runs, &erases, &pause_max, pauses);
+  for (k = 0; k < SPIFFS_GC_PAUSE_BUCKETS; k++) {
+    total += pauses[k];
+  }
+  // every gc pause erases one block
+  if (pauses[0] != 0 || total != erases || (erases > 0 && pause_max == 0)) {
+    printf("gc pauses not counted, %u erases, %u pauses, %u of no length\n", erases, total, pauses[0]);
+    return 1;
+  }
+
+  printf("%s: %u writes collected garbage, worst %u units, %u steps\n",
+#ifdef TEST_NO_STEPS
+         "no steps",
+#else
+         "steps",
+#endif
+         stalls, stall_max, steps);
+  printf("  last 2000 operations: %u gc runs, %u erases, longest pause %u units, pauses",
+         runs, erases, pause_max);
+  for (k = 0; k < SPIFFS_GC_PAUSE_BUCKETS; k++) {
+    printf(" %u", pauses[k]);
+  }
+  printf("\n");
+  return 0;
+}
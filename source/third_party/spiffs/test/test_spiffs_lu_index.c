@@ -0,0 +1,150 @@
+/*
+ * test_spiffs_lu_index.c
+ *
+ * Host test of the object index lookup index (SPIFFS_LU_INDEX).
+ *
+ * Keeps a 1 MB image and up to 23 small files on a 4 MB flash and runs random
+ * writes, renames, removes, opens and seek+reads against a RAM model of the
+ * file contents, with SPIFFS_check and remounts along the way. Fails on the
+ * first difference. Built with SPIFFS_LU_INDEX 0 and 1, and prints the HAL
+ * reads each open and each seek+read costs so that the builds can be compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_flash.h"
+
+#define TEST_FILES     24
+#define TEST_IMAGE_SZ  (1024 * 1024)
+#define TEST_OPS       3000
+#define TEST_READ_SZ   64
+
+static spiffs fs;
+static u8_t *model[TEST_FILES];
+static s32_t model_size[TEST_FILES];
+static char names[TEST_FILES][SPIFFS_OBJ_NAME_LEN];
+
+static u32_t open_reads, opens;
+static u32_t seek_reads, seeks;
+
+static int test_write(int k) {
+  // file 0 is the image, written once
+  s32_t size = k == 0 ? TEST_IMAGE_SZ + rand() % 4096 : 1 + rand() % 8000;
+  u8_t *buf = malloc(size);
+  spiffs_file fh;
+  s32_t i;
+
+  for (i = 0; i < size; i++) {
+    buf[i] = (u8_t)rand();
+  }
+  fh = SPIFFS_open(&fs, names[k], SPIFFS_CREAT | SPIFFS_TRUNC | SPIFFS_RDWR, 0);
+  if (fh < 0 || SPIFFS_write(&fs, fh, buf, size) != size ||
+      SPIFFS_close(&fs, fh) != SPIFFS_OK) {
+    printf("write of %s failed, err %d\n", names[k], SPIFFS_errno(&fs));
+    return -1;
+  }
+  free(model[k]);
+  model[k] = buf;
+  model_size[k] = size;
+  return 0;
+}
+
+static int test_read(int k) {
+  u8_t buf[TEST_READ_SZ];
+  u32_t reads = test_flash_reads;
+  spiffs_file fh;
+  int i;
+
+  fh = SPIFFS_open(&fs, names[k], SPIFFS_RDONLY, 0);
+  open_reads += test_flash_reads - reads;
+  opens++;
+  if (fh < 0) {
+    printf("open of %s failed, err %d\n", names[k], SPIFFS_errno(&fs));
+    return -1;
+  }
+
+  for (i = 0; i < 4; i++) {
+    s32_t offs = rand() % model_size[k];
+    s32_t len = model_size[k] - offs < TEST_READ_SZ ? model_size[k] - offs : TEST_READ_SZ;
+
+    reads = test_flash_reads;
+    if (SPIFFS_lseek(&fs, fh, offs, SPIFFS_SEEK_SET) != offs ||
+        SPIFFS_read(&fs, fh, buf, len) != len) {
+      printf("read of %s failed, err %d\n", names[k], SPIFFS_errno(&fs));
+      return -1;
+    }
+    seek_reads += test_flash_reads - reads;
+    seeks++;
+    if (memcmp(buf, &model[k][offs], len) != 0) {
+      printf("%s differs at %d\n", names[k], offs);
+      return -1;
+    }
+  }
+
+  return SPIFFS_close(&fs, fh);
+}
+
+int main(void) {
+  test_flash_cfg cfg = { 4 * 1024 * 1024, 65536, 4096 };
+  int it;
+  int k;
+
+  if (test_flash_format(&fs, &cfg) != SPIFFS_OK) {
+    printf("format failed\n");
+    return 1;
+  }
+
+  srand(1);
+  for (k = 0; k < TEST_FILES; k++) {
+    sprintf(names[k], "file%02d", k);
+  }
+
+  for (it = 0; it < TEST_OPS; it++) {
+    int op = rand() % 10;
+    int res = 0;
+
+    k = rand() % TEST_FILES;
+    if (op < 3) {
+      if (k != 0 || !model[0]) {
+        res = test_write(k);
+      }
+    } else if (op < 8) {
+      if (model[k]) {
+        res = test_read(k);
+      }
+    } else if (op < 9) {
+      if (model[k] && k != 0) {
+        res = SPIFFS_remove(&fs, names[k]);
+        free(model[k]);
+        model[k] = NULL;
+      }
+    } else {
+      int to = 1 + rand() % (TEST_FILES - 1);
+
+      if (model[k] && k != 0 && !model[to]) {
+        res = SPIFFS_rename(&fs, names[k], names[to]);
+        model[to] = model[k];
+        model_size[to] = model_size[k];
+        model[k] = NULL;
+      }
+    }
+
+    if (it % 500 == 250) {
+      res |= SPIFFS_check(&fs);
+    } else if (it % 500 == 499) {
+      SPIFFS_unmount(&fs);
+      res |= test_flash_mount(&fs);
+    }
+
+    if (res != 0) {
+      printf("operation %d failed, err %d\n", it, SPIFFS_errno(&fs));
+      return 1;
+    }
+  }
+
+  printf("SPIFFS_LU_INDEX %d: %.1f reads per open, %.1f reads per seek+read\n",
+         SPIFFS_LU_INDEX, (double)open_reads / opens, (double)seek_reads / seeks);
+  return 0;
+}
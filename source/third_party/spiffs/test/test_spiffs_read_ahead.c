@@ -0,0 +1,124 @@
+/*
+ * test_spiffs_read_ahead.c
+ *
+ * Host test of cache read-ahead (SPIFFS_CACHE_READ_AHEAD).
+ *
+ * Writes a 1 MB image between small files on a 4 MB flash, then streams it
+ * back and compares it with a RAM copy. Parts of the image are then rewritten
+ * in place and it is streamed and compared again, so that pages read ahead
+ * before a write cannot be served after it. Built with SPIFFS_CACHE_READ_AHEAD
+ * 0 and 4, and prints the HAL reads each stream costs and the cache counters
+ * so that the builds can be compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_flash.h"
+
+#define TEST_IMAGE_SZ  (1024 * 1024)
+#define TEST_SMALL     8
+#define TEST_CHUNK     4096
+#define TEST_REWRITES  64
+
+static spiffs fs;
+static u8_t *image;
+
+static int test_write_file(const char *name, s32_t offs, const u8_t *buf, s32_t size) {
+  spiffs_file fh = SPIFFS_open(&fs, name, SPIFFS_CREAT | SPIFFS_RDWR, 0);
+
+  if (fh < 0 || SPIFFS_lseek(&fs, fh, offs, SPIFFS_SEEK_SET) != offs ||
+      SPIFFS_write(&fs, fh, (void *)buf, size) != size ||
+      SPIFFS_close(&fs, fh) != SPIFFS_OK) {
+    printf("write of %s failed, err %d\n", name, SPIFFS_errno(&fs));
+    return -1;
+  }
+  return 0;
+}
+
+static int test_stream(const char *what) {
+  static u8_t buf[TEST_CHUNK];
+  u32_t reads = test_flash_reads;
+  spiffs_file fh = SPIFFS_open(&fs, "image", SPIFFS_RDONLY, 0);
+  s32_t offs = 0;
+  s32_t len;
+
+  if (fh < 0) {
+    printf("open failed, err %d\n", SPIFFS_errno(&fs));
+    return -1;
+  }
+  while ((len = SPIFFS_read(&fs, fh, buf, sizeof(buf))) > 0) {
+    if (memcmp(buf, &image[offs], len) != 0) {
+      printf("%s: image differs at %d\n", what, offs);
+      return -1;
+    }
+    offs += len;
+  }
+  SPIFFS_close(&fs, fh);
+  if (offs != TEST_IMAGE_SZ) {
+    printf("%s: read %d of %d bytes\n", what, offs, TEST_IMAGE_SZ);
+    return -1;
+  }
+
+  printf("  %s: %u HAL reads\n", what, test_flash_reads - reads);
+  return 0;
+}
+
+int main(void) {
+  test_flash_cfg cfg = { 4 * 1024 * 1024, 65536, 4096 };
+  u8_t small[512];
+  char name[16];
+  s32_t offs;
+  u32_t hits, misses, writebacks;
+  int i;
+
+  if (test_flash_format(&fs, &cfg) != SPIFFS_OK) {
+    printf("format failed\n");
+    return 1;
+  }
+
+  srand(1);
+  image = malloc(TEST_IMAGE_SZ);
+  for (i = 0; i < TEST_IMAGE_SZ; i++) {
+    image[i] = (u8_t)rand();
+  }
+  memset(small, 0x5a, sizeof(small));
+
+  // Image written in pieces, with small files landing between them
+  for (offs = 0; offs < TEST_IMAGE_SZ; offs += TEST_IMAGE_SZ / TEST_SMALL) {
+    sprintf(name, "small%d", offs / (TEST_IMAGE_SZ / TEST_SMALL));
+    if (test_write_file("image", offs, &image[offs], TEST_IMAGE_SZ / TEST_SMALL) ||
+        test_write_file(name, 0, small, sizeof(small))) {
+      return 1;
+    }
+  }
+
+  printf("SPIFFS_CACHE_READ_AHEAD %d:\n", SPIFFS_CACHE_READ_AHEAD);
+  if (test_stream("stream")) {
+    return 1;
+  }
+
+  for (i = 0; i < TEST_REWRITES; i++) {
+    s32_t len = 1 + rand() % 600;
+
+    offs = rand() % (TEST_IMAGE_SZ - len);
+    memset(&image[offs], i, len);
+    if (test_write_file("image", offs, &image[offs], len)) {
+      return 1;
+    }
+  }
+  if (test_stream("stream after rewrites")) {
+    return 1;
+  }
+
+  SPIFFS_unmount(&fs);
+  if (test_flash_mount(&fs) != SPIFFS_OK || test_stream("stream after remount")) {
+    return 1;
+  }
+
+  SPIFFS_cache_info(&fs, &hits, &misses, &writebacks);
+  printf("  cache since remount: %u hits, %u misses, %u write backs\n",
+         hits, misses, writebacks);
+  return 0;
+}
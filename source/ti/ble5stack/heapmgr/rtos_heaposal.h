@@ -195,6 +195,9 @@ typedef hmU32_t  heapmgrHdr_t;
 #define HEAPMGR_ALIGN_SIZE 4
 #elif defined __GNUC__ && defined __arm__
 #define HEAPMGR_ALIGN_SIZE 4
+#elif defined __GNUC__ && defined __x86_64__
+/* Host build, see icall/src/host/icall_host.h. Messages hold pointers. */
+#define HEAPMGR_ALIGN_SIZE __SIZEOF_POINTER__
 #elif defined (ccs)  || (rvmdk)
 #define HEAPMGR_ALIGN_SIZE 4
 #elif defined __TI_COMPILER_VERSION__ && defined __TI_ARM__
@@ -203,8 +206,14 @@ typedef hmU32_t  heapmgrHdr_t;
 #error "Unsupported platform or compiler"
 #endif
 
+#if HEAPMGR_ALIGN_SIZE > 4
+/* The header is padded so that the pointer returned keeps the alignment. */
+#define HDRSZ HEAPMGR_ALIGN_SIZE
+typedef uint64_t heapmgrAlign_t;
+#else
 #define HDRSZ 4
 typedef hmU32_t heapmgrAlign_t;
+#endif
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -292,7 +301,7 @@ void HEAPMGR_INIT(void)
 #endif // AUTOHEAPSIZE
 
   for (tmp = (heapmgrHdr_t *)HEAPMGR_HEAPSTORE;
-       tmp < (heapmgrHdr_t *)((uint32)HEAPMGR_HEAPSTORE+HEAPMGR_SIZE);
+       tmp < (heapmgrHdr_t *)((hmU8_t *)HEAPMGR_HEAPSTORE+HEAPMGR_SIZE);
        tmp++)
   {
     *tmp = 0;
@@ -103,6 +103,8 @@ static void setICallCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
                               uint8_t cmdId);
 static void setDispatchCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
                                  uint8_t cmdId);
+static ICall_Errno sendServiceMsgCS(ICall_EntityID src, void *msg,
+                                    ICall_MsgMatchFn matchCSFn);
 static ICall_Errno waitMatchCS(ICall_MsgMatchFn matchCSFn, void **msg);
 static bStatus_t sendWaitMatchCS(ICall_EntityID src, void *msg,
                                  ICall_MsgMatchFn matchCSFn);
@@ -520,6 +522,45 @@ static void setDispatchCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
   pHdr->cmdId = cmdId;
 }
 
+/*********************************************************************
+ * @fn      sendServiceMsgCS
+ *
+ * @brief   Send a message to the BLE Stack, to be followed by waitMatchCS.
+ *
+ *          The Command Status response is announced to ICall first, so
+ *          that waitMatchCS does not have to look through the events
+ *          queued to the application ahead of it.
+ *
+ * @param   src  entity id of the sender of the message
+ * @param   msg  pointer to the message body to send.
+ * @param   matchCSFn  pointer to a function that would return TRUE when
+ *                     the message matches its condition.
+ *
+ * @return  return value of ICall_sendServiceMsg
+ */
+static ICall_Errno sendServiceMsgCS(ICall_EntityID src, void *msg,
+                                    ICall_MsgMatchFn matchCSFn)
+{
+  ICall_Errno errno;
+
+  // waitMatchCS refuses to block the BLE Stack thread, so nothing would
+  // take the response out of the slot.
+  if (!ICall_threadServes(ICALL_SERVICE_CLASS_BLE))
+  {
+    ICall_expectMatch(matchCSFn);
+  }
+
+  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
+                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+  if (errno != ICALL_ERRNO_SUCCESS)
+  {
+    // No response will come
+    ICall_expectMatch(NULL);
+  }
+
+  return errno;
+}
+
 /*********************************************************************
  * @fn      waitMatchCS
  *
@@ -574,8 +615,7 @@ static bStatus_t sendWaitMatchCS(ICall_EntityID src, void *msg,
   }
 
   /* Send the message */
-  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
-                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+  errno = sendServiceMsgCS(src, msg, matchCSFn);
 
   if (errno == ICALL_ERRNO_SUCCESS)
   {
@@ -618,8 +658,7 @@ static bStatus_t sendWaitMatchValueCS(ICall_EntityID src, void *msg,
   ICall_Errno errno;
 
   /* Send the message */
-  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
-                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+  errno = sendServiceMsgCS(src, msg, matchCSFn);
 
   if (errno == ICALL_ERRNO_SUCCESS)
   {
@@ -2425,8 +2464,7 @@ bStatus_t GAPBondMgr_GetParameter(uint16 param, void *pValue)
     msg->paramID = param;
 
     // Send the message
-    errno = ICall_sendServiceMsg(ICall_getEntityId(), ICALL_SERVICE_CLASS_BLE,
-                                 ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+    errno = sendServiceMsgCS(ICall_getEntityId(), msg, matchBondMgrGetParamCS);
 
     if (errno == ICALL_ERRNO_SUCCESS)
     {
@@ -4229,8 +4267,7 @@ bStatus_t SM_GetScConfirmOob(uint8 *publicKey, uint8 *oob, uint8 *pOut)
     msg->oob = oob;
 
     // Send the message
-    errno = ICall_sendServiceMsg(ICall_getEntityId(), ICALL_SERVICE_CLASS_BLE,
-                                 ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+    errno = sendServiceMsgCS(ICall_getEntityId(), msg, matchSMGetScConfirmCS);
 
     // Send the message
     //return sendWaitMatchCS(ICall_getEntityId(), msg, matchSMGetScConfirmCS);
@@ -136,6 +136,13 @@ typedef void* (*pfnBMAlloc_t)(uint8_t type, uint16_t size, uint16_t connHandle,
                               uint8_t opcode, uint16_t *pSizeAlloc);
 typedef void  (*pfnBMFree_t)(uint8_t type, void *pMsg, uint8_t opcode);
 
+// Payload statistics of the data paths through the dispatcher
+typedef struct
+{
+  uint32_t bytesCopied; // Payload bytes copied into a stack buffer
+  uint32_t bytesPassed; // Payload bytes handed over without a copy
+} bleDispatchDataStats_t;
+
 /*********************************************************************
  * MACROS
  */
@@ -165,6 +172,12 @@ extern void *bleDispatch_BMAlloc(uint8_t type, uint16_t size,
  */
 extern void bleDispatch_BMFree(uint8_t type, void *pBuf, uint8_t opcode);
 
+/*
+ * Get the payload copy statistics of the dispatcher.
+ */
+extern void bleDispatch_GetDataStats(bleDispatchDataStats_t *pStats,
+                                     uint8_t reset);
+
 /*********************************************************************
 *********************************************************************/
 
@@ -0,0 +1,1062 @@
+/******************************************************************************
+
+ @file  icall_host.c
+
+ @brief Host (Linux) implementation of the TI-RTOS kernel services used by
+        ICall, on top of pthreads with a virtual tick counter, and of the
+        ICall platform power functions.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2013-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "icall_host.h"
+#include "icall.h"
+#include "icall_platform.h"
+#include <icall_cc26xx_defs.h>
+
+/**
+ * @internal
+ * Task states. A task is ready when it can be given the CPU, including the
+ * task currently holding it.
+ */
+typedef enum
+{
+  ICALLHOST_TASK_READY,
+  ICALLHOST_TASK_BLOCKED,
+  ICALLHOST_TASK_DONE
+} ICallHost_TaskState;
+
+struct Task_Object
+{
+  pthread_t      thread;
+  pthread_cond_t cond;         /* signalled when the task is given the CPU */
+  Task_FuncPtr   fxn;
+  UArg           arg0;
+  UArg           arg1;
+  Int            priority;
+  ICallHost_TaskState state;
+  int_least64_t  readySeq;     /* FIFO order among ready tasks of a priority */
+  Task_Handle    pendNext;     /* next task pending on the same semaphore */
+  void          *pendObj;      /* semaphore or event the task is pending on */
+  bool           pendEvent;    /* whether 'pendObj' is an event */
+  UInt           andMask;
+  UInt           orMask;
+  bool           timed;        /* whether 'deadline' applies */
+  UInt32         deadline;
+  UInt           result;       /* value returned by the pend call */
+};
+
+struct Clock_Object
+{
+  Clock_Handle  next;
+  Clock_FuncPtr fxn;
+  UArg          arg;
+  UInt32        timeout;
+  UInt32        period;
+  UInt32        expiry;
+  bool          active;
+};
+
+struct Semaphore_Object
+{
+  Semaphore_Mode mode;
+  Int            count;
+  Task_Handle    waitHead;
+  Task_Handle    waitTail;
+};
+
+struct Event_Object
+{
+  UInt        posted;
+  Task_Handle waiter;
+};
+
+struct Hwi_Object
+{
+  Hwi_FuncPtr fxn;
+  UArg        arg;
+  bool        enabled;
+  bool        pending;
+};
+
+/* The kernel lock protects all of the data below. Only the task designated
+ * by 'ICallHost_current' runs application code; every other task thread
+ * waits on its own condition variable. */
+static pthread_mutex_t ICallHost_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ICallHost_doneCond = PTHREAD_COND_INITIALIZER;
+
+static struct Task_Object ICallHost_tasks[ICALLHOST_MAX_TASKS];
+static size_t ICallHost_numTasks;
+static Task_Handle ICallHost_current;
+static int_least64_t ICallHost_seqTail;  /* last sequence given to a newly ready task */
+static int_least64_t ICallHost_seqHead;  /* last sequence given to a preempted task */
+
+static Clock_Handle ICallHost_clocks;
+static UInt32 ICallHost_ticks;
+
+static struct Hwi_Object ICallHost_hwis[ICALLHOST_MAX_INTS];
+
+static BIOS_ThreadType ICallHost_threadType = BIOS_ThreadType_Main;
+static UInt ICallHost_hwiDisabled;
+static UInt ICallHost_swiDisabled;
+static UInt ICallHost_taskDisabled;
+static bool ICallHost_started;
+static bool ICallHost_exit;
+static bool ICallHost_done;
+static UInt32 ICallHost_switchCount;
+
+UInt32 Clock_tickPeriod = ICALLHOST_TICK_PERIOD;
+
+static void ICallHost_schedule(Task_Handle self);
+
+/**
+ * @internal
+ * Returns whether tick 'a' is before tick 'b', allowing for wrap around.
+ */
+static bool ICallHost_before(UInt32 a, UInt32 b)
+{
+  return ((int32_t)(a - b) < 0);
+}
+
+/**
+ * @internal
+ * Makes a task ready, behind the other ready tasks of the same priority.
+ */
+static void ICallHost_makeReady(Task_Handle task, UInt result)
+{
+  task->state = ICALLHOST_TASK_READY;
+  task->pendObj = NULL;
+  task->timed = false;
+  task->result = result;
+  task->readySeq = ++ICallHost_seqTail;
+}
+
+/**
+ * @internal
+ * Returns the ready task which should run next, or NULL.
+ */
+static Task_Handle ICallHost_pickReady(void)
+{
+  Task_Handle best = NULL;
+  size_t i;
+
+  for (i = 0; i < ICallHost_numTasks; i++)
+  {
+    Task_Handle task = &ICallHost_tasks[i];
+
+    if (task->state != ICALLHOST_TASK_READY)
+    {
+      continue;
+    }
+    if (best == NULL || task->priority > best->priority ||
+        (task->priority == best->priority && task->readySeq < best->readySeq))
+    {
+      best = task;
+    }
+  }
+  return best;
+}
+
+/**
+ * @internal
+ * Removes a task from the waiter list of the semaphore it pends on.
+ */
+static void ICallHost_unlinkWaiter(Semaphore_Handle sem, Task_Handle task)
+{
+  Task_Handle prev = NULL;
+  Task_Handle cur;
+
+  for (cur = sem->waitHead; cur != NULL; prev = cur, cur = cur->pendNext)
+  {
+    if (cur == task)
+    {
+      if (prev == NULL)
+      {
+        sem->waitHead = cur->pendNext;
+      }
+      else
+      {
+        prev->pendNext = cur->pendNext;
+      }
+      if (sem->waitTail == cur)
+      {
+        sem->waitTail = prev;
+      }
+      cur->pendNext = NULL;
+      break;
+    }
+  }
+}
+
+/**
+ * @internal
+ * Advances the virtual time to the next clock expiry or pend timeout and
+ * runs whatever expires then.
+ *
+ * @return false if there is nothing left that could advance the time.
+ */
+static bool ICallHost_advanceTime(void)
+{
+  bool found = false;
+  UInt32 next = 0;
+  Clock_Handle clock;
+  size_t i;
+
+  for (clock = ICallHost_clocks; clock != NULL; clock = clock->next)
+  {
+    if (clock->active && (!found || ICallHost_before(clock->expiry, next)))
+    {
+      next = clock->expiry;
+      found = true;
+    }
+  }
+  for (i = 0; i < ICallHost_numTasks; i++)
+  {
+    Task_Handle task = &ICallHost_tasks[i];
+
+    if (task->state == ICALLHOST_TASK_BLOCKED && task->timed &&
+        (!found || ICallHost_before(task->deadline, next)))
+    {
+      next = task->deadline;
+      found = true;
+    }
+  }
+  if (!found)
+  {
+    return false;
+  }
+  if (ICallHost_before(ICallHost_ticks, next))
+  {
+    ICallHost_ticks = next;
+  }
+
+  /* Pend timeouts */
+  for (i = 0; i < ICallHost_numTasks; i++)
+  {
+    Task_Handle task = &ICallHost_tasks[i];
+
+    if (task->state == ICALLHOST_TASK_BLOCKED && task->timed &&
+        !ICallHost_before(ICallHost_ticks, task->deadline))
+    {
+      if (task->pendEvent)
+      {
+        ((Event_Handle) task->pendObj)->waiter = NULL;
+      }
+      else
+      {
+        ICallHost_unlinkWaiter((Semaphore_Handle) task->pendObj, task);
+      }
+      ICallHost_makeReady(task, 0);
+    }
+  }
+
+  /* Clock functions run in Swi context, with the kernel lock released so
+   * that they can post semaphores and events. No other thread runs
+   * meanwhile since none of them is the current task. The list is scanned
+   * again after each call since the function may create or delete clocks. */
+  clock = ICallHost_clocks;
+  while (clock != NULL)
+  {
+    if (clock->active && !ICallHost_before(ICallHost_ticks, clock->expiry))
+    {
+      if (clock->period != 0)
+      {
+        clock->expiry += clock->period;
+      }
+      else
+      {
+        clock->active = false;
+      }
+      ICallHost_threadType = BIOS_ThreadType_Swi;
+      pthread_mutex_unlock(&ICallHost_lock);
+      clock->fxn(clock->arg);
+      pthread_mutex_lock(&ICallHost_lock);
+      ICallHost_threadType = BIOS_ThreadType_Task;
+      clock = ICallHost_clocks;
+    }
+    else
+    {
+      clock = clock->next;
+    }
+  }
+  return true;
+}
+
+/**
+ * @internal
+ * Hands the CPU over to the highest priority ready task and, unless 'self'
+ * is that task or has finished, waits until 'self' is given the CPU again.
+ * Must be called with the kernel lock held.
+ *
+ * @param self  calling task, or NULL when called from BIOS_start()
+ */
+static void ICallHost_schedule(Task_Handle self)
+{
+  Task_Handle next;
+
+  for (;;)
+  {
+    next = ICallHost_exit ? NULL : ICallHost_pickReady();
+    if (next != NULL)
+    {
+      break;
+    }
+    if (ICallHost_exit || !ICallHost_advanceTime())
+    {
+      /* Nothing will ever run again: end the run. */
+      ICallHost_done = true;
+      pthread_cond_signal(&ICallHost_doneCond);
+      break;
+    }
+  }
+
+  if (next != ICallHost_current)
+  {
+    ICallHost_switchCount++;
+  }
+  ICallHost_current = next;
+  if (next != NULL && next != self)
+  {
+    pthread_cond_signal(&next->cond);
+  }
+  if (self != NULL && self->state != ICALLHOST_TASK_DONE)
+  {
+    while (ICallHost_current != self)
+    {
+      pthread_cond_wait(&self->cond, &ICallHost_lock);
+    }
+  }
+}
+
+/**
+ * @internal
+ * Switches to a higher priority ready task if scheduling is enabled and the
+ * caller is a task. Must be called with the kernel lock held.
+ */
+static void ICallHost_preempt(void)
+{
+  Task_Handle self = ICallHost_current;
+  Task_Handle next;
+
+  if (ICallHost_threadType != BIOS_ThreadType_Task || self == NULL ||
+      ICallHost_hwiDisabled || ICallHost_swiDisabled || ICallHost_taskDisabled)
+  {
+    return;
+  }
+  next = ICallHost_pickReady();
+  if (next != NULL && next->priority > self->priority)
+  {
+    /* A preempted task resumes before the other tasks of its priority. */
+    self->readySeq = --ICallHost_seqHead;
+    ICallHost_schedule(self);
+  }
+}
+
+/**
+ * @internal
+ * Blocks the current task until it is made ready again or 'timeout' ticks
+ * elapsed. Must be called with the kernel lock held.
+ *
+ * @return the result set by whoever made the task ready, 0 on timeout.
+ */
+static UInt ICallHost_block(void *obj, bool isEvent, UInt andMask, UInt orMask,
+                            UInt32 timeout)
+{
+  Task_Handle self = ICallHost_current;
+
+  self->state = ICALLHOST_TASK_BLOCKED;
+  self->pendObj = obj;
+  self->pendEvent = isEvent;
+  self->andMask = andMask;
+  self->orMask = orMask;
+  self->timed = (timeout != BIOS_WAIT_FOREVER);
+  self->deadline = ICallHost_ticks + timeout;
+  self->result = 0;
+  ICallHost_schedule(self);
+  return self->result;
+}
+
+/**
+ * @internal
+ * Thread function of every task.
+ */
+static void *ICallHost_taskThread(void *arg)
+{
+  Task_Handle self = (Task_Handle) arg;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  while (ICallHost_current != self)
+  {
+    pthread_cond_wait(&self->cond, &ICallHost_lock);
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+
+  self->fxn(self->arg0, self->arg1);
+
+  pthread_mutex_lock(&ICallHost_lock);
+  self->state = ICALLHOST_TASK_DONE;
+  ICallHost_schedule(self);
+  pthread_mutex_unlock(&ICallHost_lock);
+  return NULL;
+}
+
+/**
+ * @internal
+ * Runs the ISRs which were raised while interrupts were disabled.
+ * Must be called with the kernel lock held.
+ */
+static void ICallHost_runPendingIsrs(void)
+{
+  size_t i;
+
+  for (i = 0; i < ICALLHOST_MAX_INTS && !ICallHost_hwiDisabled; i++)
+  {
+    struct Hwi_Object *hwi = &ICallHost_hwis[i];
+
+    if (hwi->pending && hwi->enabled)
+    {
+      BIOS_ThreadType type = ICallHost_threadType;
+
+      hwi->pending = false;
+      ICallHost_threadType = BIOS_ThreadType_Hwi;
+      pthread_mutex_unlock(&ICallHost_lock);
+      hwi->fxn(hwi->arg);
+      pthread_mutex_lock(&ICallHost_lock);
+      ICallHost_threadType = type;
+    }
+  }
+}
+
+/* BIOS */
+
+BIOS_ThreadType BIOS_getThreadType(void)
+{
+  return ICallHost_threadType;
+}
+
+Void BIOS_start(void)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  ICallHost_started = true;
+  ICallHost_threadType = BIOS_ThreadType_Task;
+  ICallHost_schedule(NULL);
+  while (!ICallHost_done)
+  {
+    pthread_cond_wait(&ICallHost_doneCond, &ICallHost_lock);
+  }
+  ICallHost_threadType = BIOS_ThreadType_Main;
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+Void BIOS_exit(Int stat)
+{
+  (void) stat;
+  pthread_mutex_lock(&ICallHost_lock);
+  ICallHost_exit = true;
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+/* Hwi */
+
+Void Hwi_Params_init(Hwi_Params *params)
+{
+  params->arg = 0;
+  params->priority = ~0;
+}
+
+Hwi_Handle Hwi_create(Int intNum, Hwi_FuncPtr hwiFxn,
+                      const Hwi_Params *params, Error_Block *eb)
+{
+  struct Hwi_Object *hwi;
+
+  (void) eb;
+  if (intNum < 0 || intNum >= ICALLHOST_MAX_INTS)
+  {
+    return NULL;
+  }
+  pthread_mutex_lock(&ICallHost_lock);
+  hwi = &ICallHost_hwis[intNum];
+  hwi->fxn = hwiFxn;
+  hwi->arg = (params != NULL) ? params->arg : 0;
+  hwi->enabled = true;
+  hwi->pending = false;
+  pthread_mutex_unlock(&ICallHost_lock);
+  return hwi;
+}
+
+UInt Hwi_disable(void)
+{
+  UInt key;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  key = ICallHost_hwiDisabled;
+  ICallHost_hwiDisabled = 1;
+  pthread_mutex_unlock(&ICallHost_lock);
+  return key;
+}
+
+UInt Hwi_enable(void)
+{
+  UInt key;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  key = ICallHost_hwiDisabled;
+  ICallHost_hwiDisabled = 0;
+  ICallHost_runPendingIsrs();
+  ICallHost_preempt();
+  pthread_mutex_unlock(&ICallHost_lock);
+  return key;
+}
+
+Void Hwi_restore(UInt key)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  ICallHost_hwiDisabled = key;
+  ICallHost_runPendingIsrs();
+  ICallHost_preempt();
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+UInt Hwi_disableInterrupt(UInt intNum)
+{
+  UInt key = 0;
+
+  if (intNum < ICALLHOST_MAX_INTS)
+  {
+    pthread_mutex_lock(&ICallHost_lock);
+    key = ICallHost_hwis[intNum].enabled;
+    ICallHost_hwis[intNum].enabled = false;
+    pthread_mutex_unlock(&ICallHost_lock);
+  }
+  return key;
+}
+
+UInt Hwi_enableInterrupt(UInt intNum)
+{
+  UInt key = 0;
+
+  if (intNum < ICALLHOST_MAX_INTS)
+  {
+    pthread_mutex_lock(&ICallHost_lock);
+    key = ICallHost_hwis[intNum].enabled;
+    ICallHost_hwis[intNum].enabled = true;
+    ICallHost_runPendingIsrs();
+    pthread_mutex_unlock(&ICallHost_lock);
+  }
+  return key;
+}
+
+Void ICallHost_raiseInterrupt(UInt intNum)
+{
+  if (intNum < ICALLHOST_MAX_INTS && ICallHost_hwis[intNum].fxn != NULL)
+  {
+    pthread_mutex_lock(&ICallHost_lock);
+    ICallHost_hwis[intNum].pending = true;
+    ICallHost_runPendingIsrs();
+    ICallHost_preempt();
+    pthread_mutex_unlock(&ICallHost_lock);
+  }
+}
+
+/* Swi */
+
+UInt Swi_disable(void)
+{
+  UInt key;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  key = ICallHost_swiDisabled;
+  ICallHost_swiDisabled = 1;
+  pthread_mutex_unlock(&ICallHost_lock);
+  return key;
+}
+
+Void Swi_enable(void)
+{
+  Swi_restore(0);
+}
+
+Void Swi_restore(UInt key)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  ICallHost_swiDisabled = key;
+  ICallHost_preempt();
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+/* Task */
+
+Void Task_Params_init(Task_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+  params->priority = 1;
+}
+
+Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params,
+                        Error_Block *eb)
+{
+  Task_Handle task = NULL;
+
+  (void) eb;
+  pthread_mutex_lock(&ICallHost_lock);
+  if (ICallHost_numTasks < ICALLHOST_MAX_TASKS)
+  {
+    task = &ICallHost_tasks[ICallHost_numTasks];
+    memset(task, 0, sizeof(*task));
+    pthread_cond_init(&task->cond, NULL);
+    task->fxn = fxn;
+    task->arg0 = params->arg0;
+    task->arg1 = params->arg1;
+    task->priority = params->priority;
+    if (pthread_create(&task->thread, NULL, ICallHost_taskThread, task) != 0)
+    {
+      pthread_cond_destroy(&task->cond);
+      task = NULL;
+    }
+    else
+    {
+      /* Tasks blocked at the end of a run are never joined. */
+      pthread_detach(task->thread);
+      ICallHost_numTasks++;
+      ICallHost_makeReady(task, 0);
+      if (ICallHost_started)
+      {
+        ICallHost_preempt();
+      }
+    }
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+  return task;
+}
+
+Task_Handle Task_self(void)
+{
+  return ICallHost_current;
+}
+
+UInt Task_disable(void)
+{
+  UInt key;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  key = ICallHost_taskDisabled;
+  ICallHost_taskDisabled = 1;
+  pthread_mutex_unlock(&ICallHost_lock);
+  return key;
+}
+
+Void Task_enable(void)
+{
+  Task_restore(0);
+}
+
+Void Task_restore(UInt key)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  ICallHost_taskDisabled = key;
+  ICallHost_preempt();
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+Void Task_yield(void)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  if (ICallHost_current != NULL)
+  {
+    ICallHost_current->readySeq = ++ICallHost_seqTail;
+    ICallHost_schedule(ICallHost_current);
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+/* Clock */
+
+Void Clock_Params_init(Clock_Params *params)
+{
+  params->period = 0;
+  params->startFlag = FALSE;
+  params->arg = 0;
+}
+
+Clock_Handle Clock_create(Clock_FuncPtr clockFxn, UInt timeout,
+                          const Clock_Params *params, Error_Block *eb)
+{
+  Clock_Handle clock = malloc(sizeof(*clock));
+
+  (void) eb;
+  if (clock == NULL)
+  {
+    return NULL;
+  }
+  clock->fxn = clockFxn;
+  clock->arg = (params != NULL) ? params->arg : 0;
+  clock->timeout = timeout;
+  clock->period = (params != NULL) ? params->period : 0;
+  clock->active = false;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  clock->next = ICallHost_clocks;
+  ICallHost_clocks = clock;
+  if (params != NULL && params->startFlag)
+  {
+    clock->expiry = ICallHost_ticks + timeout;
+    clock->active = true;
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+  return clock;
+}
+
+Void Clock_delete(Clock_Handle *handle)
+{
+  Clock_Handle *link;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  for (link = &ICallHost_clocks; *link != NULL; link = &(*link)->next)
+  {
+    if (*link == *handle)
+    {
+      *link = (*handle)->next;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+  free(*handle);
+  *handle = NULL;
+}
+
+Void Clock_setTimeout(Clock_Handle handle, UInt32 timeout)
+{
+  handle->timeout = timeout;
+}
+
+Void Clock_setPeriod(Clock_Handle handle, UInt32 period)
+{
+  handle->period = period;
+}
+
+Void Clock_start(Clock_Handle handle)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  /* A zero timeout expires on the next tick, as on the target. */
+  handle->expiry = ICallHost_ticks + ((handle->timeout != 0) ? handle->timeout : 1);
+  handle->active = true;
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+Void Clock_stop(Clock_Handle handle)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  handle->active = false;
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+Bool Clock_isActive(Clock_Handle handle)
+{
+  return handle->active;
+}
+
+UInt32 Clock_getTicks(void)
+{
+  return ICallHost_ticks;
+}
+
+/* Semaphore */
+
+Void Semaphore_Params_init(Semaphore_Params *params)
+{
+  params->mode = Semaphore_Mode_COUNTING;
+}
+
+Semaphore_Handle Semaphore_create(Int count, const Semaphore_Params *params,
+                                  Error_Block *eb)
+{
+  Semaphore_Handle sem = calloc(1, sizeof(*sem));
+
+  (void) eb;
+  if (sem != NULL)
+  {
+    sem->mode = (params != NULL) ? params->mode : Semaphore_Mode_COUNTING;
+    sem->count = (sem->mode == Semaphore_Mode_BINARY && count > 1) ? 1 : count;
+  }
+  return sem;
+}
+
+Bool Semaphore_pend(Semaphore_Handle handle, UInt32 timeout)
+{
+  Bool result = TRUE;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  if (handle->count > 0)
+  {
+    handle->count--;
+  }
+  else if (timeout == BIOS_NO_WAIT ||
+           ICallHost_threadType != BIOS_ThreadType_Task)
+  {
+    result = FALSE;
+  }
+  else
+  {
+    Task_Handle self = ICallHost_current;
+
+    self->pendNext = NULL;
+    if (handle->waitTail == NULL)
+    {
+      handle->waitHead = self;
+    }
+    else
+    {
+      handle->waitTail->pendNext = self;
+    }
+    handle->waitTail = self;
+    result = (Bool) ICallHost_block(handle, false, 0, 0, timeout);
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+  return result;
+}
+
+Void Semaphore_post(Semaphore_Handle handle)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  if (handle->waitHead != NULL)
+  {
+    Task_Handle task = handle->waitHead;
+
+    handle->waitHead = task->pendNext;
+    if (handle->waitHead == NULL)
+    {
+      handle->waitTail = NULL;
+    }
+    task->pendNext = NULL;
+    ICallHost_makeReady(task, TRUE);
+    ICallHost_preempt();
+  }
+  else if (handle->mode == Semaphore_Mode_BINARY)
+  {
+    handle->count = 1;
+  }
+  else
+  {
+    handle->count++;
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+Int Semaphore_getCount(Semaphore_Handle handle)
+{
+  return handle->count;
+}
+
+/* Event */
+
+/**
+ * @internal
+ * Returns the events consumed by a pend on 'posted', or 0 if the pend
+ * condition is not met.
+ */
+static UInt ICallHost_eventMatch(UInt posted, UInt andMask, UInt orMask)
+{
+  if (andMask != 0 && (posted & andMask) == andMask)
+  {
+    return andMask | (posted & orMask);
+  }
+  return posted & orMask;
+}
+
+Event_Handle Event_create(const void *params, Error_Block *eb)
+{
+  (void) params;
+  (void) eb;
+  return calloc(1, sizeof(struct Event_Object));
+}
+
+UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask,
+                UInt32 timeout)
+{
+  UInt result;
+
+  pthread_mutex_lock(&ICallHost_lock);
+  result = ICallHost_eventMatch(handle->posted, andMask, orMask);
+  if (result != 0)
+  {
+    handle->posted &= ~result;
+  }
+  else if (timeout != BIOS_NO_WAIT &&
+           ICallHost_threadType == BIOS_ThreadType_Task)
+  {
+    handle->waiter = ICallHost_current;
+    result = ICallHost_block(handle, true, andMask, orMask, timeout);
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+  return result;
+}
+
+Void Event_post(Event_Handle handle, UInt eventMask)
+{
+  pthread_mutex_lock(&ICallHost_lock);
+  handle->posted |= eventMask;
+  if (handle->waiter != NULL)
+  {
+    Task_Handle task = handle->waiter;
+    UInt result = ICallHost_eventMatch(handle->posted, task->andMask,
+                                       task->orMask);
+    if (result != 0)
+    {
+      handle->posted &= ~result;
+      handle->waiter = NULL;
+      ICallHost_makeReady(task, result);
+      ICallHost_preempt();
+    }
+  }
+  pthread_mutex_unlock(&ICallHost_lock);
+}
+
+UInt32 ICallHost_getSwitchCount(void)
+{
+  return ICallHost_switchCount;
+}
+
+/* ICall platform functions. There is no power management on the host, so
+ * the device is always awake and the crystal always stable. */
+
+/** @internal activity counter */
+static uint_least8_t ICallPlatform_pwrActivityCount = 0;
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrUpdActivityCounter(ICall_PwrUpdActivityCounterArgs *args)
+{
+  ICall_CSState state = ICall_enterCSImpl();
+  ICall_Errno errno = ICALL_ERRNO_SUCCESS;
+
+  if (args->incFlag)
+  {
+    if (ICallPlatform_pwrActivityCount == 255)
+    {
+      errno = ICALL_ERRNO_OVERFLOW;
+    }
+    else
+    {
+      ICallPlatform_pwrActivityCount++;
+    }
+  }
+  else
+  {
+    if (ICallPlatform_pwrActivityCount == 0)
+    {
+      errno = ICALL_ERRNO_UNDERFLOW;
+    }
+    else
+    {
+      ICallPlatform_pwrActivityCount--;
+    }
+  }
+  args->pwrRequired = (ICallPlatform_pwrActivityCount != 0);
+  ICall_leaveCSImpl(state);
+  return errno;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrRegisterNotify(ICall_PwrRegisterNotifyArgs *args)
+{
+  args->obj->_private = args->fn;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrConfigACAction(ICall_PwrBitmapArgs *args)
+{
+  (void) args;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrRequire(ICall_PwrBitmapArgs *args)
+{
+  (void) args;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrDispense(ICall_PwrBitmapArgs *args)
+{
+  (void) args;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrIsStableXOSCHF(ICall_GetBoolArgs *args)
+{
+  args->value = true;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrSwitchXOSCHF(ICall_FuncArgsHdr *args)
+{
+  (void) args;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrGetTransitionState(ICall_PwrGetTransitionStateArgs *args)
+{
+  args->state = ICALL_PWR_TRANSITION_STAY_IN_ACTIVE;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/* See ICallPlatform.h for description */
+ICall_Errno
+ICallPlatform_pwrGetXOSCStartupTime(ICall_PwrGetXOSCStartupTimeArgs *args)
+{
+  args->value = 0;
+  return ICALL_ERRNO_SUCCESS;
+}
@@ -0,0 +1,267 @@
+/******************************************************************************
+
+ @file  icall_host.h
+
+ @brief Host (Linux) port of the TI-RTOS kernel services used by ICall.
+
+        This header stands in for the subset of the TI-RTOS kernel API that
+        icall.c and the OSAL ICall glue use, so that they build unmodified
+        on a workstation. Put the directory containing this file ahead of
+        the TI-RTOS include paths, build icall.c with
+        ICALL_FEATURE_SEPARATE_IMGINFO, and link icall_host.c with -pthread.
+
+        Every TI-RTOS task is a pthread, but only one of them runs at a
+        time: the scheduler hands the CPU over explicitly, by priority and
+        in FIFO order within a priority, exactly as a single core would.
+        Time is virtual. The tick counter only moves when every task is
+        blocked, and then jumps straight to the next clock or pend timeout.
+        A run is therefore fully deterministic and does not depend on the
+        speed of the host.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2013-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+#ifndef ICALLHOST_H
+#define ICALLHOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* xdc/std.h types */
+typedef void          Void;
+typedef char          Char;
+typedef int           Int;
+typedef unsigned int  UInt;
+typedef unsigned short Bool;
+typedef uint8_t       UInt8;
+typedef uint16_t      UInt16;
+typedef uint32_t      UInt32;
+typedef size_t        SizeT;
+typedef uintptr_t     UArg;
+typedef void         *Ptr;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+/** Maximum number of tasks which can be created */
+#ifndef ICALLHOST_MAX_TASKS
+#define ICALLHOST_MAX_TASKS   16
+#endif
+
+/** Number of interrupt vectors which can have an ISR registered */
+#ifndef ICALLHOST_MAX_INTS
+#define ICALLHOST_MAX_INTS    64
+#endif
+
+/** Default tick period in microseconds, matching the BLE stack configuration */
+#ifndef ICALLHOST_TICK_PERIOD
+#define ICALLHOST_TICK_PERIOD 10
+#endif
+
+typedef struct Error_Block Error_Block;
+
+/* xdc.runtime.Memory */
+typedef struct
+{
+  SizeT totalSize;
+  SizeT totalFreeSize;
+  SizeT largestFreeSize;
+} Memory_Stats;
+
+/* BIOS */
+#define BIOS_WAIT_FOREVER   (~((UInt)0))
+#define BIOS_NO_WAIT        ((UInt)0)
+
+typedef enum
+{
+  BIOS_ThreadType_Hwi,
+  BIOS_ThreadType_Swi,
+  BIOS_ThreadType_Task,
+  BIOS_ThreadType_Main
+} BIOS_ThreadType;
+
+extern BIOS_ThreadType BIOS_getThreadType(void);
+
+/**
+ * Runs the created tasks until BIOS_exit() is called or the system is idle
+ * for good, i.e. every task is blocked or finished and no clock or pend
+ * timeout is left to advance the virtual time to.
+ * Unlike TI-RTOS, this function returns to its caller.
+ */
+extern Void BIOS_start(void);
+
+/** Ends the run started by BIOS_start() once the calling task blocks. */
+extern Void BIOS_exit(Int stat);
+
+/* Hwi */
+typedef Void (*Hwi_FuncPtr)(UArg);
+typedef struct
+{
+  UArg arg;
+  Int  priority;
+} Hwi_Params;
+typedef struct Hwi_Object *Hwi_Handle;
+
+extern Void Hwi_Params_init(Hwi_Params *params);
+extern Hwi_Handle Hwi_create(Int intNum, Hwi_FuncPtr hwiFxn,
+                             const Hwi_Params *params, Error_Block *eb);
+extern UInt Hwi_disable(void);
+extern UInt Hwi_enable(void);
+extern Void Hwi_restore(UInt key);
+extern UInt Hwi_disableInterrupt(UInt intNum);
+extern UInt Hwi_enableInterrupt(UInt intNum);
+
+/* Swi */
+extern UInt Swi_disable(void);
+extern Void Swi_enable(void);
+extern Void Swi_restore(UInt key);
+
+/* Task */
+typedef Void (*Task_FuncPtr)(UArg, UArg);
+typedef struct
+{
+  UArg  arg0;
+  UArg  arg1;
+  Int   priority;
+  Ptr   stack;
+  SizeT stackSize;
+} Task_Params;
+typedef struct Task_Object *Task_Handle;
+
+extern Void Task_Params_init(Task_Params *params);
+extern Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params,
+                               Error_Block *eb);
+extern Task_Handle Task_self(void);
+extern UInt Task_disable(void);
+extern Void Task_enable(void);
+extern Void Task_restore(UInt key);
+extern Void Task_yield(void);
+
+/* Clock */
+typedef Void (*Clock_FuncPtr)(UArg);
+typedef struct
+{
+  UInt32 period;
+  Bool   startFlag;
+  UArg   arg;
+} Clock_Params;
+typedef struct Clock_Object *Clock_Handle;
+
+/** Tick period in microseconds. May be changed before BIOS_start(). */
+extern UInt32 Clock_tickPeriod;
+
+extern Void Clock_Params_init(Clock_Params *params);
+extern Clock_Handle Clock_create(Clock_FuncPtr clockFxn, UInt timeout,
+                                 const Clock_Params *params, Error_Block *eb);
+extern Void Clock_delete(Clock_Handle *handle);
+extern Void Clock_setTimeout(Clock_Handle handle, UInt32 timeout);
+extern Void Clock_setPeriod(Clock_Handle handle, UInt32 period);
+extern Void Clock_start(Clock_Handle handle);
+extern Void Clock_stop(Clock_Handle handle);
+extern Bool Clock_isActive(Clock_Handle handle);
+extern UInt32 Clock_getTicks(void);
+
+/* Semaphore */
+typedef enum
+{
+  Semaphore_Mode_COUNTING,
+  Semaphore_Mode_BINARY
+} Semaphore_Mode;
+typedef struct
+{
+  Semaphore_Mode mode;
+} Semaphore_Params;
+typedef struct Semaphore_Object *Semaphore_Handle;
+
+extern Void Semaphore_Params_init(Semaphore_Params *params);
+extern Semaphore_Handle Semaphore_create(Int count,
+                                         const Semaphore_Params *params,
+                                         Error_Block *eb);
+extern Bool Semaphore_pend(Semaphore_Handle handle, UInt32 timeout);
+extern Void Semaphore_post(Semaphore_Handle handle);
+extern Int Semaphore_getCount(Semaphore_Handle handle);
+
+/* Event */
+#define Event_Id_NONE 0
+#define Event_Id_00   (0x1ul << 0)
+#define Event_Id_01   (0x1ul << 1)
+#define Event_Id_02   (0x1ul << 2)
+#define Event_Id_03   (0x1ul << 3)
+#define Event_Id_04   (0x1ul << 4)
+#define Event_Id_05   (0x1ul << 5)
+#define Event_Id_06   (0x1ul << 6)
+#define Event_Id_07   (0x1ul << 7)
+#define Event_Id_29   (0x1ul << 29)
+#define Event_Id_30   (0x1ul << 30)
+#define Event_Id_31   (0x1ul << 31)
+
+typedef struct Event_Object *Event_Handle;
+
+extern Event_Handle Event_create(const void *params, Error_Block *eb);
+extern UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask,
+                       UInt32 timeout);
+extern Void Event_post(Event_Handle handle, UInt eventMask);
+
+/**
+ * Runs the ISR registered with Hwi_create() for an interrupt number, as if
+ * the interrupt fired while the calling task was running. The ISR is run
+ * when interrupts are next enabled if they are disabled.
+ *
+ * @param intNum  interrupt number passed to Hwi_create()
+ */
+extern Void ICallHost_raiseInterrupt(UInt intNum);
+
+/**
+ * Returns the number of context switches performed since BIOS_start().
+ */
+extern UInt32 ICallHost_getSwitchCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ICALLHOST_H */
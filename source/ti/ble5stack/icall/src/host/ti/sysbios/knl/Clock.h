@@ -0,0 +1,2 @@
+/* Host build: see icall_host.h */
+#include "icall_host.h"
@@ -0,0 +1,2 @@
+/* Host build: there is no TI-RTOS configuration; the ICall heap uses the
+ * default heapmgr configuration. See icall_host.h */
@@ -262,6 +262,10 @@ typedef struct _icall_task_entry_t
   Task_Handle task;
   ICall_SyncHandle syncHandle;
   ICall_MsgQueue queue;
+  /* Match function of the synchronous reply the task waits for, if any */
+  ICall_MsgMatchFn syncMatchFn;
+  /* Synchronous reply, set aside from the queue when it was received */
+  void *syncRsp;
 } ICall_TaskEntry;
 
 /** @internal data structure about an entity using ICall module */
@@ -408,6 +412,8 @@ static ICall_TaskEntry *ICall_newTask(Task_Handle taskhandle)
       ICall_TaskEntry *taskentry = &ICall_tasks[i];
       taskentry->task = taskhandle;
       taskentry->queue = NULL;
+      taskentry->syncMatchFn = NULL;
+      taskentry->syncRsp = NULL;
       taskentry->syncHandle = ICALL_SYNC_HANDLE_CREATE();
       if (taskentry->syncHandle == NULL)
       {
@@ -527,6 +533,8 @@ void ICall_init(void)
   {
     ICall_tasks[i].task = NULL;
     ICall_tasks[i].queue = NULL;
+    ICall_tasks[i].syncMatchFn = NULL;
+    ICall_tasks[i].syncRsp = NULL;
   }
   for (i = 0; i < ICALL_MAX_NUM_ENTITIES; i++)
   {
@@ -886,6 +894,201 @@ static void ICall_msgPrepend( ICall_MsgQueue *q_ptr, ICall_MsgQueue head )
   ICall_leaveCSImpl(key);
 }
 
+static ICall_Errno ICall_primEntityId2ServiceId(ICall_EntityID entityId,
+                                                ICall_ServiceEnum *servId);
+
+/**
+ * @internal Checks a message against a match function.
+ * @param matchFn  match function
+ * @param msg_ptr  message pointer, with its header filled in
+ * @return TRUE when the message was sent by a service and matches.
+ */
+static bool ICall_msgMatch(ICall_MsgMatchFn matchFn, void *msg_ptr)
+{
+  ICall_MsgHdr *hdr = (ICall_MsgHdr *) msg_ptr - 1;
+  ICall_ServiceEnum servId;
+
+  if (ICall_primEntityId2ServiceId(hdr->srcentity, &servId) !=
+      ICALL_ERRNO_SUCCESS)
+  {
+    return false;
+  }
+  return matchFn(servId, hdr->dstentity, msg_ptr);
+}
+
+/**
+ * @internal Delivers a message to a task.
+ *
+ * The message is queued to the message queue of the task, unless the task
+ * is waiting for a synchronous reply and the message is that reply. In that
+ * case, the message is set aside so that ICall_waitMatch() does not have to
+ * look through the rest of the queue to find it.
+ * Either way, the caller has to post the synchronization object of the task.
+ *
+ * @param taskentry  destination task entry
+ * @param msg_ptr    message pointer, with its header filled in
+ */
+static void ICall_msgDeliver(ICall_TaskEntry *taskentry, void *msg_ptr)
+{
+  ICall_MsgMatchFn matchFn = NULL;
+  ICall_CSState key;
+
+  key = ICall_enterCSImpl();
+  if (taskentry->syncRsp == NULL)
+  {
+    matchFn = taskentry->syncMatchFn;
+  }
+  ICall_leaveCSImpl(key);
+
+  /* The match function is called with interrupts enabled */
+  if (matchFn != NULL && ICall_msgMatch(matchFn, msg_ptr))
+  {
+    key = ICall_enterCSImpl();
+    /* The wait may have completed in the meantime */
+    if (taskentry->syncMatchFn == matchFn && taskentry->syncRsp == NULL)
+    {
+      ICALL_MSG_NEXT(msg_ptr) = NULL;
+      taskentry->syncRsp = msg_ptr;
+      ICall_leaveCSImpl(key);
+      return;
+    }
+    ICall_leaveCSImpl(key);
+  }
+  ICall_msgEnqueue(&taskentry->queue, msg_ptr);
+}
+
+/**
+ * @internal Sets the match function of the synchronous reply a task is
+ * about to wait for.
+ *
+ * A reply set aside for a previous match function is put back in front of
+ * the message queue.
+ *
+ * @param taskentry  task entry of the calling thread
+ * @param matchFn    match function or NULL to stop setting replies aside
+ */
+static void ICall_syncRspExpect(ICall_TaskEntry *taskentry,
+                                ICall_MsgMatchFn matchFn)
+{
+  void *msg_ptr;
+  ICall_CSState key;
+
+  key = ICall_enterCSImpl();
+  msg_ptr = taskentry->syncRsp;
+  if (taskentry->syncMatchFn == matchFn)
+  {
+    msg_ptr = NULL;
+  }
+  else
+  {
+    taskentry->syncMatchFn = matchFn;
+    taskentry->syncRsp = NULL;
+  }
+  ICall_leaveCSImpl(key);
+
+  if (msg_ptr != NULL)
+  {
+    ICall_msgPrepend(&taskentry->queue, msg_ptr);
+#ifdef ICALL_EVENTS
+    /* The event posted with the message may have been consumed already */
+    ICALL_SYNC_HANDLE_POST(taskentry->syncHandle);
+#endif /* ICALL_EVENTS */
+  }
+}
+
+/**
+ * @internal Retrieves the synchronous reply set aside for a task, if any.
+ * @param taskentry  task entry of the calling thread
+ * @return message pointer or NULL if the reply was not received yet.
+ */
+static void *ICall_syncRspTake(ICall_TaskEntry *taskentry)
+{
+  void *msg_ptr;
+  ICall_CSState key;
+
+  key = ICall_enterCSImpl();
+  msg_ptr = taskentry->syncRsp;
+  taskentry->syncRsp = NULL;
+  ICall_leaveCSImpl(key);
+
+  return msg_ptr;
+}
+
+/**
+ * @internal Starts waiting for a synchronous reply.
+ *
+ * If the match function was announced through ICall_expectMatch(), the
+ * reply cannot be in the message queue and this function returns at once.
+ * Otherwise, the message queue is looked through once for the reply, which
+ * may have been queued before the wait started.
+ *
+ * @param taskentry  task entry of the calling thread
+ * @param matchFn    match function
+ * @return matching message removed from the queue, or NULL if none.
+ */
+static void *ICall_syncRspArm(ICall_TaskEntry *taskentry,
+                              ICall_MsgMatchFn matchFn)
+{
+  void *prev = NULL;
+  void *msg_ptr;
+  ICall_CSState key;
+
+  if (taskentry->syncMatchFn == matchFn)
+  {
+    return NULL;
+  }
+  ICall_syncRspExpect(taskentry, matchFn);
+
+  /* Only the calling thread removes messages from its queue, hence the
+   * queue can be walked with interrupts enabled. Other threads may only
+   * append messages at its end.
+   */
+  for (msg_ptr = taskentry->queue; msg_ptr != NULL;
+       msg_ptr = ICALL_MSG_NEXT(msg_ptr))
+  {
+    if (ICall_msgMatch(matchFn, msg_ptr))
+    {
+      key = ICall_enterCSImpl();
+      if (prev == NULL)
+      {
+        taskentry->queue = ICALL_MSG_NEXT(msg_ptr);
+      }
+      else
+      {
+        ICALL_MSG_NEXT(prev) = ICALL_MSG_NEXT(msg_ptr);
+      }
+      ICall_leaveCSImpl(key);
+      ICALL_MSG_NEXT(msg_ptr) = NULL;
+      return msg_ptr;
+    }
+    prev = msg_ptr;
+  }
+  return NULL;
+}
+
+/**
+ * @internal Ends waiting for a synchronous reply.
+ * @param taskentry  task entry of the calling thread
+ * @param msg_ptr    reply retrieved by the wait, or NULL if none was.
+ * @return the reply, which may have been received after the wait timed out.
+ */
+static void *ICall_syncRspDisarm(ICall_TaskEntry *taskentry, void *msg_ptr)
+{
+  if (msg_ptr == NULL)
+  {
+    msg_ptr = ICall_syncRspTake(taskentry);
+#ifndef ICALL_EVENTS
+    if (msg_ptr != NULL)
+    {
+      /* Consume the semaphore count posted with the late reply */
+      (void) Semaphore_pend(taskentry->syncHandle, BIOS_NO_WAIT);
+    }
+#endif /* ICALL_EVENTS */
+  }
+  ICall_syncRspExpect(taskentry, NULL);
+  return msg_ptr;
+}
+
 #ifndef ICALL_JT
 /**
  * @internal Sends a message to an entity.
@@ -923,7 +1126,7 @@ static ICall_Errno ICall_primSend(ICall_SendArgs *args)
   hdr->srcentity = args->src;
   hdr->dstentity = args->dest.entityId;
   hdr->format = args->format;
-  ICall_msgEnqueue(&ICall_entities[args->dest.entityId].task->queue, args->msg);
+  ICall_msgDeliver(ICall_entities[args->dest.entityId].task, args->msg);
   ICALL_SYNC_HANDLE_POST(ICall_entities[args->dest.entityId].task->syncHandle);
 
   return ICALL_ERRNO_SUCCESS;
@@ -1512,11 +1715,12 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
 {
   Task_Handle taskhandle = Task_self();
   ICall_TaskEntry *taskentry = ICall_searchTask(taskhandle);
-  ICall_MsgQueue prependQueue = NULL;
+  void *msg_ptr;
 #ifndef ICALL_EVENTS
   uint_fast16_t consumedCount = 0;
 #endif
   UInt timeout;
+  uint_fast32_t startStamp;
   uint_fast32_t timeoutStamp;
   ICall_Errno errno;
 
@@ -1559,60 +1763,65 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
   }
 
   errno = ICALL_ERRNO_TIMEOUT;
-  timeoutStamp = Clock_getTicks() + timeout;
-  while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
+  startStamp = Clock_getTicks();
+  timeoutStamp = startStamp + timeout;
+
+  /* The reply may have been queued before the wait started */
+  msg_ptr = ICall_syncRspArm(taskentry, args->matchFn);
+  if (msg_ptr == NULL)
+  {
+    msg_ptr = ICall_syncRspTake(taskentry);
+  }
+  if (msg_ptr != NULL)
   {
-    ICall_FetchMsgArgs fetchArgs;
-    ICall_ServiceEnum servId;
-    errno = ICall_primFetchMsg(&fetchArgs);
-    if (errno == ICALL_ERRNO_SUCCESS)
+#ifndef ICALL_EVENTS
+    /* Consume the semaphore count posted with the reply */
+    (void) Semaphore_pend(taskentry->syncHandle, BIOS_NO_WAIT);
+#endif /* ICALL_EVENTS */
+  }
+  else
+  {
+    while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
     {
-      if (ICall_primEntityId2ServiceId(fetchArgs.src.entityId, &servId) ==
-            ICALL_ERRNO_SUCCESS)
+      /* Only the reply is set aside, other messages stay in the queue
+       * and are not looked at.
+       */
+      msg_ptr = ICall_syncRspTake(taskentry);
+      if (msg_ptr != NULL)
       {
-        if (args->matchFn(servId, fetchArgs.dest, fetchArgs.msg))
-        {
-          /* Matching message found*/
-          args->servId = servId;
-          args->dest = fetchArgs.dest;
-          args->msg = fetchArgs.msg;
-          errno = ICALL_ERRNO_SUCCESS;
-          break;
-        }
+        break;
       }
-      /* Message was received but it wasn't expected one.
-       * Add to the prepend queue */
-      ICall_msgEnqueue(&prependQueue, fetchArgs.msg);
-#ifdef ICALL_EVENTS
-    /* Event are binary semaphore, so if several messsages are posted while
-     * we are processing one, it's possible that some of them are 'missed' and
-     * not processed. Sending a event to ourself force this loop to run until
-     * all the messages in the queue are processed.
-     */
-     ICALL_SYNC_HANDLE_POST(taskentry->syncHandle);
-#endif
-    }
-
-    /* Prepare for timeout exit */
-    errno = ICALL_ERRNO_TIMEOUT;
 
 #ifndef ICALL_EVENTS
-    /* Keep the decremented semaphore count */
-    consumedCount++;
+      /* Keep the decremented semaphore count */
+      consumedCount++;
 #endif  /* ICALL_EVENTS */
-    if (timeout != BIOS_WAIT_FOREVER &&
-        timeout != BIOS_NO_WAIT)
-    {
-      /* Readjust timeout */
-      UInt newTimeout = timeoutStamp - Clock_getTicks();
-      if (newTimeout == 0 || newTimeout > timeout)
+      if (timeout != BIOS_WAIT_FOREVER &&
+          timeout != BIOS_NO_WAIT)
       {
-        break;
+        /* Readjust timeout */
+        UInt newTimeout = timeoutStamp - Clock_getTicks();
+        if (newTimeout == 0 || newTimeout > timeout)
+        {
+          break;
+        }
+        timeout = newTimeout;
       }
-      timeout = newTimeout;
     }
   }
 
+  msg_ptr = ICall_syncRspDisarm(taskentry, msg_ptr);
+  if (msg_ptr != NULL)
+  {
+    ICall_MsgHdr *hdr = (ICall_MsgHdr *) msg_ptr - 1;
+
+    /* Matching message found */
+    (void) ICall_primEntityId2ServiceId(hdr->srcentity, &args->servId);
+    args->dest = hdr->dstentity;
+    args->msg = msg_ptr;
+    errno = ICALL_ERRNO_SUCCESS;
+  }
+
 #ifdef ICALL_EVENTS
   /*
    * Because Events are binary semaphores, the task's queue must be checked for
@@ -1622,8 +1831,6 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
   ICall_primRepostSync();
 #endif //ICALL_EVENTS
 
-  /* Prepend retrieved irrelevant messages */
-  ICall_msgPrepend(&taskentry->queue, prependQueue);
 #ifndef ICALL_EVENTS
   /* Re-increment the consumed semaphores */
   for (; consumedCount > 0; consumedCount--)
@@ -1631,9 +1838,32 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
     Semaphore_post(taskentry->syncHandle);
   }
 #endif /* ICALL_EVENTS */
+  ICALL_HOOK_WAITMATCH_FUNC(args->matchFn, Clock_getTicks() - startStamp,
+                            errno);
   return errno;
 }
 
+/**
+ * @internal
+ * Announces the match function of the next ICall_waitMatch() call.
+ *
+ * @param args  arguments corresponding to those of ICall_expectMatch().
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when the calling thread
+ *         has not registered an entity.
+ */
+static ICall_Errno ICall_primExpectMatch(ICall_ExpectMatchArgs *args)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+
+  if (!taskentry)
+  {
+    return ICALL_ERRNO_UNKNOWN_THREAD;
+  }
+  ICall_syncRspExpect(taskentry, args->matchFn);
+  return ICALL_ERRNO_SUCCESS;
+}
+
 /**
  * @internal
  * Retrieves an entity ID of an entity associated with the calling thread.
@@ -2300,6 +2530,13 @@ static const struct _icall_primsvcfunc_map_entry_t
     NULL
   }, /* ICALL_RTOS_EVENT_API */
 #endif /* ICALL_RTOS_EVENT_API */
+
+  {
+#ifdef COVERAGE_TEST
+    ICALL_PRIMITIVE_FUNC_EXPECT_MATCH,
+#endif /* COVERAGE_TEST */
+    (ICall_PrimSvcFunc) ICall_primExpectMatch
+  },
 };
 /**
  * @internal
@@ -2794,7 +3031,7 @@ ICall_Errno ICall_send(ICall_EntityID src,
   hdr->srcentity = src;
   hdr->dstentity = dest;
   hdr->format = format;
-  ICall_msgEnqueue(&ICall_entities[dest].task->queue, msg);
+  ICall_msgDeliver(ICall_entities[dest].task, msg);
   ICALL_SYNC_HANDLE_POST(ICall_entities[dest].task->syncHandle);
 
   return (ICALL_ERRNO_SUCCESS);
@@ -3612,11 +3849,12 @@ ICall_waitMatch(uint_least32_t milliseconds,
 {
   Task_Handle taskhandle = Task_self();
   ICall_TaskEntry *taskentry = ICall_searchTask(taskhandle);
-  ICall_MsgQueue prependQueue = NULL;
+  void *msg_ptr;
 #ifndef ICALL_EVENTS
   uint_fast16_t consumedCount = 0;
 #endif
   UInt timeout;
+  uint_fast32_t startStamp;
   uint_fast32_t timeoutStamp;
   ICall_Errno errno;
 
@@ -3659,74 +3897,73 @@ ICall_waitMatch(uint_least32_t milliseconds,
   }
 
   errno = ICALL_ERRNO_TIMEOUT;
-  timeoutStamp = Clock_getTicks() + timeout;
+  startStamp = Clock_getTicks();
+  timeoutStamp = startStamp + timeout;
+
+  /* The reply may have been queued before the wait started */
+  msg_ptr = ICall_syncRspArm(taskentry, matchFn);
+  if (msg_ptr == NULL)
+  {
+    msg_ptr = ICall_syncRspTake(taskentry);
+  }
+  if (msg_ptr != NULL)
+  {
+#ifndef ICALL_EVENTS
+    /* Consume the semaphore count posted with the reply */
+    (void) Semaphore_pend(taskentry->syncHandle, BIOS_NO_WAIT);
+#endif /* ICALL_EVENTS */
+  }
+  else
+  {
 #ifdef ICALL_LITE
-  while(ICALL_SYNC_HANDLE_PEND_WM(taskentry->syncHandle, timeout))
+    while (ICALL_SYNC_HANDLE_PEND_WM(taskentry->syncHandle, timeout))
 #else /* !ICALL_LITE */
-  while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
+    while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
 #endif /* ICALL_LITE */
-  {
-    ICall_EntityID fetchSrc;
-    ICall_EntityID fetchDst;
-    ICall_ServiceEnum servId;
-    void *fetchMsg;
-    errno = ICall_fetchMsg(&fetchSrc, &fetchDst, &fetchMsg);
-    if (errno == ICALL_ERRNO_SUCCESS)
     {
-      if (ICall_primEntityId2ServiceId(fetchSrc, &servId) ==
-            ICALL_ERRNO_SUCCESS)
+      /* Only the reply is set aside, other messages stay in the queue
+       * and are not looked at.
+       */
+      msg_ptr = ICall_syncRspTake(taskentry);
+      if (msg_ptr != NULL)
       {
-        if (matchFn(servId, fetchDst, fetchMsg))
+        break;
+      }
+
+#ifndef ICALL_EVENTS
+      /* Keep the decremented semaphore count */
+      consumedCount++;
+#endif  /* ICALL_EVENTS */
+      if (timeout != BIOS_WAIT_FOREVER &&
+          timeout != BIOS_NO_WAIT)
+      {
+        /* Readjust timeout */
+        UInt newTimeout = timeoutStamp - Clock_getTicks();
+        if (newTimeout == 0 || newTimeout > timeout)
         {
-          /* Matching message found*/
-          if (src != NULL)
-          {
-            *src = servId;
-          }
-          if (dest != NULL)
-          {
-            *dest = fetchDst;
-          }
-          *msg = fetchMsg;
-          errno = ICALL_ERRNO_SUCCESS;
           break;
         }
+        timeout = newTimeout;
       }
-      /* Message was received but it wasn't expected one.
-       * Add to the prepend queue */
-      ICall_msgEnqueue(&prependQueue, fetchMsg);
-#ifdef ICALL_EVENTS
-    /* Event are binary semaphore, so if several messsages are posted while
-     * we are processing one, it's possible that some of them are 'missed' and
-     * not processed. Sending a event to ourself force this loop to run until
-     * all the messages in the queue are processed.
-     */
-#ifdef ICALL_LITE
-     ICALL_SYNC_HANDLE_POST_WM(taskentry->syncHandle);
-#else /* !ICALL_LITE */
-     ICALL_SYNC_HANDLE_POST(taskentry->syncHandle);
-#endif /* ICALL_LITE*/
-#endif /* ICALL_EVENTS */
     }
+  }
 
-    /* Prepare for timeout exit */
-    errno = ICALL_ERRNO_TIMEOUT;
+  msg_ptr = ICall_syncRspDisarm(taskentry, msg_ptr);
+  if (msg_ptr != NULL)
+  {
+    ICall_MsgHdr *hdr = (ICall_MsgHdr *) msg_ptr - 1;
 
-#ifndef ICALL_EVENTS
-    /* Keep the decremented semaphore count */
-    consumedCount++;
-#endif  /* ICALL_EVENTS */
-    if (timeout != BIOS_WAIT_FOREVER &&
-        timeout != BIOS_NO_WAIT)
+    /* Matching message found */
+    if (src != NULL)
     {
-      /* Readjust timeout */
-      UInt newTimeout = timeoutStamp - Clock_getTicks();
-      if (newTimeout == 0 || newTimeout > timeout)
-      {
-        break;
-      }
-      timeout = newTimeout;
+      (void) ICall_primEntityId2ServiceId(hdr->srcentity, src);
+    }
+    if (dest != NULL)
+    {
+      *dest = hdr->dstentity;
     }
+    *msg = msg_ptr;
+    errno = ICALL_ERRNO_SUCCESS;
   }
 
 #ifdef ICALL_EVENTS
@@ -3738,8 +3975,6 @@ ICall_waitMatch(uint_least32_t milliseconds,
   ICall_primRepostSync();
 #endif //ICALL_EVENTS
 
-  /* Prepend retrieved irrelevant messages */
-  ICall_msgPrepend(&taskentry->queue, prependQueue);
 #ifndef ICALL_EVENTS
   /* Re-increment the consumed semaphores */
   for (; consumedCount > 0; consumedCount--)
@@ -3747,9 +3982,34 @@ ICall_waitMatch(uint_least32_t milliseconds,
     Semaphore_post(taskentry->syncHandle);
   }
 #endif /* ICALL_EVENTS */
+  ICALL_HOOK_WAITMATCH_FUNC(matchFn, Clock_getTicks() - startStamp, errno);
   return (errno);
 }
 
+/**
+ * Announces the match function of the next ICall_waitMatch() call
+ * of the calling thread, ahead of sending the request it answers.
+ *
+ * @param matchFn  match function which will be passed to ICall_waitMatch(),
+ *                 or NULL to cancel a previous announcement.
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+ICall_Errno ICall_expectMatch(ICall_MsgMatchFn matchFn)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+
+  if (!taskentry)
+  {
+    return (ICALL_ERRNO_UNKNOWN_THREAD);
+  }
+  ICall_syncRspExpect(taskentry, matchFn);
+  return (ICALL_ERRNO_SUCCESS);
+}
+
 /**
  * Retrieves an entity ID of (arbitrary) one of the entities registered
  * from the calling thread.
@@ -3925,6 +4185,10 @@ uint32_t icall_directAPI( uint8_t service , icall_lite_id_t id, ... )
   liteMsg.hdr.dest_id = ICALL_UNDEF_DEST_ID;
   liteMsg.msg.directAPI  = id;
   liteMsg.msg.pointerStack = (uint32_t*)(*((uint32_t*)(&argp)));
+
+  // The stack completes the API before this thread gets to wait for it, so
+  // have the completion set aside rather than queued behind pending events.
+  ICall_expectMatch(matchLiteCS);
   ICall_sendServiceMsg(ICall_getEntityId(), service,
                        ICALL_MSG_FORMAT_DIRECT_API_ID, &(liteMsg.msg));
 
@@ -4009,7 +4273,7 @@ ICall_Errno ICall_sendServiceComplete(ICall_EntityID src,
   hdr->srcentity = src;
   hdr->dstentity = dest;
   hdr->format = format;
-  ICall_msgEnqueue(&ICall_entities[dest].task->queue, msg);
+  ICall_msgDeliver(ICall_entities[dest].task, msg);
   ICALL_SYNC_HANDLE_POST_WM(ICall_entities[dest].task->syncHandle);
 
   return (ICALL_ERRNO_SUCCESS);
@@ -78,6 +78,22 @@ extern void ICALL_HOOK_ABORT_FUNC();
 #define ICALL_HOOK_ABORT_FUNC() abort()
 #endif /* ICALL_HOOK_ABORT */
 
+#ifdef ICALL_HOOK_WAITMATCH_FUNC
+extern void ICALL_HOOK_WAITMATCH_FUNC(ICall_MsgMatchFn matchFn,
+                                      uint_fast32_t ticks,
+                                      ICall_Errno status);
+#else /* ICALL_HOOK_WAITMATCH_FUNC */
+/**
+ * Synchronous call trace function definition.
+ * It is called each time ICall_waitMatch() returns, with the match function,
+ * the number of RTOS ticks spent in the call and the returned error code.
+ * Note that at compile time, this macro can be overridden to point to
+ * a function of the above type, in order to measure the latency of
+ * synchronous API calls.
+ */
+#define ICALL_HOOK_WAITMATCH_FUNC(_matchFn, _ticks, _status)
+#endif /* ICALL_HOOK_WAITMATCH_FUNC */
+
 /**
  * @internal
  * Updates power activity counter
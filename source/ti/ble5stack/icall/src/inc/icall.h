@@ -416,6 +416,9 @@ extern "C" {
 /** @internal Primitive service "post event" function id */
 #define ICALL_PRIMITIVE_FUNC_POST_EVENT                   44
 #endif  /* ICALL_EVENTS */
+
+/** @internal Primitive service "expect match" function id */
+#define ICALL_PRIMITIVE_FUNC_EXPECT_MATCH                 45
 /// @endcond // NODOC
 
 /**
@@ -829,6 +832,13 @@ typedef struct _icall_wait_match_args_t
   void *msg;                    //!< field to store the starting address of the message body
 } ICall_WaitMatchArgs;
 
+/** @brief @ref ICall_expectMatch  arguments */
+typedef struct _icall_expect_match_args_t
+{
+  ICall_FuncArgsHdr hdr;        //!< common arguments
+  ICall_MsgMatchFn matchFn;     //!< match function
+} ICall_ExpectMatchArgs;
+
 /** @brief @ref ICall_getEntityId  arguments */
 typedef struct _icall_get_entity_id_args_t
 {
@@ -1765,6 +1775,27 @@ ICall_waitMatch(uint_least32_t milliseconds,
                 ICall_EntityID *dest,
                 void **msg);
 
+/**
+ * @brief Announces the match function of the next ICall_waitMatch() call
+ * of the calling thread, ahead of sending the request it answers.
+ *
+ * From then on, the first message sent to the calling thread which matches
+ * is set aside from its message queue, so that ICall_waitMatch() picks it
+ * up without going through the messages queued in front of it.
+ * Messages queued before this call are not matched against.
+ *
+ * @param matchFn  match function which will be passed to ICall_waitMatch(),
+ *                 or NULL to cancel a previous announcement, for instance
+ *                 when the request could not be sent.
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.
+ * @return @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService
+ *         or through ICall_registerApp .
+ */
+ICall_Errno
+ICall_expectMatch(ICall_MsgMatchFn matchFn);
+
 /**
  * @brief Retrieves an entity ID of (arbitrary) one of the entities registered
  * from the calling thread.
@@ -2838,6 +2869,34 @@ ICall_waitMatch(uint_least32_t milliseconds,
   return errno;
 }
 
+/**
+ * @brief Announces the match function of the next ICall_waitMatch() call
+ * of the calling thread, ahead of sending the request it answers.
+ *
+ * From then on, the first message sent to the calling thread which matches
+ * is set aside from its message queue, so that ICall_waitMatch() picks it
+ * up without going through the messages queued in front of it.
+ * Messages queued before this call are not matched against.
+ *
+ * @param matchFn  match function which will be passed to ICall_waitMatch(),
+ *                 or NULL to cancel a previous announcement, for instance
+ *                 when the request could not be sent.
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.
+ * @return @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService
+ *         or through ICall_registerApp .
+ */
+static ICall_Errno
+ICall_expectMatch(ICall_MsgMatchFn matchFn)
+{
+  ICall_ExpectMatchArgs args;
+  args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+  args.hdr.func = ICALL_PRIMITIVE_FUNC_EXPECT_MATCH;
+  args.matchFn = matchFn;
+  return ICall_dispatcher((ICall_FuncArgsHdr *)&args);
+}
+
 /**
  * @brief Retrieves an entity ID of (arbitrary) one of the entities registered
  * from the calling thread.
@@ -49,6 +49,7 @@
  */
 #include "osal_snv.h"
 #include "osal_bufmgr.h"
+#include "hal_mcu.h"
 
 #include "sm.h"
 #include "gap.h"
@@ -146,6 +147,9 @@ uint8 bleDispatch_TaskID;
 // Outgoing response
 uint8 rspBuf[MAX_RSP_BUF];
 
+// Payload bytes copied into stack buffers vs. handed over as is
+static bleDispatchDataStats_t bleDispatch_DataStats = {0};
+
 #if defined(HCI_TL_FULL) && defined(HOST_CONFIG)
   // The device's local keys
   static uint8 IRK[KEYLEN] = {0};
@@ -365,21 +369,37 @@ uint16_t bleDispatch_ProcessEvent(uint8_t task_id, uint16_t events)
           {
             hciDataPacket_t *pHciData = (hciDataPacket_t *)pMsg;
             uint8 *pData = pHciData->pData;
+            uint16 payloadLen = osal_bm_payload_len(pData);
+
+            // A length of 0 means pData was not allocated with HCI_bm_alloc,
+            // which an empty packet would otherwise pass as
+            if (payloadLen != 0 && payloadLen >= pHciData->pktLen)
+            {
+              // Data was allocated with HCI_bm_alloc, hand it over as is
+              bleDispatch_DataStats.bytesPassed += pHciData->pktLen;
+            }
+            else
+            {
+              // Replace data with bm data
+              pHciData->pData = HCI_bm_alloc(pHciData->pktLen);
 
-            // Replace data with bm data
-            pHciData->pData = HCI_bm_alloc(pHciData->pktLen);
+              if (pHciData->pData)
+              {
+                VOID osal_memcpy(pHciData->pData, pData, pHciData->pktLen);
+
+                bleDispatch_DataStats.bytesCopied += pHciData->pktLen;
+              }
+
+              osal_mem_free(pData);
+            }
 
             if (pHciData->pData)
             {
-              VOID osal_memcpy(pHciData->pData, pData, pHciData->pktLen);
-
               // Send it to the HCI handler
               (void)osal_msg_send(hciTaskID, (uint8*)(pMsg));
 
               dealloc = FALSE;
             }
-
-            osal_mem_free(pData);
           }
           break;
 
@@ -1160,6 +1180,34 @@ void bleDispatch_BMFree(uint8_t type, void *pBuf, uint8_t opcode)
       break;
   }
 }
+
+/*********************************************************************
+ * @fn      bleDispatch_GetDataStats
+ *
+ * @brief   Get the number of payload bytes the dispatcher copied into
+ *          stack buffers and the number it handed over without a copy.
+ *
+ * @param   pStats - pointer to the statistics to be returned.
+ * @param   reset - TRUE to clear the statistics once read.
+ *
+ * @return  none
+ */
+void bleDispatch_GetDataStats(bleDispatchDataStats_t *pStats, uint8_t reset)
+{
+  halIntState_t cs;
+
+  HAL_ENTER_CRITICAL_SECTION(cs);
+
+  *pStats = bleDispatch_DataStats;
+
+  if (reset)
+  {
+    bleDispatch_DataStats.bytesCopied = 0;
+    bleDispatch_DataStats.bytesPassed = 0;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(cs);
+}
 #if defined(HOST_CONFIG) && (HOST_CONFIG & (CENTRAL_CFG | PERIPHERAL_CFG))
 
 /*********************************************************************
@@ -5220,6 +5268,8 @@ static uint8 *createPayload( uint8 *pBuf, uint16 len, uint8 sigLen )
     // Copy received data over
     VOID osal_memcpy( pPayload, pBuf, len );
 
+    bleDispatch_DataStats.bytesCopied += len;
+
     return ( pPayload );
   }
 
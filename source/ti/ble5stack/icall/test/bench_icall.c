@@ -0,0 +1,375 @@
+/******************************************************************************
+
+ @file  bench_icall.c
+
+ @brief Host benchmark of the ICall primitives on the pthread port.
+
+        Runs icall.c on the TI-RTOS stand-in of icall/src/host with two
+        tasks, a BLE-like service and an application, and measures:
+        - message round trips: ICall_send/ICall_wait/ICall_fetchMsg
+          between the tasks, in host time and context switches,
+        - timer accuracy: virtual ticks at which ICall_setTimerMSecs
+          callbacks fire, and at which ICall_wait times out, against
+          the requested timeouts,
+        - heap behaviour: ICall_malloc/ICall_free under a synthetic mix
+          of HCI event, ACL data and GATT sized blocks with random
+          lifetimes, reporting failures, fragmentation and pointer
+          alignment.
+        The checks make the program fail when a result is wrong; the
+        timings are printed for comparison between builds.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2004-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "icall_host.h"
+#include "icall.h"
+
+/*********************************************************************
+ * EXTERNAL FUNCTIONS
+ */
+// icall.c only exports ICall_heapGetStats() in jump table builds
+extern void ICall_heapGetStats(ICall_heapStats_t *stats);
+extern void ICall_heapMgrGetMetrics(uint32_t *pBlkMax, uint32_t *pBlkCnt,
+                                    uint32_t *pBlkFree, uint32_t *pMemAlo,
+                                    uint32_t *pMemMax, uint32_t *pMemUB);
+
+/*********************************************************************
+ * CONSTANTS
+ */
+#define BENCH_ROUND_TRIPS     20000
+#define BENCH_HEAP_SLOTS      64
+#define BENCH_HEAP_OPS        200000
+
+// Virtual ticks per millisecond
+#define BENCH_TICKS_PER_MS    (1000 / ICALLHOST_TICK_PERIOD)
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+typedef struct
+{
+  uint32_t seq;
+  uint32_t payload[3];
+} benchMsg_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+static ICall_EntityID benchServiceId;
+static ICall_EntityID benchAppId;
+static uint32_t benchServed;
+
+static volatile uint32_t benchTimerTick;
+static volatile uint32_t benchTimerCount;
+
+static uint8_t *benchHeapBlocks[BENCH_HEAP_SLOTS];
+static uint16_t benchHeapSizes[BENCH_HEAP_SLOTS];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static double benchNowNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((double)ts.tv_sec * 1e9 + (double)ts.tv_nsec);
+}
+
+/*********************************************************************
+ * @fn      benchServiceTask
+ *
+ * @brief   Service task: echoes every message back to its sender.
+ */
+static void benchServiceTask(const ICall_RemoteTaskArg *arg, void *params)
+{
+  ICall_SyncHandle syncHandle;
+
+  (void)arg;
+  (void)params;
+
+  ICall_enrollService(ICALL_SERVICE_CLASS_BLE, NULL, &benchServiceId,
+                      &syncHandle);
+
+  for (;;)
+  {
+    ICall_EntityID src;
+    ICall_EntityID dest;
+    void *msg;
+
+    if (ICall_wait(ICALL_TIMEOUT_FOREVER) != ICALL_ERRNO_SUCCESS)
+    {
+      continue;
+    }
+
+    while (ICall_fetchMsg(&src, &dest, &msg) == ICALL_ERRNO_SUCCESS)
+    {
+      benchServed++;
+      ICall_send(benchServiceId, src, ICALL_MSG_FORMAT_KEEP, msg);
+    }
+  }
+}
+
+static void benchRoundTrips(void)
+{
+  uint32_t switches = ICallHost_getSwitchCount();
+  double start = benchNowNs();
+  double elapsed;
+
+  for (uint32_t i = 0; i < BENCH_ROUND_TRIPS; i++)
+  {
+    benchMsg_t *msg = ICall_allocMsg(sizeof(benchMsg_t));
+    ICall_EntityID src;
+    ICall_EntityID dest;
+    void *reply;
+
+    assert(msg != NULL);
+    msg->seq = i;
+    assert(ICall_send(benchAppId, benchServiceId, ICALL_MSG_FORMAT_KEEP,
+                      msg) == ICALL_ERRNO_SUCCESS);
+    assert(ICall_wait(ICALL_TIMEOUT_FOREVER) == ICALL_ERRNO_SUCCESS);
+    assert(ICall_fetchMsg(&src, &dest, &reply) == ICALL_ERRNO_SUCCESS);
+    assert((reply == msg) && (((benchMsg_t *)reply)->seq == i));
+    ICall_freeMsg(reply);
+  }
+
+  elapsed = benchNowNs() - start;
+  switches = ICallHost_getSwitchCount() - switches;
+
+  assert(benchServed == BENCH_ROUND_TRIPS);
+  printf("round trips: %u in %.0f ns each, %.1f context switches each\n",
+         BENCH_ROUND_TRIPS, elapsed / BENCH_ROUND_TRIPS,
+         (double)switches / BENCH_ROUND_TRIPS);
+}
+
+static void benchTimerCback(void *arg)
+{
+  (void)arg;
+
+  benchTimerTick = Clock_getTicks();
+  benchTimerCount++;
+}
+
+static void benchTimers(void)
+{
+  static const uint32_t timeouts[] = { 1, 5, 10, 25, 100, 1000 };
+
+  for (uint32_t i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++)
+  {
+    ICall_TimerID id = ICALL_INVALID_TIMER_ID;
+    uint32_t count = benchTimerCount;
+    uint32_t start = Clock_getTicks();
+    uint32_t expected = timeouts[i] * BENCH_TICKS_PER_MS;
+    uint32_t waited;
+
+    assert(ICall_setTimerMSecs(timeouts[i], benchTimerCback, NULL, &id) ==
+           ICALL_ERRNO_SUCCESS);
+
+    // Waiting past the timer lets the virtual clock run up to it
+    assert(ICall_wait(timeouts[i] * 2) == ICALL_ERRNO_TIMEOUT);
+    waited = Clock_getTicks() - start;
+
+    assert(benchTimerCount == count + 1);
+    printf("timer %4u ms: fired after %7u ticks (expected %7u), "
+           "wait timed out after %7u ticks (expected %7u)\n",
+           timeouts[i], benchTimerTick - start, expected, waited,
+           2 * expected);
+    assert(benchTimerTick - start == expected);
+    assert(waited == 2 * expected);
+  }
+}
+
+static uint16_t benchHeapSize(void)
+{
+  int kind = rand() % 100;
+
+  if (kind < 60)
+  {
+    // HCI events and small stack messages
+    return (uint16_t)(8 + rand() % 40);
+  }
+  else if (kind < 90)
+  {
+    // ACL data, up to the LE data length
+    return (uint16_t)(27 + rand() % 225);
+  }
+  else
+  {
+    // GATT long values
+    return (uint16_t)(256 + rand() % 257);
+  }
+}
+
+static void benchHeap(void)
+{
+  ICall_heapStats_t stats;
+  uint32_t failures = 0;
+  uint32_t allocs = 0;
+  uint32_t worstLargest = ~0u;
+  uint32_t worstFree = 0;
+  double start;
+  double elapsed;
+
+  srand(1);
+  ICall_heapGetStats(&stats);
+  printf("heap: %u bytes, %u free\n", stats.totalSize, stats.totalFreeSize);
+
+  start = benchNowNs();
+
+  for (uint32_t i = 0; i < BENCH_HEAP_OPS; i++)
+  {
+    int slot = rand() % BENCH_HEAP_SLOTS;
+
+    if (benchHeapBlocks[slot] != NULL)
+    {
+      for (uint16_t k = 0; k < benchHeapSizes[slot]; k++)
+      {
+        assert(benchHeapBlocks[slot][k] == (uint8_t)slot);
+      }
+
+      ICall_free(benchHeapBlocks[slot]);
+      benchHeapBlocks[slot] = NULL;
+    }
+    else
+    {
+      benchHeapSizes[slot] = benchHeapSize();
+      benchHeapBlocks[slot] = ICall_malloc(benchHeapSizes[slot]);
+      allocs++;
+
+      if (benchHeapBlocks[slot] == NULL)
+      {
+        failures++;
+        continue;
+      }
+
+      // Blocks must be aligned for the pointers messages carry
+      assert(((uintptr_t)benchHeapBlocks[slot] % sizeof(void *)) == 0);
+      memset(benchHeapBlocks[slot], slot, benchHeapSizes[slot]);
+    }
+
+    if ((i % 1000) == 0)
+    {
+      ICall_heapGetStats(&stats);
+
+      if (stats.largestFreeSize < worstLargest)
+      {
+        worstLargest = stats.largestFreeSize;
+        worstFree = stats.totalFreeSize;
+      }
+    }
+  }
+
+  elapsed = benchNowNs() - start;
+
+  for (int slot = 0; slot < BENCH_HEAP_SLOTS; slot++)
+  {
+    if (benchHeapBlocks[slot] != NULL)
+    {
+      ICall_free(benchHeapBlocks[slot]);
+      benchHeapBlocks[slot] = NULL;
+    }
+  }
+
+  printf("heap: %u allocations, %u failed, %.0f ns per operation\n",
+         allocs, failures, elapsed / BENCH_HEAP_OPS);
+  printf("heap: worst largest free block %u bytes with %u bytes free\n",
+         worstLargest, worstFree);
+
+  {
+    uint32_t blkMax, blkCnt, blkFree, memAlo, memMax, memUB;
+
+    ICall_heapMgrGetMetrics(&blkMax, &blkCnt, &blkFree, &memAlo, &memMax,
+                            &memUB);
+    printf("heap: at most %u blocks, %u bytes allocated at once\n",
+           blkMax, memMax);
+  }
+}
+
+/*********************************************************************
+ * @fn      benchAppTask
+ *
+ * @brief   Application task: runs the benchmarks and ends the run.
+ */
+static void benchAppTask(const ICall_RemoteTaskArg *arg, void *params)
+{
+  ICall_SyncHandle syncHandle;
+
+  (void)arg;
+  (void)params;
+
+  ICall_registerApp(&benchAppId, &syncHandle);
+
+  benchRoundTrips();
+  benchTimers();
+  benchHeap();
+
+  BIOS_exit(0);
+}
+
+/*********************************************************************
+ * IMAGE CONFIGURATION
+ */
+const ICall_RemoteTaskEntry ICall_imgEntries[] =
+{
+  (ICall_RemoteTaskEntry)benchServiceTask,
+  (ICall_RemoteTaskEntry)benchAppTask
+};
+const Int ICall_imgTaskPriorities[] = { 5, 3 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024, 1024 };
+const void *ICall_imgInitParams[] = { NULL, NULL };
+const uint_least8_t ICall_numImages = 2;
+
+int main(void)
+{
+  ICall_init();
+  ICall_createRemoteTasks();
+  BIOS_start();
+
+  return 0;
+}
@@ -0,0 +1,446 @@
+/******************************************************************************
+
+ @file  test_icall_match.c
+
+ @brief Host test of the synchronous reply slot of ICall_waitMatch().
+
+        Runs icall.c on the TI-RTOS stand-in of icall/src/host with a
+        BLE-like service task, which answers requests with a burst of
+        events followed by the reply, and an application task which
+        checks that:
+        - a reply announced with ICall_expectMatch() is returned by
+          ICall_waitMatch() ahead of the events queued before it, and
+          the events are then fetched in order,
+        - a reply queued before an unannounced ICall_waitMatch() is
+          still found in the queue,
+        - a reply received after ICall_waitMatch() timed out, or one
+          which does not match, is queued like any other message,
+        - a failed send followed by ICall_expectMatch(NULL) does not
+          leave the slot catching the next matching message, and a
+          forgotten announcement hides it from ICall_fetchMsg() until
+          it is cancelled,
+        - only the service thread serves ICALL_SERVICE_CLASS_BLE, which
+          the Command Status calls of icall_api.c rely on to skip the
+          announcement on the BLE Stack thread,
+        - ICALL_HOOK_WAITMATCH_FUNC reports the match function, the
+          ticks spent waiting and the returned error code.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2004-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <assert.h>
+#include <stdio.h>
+
+#include "icall_host.h"
+#include "icall.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+// Virtual ticks per millisecond
+#define TEST_TICKS_PER_MS     (1000 / ICALLHOST_TICK_PERIOD)
+
+// Events the service sends ahead of an immediate reply
+#define TEST_NUM_EVENTS       3
+
+// Message kinds
+#define TEST_REQ_NOW          1   // reply at once, after the events
+#define TEST_REQ_LATE         2   // keep the reply until TEST_REQ_KICK
+#define TEST_REQ_KICK         3
+#define TEST_EVT              4
+#define TEST_RSP              5
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+typedef struct
+{
+  uint8_t kind;
+  uint8_t seq;
+} testMsg_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+static ICall_EntityID testServiceId;
+static ICall_EntityID testAppId;
+static uint8_t testServiceServesBle;
+
+// Sequence number of the reply testMatchRsp() accepts
+static uint8_t testExpectSeq;
+
+// Reply held back by the service until TEST_REQ_KICK
+static uint8_t testLateSeq;
+static uint8_t testLatePending;
+
+// Last report of the wait match hook
+static ICall_MsgMatchFn testHookMatchFn;
+static uint_fast32_t testHookTicks;
+static ICall_Errno testHookStatus;
+static uint32_t testHookCount;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      testWaitMatchHook
+ *
+ * @brief   ICALL_HOOK_WAITMATCH_FUNC of this build.
+ */
+void testWaitMatchHook(ICall_MsgMatchFn matchFn, uint_fast32_t ticks,
+                       ICall_Errno status)
+{
+  testHookMatchFn = matchFn;
+  testHookTicks = ticks;
+  testHookStatus = status;
+  testHookCount++;
+}
+
+static bool testMatchRsp(ICall_ServiceEnum src, ICall_EntityID dest,
+                         const void *msg)
+{
+  const testMsg_t *pMsg = msg;
+
+  (void)dest;
+
+  return ((src == ICALL_SERVICE_CLASS_BLE) && (pMsg->kind == TEST_RSP) &&
+          (pMsg->seq == testExpectSeq));
+}
+
+static void testSendMsg(ICall_EntityID src, ICall_EntityID dest,
+                        uint8_t kind, uint8_t seq)
+{
+  testMsg_t *msg = ICall_allocMsg(sizeof(testMsg_t));
+
+  assert(msg != NULL);
+  msg->kind = kind;
+  msg->seq = seq;
+  assert(ICall_send(src, dest, ICALL_MSG_FORMAT_KEEP, msg) ==
+         ICALL_ERRNO_SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      testServiceTask
+ *
+ * @brief   Service task: answers the requests of the application.
+ */
+static void testServiceTask(const ICall_RemoteTaskArg *arg, void *params)
+{
+  ICall_SyncHandle syncHandle;
+
+  (void)arg;
+  (void)params;
+
+  ICall_enrollService(ICALL_SERVICE_CLASS_BLE, NULL, &testServiceId,
+                      &syncHandle);
+  testServiceServesBle = ICall_threadServes(ICALL_SERVICE_CLASS_BLE);
+
+  for (;;)
+  {
+    ICall_EntityID src;
+    ICall_EntityID dest;
+    testMsg_t *msg;
+
+    if (ICall_wait(ICALL_TIMEOUT_FOREVER) != ICALL_ERRNO_SUCCESS)
+    {
+      continue;
+    }
+
+    while (ICall_fetchMsg(&src, &dest, (void **)&msg) == ICALL_ERRNO_SUCCESS)
+    {
+      switch (msg->kind)
+      {
+        case TEST_REQ_NOW:
+          for (uint8_t i = 0; i < TEST_NUM_EVENTS; i++)
+          {
+            testSendMsg(testServiceId, testAppId, TEST_EVT, i);
+          }
+          testSendMsg(testServiceId, testAppId, TEST_RSP, msg->seq);
+          break;
+
+        case TEST_REQ_LATE:
+          testLateSeq = msg->seq;
+          testLatePending = 1;
+          break;
+
+        case TEST_REQ_KICK:
+          assert(testLatePending);
+          testLatePending = 0;
+          testSendMsg(testServiceId, testAppId, TEST_RSP, testLateSeq);
+          break;
+
+        default:
+          assert(0);
+      }
+      ICall_freeMsg(msg);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      testFetch
+ *
+ * @brief   Fetch the next message of the application, which must be
+ *          of the given kind and sequence number.
+ */
+static void testFetch(uint8_t kind, uint8_t seq)
+{
+  ICall_ServiceEnum src;
+  ICall_EntityID dest;
+  testMsg_t *msg;
+
+  assert(ICall_wait(ICALL_TIMEOUT_FOREVER) == ICALL_ERRNO_SUCCESS);
+  assert(ICall_fetchServiceMsg(&src, &dest, (void **)&msg) ==
+         ICALL_ERRNO_SUCCESS);
+  assert((src == ICALL_SERVICE_CLASS_BLE) && (dest == testAppId));
+  assert((msg->kind == kind) && (msg->seq == seq));
+  ICall_freeMsg(msg);
+}
+
+/*********************************************************************
+ * @fn      testFetchEvents
+ *
+ * @brief   Fetch the events sent ahead of an immediate reply, and check
+ *          that nothing else is left for the application.
+ */
+static void testFetchEvents(void)
+{
+  for (uint8_t i = 0; i < TEST_NUM_EVENTS; i++)
+  {
+    testFetch(TEST_EVT, i);
+  }
+
+  // No message, and no semaphore count, left behind
+  assert(ICall_wait(1) == ICALL_ERRNO_TIMEOUT);
+}
+
+static void testWaitRsp(uint32_t timeout, ICall_Errno status, uint8_t seq)
+{
+  ICall_ServiceEnum src;
+  ICall_EntityID dest;
+  testMsg_t *msg = NULL;
+  uint32_t count = testHookCount;
+
+  assert(ICall_waitMatch(timeout, testMatchRsp, &src, &dest,
+                         (void **)&msg) == status);
+
+  assert((testHookCount == count + 1) && (testHookMatchFn == testMatchRsp) &&
+         (testHookStatus == status));
+
+  if (status == ICALL_ERRNO_SUCCESS)
+  {
+    assert((src == ICALL_SERVICE_CLASS_BLE) && (dest == testAppId));
+    assert((msg->kind == TEST_RSP) && (msg->seq == seq));
+    ICall_freeMsg(msg);
+  }
+}
+
+static void testExpectMatch(void)
+{
+  testExpectSeq = 1;
+  assert(ICall_expectMatch(testMatchRsp) == ICALL_ERRNO_SUCCESS);
+  testSendMsg(testAppId, testServiceId, TEST_REQ_NOW, 1);
+
+  // The reply was set aside while the events were queued
+  testWaitRsp(ICALL_TIMEOUT_FOREVER, ICALL_ERRNO_SUCCESS, 1);
+  assert(testHookTicks == 0);
+  testFetchEvents();
+
+  printf("expect match: reply returned ahead of %u events\n",
+         TEST_NUM_EVENTS);
+}
+
+static void testQueuedReply(void)
+{
+  testExpectSeq = 2;
+  testSendMsg(testAppId, testServiceId, TEST_REQ_NOW, 2);
+
+  // Without the announcement the reply is queued behind the events
+  testWaitRsp(ICALL_TIMEOUT_FOREVER, ICALL_ERRNO_SUCCESS, 2);
+  assert(testHookTicks == 0);
+  testFetchEvents();
+
+  printf("queued reply: found behind %u events\n", TEST_NUM_EVENTS);
+}
+
+static void testLateReply(void)
+{
+  uint32_t start;
+
+  testExpectSeq = 3;
+  assert(ICall_expectMatch(testMatchRsp) == ICALL_ERRNO_SUCCESS);
+  testSendMsg(testAppId, testServiceId, TEST_REQ_LATE, 3);
+
+  start = Clock_getTicks();
+  testWaitRsp(10, ICALL_ERRNO_TIMEOUT, 3);
+  assert(testHookTicks == 10 * TEST_TICKS_PER_MS);
+  assert(Clock_getTicks() - start == 10 * TEST_TICKS_PER_MS);
+
+  // The timed out wait released the slot, so the late reply is queued
+  testSendMsg(testAppId, testServiceId, TEST_REQ_KICK, 0);
+  testFetch(TEST_RSP, 3);
+  assert(ICall_wait(1) == ICALL_ERRNO_TIMEOUT);
+
+  printf("late reply: wait timed out after %u ticks, reply queued\n",
+         (unsigned)testHookTicks);
+}
+
+static void testUnmatchedReply(void)
+{
+  testExpectSeq = 5;
+  assert(ICall_expectMatch(testMatchRsp) == ICALL_ERRNO_SUCCESS);
+  testSendMsg(testAppId, testServiceId, TEST_REQ_NOW, 4);
+
+  // The reply to another request does not fill the slot
+  testWaitRsp(10, ICALL_ERRNO_TIMEOUT, 5);
+  for (uint8_t i = 0; i < TEST_NUM_EVENTS; i++)
+  {
+    testFetch(TEST_EVT, i);
+  }
+  testFetch(TEST_RSP, 4);
+  assert(ICall_wait(1) == ICALL_ERRNO_TIMEOUT);
+
+  printf("unmatched reply: queued in order\n");
+}
+
+static void testFailedSend(void)
+{
+  testMsg_t *msg = ICall_allocMsg(sizeof(testMsg_t));
+  ICall_ServiceEnum src;
+  ICall_EntityID dest;
+  void *fetched;
+
+  // As sendServiceMsgCS() of icall_api.c does, announce, send and
+  // cancel the announcement when no reply will come.
+  testExpectSeq = 6;
+  assert(msg != NULL);
+  msg->kind = TEST_REQ_NOW;
+  msg->seq = 6;
+  assert(ICall_expectMatch(testMatchRsp) == ICALL_ERRNO_SUCCESS);
+  assert(ICall_sendServiceMsg(testAppId, ICALL_SERVICE_CLASS_RADIO,
+                              ICALL_MSG_FORMAT_KEEP, msg) ==
+         ICALL_ERRNO_INVALID_SERVICE);
+  assert(ICall_expectMatch(NULL) == ICALL_ERRNO_SUCCESS);
+  ICall_freeMsg(msg);
+
+  // A matching message sent later is fetched as usual
+  testSendMsg(testAppId, testServiceId, TEST_REQ_NOW, 6);
+  for (uint8_t i = 0; i < TEST_NUM_EVENTS; i++)
+  {
+    testFetch(TEST_EVT, i);
+  }
+  testFetch(TEST_RSP, 6);
+  assert(ICall_wait(1) == ICALL_ERRNO_TIMEOUT);
+
+  // Had the announcement been left in place, the slot would hide the
+  // reply from ICall_fetchMsg() until it is cancelled.
+  testExpectSeq = 7;
+  assert(ICall_expectMatch(testMatchRsp) == ICALL_ERRNO_SUCCESS);
+  testSendMsg(testAppId, testServiceId, TEST_REQ_NOW, 7);
+  for (uint8_t i = 0; i < TEST_NUM_EVENTS; i++)
+  {
+    testFetch(TEST_EVT, i);
+  }
+  assert(ICall_wait(ICALL_TIMEOUT_FOREVER) == ICALL_ERRNO_SUCCESS);
+  assert(ICall_fetchServiceMsg(&src, &dest, &fetched) == ICALL_ERRNO_NOMSG);
+
+  // Cancelling puts the reply back in front of the queue
+  assert(ICall_expectMatch(NULL) == ICALL_ERRNO_SUCCESS);
+  assert(ICall_fetchServiceMsg(&src, &dest, &fetched) ==
+         ICALL_ERRNO_SUCCESS);
+  assert((((testMsg_t *)fetched)->kind == TEST_RSP) &&
+         (((testMsg_t *)fetched)->seq == 7));
+  ICall_freeMsg(fetched);
+  assert(ICall_wait(1) == ICALL_ERRNO_TIMEOUT);
+
+  printf("failed send: slot released, forgotten slot hides the reply\n");
+}
+
+/*********************************************************************
+ * @fn      testAppTask
+ *
+ * @brief   Application task: runs the tests and ends the run.
+ */
+static void testAppTask(const ICall_RemoteTaskArg *arg, void *params)
+{
+  ICall_SyncHandle syncHandle;
+
+  (void)arg;
+  (void)params;
+
+  ICall_registerApp(&testAppId, &syncHandle);
+
+  assert(testServiceServesBle);
+  assert(!ICall_threadServes(ICALL_SERVICE_CLASS_BLE));
+
+  testExpectMatch();
+  testQueuedReply();
+  testLateReply();
+  testUnmatchedReply();
+  testFailedSend();
+
+  BIOS_exit(0);
+}
+
+/*********************************************************************
+ * IMAGE CONFIGURATION
+ */
+const ICall_RemoteTaskEntry ICall_imgEntries[] =
+{
+  (ICall_RemoteTaskEntry)testServiceTask,
+  (ICall_RemoteTaskEntry)testAppTask
+};
+const Int ICall_imgTaskPriorities[] = { 5, 3 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024, 1024 };
+const void *ICall_imgInitParams[] = { NULL, NULL };
+const uint_least8_t ICall_numImages = 2;
+
+int main(void)
+{
+  ICall_init();
+  ICall_createRemoteTasks();
+  BIOS_start();
+
+  return 0;
+}
@@ -86,6 +86,24 @@
 /*********************************************************************
  * CONSTANTS
  */
+// Number of task IDs for which the system message queue keeps depth
+// counters. Messages to higher task IDs are still queued, but finding and
+// counting them falls back to a walk of the queue.
+#if !defined OSAL_MSG_Q_MAX_TASKS
+#define OSAL_MSG_Q_MAX_TASKS     16
+#endif
+
+// Number of message event types counted per task. A message whose event
+// type finds no free slot is counted as "other", and while a task has such
+// messages queued, finding and counting by event type walk the queue.
+#if !defined OSAL_MSG_Q_EVENT_SLOTS
+#define OSAL_MSG_Q_EVENT_SLOTS   4
+#endif
+
+#if OSAL_MSG_Q_EVENT_SLOTS < 1
+#error "OSAL_MSG_Q_EVENT_SLOTS must be at least 1"
+#endif
+
 #ifdef USE_ICALL
 // A bit mask to use to indicate a proxy OSAL task ID.
 #define OSAL_PROXY_ID_FLAG       0x80
@@ -100,6 +118,13 @@
  * TYPEDEFS
  */
 
+// Number of queued messages of one event type, a slot is free at count 0
+typedef struct
+{
+  uint8  event;
+  uint16 count;
+} osalMsgQEvent_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -107,6 +132,17 @@
 // Message Pool Definitions
 osal_msg_q_t osal_qHead;
 
+// Last message of osal_qHead, so that sending a message does not walk the queue
+static void *osal_qTail;
+
+// Per task depth and high-water mark of osal_qHead
+static uint16 osal_qDepth[OSAL_MSG_Q_MAX_TASKS];
+static uint16 osal_qHighWater[OSAL_MSG_Q_MAX_TASKS];
+
+// Per task counts of osal_qHead by event type, and of messages left out of them
+static osalMsgQEvent_t osal_qEvents[OSAL_MSG_Q_MAX_TASKS][OSAL_MSG_Q_EVENT_SLOTS];
+static uint16 osal_qOtherEvents[OSAL_MSG_Q_MAX_TASKS];
+
 #ifdef USE_ICALL
 // OSAL event loop hook function pointer
 void (*osal_eventloop_hook)(void) = NULL;
@@ -177,6 +213,8 @@ static uint8 osal_notask_entity;
  */
 
 static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 urgent );
+static void osal_msg_q_count( uint8 task_id, uint8 *msg_ptr, int8 delta );
+static osalMsgQEvent_t *osal_msg_q_event( uint8 task_id, uint8 event );
 
 #ifdef USE_ICALL
 static ICall_EntityID osal_proxy2alien(uint8 proxyid);
@@ -807,6 +845,8 @@ uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr )
  */
 static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 push )
 {
+  halIntState_t intState;
+
   if ( msg_ptr == NULL )
   {
     return ( INVALID_MSG_POINTER );
@@ -835,17 +875,38 @@ static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint
 
   OSAL_MSG_ID( msg_ptr ) = destination_task;
 
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
   if ( push == TRUE )
   {
     // prepend the message
-    osal_msg_push( &osal_qHead, msg_ptr );
+    OSAL_MSG_NEXT( msg_ptr ) = osal_qHead;
+    osal_qHead = msg_ptr;
+
+    if ( osal_qTail == NULL )
+    {
+      osal_qTail = msg_ptr;
+    }
   }
   else
   {
-    // append the message
-    osal_msg_enqueue( &osal_qHead, msg_ptr );
+    // append the message after the tail
+    if ( osal_qTail == NULL )
+    {
+      osal_qHead = msg_ptr;
+    }
+    else
+    {
+      OSAL_MSG_NEXT( osal_qTail ) = msg_ptr;
+    }
+
+    osal_qTail = msg_ptr;
   }
 
+  osal_msg_q_count( destination_task, msg_ptr, 1 );
+
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
   // Signal the task that a message is waiting
   osal_set_event( destination_task, SYS_EVENT_MSG );
 
@@ -875,49 +936,84 @@ uint8 *osal_msg_receive( uint8 task_id )
   // Hold off interrupts
   HAL_ENTER_CRITICAL_SECTION(intState);
 
-  // Point to the top of the queue
-  listHdr = osal_qHead;
-
-  // Look through the queue for a message that belongs to the asking task
-  while ( listHdr != NULL )
+  if ( task_id < OSAL_MSG_Q_MAX_TASKS )
   {
-    if ( (listHdr - 1)->dest_id == task_id )
+    // The depth counter tells whether and how many messages are waiting
+    if ( osal_qDepth[task_id] != 0 )
     {
-      if ( foundHdr == NULL )
-      {
-        // Save the first one
-        foundHdr = listHdr;
-      }
-      else
+      // Look through the queue for the first message of the asking task
+      for ( listHdr = osal_qHead; (listHdr - 1)->dest_id != task_id;
+            listHdr = OSAL_MSG_NEXT( listHdr ) )
       {
-        // Second msg found, stop looking
-        break;
+        prevHdr = listHdr;
       }
+
+      foundHdr = listHdr;
     }
-    if ( foundHdr == NULL )
+
+    if ( osal_qDepth[task_id] > 1 )
     {
-      prevHdr = listHdr;
+      // Yes, Signal the task that a message is waiting
+      osal_set_event( task_id, SYS_EVENT_MSG );
+    }
+    else
+    {
+      // No more
+      osal_clear_event( task_id, SYS_EVENT_MSG );
     }
-    listHdr = OSAL_MSG_NEXT( listHdr );
-  }
-
-  // Is there more than one?
-  if ( listHdr != NULL )
-  {
-    // Yes, Signal the task that a message is waiting
-    osal_set_event( task_id, SYS_EVENT_MSG );
   }
   else
   {
-    // No more
-    osal_clear_event( task_id, SYS_EVENT_MSG );
+    // Point to the top of the queue
+    listHdr = osal_qHead;
+
+    // Look through the queue for a message that belongs to the asking task
+    while ( listHdr != NULL )
+    {
+      if ( (listHdr - 1)->dest_id == task_id )
+      {
+        if ( foundHdr == NULL )
+        {
+          // Save the first one
+          foundHdr = listHdr;
+        }
+        else
+        {
+          // Second msg found, stop looking
+          break;
+        }
+      }
+      if ( foundHdr == NULL )
+      {
+        prevHdr = listHdr;
+      }
+      listHdr = OSAL_MSG_NEXT( listHdr );
+    }
+
+    // Is there more than one?
+    if ( listHdr != NULL )
+    {
+      // Yes, Signal the task that a message is waiting
+      osal_set_event( task_id, SYS_EVENT_MSG );
+    }
+    else
+    {
+      // No more
+      osal_clear_event( task_id, SYS_EVENT_MSG );
+    }
   }
 
   // Did we find a message?
   if ( foundHdr != NULL )
   {
+    if ( foundHdr == osal_qTail )
+    {
+      osal_qTail = prevHdr;
+    }
+
     // Take out of the link list
     osal_msg_extract( &osal_qHead, foundHdr, prevHdr );
+    osal_msg_q_count( task_id, (uint8 *)foundHdr, -1 );
   }
 
   // Release interrupts
@@ -953,6 +1049,13 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
 
   pHdr = osal_qHead;  // Point to the top of the queue.
 
+  // Skip the walk when the event counts show that no such message is queued.
+  if ((task_id < OSAL_MSG_Q_MAX_TASKS) && (osal_qOtherEvents[task_id] == 0)
+      && (osal_msg_q_event(task_id, event) == NULL))
+  {
+    pHdr = NULL;
+  }
+
   // Look through the queue for a message that matches the task_id and event parameters.
   while (pHdr != NULL)
   {
@@ -985,7 +1088,7 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
  *
  * None.
  *
- * @return      The number of OSAL messages that match the task ID and Event.
+ * @return      The number of OSAL messages that match the task ID and Event, at most 0xFF.
  **************************************************************************************************
  */
 uint8 osal_msg_count( uint8 task_id, uint8 event )
@@ -998,6 +1101,30 @@ uint8 osal_msg_count( uint8 task_id, uint8 event )
 
   pHdr = osal_qHead;  // Point to the top of the queue.
 
+  if (task_id < OSAL_MSG_Q_MAX_TASKS)
+  {
+    uint16 total = 0xFFFF;
+
+    if (event == 0xFF)
+    {
+      // The depth counter already has the answer.
+      total = osal_qDepth[task_id];
+    }
+    else if (osal_qOtherEvents[task_id] == 0)
+    {
+      // So do the event counts, as long as they cover every queued message.
+      osalMsgQEvent_t *pEvent = osal_msg_q_event(task_id, event);
+
+      total = (pEvent != NULL) ? pEvent->count : 0;
+    }
+
+    if (total != 0xFFFF)
+    {
+      count = (total > 0xFF) ? 0xFF : (uint8)total;
+      pHdr = NULL;
+    }
+  }
+
   // Look through the queue for a message that matches the task_id and event parameters.
   while (pHdr != NULL)
   {
@@ -1015,6 +1142,148 @@ uint8 osal_msg_count( uint8 task_id, uint8 event )
   return ( count );
 }
 
+/*********************************************************************
+ * @fn      osal_msg_q_event
+ *
+ * @brief
+ *
+ *    This function looks up the count of an event type for a task in
+ *    the system message queue. Ints must be disabled.
+ *
+ * @param   uint8 task_id - tracked task ID
+ * @param   uint8 event - event type
+ *
+ * @return  the event count, NULL if no message of that type is counted
+ */
+static osalMsgQEvent_t *osal_msg_q_event( uint8 task_id, uint8 event )
+{
+  uint8 i;
+
+  for ( i = 0; i < OSAL_MSG_Q_EVENT_SLOTS; i++ )
+  {
+    if ( (osal_qEvents[task_id][i].count != 0) &&
+         (osal_qEvents[task_id][i].event == event) )
+    {
+      return ( &osal_qEvents[task_id][i] );
+    }
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_q_count
+ *
+ * @brief
+ *
+ *    This function updates the depth, high-water mark and event type
+ *    counts of a task in the system message queue. Ints must be disabled.
+ *
+ *    The event counts never exceed the number of queued messages of that
+ *    type: a message counted as "other" may be removed from an event
+ *    count, the "other" count then covers the one left behind.
+ *
+ * @param   uint8 task_id - task ID of the queued or removed message
+ * @param   uint8 *msg_ptr - queued or removed message
+ * @param   int8 delta - 1 when a message was queued, -1 when removed
+ *
+ * @return  none
+ */
+static void osal_msg_q_count( uint8 task_id, uint8 *msg_ptr, int8 delta )
+{
+  osalMsgQEvent_t *pEvent;
+  uint8 event;
+  uint8 i;
+
+  if ( task_id < OSAL_MSG_Q_MAX_TASKS )
+  {
+    event = ((osal_event_hdr_t *)msg_ptr)->event;
+    pEvent = osal_msg_q_event( task_id, event );
+
+    if ( delta > 0 )
+    {
+      osal_qDepth[task_id]++;
+
+      if ( osal_qDepth[task_id] > osal_qHighWater[task_id] )
+      {
+        osal_qHighWater[task_id] = osal_qDepth[task_id];
+      }
+
+      // Take a free slot for a new event type
+      for ( i = 0; (pEvent == NULL) && (i < OSAL_MSG_Q_EVENT_SLOTS); i++ )
+      {
+        if ( osal_qEvents[task_id][i].count == 0 )
+        {
+          pEvent = &osal_qEvents[task_id][i];
+          pEvent->event = event;
+        }
+      }
+
+      if ( pEvent != NULL )
+      {
+        pEvent->count++;
+      }
+      else
+      {
+        osal_qOtherEvents[task_id]++;
+      }
+    }
+    else
+    {
+      osal_qDepth[task_id]--;
+
+      if ( pEvent != NULL )
+      {
+        pEvent->count--;
+      }
+      else
+      {
+        osal_qOtherEvents[task_id]--;
+      }
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          osal_msg_q_high_water
+ *
+ * @brief       This function returns the highest number of messages queued at once for a task
+ *              in the OSAL message queue since startup or the last reset.
+ *
+ * input parameters
+ *
+ * @param       task_id - The OSAL task id.
+ * @param       reset - TRUE to restart tracking from the current queue depth.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The high-water mark of the task queue depth, 0 if the task is not tracked.
+ **************************************************************************************************
+ */
+uint16 osal_msg_q_high_water( uint8 task_id, uint8 reset )
+{
+  uint16 highWater = 0;
+  halIntState_t intState;
+
+  if ( task_id < OSAL_MSG_Q_MAX_TASKS )
+  {
+    HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
+
+    highWater = osal_qHighWater[task_id];
+
+    if ( reset )
+    {
+      osal_qHighWater[task_id] = osal_qDepth[task_id];
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState);  // Release interrupts.
+  }
+
+  return ( highWater );
+}
+
 /*********************************************************************
  * @fn      osal_msg_enqueue
  *
@@ -1434,6 +1703,11 @@ uint8 osal_init_system( void )
 
   // Initialize the message queue
   osal_qHead = NULL;
+  osal_qTail = NULL;
+  osal_memset( osal_qDepth, 0, sizeof( osal_qDepth ) );
+  osal_memset( osal_qHighWater, 0, sizeof( osal_qHighWater ) );
+  osal_memset( osal_qEvents, 0, sizeof( osal_qEvents ) );
+  osal_memset( osal_qOtherEvents, 0, sizeof( osal_qOtherEvents ) );
 
   // Initialize the timers
   osalTimerInit();
@@ -253,6 +253,31 @@ void *osal_bm_adjust_tail( void *payload_ptr, int16 size )
   return ( payload_ptr );
 }
 
+/*********************************************************************
+ * @fn      osal_bm_payload_len
+ *
+ * @brief   Get the number of bytes from the payload pointer to the end
+ *          of its buffer. This tells whether a payload handed over by
+ *          another task was allocated by the buffer manager, in which
+ *          case it can be passed on down the stack without a copy.
+ *
+ * @param   payload_ptr - pointer to payload
+ *
+ * @return  number of bytes; 0 if not allocated by the buffer manager
+ */
+uint16 osal_bm_payload_len( void *payload_ptr )
+{
+  bm_desc_t *bd_ptr;
+
+  bd_ptr = bm_desc_from_payload( (uint8 *)payload_ptr );
+  if ( bd_ptr != NULL )
+  {
+    return ( (uint16)( (uint8 *)END_PTR( bd_ptr ) - (uint8 *)payload_ptr ) );
+  }
+
+  return ( 0 );
+}
+
 /*********************************************************************
  * @fn      bm_desc_from_payload
  *
@@ -151,6 +151,44 @@
 #define OSALMEM_PROFILER_LL        FALSE  // Special profiling of the Long-Lived bucket.
 #endif
 
+#if OSALMEM_POOLS
+/* Fixed-size pools carved from the front of the big-block bucket at init time. Allocations made
+ * after osal_mem_kick() too big for the small-block bucket are served from the smallest pool whose
+ * block size fits the request; when that pool is empty, or no pool is large enough, the allocation
+ * falls back to the heap.
+ * Block sizes include the OSALMEM_HDRSZ block header, are rounded up to an even multiple of
+ * OSALMEM_HDRSZ and must be listed in ascending order, up to OSALMEM_POOL_MAX pools. Profile the
+ * application with OSALMEM_PROFILER to choose sizes matching its dominant message sizes.
+ */
+#if !defined OSALMEM_POOL_BLKSZ_LIST
+#define OSALMEM_POOL_BLKSZ_LIST    32, 64, 128
+#endif
+#if !defined OSALMEM_POOL_BLKCNT_LIST
+#define OSALMEM_POOL_BLKCNT_LIST    8,  6,   4
+#endif
+
+#define OSALMEM_POOL_MAX           8
+
+// Element 'n' of a pool list, 0 past its end.
+#define OSALMEM_POOL_ARG(n, ...)   OSALMEM_POOL_ARG_##n(__VA_ARGS__, 0, 0, 0, 0, 0, 0, 0, 0)
+#define OSALMEM_POOL_ARG_0(a, ...)                      a
+#define OSALMEM_POOL_ARG_1(a, b, ...)                   b
+#define OSALMEM_POOL_ARG_2(a, b, c, ...)                c
+#define OSALMEM_POOL_ARG_3(a, b, c, d, ...)             d
+#define OSALMEM_POOL_ARG_4(a, b, c, d, e, ...)          e
+#define OSALMEM_POOL_ARG_5(a, b, c, d, e, f, ...)       f
+#define OSALMEM_POOL_ARG_6(a, b, c, d, e, f, g, ...)    g
+#define OSALMEM_POOL_ARG_7(a, b, c, d, e, f, g, h, ...) h
+
+#define OSALMEM_POOL_SZ(n)         OSALMEM_ROUND(OSALMEM_POOL_ARG(n, OSALMEM_POOL_BLKSZ_LIST))
+#define OSALMEM_POOL_BYTES(n)      (OSALMEM_POOL_SZ(n) * OSALMEM_POOL_ARG(n, OSALMEM_POOL_BLKCNT_LIST))
+
+// Pool 'n' is absent, or its blocks hold a free list link and are larger than those of pool 'p'.
+#define OSALMEM_POOL_OK(n, p)      ((OSALMEM_POOL_SZ(n) == 0) ||                                 \
+                                    ((OSALMEM_POOL_SZ(n) >= (OSALMEM_HDRSZ + sizeof(void *))) && \
+                                     (OSALMEM_POOL_SZ(n) > OSALMEM_POOL_SZ(p))))
+#endif
+
 #if OSALMEM_PROFILER
 #define OSALMEM_INIT              'X'
 #define OSALMEM_ALOC              'A'
@@ -178,6 +216,18 @@ typedef union {
   osalMemHdrHdr_t hdr;
 } osalMemHdr_t;
 
+#if OSALMEM_POOLS
+typedef struct {
+  osalMemHdr_t *end;   // First header past the last block of the pool.
+  osalMemHdr_t *free;  // Free list, linked through the first word of each free block.
+  uint16 blkSz;        // Block size, including the header.
+  uint16 blkCnt;       // Number of blocks in the pool.
+  uint16 blkUsed;      // Current cnt of blocks allocated from the pool.
+  uint16 blkMax;       // Max cnt of blocks ever allocated at once from the pool.
+  uint16 missCnt;      // Cnt of allocations which fell back to the heap because the pool was empty.
+} osalMemPool_t;
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -201,6 +251,30 @@ static uint16 memAlo;  // Current total memory allocated.
 static uint16 memMax;  // Max total memory ever allocated at once.
 #endif
 
+#if OSALMEM_POOLS
+static const uint16 poolBlkSz[] = { OSALMEM_POOL_BLKSZ_LIST };
+static const uint16 poolBlkCnt[] = { OSALMEM_POOL_BLKCNT_LIST };
+#define OSALMEM_POOL_CNT  (sizeof(poolBlkSz) / sizeof(poolBlkSz[0]))
+
+// Compile-time checks of the pool geometry.
+typedef char osalMemPoolListCheck[((sizeof(poolBlkSz) == sizeof(poolBlkCnt)) &&
+                                   (OSALMEM_POOL_CNT <= OSALMEM_POOL_MAX)) ? 1 : -1];
+typedef char osalMemPoolSizeCheck[((OSALMEM_POOL_SZ(0) > OSALMEM_SMALL_BLKSZ) &&
+                                   (OSALMEM_POOL_SZ(0) >= (OSALMEM_HDRSZ + sizeof(void *))) &&
+                                   OSALMEM_POOL_OK(1, 0) && OSALMEM_POOL_OK(2, 1) &&
+                                   OSALMEM_POOL_OK(3, 2) && OSALMEM_POOL_OK(4, 3) &&
+                                   OSALMEM_POOL_OK(5, 4) && OSALMEM_POOL_OK(6, 5) &&
+                                   OSALMEM_POOL_OK(7, 6)) ? 1 : -1];
+typedef char osalMemPoolFitCheck[((OSALMEM_POOL_BYTES(0) + OSALMEM_POOL_BYTES(1) +
+                                   OSALMEM_POOL_BYTES(2) + OSALMEM_POOL_BYTES(3) +
+                                   OSALMEM_POOL_BYTES(4) + OSALMEM_POOL_BYTES(5) +
+                                   OSALMEM_POOL_BYTES(6) + OSALMEM_POOL_BYTES(7) +
+                                   OSALMEM_HDRSZ + OSALMEM_MIN_BLKSZ) <= OSALMEM_BIGBLK_SZ) ? 1 : -1];
+
+static osalMemPool_t osalMemPool[OSALMEM_POOL_CNT];
+static osalMemHdr_t *poolBase;  // First block of the first pool.
+#endif
+
 #if OSALMEM_PROFILER
 #define OSALMEM_PROMAX  8
 /* The profiling buckets must differ by at least OSALMEM_MIN_BLKSZ; the
@@ -224,6 +298,17 @@ static uint16 proSmallBlkMiss;
 extern int dprintf(const char *fmt, ...);
 #endif /* DPRINTF_HEAPTRACE */
 
+/* ------------------------------------------------------------------------------------------------
+ *                                           Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if OSALMEM_POOLS
+static void osal_mem_pool_init(void);
+static osalMemHdr_t *osal_mem_pool_alloc(uint16 size);
+static uint8 osal_mem_pool_free(osalMemHdr_t *hdr);
+#endif
+
 /**************************************************************************************************
  * @fn          osal_mem_init
  *
@@ -259,14 +344,30 @@ void osal_mem_init(void)
   // small-block bucket from ever being coalesced with the wilderness.
   theHeap[OSALMEM_SMALLBLK_HDRCNT].val = (OSALMEM_HDRSZ | OSALMEM_IN_USE);
 
+#if OSALMEM_POOLS
+  osal_mem_pool_init();
+#else
   // Setup the wilderness.
   theHeap[OSALMEM_BIGBLK_IDX].val = OSALMEM_BIGBLK_SZ;  // Set 'len' & clear 'inUse' field.
+#endif
 
 #if ( OSALMEM_METRICS )
   /* Start with the small-block bucket and the wilderness - don't count the
    * end-of-heap NULL block nor the end-of-small-block NULL block.
    */
   blkCnt = blkFree = 2;
+#if OSALMEM_POOLS
+  {
+    uint8 idx;
+
+    for ( idx = 0; idx < OSALMEM_POOL_CNT; idx++ )
+    {
+      blkCnt += osalMemPool[idx].blkCnt;
+    }
+    blkFree = blkCnt;
+    blkMax = blkCnt;
+  }
+#endif
 #endif
 }
 
@@ -352,6 +453,21 @@ void *osal_mem_alloc( uint16 size )
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
+#if OSALMEM_POOLS
+  // Pools are only used once the long-lived allocations have filled the LL block, and only for
+  // allocations too big for the small-block bucket.
+  if ( (osalMemStat != 0) && (size > OSALMEM_SMALL_BLKSZ) &&
+       ((hdr = osal_mem_pool_alloc( size )) != NULL) )
+  {
+    HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+#ifdef DPRINTF_OSALHEAPTRACE
+    dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) hdr, fname, lnum);
+#endif /* DPRINTF_OSALHEAPTRACE */
+    return (void *)hdr;
+  }
+#endif
+
   // Smaller allocations are first attempted in the small-block bucket, and all long-lived
   // allocations are channelled into the LL block reserved within this bucket.
   if ((osalMemStat == 0) || (size <= OSALMEM_SMALL_BLKSZ))
@@ -533,6 +649,15 @@ void osal_mem_free(void *ptr)
   HAL_ASSERT(hdr->hdr.inUse);
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+#if OSALMEM_POOLS
+  if ( osal_mem_pool_free( hdr ) )
+  {
+    HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+    return;
+  }
+#endif
+
   hdr->hdr.inUse = FALSE;
 
   if (ff1 > hdr)
@@ -568,11 +693,212 @@ void osal_mem_free(void *ptr)
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
 }
 
+#if OSALMEM_POOLS
+/**************************************************************************************************
+ * @fn          osal_mem_pool_init
+ *
+ * @brief       This function carves the fixed-size pools out of the front of the big-block bucket
+ *              and sets up the wilderness after them.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void osal_mem_pool_init(void)
+{
+  osalMemHdr_t *hdr;
+  uint16 total = 0;
+  uint8 idx;
+
+  // The pools live behind a single lifetime allocation so that they are skipped over in one step
+  // by the big-block search and never coalesced with the wilderness.
+  poolBase = theHeap + OSALMEM_BIGBLK_IDX + 1;
+  hdr = poolBase;
+
+  for ( idx = 0; idx < OSALMEM_POOL_CNT; idx++ )
+  {
+    osalMemPool_t *pool = osalMemPool + idx;
+    uint16 cnt;
+
+    pool->blkSz = OSALMEM_ROUND(poolBlkSz[idx]);
+    pool->blkCnt = poolBlkCnt[idx];
+    pool->blkUsed = pool->blkMax = pool->missCnt = 0;
+    pool->free = NULL;
+
+    // Build the free list so that the lowest addressed block is handed out first.
+    hdr = (osalMemHdr_t *)((uint8 *)hdr + (pool->blkSz * pool->blkCnt));
+    pool->end = hdr;
+
+    for ( cnt = 0; cnt < pool->blkCnt; cnt++ )
+    {
+      osalMemHdr_t *blk = (osalMemHdr_t *)((uint8 *)hdr - (pool->blkSz * (cnt + 1)));
+
+      blk->val = pool->blkSz;  // Set 'len' & clear 'inUse' field.
+      *(osalMemHdr_t **)(blk + 1) = pool->free;
+      pool->free = blk;
+    }
+
+    total += pool->blkSz * pool->blkCnt;
+  }
+
+  // Set 'len' & 'inUse' fields of the lifetime allocation holding the pools.
+  theHeap[OSALMEM_BIGBLK_IDX].val = ((total + OSALMEM_HDRSZ) | OSALMEM_IN_USE);
+
+  // Setup the wilderness.
+  hdr->val = OSALMEM_BIGBLK_SZ - total - OSALMEM_HDRSZ;  // Set 'len' & clear 'inUse' field.
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_pool_alloc
+ *
+ * @brief       This function allocates a block from the smallest pool fitting 'size'.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param size - the number of bytes needed, including the header and alignment.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the allocated memory, or NULL to fall back to the heap.
+ */
+static osalMemHdr_t *osal_mem_pool_alloc(uint16 size)
+{
+  osalMemPool_t *pool = osalMemPool;
+  osalMemHdr_t *hdr;
+
+  while ( pool->blkSz < size )
+  {
+    if ( ++pool == (osalMemPool + OSALMEM_POOL_CNT) )
+    {
+      return NULL;
+    }
+  }
+
+  if ( (hdr = pool->free) == NULL )
+  {
+    pool->missCnt++;
+    return NULL;
+  }
+
+  pool->free = *(osalMemHdr_t **)(hdr + 1);
+  hdr->hdr.inUse = TRUE;
+
+  if ( ++pool->blkUsed > pool->blkMax )
+  {
+    pool->blkMax = pool->blkUsed;
+  }
+
+#if ( OSALMEM_METRICS )
+  blkFree--;
+  memAlo += pool->blkSz;
+  if ( memMax < memAlo )
+  {
+    memMax = memAlo;
+  }
+#endif
+
+#if ( OSALMEM_PROFILER )
+  (void)osal_memset((uint8 *)(hdr+1), OSALMEM_ALOC, (pool->blkSz - OSALMEM_HDRSZ));
+#endif
+
+  return (hdr + 1);
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_pool_free
+ *
+ * @brief       This function returns a block to its pool if it was allocated from one.
+ *              Ints must be disabled.
+ *
+ * input parameters
+ *
+ * @param hdr - Header of the block to free.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the block belongs to a pool, FALSE if it belongs to the heap.
+ */
+static uint8 osal_mem_pool_free(osalMemHdr_t *hdr)
+{
+  osalMemPool_t *pool = osalMemPool;
+
+  if ( (hdr < poolBase) || (hdr >= osalMemPool[OSALMEM_POOL_CNT - 1].end) )
+  {
+    return FALSE;
+  }
+
+  while ( hdr >= pool->end )
+  {
+    pool++;
+  }
+
+#if ( OSALMEM_PROFILER )
+  (void)osal_memset((uint8 *)(hdr+1), OSALMEM_REIN, (pool->blkSz - OSALMEM_HDRSZ));
+#endif
+
+  hdr->hdr.inUse = FALSE;
+  *(osalMemHdr_t **)(hdr + 1) = pool->free;
+  pool->free = hdr;
+  pool->blkUsed--;
+
+#if ( OSALMEM_METRICS )
+  blkFree++;
+  memAlo -= pool->blkSz;
+#endif
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      osal_mem_pool_stats
+ *
+ * @brief   Return the usage counters of one of the fixed-size pools.
+ *
+ * @param   pool - index of the pool, 0 for the smallest block size.
+ * @param   pStats - filled with the counters of the pool.
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if there is no such pool.
+ */
+uint8 osal_mem_pool_stats( uint8 pool, osalMemPoolStats_t *pStats )
+{
+  halIntState_t intState;
+
+  if ( (pool >= OSALMEM_POOL_CNT) || (pStats == NULL) )
+  {
+    return INVALIDPARAMETER;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  pStats->blkSz = osalMemPool[pool].blkSz;
+  pStats->blkCnt = osalMemPool[pool].blkCnt;
+  pStats->blkUsed = osalMemPool[pool].blkUsed;
+  pStats->blkMax = osalMemPool[pool].blkMax;
+  pStats->missCnt = osalMemPool[pool].missCnt;
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return SUCCESS;
+}
+#endif
+
 #if OSALMEM_METRICS
 /*********************************************************************
  * @fn      osal_heap_block_max
  *
  * @brief   Return the maximum number of blocks ever allocated at once.
+ *          With OSALMEM_POOLS, all pool blocks are counted as blocks.
  *
  * @param   none
  *
@@ -66,25 +66,43 @@
  * MACROS
  */
 
+// Wrap-safe test of an absolute expiry time against the OSAL system clock.
+// Valid since timeouts never exceed OSAL_TIMERS_MAX_TIMEOUT (< 2^31 ms).
+#define OSAL_TIMER_EXPIRED( expiry, now )   ( (int32)((expiry) - (now)) <= 0 )
+
+// Slot of a (task, event) pair in the timer index.
+#define OSAL_TIMER_INDEX_HASH( task_id, event_flag ) \
+  ( (uint8)((uint16)((((uint16)(task_id) << 8) ^ (event_flag)) * 40503u) >> \
+            (16 - OSAL_TIMERS_INDEX_BITS)) )
+
 /*********************************************************************
  * CONSTANTS
  */
 #define MILLS_IN_MICROS                   1000
 
+// The (task, event) timer index holds 2^OSAL_TIMERS_INDEX_BITS entries.
+// Size it above the number of concurrently running timers, additional timers
+// are still served but their lookups fall back to a walk of the timer list.
+#if !defined OSAL_TIMERS_INDEX_BITS
+#define OSAL_TIMERS_INDEX_BITS            5
+#endif
+// Index slots are uint8 and the hash is 16 bits wide.
+#if OSAL_TIMERS_INDEX_BITS < 1 || OSAL_TIMERS_INDEX_BITS > 8
+#error "OSAL_TIMERS_INDEX_BITS must be between 1 and 8"
+#endif
+#define OSAL_TIMERS_INDEX_SIZE            (1 << OSAL_TIMERS_INDEX_BITS)
+
 /*********************************************************************
  * TYPEDEFS
  */
 
-typedef union {
-  uint32 time32;
-  uint16 time16[2];
-  uint8 time8[4];
-} osalTime_t;
-
+// Timer records are kept in a list sorted by absolute expiry time, so a tick
+// only looks at the head of the list. The record size is kept at 16 bytes to
+// fit the OSAL small-block heap bucket.
 typedef struct
 {
   void   *next;
-  osalTime_t timeout;
+  uint32 expiry;          // Absolute expiry time, in osal_systemClock ms
   uint16 event_flag;
   uint8  task_id;
   uint32 reloadTimeout;
@@ -113,6 +131,13 @@ uint_least32_t osal_last_timestamp;
 // Milliseconds since last reboot
 static uint32 osal_systemClock;
 
+// Open addressing (task, event) index of the running timers
+static osalTimerRec_t *osalTimerIndex[OSAL_TIMERS_INDEX_SIZE];
+
+// Number of running timers, and of those missing from the full index
+static uint8 osalTimerCount;
+static uint8 osalTimerIndexOverflow;
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
@@ -120,6 +145,11 @@ osalTimerRec_t  *osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout
 osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag );
 void osalDeleteTimer( osalTimerRec_t *rmTimer );
 
+static void osalTimerListInsert( osalTimerRec_t *newTimer );
+static void osalTimerListRemove( osalTimerRec_t *rmTimer );
+static void osalTimerIndexAdd( osalTimerRec_t *newTimer );
+static void osalTimerIndexRemove( osalTimerRec_t *rmTimer );
+
 /*********************************************************************
  * FUNCTIONS
  *********************************************************************/
@@ -137,12 +167,177 @@ void osalTimerInit( void )
 {
   osal_systemClock = 0;
 
+  osal_memset( osalTimerIndex, 0, sizeof( osalTimerIndex ) );
+  osalTimerCount = 0;
+  osalTimerIndexOverflow = 0;
+
 #ifdef USE_ICALL
   // Initialize variables used to track timing and provide OSAL timer service
   osal_last_timestamp = (uint_least32_t) ICall_getTicks();
 #endif /* USE_ICALL */
 }
 
+/*********************************************************************
+ * @fn      osalTimerListInsert
+ *
+ * @brief   Insert a timer in the timer list, in expiry order.
+ *          Timers with the same expiry keep their start order.
+ *          Ints must be disabled.
+ *
+ * @param   newTimer - timer to insert, with its expiry set
+ *
+ * @return  none
+ */
+static void osalTimerListInsert( osalTimerRec_t *newTimer )
+{
+  osalTimerRec_t *prevTimer = NULL;
+  osalTimerRec_t *srchTimer = timerHead;
+
+  while ( srchTimer &&
+          ((int32)(srchTimer->expiry - newTimer->expiry) <= 0) )
+  {
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  newTimer->next = srchTimer;
+
+  if ( prevTimer == NULL )
+  {
+    timerHead = newTimer;
+  }
+  else
+  {
+    prevTimer->next = newTimer;
+  }
+}
+
+/*********************************************************************
+ * @fn      osalTimerListRemove
+ *
+ * @brief   Take a timer out of the timer list.
+ *          Ints must be disabled.
+ *
+ * @param   rmTimer - timer to remove
+ *
+ * @return  none
+ */
+static void osalTimerListRemove( osalTimerRec_t *rmTimer )
+{
+  osalTimerRec_t *prevTimer = NULL;
+  osalTimerRec_t *srchTimer = timerHead;
+
+  while ( srchTimer && (srchTimer != rmTimer) )
+  {
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  if ( srchTimer )
+  {
+    if ( prevTimer == NULL )
+    {
+      timerHead = srchTimer->next;
+    }
+    else
+    {
+      prevTimer->next = srchTimer->next;
+    }
+
+    srchTimer->next = NULL;
+  }
+}
+
+/*********************************************************************
+ * @fn      osalTimerIndexAdd
+ *
+ * @brief   Add a timer to the (task, event) index.
+ *          Ints must be disabled.
+ *
+ * @param   newTimer - timer to add
+ *
+ * @return  none
+ */
+static void osalTimerIndexAdd( osalTimerRec_t *newTimer )
+{
+  uint8 slot = OSAL_TIMER_INDEX_HASH( newTimer->task_id, newTimer->event_flag );
+  uint8 i;
+
+  // Linear probing
+  for ( i = 0; i < OSAL_TIMERS_INDEX_SIZE; i++ )
+  {
+    if ( osalTimerIndex[slot] == NULL )
+    {
+      osalTimerIndex[slot] = newTimer;
+      return;
+    }
+
+    slot = (slot + 1) & (OSAL_TIMERS_INDEX_SIZE - 1);
+  }
+
+  // The index is full, lookups now have to walk the timer list
+  osalTimerIndexOverflow++;
+}
+
+/*********************************************************************
+ * @fn      osalTimerIndexRemove
+ *
+ * @brief   Remove a timer from the (task, event) index.
+ *          Ints must be disabled.
+ *
+ * @param   rmTimer - timer to remove
+ *
+ * @return  none
+ */
+static void osalTimerIndexRemove( osalTimerRec_t *rmTimer )
+{
+  uint8 slot = OSAL_TIMER_INDEX_HASH( rmTimer->task_id, rmTimer->event_flag );
+  uint8 next;
+  uint8 home;
+  uint8 i;
+
+  for ( i = 0; i < OSAL_TIMERS_INDEX_SIZE; i++ )
+  {
+    if ( (osalTimerIndex[slot] == rmTimer) || (osalTimerIndex[slot] == NULL) )
+    {
+      break;
+    }
+
+    slot = (slot + 1) & (OSAL_TIMERS_INDEX_SIZE - 1);
+  }
+
+  if ( osalTimerIndex[slot] != rmTimer )
+  {
+    // Not indexed, it was added while the index was full
+    if ( osalTimerIndexOverflow )
+    {
+      osalTimerIndexOverflow--;
+    }
+    return;
+  }
+
+  // Backward shift deletion keeps the probe sequences intact without tombstones
+  osalTimerIndex[slot] = NULL;
+  next = (slot + 1) & (OSAL_TIMERS_INDEX_SIZE - 1);
+
+  while ( osalTimerIndex[next] != NULL )
+  {
+    home = OSAL_TIMER_INDEX_HASH( osalTimerIndex[next]->task_id,
+                                  osalTimerIndex[next]->event_flag );
+
+    // Move the entry into the hole unless its home slot lies cyclically in (slot, next]
+    if ( ((next - home) & (OSAL_TIMERS_INDEX_SIZE - 1)) >=
+         ((next - slot) & (OSAL_TIMERS_INDEX_SIZE - 1)) )
+    {
+      osalTimerIndex[slot] = osalTimerIndex[next];
+      osalTimerIndex[next] = NULL;
+      slot = next;
+    }
+
+    next = (next + 1) & (OSAL_TIMERS_INDEX_SIZE - 1);
+  }
+}
+
 /*********************************************************************
  * @fn      osalAddTimer
  *
@@ -158,14 +353,15 @@ void osalTimerInit( void )
 osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout )
 {
   osalTimerRec_t *newTimer;
-  osalTimerRec_t *srchTimer;
 
   // Look for an existing timer first
   newTimer = osalFindTimer( task_id, event_flag );
   if ( newTimer )
   {
-    // Timer is found - update it.
-    newTimer->timeout.time32 = timeout;
+    // Timer is found - update it and move it to its new place in the list.
+    osalTimerListRemove( newTimer );
+    newTimer->expiry = osal_systemClock + timeout;
+    osalTimerListInsert( newTimer );
 
     return ( newTimer );
   }
@@ -179,28 +375,13 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout
       // Fill in new timer
       newTimer->task_id = task_id;
       newTimer->event_flag = event_flag;
-      newTimer->timeout.time32 = timeout;
+      newTimer->expiry = osal_systemClock + timeout;
       newTimer->next = (void *)NULL;
       newTimer->reloadTimeout = 0;
 
-      // Does the timer list already exist
-      if ( timerHead == NULL )
-      {
-        // Start task list
-        timerHead = newTimer;
-      }
-      else
-      {
-        // Add it to the end of the timer list
-        srchTimer = timerHead;
-
-        // Stop at the last record
-        while ( srchTimer->next )
-          srchTimer = srchTimer->next;
-
-        // Add to the list
-        srchTimer->next = newTimer;
-      }
+      osalTimerListInsert( newTimer );
+      osalTimerIndexAdd( newTimer );
+      osalTimerCount++;
 
       return ( newTimer );
     }
@@ -225,8 +406,34 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout
 osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
 {
   osalTimerRec_t *srchTimer;
+  uint8 slot = OSAL_TIMER_INDEX_HASH( task_id, event_flag );
+  uint8 i;
+
+  // Probe the index first
+  for ( i = 0; i < OSAL_TIMERS_INDEX_SIZE; i++ )
+  {
+    srchTimer = osalTimerIndex[slot];
+
+    if ( srchTimer == NULL )
+    {
+      break;
+    }
 
-  // Head of the timer list
+    if ( srchTimer->event_flag == event_flag &&
+         srchTimer->task_id == task_id )
+    {
+      return ( srchTimer );
+    }
+
+    slot = (slot + 1) & (OSAL_TIMERS_INDEX_SIZE - 1);
+  }
+
+  if ( osalTimerIndexOverflow == 0 )
+  {
+    return ( (osalTimerRec_t *)NULL );
+  }
+
+  // Some timers could not be indexed, search the whole list
   srchTimer = timerHead;
 
   // Stop when found or at the end
@@ -248,9 +455,9 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
 /*********************************************************************
  * @fn      osalDeleteTimer
  *
- * @brief   Delete a timer from a timer list.
+ * @brief   Take a timer out of the timer list and index.
+ *          Ints must be disabled, the caller frees the timer.
  *
- * @param   table
  * @param   rmTimer
  *
  * @return  none
@@ -260,9 +467,9 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer )
   // Does the timer list really exist
   if ( rmTimer )
   {
-    // Clear the event flag and osalTimerUpdate() will delete
-    // the timer from the list.
-    rmTimer->event_flag = 0;
+    osalTimerListRemove( rmTimer );
+    osalTimerIndexRemove( rmTimer );
+    osalTimerCount--;
   }
 }
 
@@ -409,6 +616,11 @@ uint8 osal_stop_timerEx( uint8 task_id, uint16 event_id )
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
+  if ( foundTimer )
+  {
+    osal_mem_free( foundTimer );
+  }
+
   return ( (foundTimer != NULL) ? SUCCESS : INVALID_EVENT_ID );
 }
 
@@ -432,9 +644,9 @@ uint32 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
 
   tmr = osalFindTimer( task_id, event_id );
 
-  if ( tmr )
+  if ( tmr && !OSAL_TIMER_EXPIRED( tmr->expiry, osal_systemClock ) )
   {
-    rtrn = tmr->timeout.time32;
+    rtrn = tmr->expiry - osal_systemClock;
   }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
@@ -453,25 +665,7 @@ uint32 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
  */
 uint8 osal_timer_num_active( void )
 {
-  halIntState_t intState;
-  uint8 num_timers = 0;
-  osalTimerRec_t *srchTimer;
-
-  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
-
-  // Head of the timer list
-  srchTimer = timerHead;
-
-  // Count timers in the list
-  while ( srchTimer != NULL )
-  {
-    num_timers++;
-    srchTimer = srchTimer->next;
-  }
-
-  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
-
-  return num_timers;
+  return osalTimerCount;
 }
 
 /*********************************************************************
@@ -479,6 +673,10 @@ uint8 osal_timer_num_active( void )
  *
  * @brief   Update the timer structures for a timer tick.
  *
+ *          Only the expired timers at the head of the timer list are
+ *          visited, so the cost of a tick does not depend on the number
+ *          of running timers.
+ *
  * @param   none
  *
  * @return  none
@@ -486,116 +684,62 @@ uint8 osal_timer_num_active( void )
 void osalTimerUpdate( uint32 updateTime )
 {
   halIntState_t intState;
-  osalTimerRec_t *srchTimer;
-  osalTimerRec_t *prevTimer;
-
-  osalTime_t timeUnion;
-  timeUnion.time32 = updateTime;
+  osalTimerRec_t *expTimer;
+  osalTimerRec_t *freeTimer;
+  uint16 event_flag;
+  uint8 task_id;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
   // Update the system time
   osal_systemClock += updateTime;
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
-  // Look for open timer slot
-  if ( timerHead != NULL )
+  do
   {
-    // Add it to the end of the timer list
-    srchTimer = timerHead;
-    prevTimer = (void *)NULL;
+    expTimer = NULL;
+    freeTimer = NULL;
+
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-    // Look for open timer slot
-    while ( srchTimer )
+    // Pop one expired timer per critical section
+    if ( (timerHead != NULL) &&
+         OSAL_TIMER_EXPIRED( timerHead->expiry, osal_systemClock ) )
     {
-      osalTimerRec_t *freeTimer = NULL;
+      expTimer = timerHead;
+      timerHead = expTimer->next;
+      expTimer->next = NULL;
 
-      HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+      task_id = expTimer->task_id;
+      event_flag = expTimer->event_flag;
 
-      // To minimize time in this critical section, avoid 32-bit math
-      if ((timeUnion.time16[1] == 0) && (timeUnion.time8[1] == 0))
+      if ( expTimer->reloadTimeout )
       {
-        // If upper 24 bits are zero, check lower 8 bits for roll over
-        if (srchTimer->timeout.time8[0] >= timeUnion.time8[0])
-        {
-          // 8-bit math
-          srchTimer->timeout.time8[0] -= timeUnion.time8[0];
-        }
-        else
-        {
-          // 32-bit math
-          if (srchTimer->timeout.time32 > timeUnion.time32)
-          {
-            srchTimer->timeout.time32 -= timeUnion.time32;
-          }
-          else
-          {
-            srchTimer->timeout.time32 = 0;
-          }
-        }
-      }
-      else
-      {
-          // 32-bit math
-        if (srchTimer->timeout.time32 > timeUnion.time32)
-        {
-          srchTimer->timeout.time32 -= timeUnion.time32;
-        }
-        else
-        {
-          srchTimer->timeout.time32 = 0;
-        }
-      }
-
-      // Check for reloading
-      if ( (srchTimer->timeout.time16[0] == 0) && (srchTimer->timeout.time16[1] == 0) &&
-           (srchTimer->reloadTimeout) && (srchTimer->event_flag) )
-      {
-        // Notify the task of a timeout
-        osal_set_event( srchTimer->task_id, srchTimer->event_flag );
-
         // Reload the timer timeout value
-        srchTimer->timeout.time32 = srchTimer->reloadTimeout;
-      }
-
-      // When timeout or delete (event_flag == 0)
-      if ( ((srchTimer->timeout.time16[0] == 0) && (srchTimer->timeout.time16[1] == 0)) ||
-            (srchTimer->event_flag == 0) )
-      {
-        // Take out of list
-        if ( prevTimer == NULL )
-        {
-          timerHead = srchTimer->next;
-        }
-        else
-        {
-          prevTimer->next = srchTimer->next;
-        }
-
-        // Setup to free memory
-        freeTimer = srchTimer;
-
-        // Next
-        srchTimer = srchTimer->next;
+        expTimer->expiry = osal_systemClock + expTimer->reloadTimeout;
+        osalTimerListInsert( expTimer );
       }
       else
       {
-        // Get next
-        prevTimer = srchTimer;
-        srchTimer = srchTimer->next;
+        // Setup to free memory
+        osalTimerIndexRemove( expTimer );
+        osalTimerCount--;
+        freeTimer = expTimer;
       }
+    }
 
-      HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+    HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
-      if ( freeTimer )
-      {
-        if ( (freeTimer->timeout.time16[0] == 0) && (freeTimer->timeout.time16[1] == 0) )
-        {
-          osal_set_event( freeTimer->task_id, freeTimer->event_flag );
-        }
-        osal_mem_free( freeTimer );
-      }
+    if ( expTimer )
+    {
+      // Notify the task of a timeout
+      osal_set_event( task_id, event_flag );
     }
-  }
+
+    if ( freeTimer )
+    {
+      osal_mem_free( freeTimer );
+    }
+  } while ( expTimer );
 }
 
 #ifdef POWER_SAVING
@@ -631,8 +775,8 @@ void osal_adjust_timers( void )
  *
  * @brief
  *
- *   Search timer table to return the lowest timeout value. If the
- *   timer list is empty, then the returned timeout will be zero.
+ *   Return the lowest timeout value, from the head of the timer list.
+ *   If the timer list is empty, then the returned timeout will be zero.
  *
  * @param   none
  *
@@ -641,23 +785,19 @@ void osal_adjust_timers( void )
 uint32 osal_next_timeout( void )
 {
   uint32 nextTimeout;
-  osalTimerRec_t *srchTimer;
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
   if ( timerHead != NULL )
   {
-    // Head of the timer list
-    srchTimer = timerHead;
-    nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
-
-    // Look for the next timeout timer
-    while ( srchTimer != NULL )
+    if ( OSAL_TIMER_EXPIRED( timerHead->expiry, osal_systemClock ) )
     {
-      if (srchTimer->timeout.time32 < nextTimeout)
-      {
-        nextTimeout = srchTimer->timeout.time32;
-      }
-      // Check next timer
-      srchTimer = srchTimer->next;
+      nextTimeout = 0;
+    }
+    else
+    {
+      nextTimeout = timerHead->expiry - osal_systemClock;
     }
   }
   else
@@ -666,6 +806,8 @@ uint32 osal_next_timeout( void )
     nextTimeout = 0;
   }
 
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
   return ( nextTimeout );
 }
 #endif // POWER_SAVING || USE_ICALL
@@ -288,6 +288,17 @@ extern void (*osal_eventloop_hook)(void);     //!< OSAL event loop hook
  */
   extern uint8 osal_msg_count(uint8 task_id, uint8 event);
 
+/**
+ * @brief Returns the highest number of messages queued at once for a task
+ *              in the OSAL message queue.
+ *
+ * @param task_id The OSAL task id.
+ * @param reset TRUE to restart tracking from the current queue depth.
+ *
+ * @return The high-water mark of the task queue depth, 0 if the task is not tracked.
+ */
+  extern uint16 osal_msg_q_high_water(uint8 task_id, uint8 reset);
+
 /**
  * @brief Equeues an OSAL message into an OSAL queue.
  *
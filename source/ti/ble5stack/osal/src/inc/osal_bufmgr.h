@@ -108,6 +108,11 @@ extern void *osal_bm_adjust_header( void *payload_ptr, int16 size );
  */
 extern void *osal_bm_adjust_tail( void *payload_ptr, int16 size );
 
+/*
+ * Get the number of bytes from the payload pointer to the end of its buffer.
+ */
+extern uint16 osal_bm_payload_len( void *payload_ptr );
+
 /*
  * Free a block of memory.
  */
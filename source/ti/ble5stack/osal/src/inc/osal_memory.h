@@ -66,6 +66,10 @@ extern "C"
   #define OSALMEM_METRICS  FALSE      //!< Set to TRUE to gather OSAL heap metrics
 #endif
 
+#if !defined ( OSALMEM_POOLS )
+  #define OSALMEM_POOLS  FALSE        //!< Set to TRUE to serve common sizes from fixed-size pools
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -77,6 +81,18 @@ extern "C"
  * TYPEDEFS
  */
 
+#if ( OSALMEM_POOLS )
+/// @brief Usage counters of a fixed-size pool
+typedef struct
+{
+  uint16 blkSz;    //!< Block size, including the heap block header
+  uint16 blkCnt;   //!< Number of blocks in the pool
+  uint16 blkUsed;  //!< Current number of blocks allocated
+  uint16 blkMax;   //!< Maximum number of blocks ever allocated at once
+  uint16 missCnt;  //!< Number of allocations which fell back to the heap because the pool was empty
+} osalMemPoolStats_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -169,6 +185,18 @@ void *osal_mem_allocLimited( uint16 size );
   uint16 osal_heap_mem_used( void );
 #endif
 
+#if ( OSALMEM_POOLS )
+/**
+ * @brief   Return the usage counters of one of the fixed-size pools.
+ *
+ * @param   pool index of the pool, 0 for the smallest block size.
+ * @param   pStats filled with the counters of the pool.
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if there is no such pool.
+ */
+  uint8 osal_mem_pool_stats( uint8 pool, osalMemPoolStats_t *pStats );
+#endif
+
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
 /**
  * @brief   Return the highest byte ever allocated in the heap.
@@ -0,0 +1,212 @@
+/******************************************************************************
+
+ @file  test_osal_memory.c
+
+ @brief Host test of the OSAL heap and its fixed-size pools.
+
+        Random allocation and free sequences fill every block with a
+        pattern and check it before freeing, so overlapping blocks are
+        caught. With OSALMEM_POOLS the test also checks that small
+        allocations stay in the small-block bucket, that pool blocks
+        are used for larger ones, and that all blocks are returned.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2004-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "comdef.h"
+#include "osal_memory.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+#define TEST_BLOCKS       200
+#define TEST_MAX_SIZE     150
+#define TEST_ITERATIONS   200000
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+static uint8 *blocks[TEST_BLOCKS];
+static uint16 blockSizes[TEST_BLOCKS];
+
+/*********************************************************************
+ * OSAL STUBS
+ */
+void *osal_memset( void *dest, uint8 value, int size )
+{
+  return memset( dest, value, size );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+#if OSALMEM_POOLS
+static uint16 poolBlocksUsed( void )
+{
+  osalMemPoolStats_t stats;
+  uint16 used = 0;
+
+  for ( uint8 pool = 0; osal_mem_pool_stats( pool, &stats ) == SUCCESS; pool++ )
+  {
+    used += stats.blkUsed;
+  }
+
+  return ( used );
+}
+
+static void testSmallBlocks( void )
+{
+  uint8 *small[8];
+  uint16 used = poolBlocksUsed();
+
+  // Allocations fitting a small block never take a pool block
+  for ( int i = 0; i < 8; i++ )
+  {
+    small[i] = osal_mem_alloc( 1 + i );
+    assert( small[i] != NULL );
+  }
+
+  assert( poolBlocksUsed() == used );
+
+  for ( int i = 0; i < 8; i++ )
+  {
+    osal_mem_free( small[i] );
+  }
+
+  // The smallest pool takes the next size up
+  small[0] = osal_mem_alloc( 20 );
+  assert( poolBlocksUsed() == used + 1 );
+  osal_mem_free( small[0] );
+  assert( poolBlocksUsed() == used );
+}
+#endif
+
+static void testRandom( void )
+{
+  srand( 1 );
+
+  for ( int i = 0; i < TEST_ITERATIONS; i++ )
+  {
+    int block = rand() % TEST_BLOCKS;
+
+    if ( blocks[block] != NULL )
+    {
+      for ( int k = 0; k < blockSizes[block]; k++ )
+      {
+        assert( blocks[block][k] == (uint8)block );
+      }
+
+      osal_mem_free( blocks[block] );
+      blocks[block] = NULL;
+    }
+    else
+    {
+      blockSizes[block] = (uint16)(1 + rand() % TEST_MAX_SIZE);
+      blocks[block] = osal_mem_alloc( blockSizes[block] );
+
+      if ( blocks[block] != NULL )
+      {
+        memset( blocks[block], block, blockSizes[block] );
+      }
+    }
+  }
+
+  for ( int block = 0; block < TEST_BLOCKS; block++ )
+  {
+    if ( blocks[block] != NULL )
+    {
+      osal_mem_free( blocks[block] );
+      blocks[block] = NULL;
+    }
+  }
+}
+
+int main( void )
+{
+  void *longLived;
+  uint16 usedBefore;
+
+  osal_mem_init();
+  longLived = osal_mem_alloc( 20 );
+  assert( longLived != NULL );
+  osal_mem_kick();
+
+#if OSALMEM_METRICS
+  usedBefore = osal_heap_mem_used();
+#else
+  usedBefore = 0;
+#endif
+
+#if OSALMEM_POOLS
+  testSmallBlocks();
+#endif
+  testRandom();
+
+#if OSALMEM_METRICS
+  // Everything but the long-lived allocation was returned
+  assert( osal_heap_mem_used() == usedBefore );
+  assert( osal_heap_block_free() + 1 == osal_heap_block_cnt() );
+#endif
+#if OSALMEM_POOLS
+  assert( poolBlocksUsed() == 0 );
+  {
+    osalMemPoolStats_t stats;
+
+    for ( uint8 pool = 0; osal_mem_pool_stats( pool, &stats ) == SUCCESS; pool++ )
+    {
+      printf( "pool %u: %u blocks of %u bytes, at most %u used, %u allocations fell back to the heap\n",
+              pool, stats.blkCnt, stats.blkSz, stats.blkMax, stats.missCnt );
+    }
+  }
+#endif
+  (void)usedBefore;
+
+  printf( "osal memory: %d operations passed\n", TEST_ITERATIONS );
+
+  return 0;
+}
@@ -0,0 +1,303 @@
+/******************************************************************************
+
+ @file  test_osal_msg.c
+
+ @brief Host test of the OSAL system message queue against a reference model.
+
+        Random send, push-front, receive, find and count sequences over
+        tracked and untracked task IDs, and over more event types than
+        the per-task event slots hold, are checked against a plain list
+        of queued messages. A burst deeper than 255 messages checks the
+        depth counters and the high-water mark.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2004-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osal.h"
+#include "osal_tasks.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+#define TEST_TASKS        20    // Above OSAL_MSG_Q_MAX_TASKS, so some are untracked
+#define TEST_EVENT_TYPES  8     // Above OSAL_MSG_Q_EVENT_SLOTS
+#define TEST_MODEL_SIZE   512
+#define TEST_ITERATIONS   200000
+#define TEST_BURST        300
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+const pTaskEventHandlerFn tasksArr[TEST_TASKS];
+const uint8 tasksCnt = TEST_TASKS;
+static uint16 testTasksEvents[TEST_TASKS];
+uint16 *tasksEvents = testTasksEvents;
+
+ICall_Dispatcher ICall_dispatcher;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Reference model: the queued messages in queue order
+static uint8 *modelMsgs[TEST_MODEL_SIZE];
+static int    modelCount;
+
+/*********************************************************************
+ * OSAL AND ICALL STUBS
+ */
+void *osal_mem_alloc( uint16 size )
+{
+  return malloc( size );
+}
+
+void osal_mem_free( void *ptr )
+{
+  free( ptr );
+}
+
+void osalInitTasks( void ) {}
+void osalTimerInit( void ) {}
+void osal_pwrmgr_init( void ) {}
+void osal_timer_refTimeUpdate( void ) {}
+uint32 osal_next_timeout( void ) { return 0; }
+void Hal_ProcessPoll( void ) {}
+uint16 Onboard_rand( void ) { return (uint16)rand(); }
+char *ltoa( long value, char *buf, int radix ) { (void)value; (void)radix; return buf; }
+ICall_Errno ICall_sendServiceComplete( ICall_EntityID src, ICall_EntityID dest,
+                                       ICall_MSGFormat format, void *msg )
+{
+  (void)src; (void)dest; (void)format; (void)msg;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+static ICall_Errno testDispatcher( ICall_FuncArgsHdr *args )
+{
+  (void)args;
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint8 *newMsg( uint8 event )
+{
+  osal_event_hdr_t *msg = (osal_event_hdr_t *)osal_msg_allocate( sizeof( osal_event_hdr_t ) );
+
+  assert( msg != NULL );
+  msg->event = event;
+  msg->status = 0;
+
+  return ( (uint8 *)msg );
+}
+
+static uint8 msgTask( uint8 *msg )
+{
+  return ( ((osal_msg_hdr_t *)msg - 1)->dest_id );
+}
+
+static uint8 msgEvent( uint8 *msg )
+{
+  return ( ((osal_event_hdr_t *)msg)->event );
+}
+
+static void modelInsert( int index, uint8 *msg )
+{
+  assert( modelCount < TEST_MODEL_SIZE );
+  memmove( &modelMsgs[index + 1], &modelMsgs[index], (modelCount - index) * sizeof( modelMsgs[0] ) );
+  modelMsgs[index] = msg;
+  modelCount++;
+}
+
+static void modelRemove( int index )
+{
+  modelCount--;
+  memmove( &modelMsgs[index], &modelMsgs[index + 1], (modelCount - index) * sizeof( modelMsgs[0] ) );
+}
+
+static int modelFind( uint8 task, uint8 event )
+{
+  for ( int i = 0; i < modelCount; i++ )
+  {
+    if ( (msgTask( modelMsgs[i] ) == task) &&
+         ((event == 0xFF) || (msgEvent( modelMsgs[i] ) == event)) )
+    {
+      return ( i );
+    }
+  }
+
+  return ( -1 );
+}
+
+static int modelCountOf( uint8 task, uint8 event )
+{
+  int count = 0;
+
+  for ( int i = 0; i < modelCount; i++ )
+  {
+    if ( (msgTask( modelMsgs[i] ) == task) &&
+         ((event == 0xFF) || (msgEvent( modelMsgs[i] ) == event)) )
+    {
+      count++;
+    }
+  }
+
+  return ( count );
+}
+
+static void testAgainstModel( void )
+{
+  srand( 1 );
+
+  for ( int i = 0; i < TEST_ITERATIONS; i++ )
+  {
+    uint8 task  = (uint8)(rand() % TEST_TASKS);
+    uint8 event = (uint8)(0xC0 + rand() % TEST_EVENT_TYPES);
+    int   op    = rand() % 10;
+
+    if ( (op < 3) && (modelCount < TEST_MODEL_SIZE) )
+    {
+      uint8 *msg = newMsg( event );
+
+      assert( osal_msg_send( task, msg ) == SUCCESS );
+      modelInsert( modelCount, msg );
+    }
+    else if ( (op < 4) && (modelCount < TEST_MODEL_SIZE) )
+    {
+      uint8 *msg = newMsg( event );
+
+      assert( osal_msg_push_front( task, msg ) == SUCCESS );
+      modelInsert( 0, msg );
+    }
+    else if ( op < 7 )
+    {
+      int    index = modelFind( task, 0xFF );
+      int    count = modelCountOf( task, 0xFF );
+      uint8 *msg   = osal_msg_receive( task );
+
+      assert( msg == ((index >= 0) ? modelMsgs[index] : NULL) );
+      // SYS_EVENT_MSG stays raised while more messages are waiting
+      assert( ((tasksEvents[task] & SYS_EVENT_MSG) != 0) == (count > 1) );
+
+      if ( msg != NULL )
+      {
+        modelRemove( index );
+        osal_msg_deallocate( msg );
+      }
+    }
+    else if ( op < 8 )
+    {
+      int index = modelFind( task, event );
+
+      assert( (uint8 *)osal_msg_find( task, event ) == ((index >= 0) ? modelMsgs[index] : NULL) );
+    }
+    else if ( op < 9 )
+    {
+      assert( osal_msg_count( task, event ) == modelCountOf( task, event ) );
+    }
+    else
+    {
+      assert( osal_msg_count( task, 0xFF ) == modelCountOf( task, 0xFF ) );
+    }
+  }
+
+  // Drain the queue
+  for ( uint8 task = 0; task < TEST_TASKS; task++ )
+  {
+    uint8 *msg;
+
+    while ( (msg = osal_msg_receive( task )) != NULL )
+    {
+      osal_msg_deallocate( msg );
+    }
+  }
+
+  modelCount = 0;
+}
+
+static void testDeepQueue( void )
+{
+  uint8 *msg;
+  int    received = 0;
+
+  osal_msg_q_high_water( 0, TRUE );
+
+  for ( int i = 0; i < TEST_BURST; i++ )
+  {
+    assert( osal_msg_send( 0, newMsg( 0xC0 + (i % TEST_EVENT_TYPES) ) ) == SUCCESS );
+  }
+
+  // osal_msg_count() returns a uint8 and saturates
+  assert( osal_msg_count( 0, 0xFF ) == 0xFF );
+  assert( osal_msg_count( 0, 0xC1 ) == TEST_BURST / TEST_EVENT_TYPES + 1 );
+
+  while ( (msg = osal_msg_receive( 0 )) != NULL )
+  {
+    assert( msgEvent( msg ) == 0xC0 + (received % TEST_EVENT_TYPES) );
+    osal_msg_deallocate( msg );
+    received++;
+  }
+
+  assert( received == TEST_BURST );
+  assert( osal_msg_count( 0, 0xFF ) == 0 );
+  assert( osal_msg_q_high_water( 0, TRUE ) == TEST_BURST );
+  assert( osal_msg_q_high_water( 0, FALSE ) == 0 );
+}
+
+int main( void )
+{
+  ICall_dispatcher = testDispatcher;
+  osal_init_system();
+
+  testAgainstModel();
+  testDeepQueue();
+
+  printf( "osal msg: %d operations match the model\n", TEST_ITERATIONS );
+
+  return 0;
+}
@@ -0,0 +1,225 @@
+/******************************************************************************
+
+ @file  test_osal_timers.c
+
+ @brief Host test of the OSAL timer service against a reference model.
+
+        Random start, reload, stop, get-timeout and tick sequences over
+        more (task, event) pairs than the timer index holds are checked
+        against a per-timer countdown model: fired events, remaining
+        timeouts and the number of active timers must all match.
+
+ Group: WCS, LPC, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2004-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osal.h"
+#include "osal_timers.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+#define TEST_TASKS        6
+#define TEST_EVENTS       16
+#define TEST_ITERATIONS   200000
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Events delivered through osal_set_event()
+static int firedEvents[TEST_TASKS][TEST_EVENTS];
+
+// Reference model: running flag, remaining and reload time, events fired
+static int  modelActive[TEST_TASKS][TEST_EVENTS];
+static long modelRemaining[TEST_TASKS][TEST_EVENTS];
+static long modelReload[TEST_TASKS][TEST_EVENTS];
+static int  modelFired[TEST_TASKS][TEST_EVENTS];
+
+/*********************************************************************
+ * OSAL STUBS
+ */
+void *osal_mem_alloc( uint16 size )
+{
+  return malloc( size );
+}
+
+void osal_mem_free( void *ptr )
+{
+  free( ptr );
+}
+
+void *osal_memset( void *dest, uint8 value, int size )
+{
+  return memset( dest, value, size );
+}
+
+uint8 osal_set_event( uint8 task_id, uint16 event_flag )
+{
+  for ( int event = 0; event < TEST_EVENTS; event++ )
+  {
+    if ( event_flag == (1u << event) )
+    {
+      firedEvents[task_id][event]++;
+    }
+  }
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void modelUpdate( long elapsed )
+{
+  for ( int task = 0; task < TEST_TASKS; task++ )
+  {
+    for ( int event = 0; event < TEST_EVENTS; event++ )
+    {
+      if ( !modelActive[task][event] )
+      {
+        continue;
+      }
+
+      modelRemaining[task][event] -= elapsed;
+
+      if ( modelRemaining[task][event] <= 0 )
+      {
+        modelFired[task][event]++;
+
+        if ( modelReload[task][event] )
+        {
+          modelRemaining[task][event] = modelReload[task][event];
+        }
+        else
+        {
+          modelActive[task][event] = 0;
+          modelRemaining[task][event] = 0;
+        }
+      }
+    }
+  }
+}
+
+static void modelCheck( void )
+{
+  int active = 0;
+
+  for ( int task = 0; task < TEST_TASKS; task++ )
+  {
+    for ( int event = 0; event < TEST_EVENTS; event++ )
+    {
+      active += modelActive[task][event];
+      assert( modelFired[task][event] == firedEvents[task][event] );
+    }
+  }
+
+  assert( active == osal_timer_num_active() );
+}
+
+int main( void )
+{
+  srand( 1 );
+  osalTimerInit();
+
+  for ( int i = 0; i < TEST_ITERATIONS; i++ )
+  {
+    int    task  = rand() % TEST_TASKS;
+    int    event = rand() % TEST_EVENTS;
+    int    op    = rand() % 10;
+    uint16 flag  = (uint16)(1u << event);
+
+    if ( op < 3 )
+    {
+      uint32 timeout = rand() % 50;
+
+      // Restarting a reload timer keeps its reload period
+      assert( osal_start_timerEx( task, flag, timeout ) == SUCCESS );
+      if ( !modelActive[task][event] )
+      {
+        modelReload[task][event] = 0;
+      }
+      modelActive[task][event] = 1;
+      modelRemaining[task][event] = timeout;
+    }
+    else if ( op < 4 )
+    {
+      uint32 timeout = 1 + rand() % 50;
+
+      assert( osal_start_reload_timer( task, flag, timeout ) == SUCCESS );
+      modelActive[task][event] = 1;
+      modelRemaining[task][event] = timeout;
+      modelReload[task][event] = timeout;
+    }
+    else if ( op < 6 )
+    {
+      uint8 status = osal_stop_timerEx( task, flag );
+
+      assert( (status == SUCCESS) == (modelActive[task][event] != 0) );
+      modelActive[task][event] = 0;
+    }
+    else if ( op < 7 )
+    {
+      uint32 expected = modelActive[task][event] ? (uint32)modelRemaining[task][event] : 0;
+
+      assert( osal_get_timeoutEx( task, flag ) == expected );
+    }
+    else
+    {
+      uint32 elapsed = rand() % 7;
+
+      osalTimerUpdate( elapsed );
+      modelUpdate( elapsed );
+    }
+
+    modelCheck();
+  }
+
+  printf( "osal timers: %d operations match the model\n", TEST_ITERATIONS );
+
+  return 0;
+}
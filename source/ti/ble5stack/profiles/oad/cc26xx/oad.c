@@ -273,6 +273,12 @@ static uint16_t oadImgBytesPerBlock = OAD_DEFAULT_BLOCK_SIZE - OAD_BLK_NUM_HDR_S
 static uint8_t  blkReqActive = true;
 static uint8_t numBlksInImgHdr = 0;
 
+/* Pipelined download, see OAD_EXT_CTRL_SET_BLK_WINDOW */
+static uint8_t  oadBlkWindow = 0;       // Granted window, 0 for lockstep
+static uint8_t  oadBlksQueued = 0;      // Blocks waiting in the OAD queue
+static uint32_t oadBlkAcked = 0;        // Block last requested from the peer
+static uint32_t oadBlkResent = 0xFFFFFFFF; // Block requested again after a gap
+
 /* Information about image that is currently being downloaded */
 static uint32_t imageAddress = 0;
 static uint16_t imagePage = 0;
@@ -359,6 +365,7 @@ static uint16_t oadFindleastRecentlyUsedIdx(ImageSizeInfo_t *extImgInfo, uint8_t
 
 static uint8_t oadEraseExtFlashPages(uint8_t startAddr, uint32_t imgLen,
                                      uint32_t pageSize);
+static uint8_t oadWriteImageData(uint32_t addr, uint8_t *pData, uint16_t len);
 static bool oadCheckFactoryImage(void);
 
 /*********************************************************************
@@ -593,6 +600,23 @@ uint8_t OAD_processQueue(void)
             // Extract the event from the message
             oadEvent_e event = oadWriteEvt->event;
 
+            // Blocks still queued behind this one, the stack task adds to
+            // the count as it queues blocks
+            uint8_t blksQueued = 0;
+
+            if(event == OAD_WRITE_BLOCK_REQ)
+            {
+                ICall_CSState key = ICall_enterCriticalSection();
+
+                if(oadBlksQueued > 0)
+                {
+                    oadBlksQueued--;
+                }
+                blksQueued = oadBlksQueued;
+
+                ICall_leaveCriticalSection(key);
+            }
+
             // Timeout is state independent. Always results in OAD state reset
             if(event == OAD_TIMEOUT)
             {
@@ -677,13 +701,43 @@ uint8_t OAD_processQueue(void)
             {
                 if(event == OAD_WRITE_BLOCK_REQ)
                 {
-                    status = oadImgBlockWrite(oadWriteEvt->connHandle,
-                                                oadWriteEvt->pData,
-                                                oadWriteEvt->len);
+                    uint8_t *pBlk = oadWriteEvt->pData;
 
-                    // Request the next block
-                    oadGetNextBlockReq(oadWriteEvt->connHandle, oadBlkNum,
-                                        status);
+                    if((oadBlkWindow > 0) &&
+                       (oadWriteEvt->len >= OAD_BLK_NUM_HDR_SZ) &&
+                       (BUILD_UINT32(pBlk[0], pBlk[1], pBlk[2], pBlk[3]) !=
+                        oadBlkNum))
+                    {
+                        // The peer sent this block before it learned that an
+                        // earlier one was dropped. It is told to go back to
+                        // the requested block once, on the first of these
+                        status = OAD_SUCCESS;
+
+                        if(oadBlkResent != oadBlkNum)
+                        {
+                            oadGetNextBlockReq(oadWriteEvt->connHandle,
+                                                oadBlkNum, OAD_BUFFER_OFL);
+                            oadBlkResent = oadBlkNum;
+                        }
+                    }
+                    else
+                    {
+                        status = oadImgBlockWrite(oadWriteEvt->connHandle,
+                                                    pBlk,
+                                                    oadWriteEvt->len);
+
+                        // Request the next block. When pipelined, only once
+                        // half the window has been written or no block is
+                        // left queued
+                        if((oadBlkWindow == 0) || (status != OAD_SUCCESS) ||
+                           (blksQueued == 0) ||
+                           ((oadBlkNum - oadBlkAcked) >=
+                            ((oadBlkWindow + 1) / 2)))
+                        {
+                            oadGetNextBlockReq(oadWriteEvt->connHandle,
+                                                oadBlkNum, status);
+                        }
+                    }
 
                     if(status == OAD_SUCCESS)
                     {
@@ -724,6 +778,12 @@ uint8_t OAD_processQueue(void)
                                                         oadWriteEvt->pData,
                                                         oadWriteEvt->len);
                 }
+                else if((event == OAD_WRITE_BLOCK_REQ) && (oadBlkWindow > 0))
+                {
+                    // A resent block still in flight after the last block
+                    // was written, ignore it
+                    nextState = OAD_COMPLETE;
+                }
                 else
                 {
                     // An error has occured, reset and go back to idle
@@ -1018,6 +1078,16 @@ uint8_t oadImgIdentifyWrite(uint16_t connHandle, uint8_t *pValue, uint16_t len,
     candidateImageType = OAD_IMG_TYPE_APP;
     activeOadCxnHandle = LINKDB_CONNHANDLE_INVALID;
 
+#ifdef OAD_FLASH_STREAM
+    // Drop image data still held by the flash stream
+    eraseFlashAhead(0, 0);
+#endif
+
+    // Go back to lockstep block requests
+    oadBlkWindow = 0;
+    oadBlkAcked = 0;
+    oadBlkResent = 0xFFFFFFFF;
+
     // Remove the element from the head of the Queue
     oadTargetWrite_t *oadWriteEvt = Queue_get(hOadQ);
 
@@ -1034,6 +1104,10 @@ uint8_t oadImgIdentifyWrite(uint16_t connHandle, uint8_t *pValue, uint16_t len,
         oadWriteEvt = Queue_get(hOadQ);
     }
 
+    ICall_CSState key = ICall_enterCriticalSection();
+    oadBlksQueued = 0;
+    ICall_leaveCriticalSection(key);
+
     // Stop the inactivity timer if running
     if(Util_isActive(&oadActivityClk))
     {
@@ -1143,10 +1217,15 @@ uint8_t oadImgBlockWrite(uint16_t connHandle, uint8_t *pValue, uint8_t len)
             status = oadValidateCandidateHdr((imgHdr_t * )&candidateImageHeader);
             if(status == OAD_SUCCESS)
             {
+#ifdef OAD_FLASH_STREAM
+                // Erase the image pages as the blocks reach them
+                eraseFlashAhead(imageAddress, candidateImageHeader.fixedHdr.len);
+#else
                 // Calculate number of flash pages to pre-erase
                 uint32_t pageSize = (useExternalFlash)?EFL_PAGE_SIZE:HAL_FLASH_PAGE_SIZE;
 
                 oadEraseExtFlashPages(imagePage, candidateImageHeader.fixedHdr.len, pageSize);
+#endif
 
                 // at this point we have erased the user app
                 if(!useExternalFlash)
@@ -1155,7 +1234,7 @@ uint8_t oadImgBlockWrite(uint16_t connHandle, uint8_t *pValue, uint8_t len)
                 }
 
                 // Write a OAD_BLOCK to Flash.
-                status = writeFlashPg(imagePage, 0,
+                status = oadWriteImageData(imageAddress,
                                         (uint8_t * ) &candidateImageHeader,
                                         sizeof(imgHdr_t));
 
@@ -1171,8 +1250,7 @@ uint8_t oadImgBlockWrite(uint16_t connHandle, uint8_t *pValue, uint8_t len)
                 if(nonHeaderBytes)
                 {
                     // Write a OAD_BLOCK to Flash.
-                    status = writeFlashPg(imagePage,
-                                            sizeof(imgHdr_t),
+                    status = oadWriteImageData(imageAddress + sizeof(imgHdr_t),
                                             (pValue+OAD_BLK_NUM_HDR_SZ+remainder),
                                             nonHeaderBytes);
 
@@ -1193,23 +1271,10 @@ uint8_t oadImgBlockWrite(uint16_t connHandle, uint8_t *pValue, uint8_t len)
         {
             // Calculate address to write as (start of OAD range) + (offset into range)
             uint32_t blkStartAddr = (oadImgBytesPerBlock)*blkNum + imageAddress;
-            uint8_t page = 0xFF;
-            uint32_t offset = 0;
-
-            if(useExternalFlash)
-            {
-                page = EXT_FLASH_PAGE(blkStartAddr); //(blkStartAddr >> 12);
-                offset = blkStartAddr & (~EXTFLASH_PAGE_MASK); //0x00000FFF);
-            }
-            else
-            {
-                page = FLASH_PAGE(blkStartAddr); //(blkStartAddr >> 13);
-                offset = blkStartAddr & (~INTFLASH_PAGE_MASK); //0x00001FFF);
-            }
 
             // Write a OAD_BLOCK to Flash.
-            status = writeFlashPg(page, offset, pValue+OAD_BLK_NUM_HDR_SZ,
-                                  (len - OAD_BLK_NUM_HDR_SZ));
+            status = oadWriteImageData(blkStartAddr, pValue+OAD_BLK_NUM_HDR_SZ,
+                                       (len - OAD_BLK_NUM_HDR_SZ));
 
             // Cancel OAD due to flash program error
             if(FLASH_SUCCESS != status)
@@ -1232,6 +1297,14 @@ uint8_t oadImgBlockWrite(uint16_t connHandle, uint8_t *pValue, uint8_t len)
     // Check if the OAD Image is complete.
     if (oadBlkNum == oadBlkTot)
     {
+#ifdef OAD_FLASH_STREAM
+        // Write the end of the image still in the stream buffer
+        if(FLASH_SUCCESS != flushFlashStream())
+        {
+            return (OAD_FLASH_ERR);
+        }
+#endif
+
         // Run CRC check on new image.
         if (OAD_SUCCESS != oadCheckDL())
         {
@@ -1635,6 +1708,9 @@ uint8_t oadProcessExtControlCmd(uint16_t connHandle, uint8_t  *pData,
             // Stop sending block request notifications
             blkReqActive = false;
 
+            // Without block requests the peer cannot be paced by a window
+            oadBlkWindow = 0;
+
             pRspPldlen = sizeof(genericExtCtrlRsp_t);
 
             // Allocate memory for the ext ctrl rsp message
@@ -1846,6 +1922,46 @@ uint8_t oadProcessExtControlCmd(uint16_t connHandle, uint8_t  *pData,
             }
             break;
         }
+        case OAD_EXT_CTRL_SET_BLK_WINDOW:
+        {
+            pRspPldlen = sizeof(setBlkWindowRspPld_t);
+
+            // Allocate memory for the ext ctrl rsp message
+            pCmdRsp = ICall_malloc(pRspPldlen);
+
+            if(pCmdRsp == NULL)
+            {
+                // Ensure the allocation succeeded
+                return (OAD_NO_RESOURCES);
+            }
+
+            setBlkWindowRspPld_t *rsp = (setBlkWindowRspPld_t *)pCmdRsp;
+
+            // Pack up the payload
+            rsp->cmdID = OAD_EXT_CTRL_SET_BLK_WINDOW;
+
+            if(state == OAD_DOWNLOAD)
+            {
+                // The window cannot change during a download
+                rsp->status = OAD_ALREADY_STARTED;
+            }
+            else if((len < sizeof(setBlkWindowReq_t)) || !blkReqActive)
+            {
+                // Pipelining relies on block request notifications
+                rsp->status = OAD_EXT_NOT_SUPPORTED;
+            }
+            else
+            {
+                setBlkWindowReq_t *req = (setBlkWindowReq_t *)pData;
+
+                oadBlkWindow = (req->window > OAD_MAX_BLK_WINDOW) ?
+                                OAD_MAX_BLK_WINDOW : req->window;
+                rsp->status = OAD_SUCCESS;
+            }
+            rsp->window = oadBlkWindow;
+
+            break;
+        }
         case OAD_EXT_CTRL_ERASE_BONDS:
         {
             // Ext control commands for erasing bonds
@@ -2301,7 +2417,21 @@ static uint8_t oadCheckImageID(imgIdentifyPld_t *idPld)
 static void oadGetNextBlockReq(uint16_t connHandle, uint32_t blkNum,
                                 uint8_t status)
 {
-    if(blkReqActive)
+    if(blkReqActive && (oadBlkWindow > 0))
+    {
+        blockWindowReqPld_t blkReqPld;
+
+        blkReqPld.cmdID = OAD_EXT_CTRL_BLK_WINDOW_NOTIF;
+        blkReqPld.prevBlkStat = status;
+        blkReqPld.requestedBlk = blkNum;
+        blkReqPld.numBlks = oadBlkWindow;
+
+        oadSendNotification(connHandle, oadExtCtrlConfig, OAD_IDX_EXT_CTRL,
+                                (uint8_t *)&blkReqPld,
+                                sizeof(blockWindowReqPld_t));
+        oadBlkAcked = blkNum;
+    }
+    else if(blkReqActive)
     {
         blockReqPld_t blkReqPld;
 
@@ -2819,18 +2949,45 @@ static bStatus_t oadWriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
             // Notify the application.
             if (oadTargetWriteCB != NULL)
             {
-                // Add the message to the Queue for processing
-                uint8_t stat = oadEnqueueMsg(OAD_WRITE_BLOCK_REQ, connHandle,
-                                                pValue, len);
-                if(stat == OAD_NO_RESOURCES)
+                // Count the block before it is queued, so that the
+                // application task never sees more blocks than counted
+                ICall_CSState key = ICall_enterCriticalSection();
+                bool overflow = (oadBlkWindow > 0) &&
+                                (oadBlksQueued >= oadBlkWindow);
+
+                if(!overflow)
                 {
-                    // Notify the application there is no memory left
-                    (*oadTargetWriteCB)(OAD_OUT_OF_MEM_EVT, NULL);
+                    oadBlksQueued++;
+                }
+                ICall_leaveCriticalSection(key);
+
+                if(overflow)
+                {
+                    // The peer has exceeded the window, drop the block. It
+                    // is sent again after the next block request
                 }
                 else
                 {
-                    // Notify the application that OAD needs to service its Queue
-                    (*oadTargetWriteCB)(OAD_QUEUE_EVT, NULL);
+                    // Add the message to the Queue for processing
+                    uint8_t stat = oadEnqueueMsg(OAD_WRITE_BLOCK_REQ, connHandle,
+                                                    pValue, len);
+                    if(stat == OAD_NO_RESOURCES)
+                    {
+                        key = ICall_enterCriticalSection();
+                        if(oadBlksQueued > 0)
+                        {
+                            oadBlksQueued--;
+                        }
+                        ICall_leaveCriticalSection(key);
+
+                        // Notify the application there is no memory left
+                        (*oadTargetWriteCB)(OAD_OUT_OF_MEM_EVT, NULL);
+                    }
+                    else
+                    {
+                        // Notify the application that OAD needs to service its Queue
+                        (*oadTargetWriteCB)(OAD_QUEUE_EVT, NULL);
+                    }
                 }
             }
         }
@@ -2905,6 +3062,41 @@ static void oadInactivityTimeout(UArg param)
     }
 }
 
+/*********************************************************************
+ * @fn      oadWriteImageData
+ *
+ * @brief   This function writes image data received in a block, through
+ *          the flash stream if OAD_FLASH_STREAM is defined
+ *
+ * @param   addr  - flash address to write the data to
+ * @param   pData - data to write
+ * @param   len   - number of bytes to write
+ *
+ * @return  FLASH_SUCCESS or FLASH_FAILURE
+ */
+static uint8_t oadWriteImageData(uint32_t addr, uint8_t *pData, uint16_t len)
+{
+#ifdef OAD_FLASH_STREAM
+    return (writeFlashStream(addr, pData, len));
+#else
+    uint8_t page = 0xFF;
+    uint32_t offset = 0;
+
+    if(useExternalFlash)
+    {
+        page = EXT_FLASH_PAGE(addr); //(addr >> 12);
+        offset = addr & (~EXTFLASH_PAGE_MASK); //0x00000FFF);
+    }
+    else
+    {
+        page = FLASH_PAGE(addr); //(addr >> 13);
+        offset = addr & (~INTFLASH_PAGE_MASK); //0x00001FFF);
+    }
+
+    return (writeFlashPg(page, offset, pData, len));
+#endif
+}
+
 /*********************************************************************
  * @fn      oadEraseExtFlashPages
  *
@@ -179,6 +179,13 @@ extern "C"
     #define OAD_WRITE_PERMIT     GATT_PERMIT_WRITE
 #endif //OAD_SECURITY
 
+/*!
+ * This define controls whether image blocks are written through the
+ * streaming flash interface, which erases the image pages as the blocks
+ * reach them. flash_interface_stream.c must then be built as well.
+ * By default, this is off and each block is written on its own.
+ */
+
 /*!
  * Number of failed image IDs are allowed before OAD terminates the cxn
  */
@@ -303,6 +310,15 @@ extern "C"
  */
 #define OAD_MAX_BLOCK_SIZE                  244
 
+/*!
+ * Maximum number of blocks a peer may have outstanding during a pipelined
+ * download, see @ref OAD_EXT_CTRL_SET_BLK_WINDOW
+ * \note Each outstanding block is buffered on the heap
+ */
+#ifndef OAD_MAX_BLK_WINDOW
+#define OAD_MAX_BLK_WINDOW                  8
+#endif
+
 /*!
  * Size of the payload in an image identify response.
  */
@@ -396,6 +412,26 @@ extern "C"
  */
 #define OAD_EXT_CTRL_ERASE_BONDS            0x13
 
+/*!
+ * Set block window external control command op-code
+ * This command is used by a peer to pipeline the download. The target keeps
+ * up to the granted number of blocks buffered while it writes to flash, and
+ * requests blocks with @ref OAD_EXT_CTRL_BLK_WINDOW_NOTIF instead of one at a
+ * time. It must be sent before the download starts.
+ */
+#define OAD_EXT_CTRL_SET_BLK_WINDOW         0x14
+
+/*!
+ * Send block window request external control command op-code
+ * This notification acknowledges all blocks before the requested block and
+ * allows the peer to send the requested block and the ones following it, up
+ * to the number of blocks given, without waiting for another request.
+ * Blocks which do not follow the last one received are dropped. The request
+ * then carries @ref OAD_BUFFER_OFL as status, and the peer must go back to
+ * the requested block. Otherwise it continues after the last block it sent.
+ */
+#define OAD_EXT_CTRL_BLK_WINDOW_NOTIF       0x15
+
 /** @} End OAD_EXT_CTRL_OPCODES */
 
 
@@ -524,6 +560,17 @@ PACKED_TYPEDEF_STRUCT
     uint32_t  requestedBlk;     //!< Requested block number
 }blockReqPld_t;
 
+/*!
+ * Block window request payload
+ */
+PACKED_TYPEDEF_STRUCT
+{
+    uint8_t   cmdID;            //!< External control op-code
+    uint8_t   prevBlkStat;      //!< Status of previous block write
+    uint32_t  requestedBlk;     //!< Requested block number
+    uint8_t   numBlks;          //!< Number of blocks which may be sent
+}blockWindowReqPld_t;
+
 /*!
  * Image info structure
  * This structure is a subset of the image info field in @ref imgFixedHdr_t
@@ -663,6 +710,25 @@ PACKED_TYPEDEF_STRUCT
     uint16_t    techType;       //!< Wireless technology type
 }extImgEnableReq_t;
 
+/*!
+ * The payload of an @ref OAD_EXT_CTRL_SET_BLK_WINDOW command
+ */
+PACKED_TYPEDEF_STRUCT
+{
+    uint8_t     cmdID;          //!< Ext Ctrl Op-code
+    uint8_t     window;         //!< Requested window in blocks, 0 for none
+}setBlkWindowReq_t;
+
+/*!
+ * Response to a @ref OAD_EXT_CTRL_SET_BLK_WINDOW command
+ */
+PACKED_TYPEDEF_STRUCT
+{
+    uint8_t     cmdID;          //!< Ext Ctrl Op-code
+    uint8_t     status;         //!< Status of command
+    uint8_t     window;         //!< Granted window in blocks, 0 for none
+}setBlkWindowRspPld_t;
+
 #ifdef DMM_OAD
 typedef struct
 {
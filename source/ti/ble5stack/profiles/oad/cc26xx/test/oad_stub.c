@@ -0,0 +1,538 @@
+/******************************************************************************
+
+ @file  oad_stub.c
+
+ @brief Host services for oad.c, see oad_stub.h.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <driverlib/chipinfo.h>
+#include <icall.h>
+#include "util.h"
+#include "icall_ble_api.h"
+#include "oad.h"
+
+#include "oad_stub.h"
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define OADSTUB_MAX_CLOCKS      4
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static ICall_CSState oadStubEnterCS(void);
+static void oadStubLeaveCS(ICall_CSState key);
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+uint8_t *oadStubIntFlash;
+uint8_t oadStubExtFlash[EFL_FLASH_SIZE];
+
+void (*oadStubFlashHook)(void);
+
+bool oadStubFailMalloc;
+long oadStubAllocs;
+
+unsigned oadStubCsDepth;
+unsigned long oadStubCsEntries;
+
+ICall_EnterCS ICall_enterCriticalSection = oadStubEnterCS;
+ICall_LeaveCS ICall_leaveCriticalSection = oadStubLeaveCS;
+
+CONST uint8_t primaryServiceUUID[ATT_BT_UUID_SIZE] = { 0x00, 0x28 };
+CONST uint8_t characterUUID[ATT_BT_UUID_SIZE] = { 0x03, 0x28 };
+CONST uint8_t charUserDescUUID[ATT_BT_UUID_SIZE] = { 0x01, 0x29 };
+CONST uint8_t clientCharCfgUUID[ATT_BT_UUID_SIZE] = { 0x02, 0x29 };
+
+uint8_t linkDBNumConns = 1;
+
+gattAttribute_t *gattServAttrs;
+uint16_t gattServNumAttrs;
+CONST gattServiceCBs_t *gattServCBs;
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+
+static Clock_Struct *clocks[OADSTUB_MAX_CLOCKS];
+static unsigned numClocks;
+
+// The queue constructed last, which is the OAD queue
+static Queue_Handle oadQueue;
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static ICall_CSState oadStubEnterCS(void)
+{
+    oadStubCsEntries++;
+    return (oadStubCsDepth++);
+}
+
+static void oadStubLeaveCS(ICall_CSState key)
+{
+    // Sections are left in the reverse order of entry
+    assert(oadStubCsDepth == key + 1);
+    oadStubCsDepth--;
+}
+
+static void oadStubFlashBusy(void)
+{
+    // Flash is never written from within a critical section
+    assert(oadStubCsDepth == 0);
+
+    if(oadStubFlashHook != NULL)
+    {
+        oadStubFlashHook();
+    }
+}
+
+//*****************************************************************************
+// ICall
+//*****************************************************************************
+
+void *ICall_malloc(uint_least16_t size)
+{
+    void *p;
+
+    if(oadStubFailMalloc)
+    {
+        oadStubFailMalloc = false;
+        return (NULL);
+    }
+
+    p = malloc(size);
+    assert(p != NULL);
+    oadStubAllocs++;
+
+    return (p);
+}
+
+void ICall_free(void *msg)
+{
+    if(msg != NULL)
+    {
+        free(msg);
+        oadStubAllocs--;
+    }
+}
+
+//*****************************************************************************
+// Util clocks
+//*****************************************************************************
+
+Clock_Handle Util_constructClock(Clock_Struct *pClock, Clock_FuncPtr clockCB,
+                                 uint32_t clockDuration, uint32_t clockPeriod,
+                                 uint8_t startFlag, UArg arg)
+{
+    assert(numClocks < OADSTUB_MAX_CLOCKS);
+    clocks[numClocks++] = pClock;
+
+    pClock->fxn = clockCB;
+    pClock->arg = arg;
+    pClock->timeout = clockDuration;
+    pClock->period = clockPeriod;
+    pClock->remaining = clockDuration;
+    pClock->active = startFlag;
+
+    return (pClock);
+}
+
+void Util_startClock(Clock_Struct *pClock)
+{
+    pClock->remaining = pClock->timeout;
+    pClock->active = true;
+}
+
+bool Util_isActive(Clock_Struct *pClock)
+{
+    return (pClock->active);
+}
+
+void Util_stopClock(Clock_Struct *pClock)
+{
+    pClock->active = false;
+}
+
+void Util_rescheduleClock(Clock_Struct *pClock, uint32_t clockPeriod)
+{
+    pClock->timeout = clockPeriod;
+    pClock->period = clockPeriod;
+
+    if(pClock->active)
+    {
+        Util_startClock(pClock);
+    }
+}
+
+void oadStubTick(uint32_t ms)
+{
+    unsigned i;
+
+    for(i = 0; i < numClocks; i++)
+    {
+        Clock_Struct *pClock = clocks[i];
+
+        if(!pClock->active)
+        {
+            continue;
+        }
+
+        if(pClock->remaining > ms)
+        {
+            pClock->remaining -= ms;
+        }
+        else
+        {
+            pClock->remaining = pClock->period;
+            pClock->active = (pClock->period > 0);
+            pClock->fxn(pClock->arg);
+        }
+    }
+}
+
+//*****************************************************************************
+// Queue
+//*****************************************************************************
+
+void Queue_construct(Queue_Struct *obj, const Queue_Params *params)
+{
+    obj->next = obj;
+    obj->prev = obj;
+    oadQueue = obj;
+}
+
+Queue_Handle Queue_handle(Queue_Struct *obj)
+{
+    return (obj);
+}
+
+void *Queue_get(Queue_Handle handle)
+{
+    Queue_Elem *elem = handle->next;
+
+    // An empty queue returns its own handle
+    elem->next->prev = handle;
+    handle->next = elem->next;
+
+    return (elem);
+}
+
+void Queue_put(Queue_Handle handle, Queue_Elem *elem)
+{
+    elem->next = handle;
+    elem->prev = handle->prev;
+    handle->prev->next = elem;
+    handle->prev = elem;
+}
+
+bool Queue_empty(Queue_Handle handle)
+{
+    return (handle->next == handle);
+}
+
+unsigned oadStubQueued(uint8_t event)
+{
+    Queue_Elem *elem;
+    unsigned count = 0;
+
+    for(elem = oadQueue->next; elem != oadQueue; elem = elem->next)
+    {
+        if(((oadTargetWrite_t *)elem)->event == event)
+        {
+            count++;
+        }
+    }
+
+    return (count);
+}
+
+//*****************************************************************************
+// GATT server and link database
+//*****************************************************************************
+
+bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs,
+                                      uint16_t numAttrs, uint8_t encKeySize,
+                                      CONST gattServiceCBs_t *pServiceCBs)
+{
+    uint16_t i;
+
+    for(i = 0; i < numAttrs; i++)
+    {
+        pAttrs[i].handle = i + 1;
+    }
+
+    gattServAttrs = pAttrs;
+    gattServNumAttrs = numAttrs;
+    gattServCBs = pServiceCBs;
+
+    return (SUCCESS);
+}
+
+gattAttribute_t *GATTServApp_FindAttr(gattAttribute_t *pAttrTbl,
+                                      uint16_t numAttrs, uint8_t *pValue)
+{
+    uint16_t i;
+
+    for(i = 0; i < numAttrs; i++)
+    {
+        if(pAttrTbl[i].pValue == pValue)
+        {
+            return (&pAttrTbl[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+void GATTServApp_InitCharCfg(uint16_t connHandle, gattCharCfg_t *charCfgTbl)
+{
+    uint8_t i;
+
+    for(i = 0; i < linkDBNumConns; i++)
+    {
+        if((connHandle == LINKDB_CONNHANDLE_INVALID) ||
+           (charCfgTbl[i].connHandle == connHandle))
+        {
+            charCfgTbl[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+            charCfgTbl[i].value = 0;
+        }
+    }
+}
+
+uint16_t GATTServApp_ReadCharCfg(uint16_t connHandle, gattCharCfg_t *charCfgTbl)
+{
+    uint8_t i;
+
+    for(i = 0; i < linkDBNumConns; i++)
+    {
+        if(charCfgTbl[i].connHandle == connHandle)
+        {
+            return (charCfgTbl[i].value);
+        }
+    }
+
+    return (0);
+}
+
+bStatus_t GATTServApp_ProcessCCCWriteReq(uint16_t connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t len,
+                                         uint16_t offset, uint16_t validCfg)
+{
+    // The attribute value holds a pointer to the CCCD table
+    gattCharCfg_t *charCfgTbl = *(gattCharCfg_t **)pAttr->pValue;
+    uint16_t value;
+    uint8_t i;
+
+    if((len != 2) || (offset != 0))
+    {
+        return (ATT_ERR_INVALID_VALUE_SIZE);
+    }
+
+    value = BUILD_UINT16(pValue[0], pValue[1]);
+    assert((value & ~validCfg) == 0);
+
+    for(i = 0; i < linkDBNumConns; i++)
+    {
+        if((charCfgTbl[i].connHandle == connHandle) ||
+           (charCfgTbl[i].connHandle == LINKDB_CONNHANDLE_INVALID))
+        {
+            charCfgTbl[i].connHandle = connHandle;
+            charCfgTbl[i].value = value;
+            return (SUCCESS);
+        }
+    }
+
+    return (FAILURE);
+}
+
+void *GATT_bm_alloc(uint16_t connHandle, uint8_t opcode, uint16_t size,
+                    uint16_t *pSizeAlloc)
+{
+    if(pSizeAlloc != NULL)
+    {
+        *pSizeAlloc = size;
+    }
+
+    return (malloc(size));
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8_t opcode)
+{
+    free(pMsg->handleValueNoti.pValue);
+    pMsg->handleValueNoti.pValue = NULL;
+}
+
+uint8_t linkDB_State(uint16_t connectionHandle, uint8_t state)
+{
+    // A single connection, which stays up
+    return ((connectionHandle != LINKDB_CONNHANDLE_INVALID) &&
+            (state == LINK_CONNECTED));
+}
+
+bStatus_t GAPBondMgr_SetParameter(uint16_t param, uint8_t len, void *pValue)
+{
+    return (SUCCESS);
+}
+
+//*****************************************************************************
+// Chip info, of a CC2652R
+//*****************************************************************************
+
+ChipType_t ChipInfo_GetChipType(void)
+{
+    return (CHIP_TYPE_CC2652);
+}
+
+ChipFamily_t ChipInfo_GetChipFamily(void)
+{
+    return (FAMILY_CC13x2_CC26x2);
+}
+
+HwRevision_t ChipInfo_GetHwRevision(void)
+{
+    return (HWREV_2_1);
+}
+
+//*****************************************************************************
+// Flash interface, off-chip
+//*****************************************************************************
+
+bool oadStubInit(void)
+{
+    if(oadStubIntFlash == NULL)
+    {
+        void *p = mmap((void *)OADSTUB_INT_BASE, OADSTUB_INT_SIZE,
+                       PROT_READ | PROT_WRITE,
+                       MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if(p != (void *)OADSTUB_INT_BASE)
+        {
+            return (false);
+        }
+        oadStubIntFlash = p;
+    }
+
+    memset(oadStubIntFlash, 0xFF, OADSTUB_INT_SIZE);
+    memset(oadStubExtFlash, 0xFF, sizeof(oadStubExtFlash));
+
+    return (true);
+}
+
+void flash_init(void)
+{
+}
+
+bool flash_open(void)
+{
+    return (true);
+}
+
+void flash_close(void)
+{
+}
+
+bool hasExternalFlash(void)
+{
+    return (true);
+}
+
+uint8_t readFlash(uint_least32_t addr, uint8_t *pBuf, size_t len)
+{
+    assert(addr + len <= sizeof(oadStubExtFlash));
+    memcpy(pBuf, &oadStubExtFlash[addr], len);
+
+    return (FLASH_SUCCESS);
+}
+
+uint8_t readFlashPg(uint8_t page, uint32_t offset, uint8_t *pBuf,
+                    uint16_t len)
+{
+    return (readFlash(EXT_FLASH_ADDRESS(page, offset), pBuf, len));
+}
+
+uint8_t writeFlash(uint_least32_t addr, uint8_t *pBuf, size_t len)
+{
+    size_t i;
+
+    oadStubFlashBusy();
+
+    assert(addr + len <= sizeof(oadStubExtFlash));
+    for(i = 0; i < len; i++)
+    {
+        oadStubExtFlash[addr + i] &= pBuf[i];
+    }
+
+    return (FLASH_SUCCESS);
+}
+
+uint8_t writeFlashPg(uint8_t page, uint32_t offset, uint8_t *pBuf,
+                     uint16_t len)
+{
+    return (writeFlash(EXT_FLASH_ADDRESS(page, offset), pBuf, len));
+}
+
+uint8_t eraseFlashPg(uint8_t page)
+{
+    oadStubFlashBusy();
+
+    assert(EXT_FLASH_ADDRESS(page + 1, 0) <= sizeof(oadStubExtFlash));
+    memset(&oadStubExtFlash[EXT_FLASH_ADDRESS(page, 0)], 0xFF, EFL_PAGE_SIZE);
+
+    return (FLASH_SUCCESS);
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+
+ @file  oad_stub.h
+
+ @brief Host services for oad.c: heap, critical sections, clocks, queue,
+        GATT server and flash.
+
+        Internal flash is mapped at OADSTUB_INT_BASE, where FLASH_ADDRESS()
+        of stub/common/cc26xx/flash_interface/flash_interface.h points, and
+        external flash is an array served through the flash interface.
+        Both behave as NOR flash: a write can only clear bits. Time is
+        virtual. Clocks expire as the test advances it, and flash writes and
+        erases call oadStubFlashHook first, so that a test can pass time
+        and run the stack task while the application task waits on flash.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef OAD_STUB_H
+#define OAD_STUB_H
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/cc26xx/flash_interface/flash_interface.h>
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define OADSTUB_INT_SIZE        (MAX_ONCHIP_FLASH_PAGES * INTFLASH_PAGE_SIZE)
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+// Internal flash, mapped at OADSTUB_INT_BASE by oadStubInit()
+extern uint8_t *oadStubIntFlash;
+extern uint8_t oadStubExtFlash[EFL_FLASH_SIZE];
+
+// Called before each flash write or erase
+extern void (*oadStubFlashHook)(void);
+
+// Makes the next ICall_malloc() fail
+extern bool oadStubFailMalloc;
+// ICall_malloc() blocks not yet freed
+extern long oadStubAllocs;
+
+// Critical section nesting, the stack task may only run at 0
+extern unsigned oadStubCsDepth;
+extern unsigned long oadStubCsEntries;
+
+//*****************************************************************************
+// Functions
+//*****************************************************************************
+
+// Maps internal flash and erases both flashes, false if it can not be mapped
+extern bool oadStubInit(void);
+
+// Passes ms of virtual time, running the clocks which expire
+extern void oadStubTick(uint32_t ms);
+
+// Messages of an oadEvent_e waiting in the OAD queue
+extern unsigned oadStubQueued(uint8_t event);
+
+#endif /* OAD_STUB_H */
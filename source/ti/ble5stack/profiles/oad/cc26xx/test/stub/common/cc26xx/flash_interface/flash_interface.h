@@ -0,0 +1,66 @@
+/******************************************************************************
+
+ @file  flash_interface.h
+
+ @brief The flash interface of common/cc26xx, with internal flash moved to
+        where the host can map it.
+
+        oad.c reads the headers of the images in internal flash in place,
+        through FLASH_ADDRESS(). The device maps internal flash from
+        address 0, which a host process cannot map, so this header moves it
+        up by OADSTUB_INT_BASE. FLASH_PAGE() and the page numbers passed to
+        the flash interface are left as on the device.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#include_next <common/cc26xx/flash_interface/flash_interface.h>
+
+#ifndef OADSTUB_FLASH_INTERFACE_H
+#define OADSTUB_FLASH_INTERFACE_H
+
+// Host address of internal flash page 0, below 4 GB as oad.c keeps flash
+// addresses in 32 bits
+#define OADSTUB_INT_BASE                0x10000
+
+#undef FLASH_ADDRESS
+#define FLASH_ADDRESS(page, offset)     (OADSTUB_INT_BASE + ((page) << 13) + (offset))
+
+#endif /* OADSTUB_FLASH_INTERFACE_H */
@@ -0,0 +1,217 @@
+/******************************************************************************
+
+ @file  icall_ble_api.h
+
+ @brief Host stand-in for the BLE stack API used by oad.c.
+
+        Declares the GATT server, link database and bond manager types and
+        functions oad.c calls, with the same names and layouts as the
+        stack headers. oad_stub.c serves them from a single GATT server
+        that keeps the attribute table registered last; GATT_Notification()
+        is left to the test, which plays the peer.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef ICALL_BLE_API_H
+#define ICALL_BLE_API_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define CONST                           const
+
+// Status, as in comdef.h
+#define SUCCESS                         0x00
+#define FAILURE                         0x01
+
+// Flash geometry, as in hal_board_cfg.h for CC26X2
+#define HAL_FLASH_PAGE_SIZE             8192
+#define HAL_FLASH_WORD_SIZE             4
+
+#define LO_UINT16(a)                    ((a) & 0xFF)
+#define HI_UINT16(a)                    (((a) >> 8) & 0xFF)
+#define BUILD_UINT16(loByte, hiByte) \
+          ((uint16_t)(((loByte) & 0x00FF) + (((hiByte) & 0x00FF) << 8)))
+#define BUILD_UINT32(Byte0, Byte1, Byte2, Byte3) \
+          ((uint32_t)((uint32_t)((Byte0) & 0x00FF) \
+          + ((uint32_t)((Byte1) & 0x00FF) << 8) \
+          + ((uint32_t)((Byte2) & 0x00FF) << 16) \
+          + ((uint32_t)((Byte3) & 0x00FF) << 24)))
+
+// TI Base 128-bit UUID, as in bcomdef.h
+#define TI_BASE_UUID_128( uuid )  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB0, \
+                                  0x00, 0x40, 0x51, 0x04, LO_UINT16( uuid ), HI_UINT16( uuid ), 0x00, 0xF0
+
+// ATT, as in att.h
+#define ATT_HANDLE_VALUE_NOTI           0x1b
+#define ATT_WRITE_CMD                   0x52
+#define ATT_BT_UUID_SIZE                2
+#define ATT_UUID_SIZE                   16
+#define ATT_ERR_INVALID_HANDLE          0x01
+#define ATT_ERR_ATTR_NOT_FOUND          0x0a
+#define ATT_ERR_ATTR_NOT_LONG           0x0b
+#define ATT_ERR_INVALID_VALUE_SIZE      0x0d
+
+// GATT, as in gatt.h, gattservapp.h and gatt_uuid.h
+#define GATT_PERMIT_READ                0x01
+#define GATT_PERMIT_WRITE               0x02
+#define GATT_PERMIT_AUTHEN_WRITE        0x08
+#define GATT_MAX_ENCRYPT_KEY_SIZE       16
+
+#define GATT_PROP_READ                  0x02
+#define GATT_PROP_WRITE_NO_RSP          0x04
+#define GATT_PROP_WRITE                 0x08
+#define GATT_PROP_NOTIFY                0x10
+
+#define GATT_CLIENT_CFG_NOTIFY          0x0001
+#define GATT_CLIENT_CHAR_CFG_UUID       0x2902
+
+#define GATT_NUM_ATTRS( attrs )         ( sizeof( attrs ) / sizeof( gattAttribute_t ) )
+
+// Link database, as in linkdb.h
+#define LINKDB_CONNHANDLE_INVALID       0xFFFF
+#define LINK_CONNECTED                  0x01
+
+// Bond manager, as in gapbondmgr.h
+#define GAPBOND_ERASE_ALLBONDS          0x409
+
+//*****************************************************************************
+// Typedefs
+//*****************************************************************************
+
+typedef uint8_t bStatus_t;
+
+typedef struct
+{
+  uint8_t len;                  //!< Length of UUID (2 or 16)
+  const uint8_t *uuid;          //!< Pointer to UUID
+} gattAttrType_t;
+
+typedef struct attAttribute_t
+{
+  gattAttrType_t type;          //!< Attribute type (2 or 16 octet UUIDs)
+  uint8_t permissions;          //!< Attribute permissions
+  uint16_t handle;              //!< Attribute handle, assigned on registration
+  uint8_t * const pValue;       //!< Attribute value
+} gattAttribute_t;
+
+typedef struct
+{
+  uint16_t handle;              //!< Handle of the attribute notified
+  uint16_t len;                 //!< Length of value
+  uint8_t *pValue;              //!< Value, allocated with GATT_bm_alloc()
+} attHandleValueNoti_t;
+
+typedef union
+{
+  attHandleValueNoti_t handleValueNoti;
+} gattMsg_t;
+
+typedef struct
+{
+  uint16_t connHandle;          //!< Client connection handle
+  uint8_t  value;               //!< Characteristic configuration value
+} gattCharCfg_t;
+
+typedef bStatus_t (*pfnGATTReadAttrCB_t)( uint16_t connHandle, gattAttribute_t *pAttr,
+                                          uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                                          uint16_t maxLen, uint8_t method );
+
+typedef bStatus_t (*pfnGATTWriteAttrCB_t)( uint16_t connHandle, gattAttribute_t *pAttr,
+                                           uint8_t *pValue, uint16_t len, uint16_t offset,
+                                           uint8_t method );
+
+typedef bStatus_t (*pfnGATTAuthorizeAttrCB_t)( uint16_t connHandle, gattAttribute_t *pAttr,
+                                               uint8_t opcode );
+
+typedef struct
+{
+  pfnGATTReadAttrCB_t pfnReadAttrCB;           //!< Read callback function pointer
+  pfnGATTWriteAttrCB_t pfnWriteAttrCB;         //!< Write callback function pointer
+  pfnGATTAuthorizeAttrCB_t pfnAuthorizeAttrCB; //!< Authorization callback function pointer
+} gattServiceCBs_t;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+extern CONST uint8_t primaryServiceUUID[];
+extern CONST uint8_t characterUUID[];
+extern CONST uint8_t charUserDescUUID[];
+extern CONST uint8_t clientCharCfgUUID[];
+
+extern uint8_t linkDBNumConns;
+
+// The service registered last, served by the stub GATT server
+extern gattAttribute_t *gattServAttrs;
+extern uint16_t gattServNumAttrs;
+extern CONST gattServiceCBs_t *gattServCBs;
+
+//*****************************************************************************
+// Functions
+//*****************************************************************************
+
+extern bStatus_t GATTServApp_RegisterService( gattAttribute_t *pAttrs,
+                                              uint16_t numAttrs, uint8_t encKeySize,
+                                              CONST gattServiceCBs_t *pServiceCBs );
+extern gattAttribute_t *GATTServApp_FindAttr( gattAttribute_t *pAttrTbl,
+                                              uint16_t numAttrs, uint8_t *pValue );
+extern void GATTServApp_InitCharCfg( uint16_t connHandle, gattCharCfg_t *charCfgTbl );
+extern uint16_t GATTServApp_ReadCharCfg( uint16_t connHandle, gattCharCfg_t *charCfgTbl );
+extern bStatus_t GATTServApp_ProcessCCCWriteReq( uint16_t connHandle, gattAttribute_t *pAttr,
+                                                 uint8_t *pValue, uint16_t len, uint16_t offset,
+                                                 uint16_t validCfg );
+
+extern void *GATT_bm_alloc( uint16_t connHandle, uint8_t opcode, uint16_t size,
+                            uint16_t *pSizeAlloc );
+extern void GATT_bm_free( gattMsg_t *pMsg, uint8_t opcode );
+extern bStatus_t GATT_Notification( uint16_t connHandle, attHandleValueNoti_t *pNoti,
+                                    uint8_t authenticated );
+
+extern uint8_t linkDB_State( uint16_t connectionHandle, uint8_t state );
+
+extern bStatus_t GAPBondMgr_SetParameter( uint16_t param, uint8_t len, void *pValue );
+
+#endif /* ICALL_BLE_API_H */
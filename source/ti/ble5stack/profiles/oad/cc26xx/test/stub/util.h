@@ -0,0 +1,89 @@
+/******************************************************************************
+
+ @file  util.h
+
+ @brief Host stand-in for the clock functions of util.h used by oad.c.
+
+        Clocks run on the virtual time of oad_stub.c, which the test
+        advances with oadStubTick().
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ti/sysbios/knl/Queue.h>
+
+// Event ids, as in ti/sysbios/knl/Event.h
+#define Event_Id_01         (0x2)
+#define Event_Id_02         (0x4)
+#define Event_Id_03         (0x8)
+
+typedef uintptr_t UArg;
+
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct
+{
+    Clock_FuncPtr fxn;
+    UArg          arg;
+    uint32_t      timeout;      // ms to the first expiry
+    uint32_t      period;       // ms between expiries, 0 for one shot
+    uint32_t      remaining;    // ms to the next expiry while active
+    bool          active;
+} Clock_Struct;
+
+typedef Clock_Struct *Clock_Handle;
+
+extern Clock_Handle Util_constructClock(Clock_Struct *pClock,
+                                        Clock_FuncPtr clockCB,
+                                        uint32_t clockDuration,
+                                        uint32_t clockPeriod,
+                                        uint8_t startFlag,
+                                        UArg arg);
+extern void Util_startClock(Clock_Struct *pClock);
+extern bool Util_isActive(Clock_Struct *pClock);
+extern void Util_stopClock(Clock_Struct *pClock);
+extern void Util_rescheduleClock(Clock_Struct *pClock, uint32_t clockPeriod);
+
+#endif /* UTIL_H */
@@ -0,0 +1,780 @@
+/******************************************************************************
+
+ @file  test_oad_window.c
+
+ @brief Host simulation of the OAD block window protocol.
+
+        Runs oad.c for off-chip OAD on the stand-ins of oad_stub.c. The test
+        plays the peer, which writes through oadWriteAttrCB as the stack
+        task, and the application task, which calls OAD_processQueue on
+        OAD_QUEUE_EVT, on a clock of radio slots and connection events.
+        The stack task keeps writing while the application task waits on
+        flash. Blocks are lost at random as if the OAD queue ran out of
+        heap. The image must arrive whole in external flash, the queue
+        must stay within the window, blocks past the window must be
+        dropped, the target must ask the peer to go back at most once per
+        requested block and blocks in flight must not disturb OAD_COMPLETE.
+        It prints the connection events an image takes in lockstep and with
+        a window.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util.h"
+#include "icall_ble_api.h"
+#include "oad.h"
+#include <common/cc26xx/oad/oad_image_header.h>
+#include <common/cc26xx/oad/ext_flash_layout.h>
+
+#include "oad_stub.h"
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define SIM_CONN                0
+// ATT MTU for blocks of OAD_MAX_BLOCK_SIZE
+#define SIM_MTU                 (OAD_MAX_BLOCK_SIZE + OAD_ATT_OVERHEAD)
+#define SIM_BLK_BYTES           (OAD_MAX_BLOCK_SIZE - OAD_BLK_NUM_HDR_SZ)
+// 352 kB image in 240 byte blocks, the last one partial
+#define SIM_BLOCKS              1500
+#define SIM_IMG_LEN             (SIM_BLOCKS * SIM_BLK_BYTES - 100)
+// The peer gets a block out in each radio slot it has credit for
+#define SIM_SLOTS_PER_EVENT     6
+#define SIM_EVENT_MS            15
+// Slots the application task waits on a flash write or page erase
+#define SIM_FLASH_SLOTS         2
+// Notifications in flight to the peer
+#define SIM_NOTIF_MAX           64
+#define SIM_SEEDS               200
+
+// The factory image, which OAD_open() finds on external flash
+#define SIM_FACT_ADDR           0xC0000
+#define SIM_FACT_LEN            0x3F000
+// Where oad.c puts the candidate and its metadata: after the meta pages,
+// and in the last free meta page
+#define SIM_IMG_ADDR            (OAD_EFL_MAX_META * EFL_PAGE_SIZE)
+#define SIM_META_PAGE           (OAD_EFL_MAX_META - 1)
+
+#define CRC32_POLYNOMIAL_REF    ((uint32_t)0xEDB88320)
+
+//*****************************************************************************
+// Typedefs
+//*****************************************************************************
+
+typedef struct
+{
+    uint16_t handle;
+    uint8_t  len;
+    uint8_t  data[16];
+} simNotif_t;
+
+typedef struct
+{
+    unsigned long events;
+    unsigned long requests;
+    unsigned long goBacks;
+    unsigned long lost;
+    unsigned long drops;
+    unsigned long timeouts;
+} simStats_t;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+// Header of the running image, an app and stack library image
+const imgHdr_t _imgHdr =
+{
+    .fixedHdr =
+    {
+        .imgID = OAD_IMG_ID_VAL,
+        .bimVer = BIM_VER,
+        .metaVer = META_VER,
+        .techType = OAD_WIRELESS_TECH_BLE,
+        .imgCpStat = DEFAULT_STATE,
+        .crcStat = CRC_VALID,
+        .imgType = OAD_IMG_TYPE_APPSTACKLIB,
+        .hdrLen = sizeof(imgHdr_t),
+    },
+    .imgPayload =
+    {
+        .segTypeImg = IMG_PAYLOAD_SEG_ID,
+        .wirelessTech = OAD_WIRELESS_TECH_BLE,
+    },
+};
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+
+static uint8_t image[SIM_IMG_LEN];
+static imgIdentifyPld_t imgIdentify;
+
+static gattAttribute_t *identifyAttr;
+static gattAttribute_t *blockAttr;
+static gattAttribute_t *extCtrlAttr;
+
+// ICall_malloc() blocks held by the open OAD module
+static long allocsOpen;
+
+// Radio slots since the start
+static unsigned long slot;
+
+// Notifications sent this connection event, delivered in the next one
+static simNotif_t notifs[SIM_NOTIF_MAX];
+static unsigned numNotifs;
+
+// Application task state
+static unsigned callbacks;
+static uint8_t lastEvent;
+static bool appPending;
+static bool timedOut;
+static bool enabled;
+
+// Peer state
+static uint8_t window;
+static uint32_t peerNext;
+static uint32_t peerLimit;
+static bool peerDone;
+// Blocks past the window the peer sends with its first blocks
+static unsigned peerOverrun;
+static unsigned peerBurst;
+
+static uint8_t goBacks[SIM_BLOCKS];
+// Block last asked for again, and whether it was lost again
+static uint32_t resentBlk;
+static bool lostResent;
+// Blocks sent and lost since the last block request
+static unsigned long sentSinceReq;
+static unsigned long lostSinceReq;
+static unsigned lossPerMille;
+static simStats_t stats;
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static void simSlot(void);
+
+// Bit-wise crc32, as calculated before CRC32_update()
+static uint32_t refCrc(const uint8_t *pBuf, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    uint8_t j;
+
+    while(len--)
+    {
+        crc ^= *pBuf++;
+        for(j = 0; j < 8; j++)
+        {
+            crc = (crc >> 1) ^ (CRC32_POLYNOMIAL_REF & -(crc & 1));
+        }
+    }
+
+    return (~crc);
+}
+
+// The image to download, and its image identify payload
+static void simImage(void)
+{
+    imgHdr_t hdr = _imgHdr;
+    uint32_t i;
+
+    srand(0);
+    for(i = 0; i < SIM_IMG_LEN; i++)
+    {
+        image[i] = rand();
+    }
+
+    hdr.fixedHdr.crcStat = DEFAULT_STATE;
+    hdr.fixedHdr.len = SIM_IMG_LEN;
+    hdr.fixedHdr.imgEndAddr = SIM_IMG_LEN - 1;
+    hdr.imgPayload.imgSegLen = SIM_IMG_LEN;
+    hdr.imgPayload.startAddr = 0;
+    memcpy(image, &hdr, sizeof(hdr));
+
+    hdr.fixedHdr.crc32 = refCrc(image + IMG_DATA_OFFSET,
+                                SIM_IMG_LEN - IMG_DATA_OFFSET);
+    memcpy(image, &hdr, sizeof(hdr));
+
+    memcpy(imgIdentify.imgID, hdr.fixedHdr.imgID, OAD_IMG_ID_LEN);
+    imgIdentify.bimVer = hdr.fixedHdr.bimVer;
+    imgIdentify.metaVer = hdr.fixedHdr.metaVer;
+    imgIdentify.imgCpStat = hdr.fixedHdr.imgCpStat;
+    imgIdentify.crcStat = hdr.fixedHdr.crcStat;
+    imgIdentify.imgType = hdr.fixedHdr.imgType;
+    imgIdentify.imgNo = hdr.fixedHdr.imgNo;
+    imgIdentify.len = hdr.fixedHdr.len;
+    memcpy(imgIdentify.softVer, hdr.fixedHdr.softVer, 4);
+}
+
+// Erased flash, but for the metadata of the factory image
+static void simFlashInit(void)
+{
+    uint8_t magic[] = OAD_EFL_MAGIC;
+    ExtImageInfo_t fact;
+
+    oadStubInit();
+
+    memset(&fact, 0xFF, sizeof(fact));
+    memcpy(fact.fixedHdr.imgID, magic, OAD_IMG_ID_LEN);
+    fact.fixedHdr.imgType = OAD_IMG_TYPE_FACTORY;
+    fact.fixedHdr.crcStat = CRC_VALID;
+    fact.fixedHdr.len = SIM_FACT_LEN;
+    fact.extFlAddr = SIM_FACT_ADDR;
+    fact.counter = 0;
+    memcpy(&oadStubExtFlash[EFL_ADDR_META_FACT_IMG], &fact, sizeof(fact));
+}
+
+static gattAttribute_t *simFindAttr(uint16_t uuid)
+{
+    uint16_t i;
+
+    for(i = 0; i < gattServNumAttrs; i++)
+    {
+        gattAttribute_t *pAttr = &gattServAttrs[i];
+
+        if((pAttr->type.len == ATT_UUID_SIZE) &&
+           (BUILD_UINT16(pAttr->type.uuid[12], pAttr->type.uuid[13]) == uuid))
+        {
+            return (pAttr);
+        }
+    }
+
+    assert(false);
+    return (NULL);
+}
+
+// Stack task: a write of the peer, returns the OAD callbacks it made
+static unsigned simWrite(gattAttribute_t *pAttr, uint8_t *pValue, uint16_t len)
+{
+    unsigned calls = callbacks;
+    bStatus_t status;
+
+    // The stack task does not run inside a critical section
+    assert(oadStubCsDepth == 0);
+
+    status = gattServCBs->pfnWriteAttrCB(SIM_CONN, pAttr, pValue, len, 0,
+                                         ATT_WRITE_CMD);
+    assert(status == SUCCESS);
+
+    return (callbacks - calls);
+}
+
+static void simEnableNotif(gattAttribute_t *pAttr)
+{
+    uint8_t cfg[2] = { LO_UINT16(GATT_CLIENT_CFG_NOTIFY),
+                       HI_UINT16(GATT_CLIENT_CFG_NOTIFY) };
+
+    // The CCCD follows the characteristic value
+    assert(BUILD_UINT16(pAttr[1].type.uuid[0], pAttr[1].type.uuid[1]) ==
+           GATT_CLIENT_CHAR_CFG_UUID);
+    simWrite(&pAttr[1], cfg, sizeof(cfg));
+}
+
+static uint16_t simBlock(uint32_t blkNum, uint8_t *pBlk)
+{
+    uint32_t offset = blkNum * SIM_BLK_BYTES;
+    uint16_t len = SIM_BLK_BYTES;
+
+    if(SIM_IMG_LEN - offset < len)
+    {
+        len = SIM_IMG_LEN - offset;
+    }
+
+    pBlk[0] = blkNum;
+    pBlk[1] = blkNum >> 8;
+    pBlk[2] = blkNum >> 16;
+    pBlk[3] = blkNum >> 24;
+    memcpy(pBlk + OAD_BLK_NUM_HDR_SZ, image + offset, len);
+
+    return (len + OAD_BLK_NUM_HDR_SZ);
+}
+
+static void simSendBlock(uint32_t blkNum)
+{
+    uint8_t blk[OAD_MAX_BLOCK_SIZE];
+    uint16_t len = simBlock(blkNum, blk);
+    unsigned queued = oadStubQueued(OAD_WRITE_BLOCK_REQ);
+    bool lose = ((unsigned)(rand() % 1000) < lossPerMille);
+
+    oadStubFailMalloc = lose;
+    if(simWrite(blockAttr, blk, len) == 0)
+    {
+        // Dropped without a callback, only once the peer is past the window
+        assert((window > 0) && (queued >= window));
+        stats.drops++;
+        lostSinceReq++;
+    }
+    else if(lastEvent == OAD_OUT_OF_MEM_EVT)
+    {
+        assert(lose);
+        stats.lost++;
+        lostSinceReq++;
+
+        if(blkNum == resentBlk)
+        {
+            lostResent = true;
+        }
+    }
+    else
+    {
+        assert(!lose && (lastEvent == OAD_QUEUE_EVT));
+        assert((window == 0) || (queued < window));
+    }
+    oadStubFailMalloc = false;
+    sentSinceReq++;
+
+    // The queue never holds more than the window
+    assert((window == 0) || (oadStubQueued(OAD_WRITE_BLOCK_REQ) <= window));
+}
+
+static void peerRequest(uint8_t status, uint32_t blkNum, uint8_t numBlks)
+{
+    sentSinceReq = 0;
+    lostSinceReq = 0;
+
+    if(status == OAD_DL_COMPLETE)
+    {
+        peerNext = peerLimit = SIM_BLOCKS;
+        peerDone = true;
+        return;
+    }
+    assert((status == OAD_SUCCESS) || (status == OAD_BUFFER_OFL));
+
+    if((window == 0) || (status == OAD_BUFFER_OFL) || (peerNext < blkNum))
+    {
+        peerNext = blkNum;
+    }
+    peerLimit = blkNum + numBlks;
+
+    if(peerLimit > SIM_BLOCKS)
+    {
+        peerLimit = SIM_BLOCKS;
+    }
+}
+
+static void peerReceive(const simNotif_t *notif)
+{
+    if(notif->handle == identifyAttr->handle)
+    {
+        // The image is accepted
+        assert(notif->data[0] == OAD_SUCCESS);
+        return;
+    }
+    assert(notif->handle == extCtrlAttr->handle);
+
+    switch(EXT_CTRL_OP_CODE(notif->data))
+    {
+        case OAD_EXT_CTRL_SET_BLK_WINDOW:
+        {
+            setBlkWindowRspPld_t *rsp = (setBlkWindowRspPld_t *)notif->data;
+
+            assert((rsp->status == OAD_SUCCESS) && (rsp->window == window));
+            break;
+        }
+        case OAD_EXT_CTRL_ENABLE_IMG:
+        {
+            genericExtCtrlRsp_t *rsp = (genericExtCtrlRsp_t *)notif->data;
+
+            assert(rsp->status == OAD_SUCCESS);
+            break;
+        }
+        case OAD_EXT_CTRL_BLK_RSP_NOTIF:
+        {
+            blockReqPld_t *req = (blockReqPld_t *)notif->data;
+
+            assert(window == 0);
+            peerRequest(req->prevBlkStat, req->requestedBlk, 1);
+            break;
+        }
+        case OAD_EXT_CTRL_BLK_WINDOW_NOTIF:
+        {
+            blockWindowReqPld_t *req = (blockWindowReqPld_t *)notif->data;
+
+            assert((window > 0) && (req->numBlks == window));
+            peerRequest(req->prevBlkStat, req->requestedBlk, req->numBlks);
+            break;
+        }
+        default:
+        {
+            assert(false);
+            break;
+        }
+    }
+}
+
+// One radio slot, the first of a connection event delivers the
+// notifications of the previous one
+static void simSlot(void)
+{
+    if((slot % SIM_SLOTS_PER_EVENT) == 0)
+    {
+        simNotif_t delivered[SIM_NOTIF_MAX];
+        unsigned numDelivered = numNotifs;
+        unsigned i;
+
+        memcpy(delivered, notifs, numDelivered * sizeof(simNotif_t));
+        numNotifs = 0;
+        for(i = 0; i < numDelivered; i++)
+        {
+            peerReceive(&delivered[i]);
+        }
+
+        if(!peerDone)
+        {
+            stats.events++;
+        }
+        oadStubTick(SIM_EVENT_MS);
+    }
+    slot++;
+
+    if(peerNext < peerLimit)
+    {
+        unsigned burst = 1;
+
+        if(peerBurst > 0)
+        {
+            burst = peerBurst;
+            peerBurst = 0;
+        }
+
+        while((burst-- > 0) && (peerNext < SIM_BLOCKS))
+        {
+            simSendBlock(peerNext++);
+        }
+    }
+}
+
+// Flash hook: the stack task runs while the application task waits
+static void simFlashBusy(void)
+{
+    unsigned i;
+
+    for(i = 0; i < SIM_FLASH_SLOTS; i++)
+    {
+        simSlot();
+    }
+}
+
+// Application task: oadTargetWriteCB
+static void simOadWrite(uint8_t event, uint16_t arg)
+{
+    callbacks++;
+    lastEvent = event;
+
+    if(event == OAD_QUEUE_EVT)
+    {
+        appPending = true;
+
+        if(oadStubQueued(OAD_TIMEOUT) > 0)
+        {
+            timedOut = true;
+        }
+    }
+    else if(event == OAD_DL_COMPLETE_EVT)
+    {
+        enabled = true;
+    }
+}
+
+bStatus_t GATT_Notification(uint16_t connHandle, attHandleValueNoti_t *pNoti,
+                            uint8_t authenticated)
+{
+    simNotif_t *notif = &notifs[numNotifs++];
+
+    assert(numNotifs <= SIM_NOTIF_MAX);
+    assert(pNoti->len <= sizeof(notif->data));
+
+    notif->handle = pNoti->handle;
+    notif->len = pNoti->len;
+    memcpy(notif->data, pNoti->pValue, pNoti->len);
+
+    // Sent, the stack frees the value
+    GATT_bm_free((gattMsg_t *)pNoti, ATT_HANDLE_VALUE_NOTI);
+
+    if((notif->handle == extCtrlAttr->handle) &&
+       ((EXT_CTRL_OP_CODE(notif->data) == OAD_EXT_CTRL_BLK_RSP_NOTIF) ||
+        (EXT_CTRL_OP_CODE(notif->data) == OAD_EXT_CTRL_BLK_WINDOW_NOTIF)))
+    {
+        blockReqPld_t *req = (blockReqPld_t *)notif->data;
+
+        stats.requests++;
+
+        if(req->prevBlkStat == OAD_BUFFER_OFL)
+        {
+            // The peer is told to go back at most once per block
+            assert(req->requestedBlk < SIM_BLOCKS);
+            assert(++goBacks[req->requestedBlk] == 1);
+            resentBlk = req->requestedBlk;
+            stats.goBacks++;
+        }
+    }
+
+    return (SUCCESS);
+}
+
+// The peer identifies the image, sets the window and starts the download
+static void simStart(void)
+{
+    uint8_t setWindow[] = { OAD_EXT_CTRL_SET_BLK_WINDOW, window };
+    uint8_t startOad[] = { OAD_EXT_CTRL_START_OAD };
+
+    numNotifs = 0;
+    peerNext = peerLimit = 0;
+    peerDone = false;
+    peerBurst = (peerOverrun > 0) ? window + peerOverrun : 0;
+    memset(goBacks, 0, sizeof(goBacks));
+    resentBlk = 0xFFFFFFFF;
+    lostResent = false;
+    sentSinceReq = 0;
+    lostSinceReq = 0;
+    timedOut = false;
+
+    OAD_setBlockSize(SIM_MTU);
+
+    simWrite(identifyAttr, (uint8_t *)&imgIdentify, sizeof(imgIdentify));
+    if(window > 0)
+    {
+        simWrite(extCtrlAttr, setWindow, sizeof(setWindow));
+    }
+    simWrite(extCtrlAttr, startOad, sizeof(startOad));
+}
+
+static void simDownload(void)
+{
+    uint8_t magic[] = OAD_EFL_MAGIC;
+    uint8_t enableImg[] = { OAD_EXT_CTRL_ENABLE_IMG };
+    uint8_t blk[OAD_MAX_BLOCK_SIZE];
+    ExtImageInfo_t meta;
+    unsigned calls;
+
+    simStart();
+
+    while(!peerDone)
+    {
+        if(appPending)
+        {
+            appPending = false;
+            OAD_processQueue();
+
+            if(timedOut)
+            {
+                // Inactivity timeout, the peer starts the download over. It
+                // only comes when every block sent since the last request
+                // was lost, as in lockstep, or when the block asked for
+                // again was lost
+                assert(lostResent || (lostSinceReq == sentSinceReq));
+                stats.timeouts++;
+                simStart();
+            }
+        }
+        else
+        {
+            simSlot();
+        }
+    }
+
+    if(window > 0)
+    {
+        // OAD_COMPLETE ignores a block still in flight
+        calls = simWrite(blockAttr, blk, simBlock(SIM_BLOCKS - 1, blk));
+        assert(calls == 1);
+        OAD_processQueue();
+    }
+
+    // Only enabled in OAD_COMPLETE
+    simWrite(extCtrlAttr, enableImg, sizeof(enableImg));
+    OAD_processQueue();
+    appPending = false;
+    assert(enabled);
+    enabled = false;
+
+    while(numNotifs > 0)
+    {
+        simSlot();
+    }
+
+    // The image is whole, and its metadata asks the BIM to copy it
+    assert(memcmp(&oadStubExtFlash[SIM_IMG_ADDR], image, SIM_IMG_LEN) == 0);
+
+    memcpy(&meta, &oadStubExtFlash[EXT_FLASH_ADDRESS(SIM_META_PAGE, 0)],
+           sizeof(meta));
+    assert(memcmp(meta.fixedHdr.imgID, magic, OAD_IMG_ID_LEN) == 0);
+    assert(meta.fixedHdr.len == SIM_IMG_LEN);
+    assert(meta.fixedHdr.imgCpStat == NEED_COPY);
+    assert(meta.fixedHdr.crcStat == CRC_VALID);
+    assert(meta.extFlAddr == SIM_IMG_ADDR);
+
+    // Every queued message and response is freed
+    OAD_cancel();
+    assert(oadStubAllocs == allocsOpen);
+    assert(oadStubCsDepth == 0);
+}
+
+// The application cancels with the window full, as on a link drop
+static void simCancel(uint8_t win)
+{
+    window = win;
+    lossPerMille = 0;
+    simFlashInit();
+    simStart();
+
+    while(peerLimit == 0)
+    {
+        if(appPending)
+        {
+            appPending = false;
+            OAD_processQueue();
+        }
+        else
+        {
+            simSlot();
+        }
+    }
+
+    // The application task is busy elsewhere as the blocks come in
+    while(oadStubQueued(OAD_WRITE_BLOCK_REQ) < win)
+    {
+        simSlot();
+    }
+
+    OAD_cancel();
+    appPending = false;
+    assert(oadStubAllocs == allocsOpen);
+}
+
+static void simRun(uint8_t win, unsigned perMille, unsigned seeds)
+{
+    unsigned seed;
+
+    memset(&stats, 0, sizeof(stats));
+    window = win;
+    lossPerMille = perMille;
+
+    for(seed = 1; seed <= seeds; seed++)
+    {
+        srand(seed);
+        simFlashInit();
+        simDownload();
+    }
+
+    // A peer which keeps to the window never overflows it, and without
+    // loss the download never times out
+    assert((peerOverrun > 0) || (stats.drops == 0));
+    assert((perMille > 0) || (stats.timeouts == 0));
+
+    printf("window %d, %u/1000 lost: %7.1f events, %6.1f requests, "
+           "%5.2f lost, %5.2f dropped, %5.2f go-backs per image, "
+           "%lu timeouts in %u\n",
+           window, perMille, (double)stats.events / seeds,
+           (double)stats.requests / seeds, (double)stats.lost / seeds,
+           (double)stats.drops / seeds, (double)stats.goBacks / seeds,
+           stats.timeouts, seeds);
+}
+
+int main(void)
+{
+    static oadTargetCBs_t oadCBs = { simOadWrite };
+    uint8_t status;
+    uint8_t win;
+
+    if(!oadStubInit())
+    {
+        printf("internal flash cannot be mapped\n");
+        return (1);
+    }
+
+    simImage();
+    simFlashInit();
+
+    status = OAD_open(OAD_DEFAULT_INACTIVITY_TIME);
+    assert(status == OAD_SUCCESS);
+    OAD_register(&oadCBs);
+    allocsOpen = oadStubAllocs;
+    oadStubFlashHook = simFlashBusy;
+
+    identifyAttr = simFindAttr(OAD_IMG_IDENTIFY_UUID);
+    blockAttr = simFindAttr(OAD_IMG_BLOCK_UUID);
+    extCtrlAttr = simFindAttr(OAD_EXT_CTRL_UUID);
+    simEnableNotif(identifyAttr);
+    simEnableNotif(blockAttr);
+    simEnableNotif(extCtrlAttr);
+
+    simRun(0, 0, 1);
+    for(win = 2; win <= OAD_MAX_BLK_WINDOW; win *= 2)
+    {
+        simRun(win, 0, 1);
+    }
+
+    // A peer which sends two blocks past the window at the start has them
+    // dropped, and is told to go back for them
+    peerOverrun = 2;
+    simRun(4, 0, 1);
+    peerOverrun = 0;
+    assert((stats.drops == 2) && (stats.goBacks > 0));
+
+    // The download after a cancel starts with an empty window
+    simCancel(4);
+    simRun(4, 0, 1);
+
+    for(win = 2; win <= OAD_MAX_BLK_WINDOW; win *= 2)
+    {
+        simRun(win, 5, SIM_SEEDS);
+        assert(stats.goBacks > 0);
+    }
+
+    // Every critical section entered was left
+    assert((oadStubCsEntries > 0) && (oadStubCsDepth == 0));
+
+    return (0);
+}
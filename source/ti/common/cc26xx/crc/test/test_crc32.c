@@ -0,0 +1,287 @@
+/******************************************************************************
+
+ @file  test_crc32.c
+
+ @brief Host test and benchmark of the crc32 module.
+
+        Checks CRC32_update() against a bit-wise reference over random
+        buffers split at random points, and CRC32_calc() over internal
+        and external flash images of random offsets and lengths. Internal
+        flash is mapped at its page addresses, external flash is read
+        through a readFlashPg() stub which counts the reads. Then times
+        CRC32_calc() over a 1 MB internal and a 352 KB external image,
+        so that the CRC32_BUF_SZ and CRC32_SLICE_BY_8 builds can be
+        compared.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+/*******************************************************************************
+ *                                          Includes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "common/cc26xx/flash_interface/flash_interface.h"
+#include "common/cc26xx/oad/oad_image_header.h"
+#include "common/cc26xx/crc/crc32.h"
+
+/*******************************************************************************
+ *                                          Constants
+ */
+
+/* Internal flash is mapped from this address, pages of INTFLASH_PAGE_SIZE */
+#define TEST_INT_BASE         0x10000
+#define TEST_INT_SIZE         (2 * 1024 * 1024)
+#define TEST_EXT_SIZE         (2 * 1024 * 1024)
+
+#define CRC32_POLYNOMIAL_REF  ((uint32_t)0xEDB88320)
+
+/* As in crc32.c */
+#ifndef CRC32_BUF_SZ
+#define CRC32_BUF_SZ          256
+#endif
+
+#define TEST_ROUNDS           3000
+#define TEST_RUNS             5
+
+#if defined(CRC32_SLICE_BY_8)
+#define TEST_BUILD            "slice-by-8"
+#else
+#define TEST_BUILD            "nibble table"
+#endif
+
+/*******************************************************************************
+ *                                       Local Variables
+ */
+
+static uint8_t extFlash[TEST_EXT_SIZE];
+static uint8_t *intFlash;
+static unsigned long extReads;
+
+/*******************************************************************************
+ *                                       Local Functions
+ */
+
+/*
+ * readFlashPg of the external flash, counting the reads.
+ */
+uint8_t readFlashPg(uint8_t page, uint32_t offset, uint8_t *pBuf, uint16_t len)
+{
+    extReads++;
+    memcpy(pBuf, &extFlash[EXT_FLASH_ADDRESS(page, offset)], len);
+    return(FLASH_SUCCESS);
+}
+
+/*
+ * Bit-wise crc32, as calculated before CRC32_update().
+ */
+static uint32_t refCrc(const uint8_t *pBuf, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    uint8_t j;
+
+    while(len--)
+    {
+        crc ^= *pBuf++;
+        for(j = 0; j < 8; j++)
+        {
+            crc = (crc >> 1) ^ (CRC32_POLYNOMIAL_REF & -(crc & 1));
+        }
+    }
+
+    return(~crc);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return(ts.tv_sec + ts.tv_nsec * 1e-9);
+}
+
+/*
+ * CRC32_update() in random pieces against the reference.
+ */
+static int testUpdate(void)
+{
+    uint32_t crc;
+    uint32_t len;
+    uint32_t done;
+    uint32_t piece;
+    uint32_t start;
+    int round;
+
+    if(CRC32_update(0, (const uint8_t *)"123456789", 9) != 0xCBF43926)
+    {
+        printf("CRC32_update: wrong check value\n");
+        return(-1);
+    }
+
+    for(round = 0; round < TEST_ROUNDS; round++)
+    {
+        start = rand() % 64;
+        len = rand() % 5000;
+        crc = 0;
+        for(done = 0; done < len; done += piece)
+        {
+            piece = rand() % 300;
+            if(piece > len - done)
+            {
+                piece = len - done;
+            }
+            crc = CRC32_update(crc, &extFlash[start + done], piece);
+        }
+        if(crc != refCrc(&extFlash[start], len))
+        {
+            printf("CRC32_update: %u bytes at %u differ\n", len, start);
+            return(-1);
+        }
+    }
+
+    return(0);
+}
+
+/*
+ * CRC32_calc() of random images against the reference. The bytes before
+ * offset + IMG_DATA_OFFSET are skipped.
+ */
+static int testCalc(void)
+{
+    const uint8_t *image;
+    uint32_t pageSize;
+    uint32_t len;
+    uint32_t skip;
+    uint16_t offset;
+    uint8_t page;
+    bool useExtFl;
+    int round;
+
+    for(round = 0; round < TEST_ROUNDS; round++)
+    {
+        useExtFl = rand() & 1;
+        offset = (rand() & 1) ? 0 : rand() % 200;
+        len = 1 + rand() % (round < 100 ? 600 : 200000);
+        if(useExtFl)
+        {
+            pageSize = EFL_PAGE_SIZE;
+            page = rand() % 200;
+            image = &extFlash[EXT_FLASH_ADDRESS(page, 0)];
+        }
+        else
+        {
+            pageSize = INTFLASH_PAGE_SIZE;
+            page = TEST_INT_BASE / INTFLASH_PAGE_SIZE + rand() % 64;
+            image = (const uint8_t *)(uintptr_t)(page * pageSize);
+        }
+
+        skip = offset + IMG_DATA_OFFSET;
+        if(CRC32_calc(page, pageSize, offset, len, useExtFl) !=
+           (skip < len ? refCrc(image + skip, len - skip) : 0))
+        {
+            printf("CRC32_calc: %s image of %u bytes at page %u differs\n",
+                   useExtFl ? "external" : "internal", len, page);
+            return(-1);
+        }
+    }
+
+    return(0);
+}
+
+/*
+ * Times CRC32_calc() over one image.
+ */
+static void timeCalc(uint8_t page, uint32_t pageSize, uint32_t len,
+                     bool useExtFl)
+{
+    unsigned long reads = extReads;
+    double start = now();
+    int run;
+
+    for(run = 0; run < TEST_RUNS; run++)
+    {
+        CRC32_calc(page, pageSize, 0, len, useExtFl);
+    }
+
+    printf("%s, CRC32_BUF_SZ %4d: %4u KB %s image, %.2f ms, %lu reads\n",
+           TEST_BUILD, CRC32_BUF_SZ, len / 1024,
+           useExtFl ? "external" : "internal",
+           (now() - start) / TEST_RUNS * 1e3,
+           (extReads - reads) / TEST_RUNS);
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    intFlash = mmap((void *)TEST_INT_BASE, TEST_INT_SIZE,
+                    PROT_READ | PROT_WRITE,
+                    MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(intFlash != (uint8_t *)TEST_INT_BASE)
+    {
+        printf("internal flash can not be mapped at 0x%x\n", TEST_INT_BASE);
+        return(1);
+    }
+
+    srand(3);
+    for(i = 0; i < TEST_EXT_SIZE; i++)
+    {
+        extFlash[i] = rand();
+        intFlash[i] = rand();
+    }
+
+    if(testUpdate() != 0 || testCalc() != 0)
+    {
+        return(1);
+    }
+
+    /* The largest images CRC32_calc() accepts */
+    timeCalc(TEST_INT_BASE / INTFLASH_PAGE_SIZE, INTFLASH_PAGE_SIZE,
+             1024 * 1024, false);
+    timeCalc(0, EFL_PAGE_SIZE, MAX_ONCHIP_FLASH_PAGES * INTFLASH_PAGE_SIZE,
+             true);
+
+    return(0);
+}
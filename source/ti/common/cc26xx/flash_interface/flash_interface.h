@@ -77,6 +77,27 @@
  *  To select the interface, the user should include one of the above .c
  *  files within their project
  *
+ *  ## Streaming access
+ *    flash_interface_stream.c adds buffered access on top of any of the
+ *    above, for data which is written a little at a time, such as OAD
+ *    image blocks. It must be included in the project as well, and OAD
+ *    only uses it when OAD_FLASH_STREAM is defined.
+ *    - writeFlashStream() gathers consecutive writes and programs them a
+ *      FLASH_STREAM_BUF_SZ aligned block at a time.
+ *    - eraseFlashAhead() names the pages the stream is going to write.
+ *      Each is erased just before the first write to it, so the erase time
+ *      is spread over the download instead of being spent up front.
+ *
+ *    @code
+ *    eraseFlashAhead(imgAddr, imgLen);
+ *
+ *    // for every block received
+ *    writeFlashStream(imgAddr + blkOffset, pBlk, blkLen);
+ *
+ *    // once the image is complete
+ *    flushFlashStream();
+ *    @endcode
+ *
  *  ## Initialzation
  *    Initialze the module as shown below
  *    @code
@@ -149,6 +170,21 @@ extern "C"
  */
 #define SPI_MAX_READ_SZ 1024
 
+/*!
+ * Size of the streaming buffer, a power of 2. The default is the program
+ * page size of SPI flash.
+ */
+#ifndef FLASH_STREAM_BUF_SZ
+#define FLASH_STREAM_BUF_SZ         256
+#endif
+
+/*!
+ * Number of pages eraseFlashAhead() erases at a time
+ */
+#ifndef FLASH_STREAM_ERASE_BATCH
+#define FLASH_STREAM_ERASE_BATCH    1
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -300,6 +336,37 @@ extern uint8_t eraseFlashPg(uint8_t page);
  */
 extern uint8_t eraseFlash(uint8_t page);
 
+/*!
+ * Start a new stream of writes, the pages holding addr to addr + len are
+ * erased as the writes reach them. Pending write data is discarded.
+ *
+ * @param   addr   - address of the first byte to erase
+ * @param   len    - number of bytes to erase
+ */
+extern void eraseFlashAhead(uint_least32_t addr, size_t len);
+
+/*!
+ * Write data to flash through the stream buffer
+ *
+ * @param   addr   - address to write to in flash
+ * @param   pBuf   - pointer to buffer of data to write
+ * @param   len    - length of data to write in bytes
+ *
+ * @return  status - @ref FLASH_SUCCESS if programmed successfully or
+ *                   @ref FLASH_FAILURE if programming this or earlier
+ *                   buffered data failed
+ */
+extern uint8_t writeFlashStream(uint_least32_t addr, uint8_t *pBuf,
+                                size_t len);
+
+/*!
+ * Write pending stream data to flash
+ *
+ * @return  status - @ref FLASH_SUCCESS if programmed successfully or
+ *                   @ref FLASH_FAILURE if programming failed
+ */
+extern uint8_t flushFlashStream(void);
+
 /*********************************************************************
 *********************************************************************/
 
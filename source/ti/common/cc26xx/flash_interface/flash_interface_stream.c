@@ -0,0 +1,263 @@
+/*******************************************************************************
+
+ @file  flash_interface_stream.c
+
+ @brief Buffered, streaming access to flash on top of the flash interface
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ *******************************************************************************
+ 
+ Copyright (c) 2017-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ *******************************************************************************
+ 
+ 
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ */
+
+#include <common/cc26xx/flash_interface/flash_interface.h>
+
+/*******************************************************************************
+ * Constants and macros
+ */
+
+#if (FLASH_STREAM_BUF_SZ & (FLASH_STREAM_BUF_SZ - 1))
+#error "FLASH_STREAM_BUF_SZ must be a power of 2"
+#endif
+
+/*******************************************************************************
+ * PRIVATE VARIABLES
+ */
+
+/* Pending write data, never crossing a multiple of FLASH_STREAM_BUF_SZ */
+static uint8_t streamBuf[FLASH_STREAM_BUF_SZ];
+static uint_least32_t bufAddr;      // flash address of streamBuf[0]
+static size_t bufLen;               // number of pending bytes, 0 if empty
+
+static uint_least32_t eraseNext;    // next page of the range to erase
+static uint_least32_t eraseEnd;     // end of the range to erase
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ */
+
+static uint_least32_t pageSize(void);
+static uint8_t pageNum(uint_least32_t addr);
+static uint8_t eraseUpTo(uint_least32_t addr);
+static uint8_t programBuf(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      eraseFlashAhead
+ *
+ * @brief   Start a new stream of writes. The pages from addr to addr + len
+ *          are erased just before the first write to them, instead of
+ *          all at once. Pending write data is discarded.
+ *
+ * @param   addr - address of the first byte to erase
+ * @param   len  - number of bytes to erase, 0 if nothing is to be erased
+ *
+ * @return  None.
+ */
+void eraseFlashAhead(uint_least32_t addr, size_t len)
+{
+    bufLen = 0;
+
+    eraseNext = addr & ~(pageSize() - 1);
+    eraseEnd = addr + len;
+}
+
+/*********************************************************************
+ * @fn      writeFlashStream
+ *
+ * @brief   Write data to flash through the stream buffer. Data which
+ *          continues the previous write is gathered, so that every program
+ *          operation covers a full FLASH_STREAM_BUF_SZ aligned block.
+ *
+ * @param   addr   - address to write to in flash
+ * @param   pBuf   - pointer to buffer of data to write
+ * @param   len    - length of data to write in bytes
+ *
+ * @return  status - FLASH_SUCCESS if programmed successfully or
+ *                   FLASH_FAILURE if programming this or earlier buffered
+ *                   data failed
+ */
+uint8_t writeFlashStream(uint_least32_t addr, uint8_t *pBuf, size_t len)
+{
+    uint8_t flashStat = FLASH_SUCCESS;
+
+    if(addr != (bufAddr + bufLen))
+    {
+        flashStat = flushFlashStream();
+        bufAddr = addr;
+    }
+
+    while((len > 0) && (flashStat == FLASH_SUCCESS))
+    {
+        size_t room = FLASH_STREAM_BUF_SZ -
+                      ((bufAddr & (FLASH_STREAM_BUF_SZ - 1)) + bufLen);
+        size_t numBytes = (len < room) ? len : room;
+
+        memcpy(&streamBuf[bufLen], pBuf, numBytes);
+        bufLen += numBytes;
+        pBuf += numBytes;
+        len -= numBytes;
+
+        // Program the buffer once it reaches the end of its block
+        if(numBytes == room)
+        {
+            flashStat = programBuf();
+        }
+    }
+
+    return (flashStat);
+}
+
+/*********************************************************************
+ * @fn      flushFlashStream
+ *
+ * @brief   Write pending data to flash. Must be called before flash
+ *          written through the stream is accessed in another way.
+ *
+ * @param   None.
+ *
+ * @return  status - FLASH_SUCCESS if programmed successfully or
+ *                   FLASH_FAILURE if programming failed
+ */
+uint8_t flushFlashStream(void)
+{
+    uint8_t flashStat = FLASH_SUCCESS;
+
+    if(bufLen > 0)
+    {
+        flashStat = programBuf();
+    }
+
+    return (flashStat);
+}
+
+/*********************************************************************
+ * @fn      pageSize
+ *
+ * @brief   Get the erase page size of the flash behind the interface.
+ *
+ * @param   None.
+ *
+ * @return  page size in bytes
+ */
+static uint_least32_t pageSize(void)
+{
+    return (hasExternalFlash() ? EFL_PAGE_SIZE : INTFLASH_PAGE_SIZE);
+}
+
+/*********************************************************************
+ * @fn      pageNum
+ *
+ * @brief   Get the page an address of the flash behind the interface is on.
+ *
+ * @param   addr - flash address
+ *
+ * @return  page number
+ */
+static uint8_t pageNum(uint_least32_t addr)
+{
+    return (hasExternalFlash() ? EXT_FLASH_PAGE(addr) : FLASH_PAGE(addr));
+}
+
+/*********************************************************************
+ * @fn      eraseUpTo
+ *
+ * @brief   Erase the pages of the erase ahead range below addr which have
+ *          not been erased yet, FLASH_STREAM_ERASE_BATCH pages at a time.
+ *
+ * @param   addr - end of the data about to be programmed
+ *
+ * @return  status - FLASH_SUCCESS if erased successfully or
+ *                   FLASH_FAILURE if erase failed
+ */
+static uint8_t eraseUpTo(uint_least32_t addr)
+{
+    uint8_t flashStat = FLASH_SUCCESS;
+    uint_least32_t size = pageSize();
+
+    if(addr > eraseEnd)
+    {
+        addr = eraseEnd;
+    }
+
+    while((eraseNext < addr) && (flashStat == FLASH_SUCCESS))
+    {
+        uint8_t i;
+
+        for(i = 0; (i < FLASH_STREAM_ERASE_BATCH) && (eraseNext < eraseEnd) &&
+                   (flashStat == FLASH_SUCCESS); i++)
+        {
+            flashStat = eraseFlashPg(pageNum(eraseNext));
+            eraseNext += size;
+        }
+    }
+
+    return (flashStat);
+}
+
+/*********************************************************************
+ * @fn      programBuf
+ *
+ * @brief   Program the pending write data, erasing its pages first if
+ *          needed, and advance the buffer past it.
+ *
+ * @param   None.
+ *
+ * @return  status - FLASH_SUCCESS if programmed successfully or
+ *                   FLASH_FAILURE if programming failed
+ */
+static uint8_t programBuf(void)
+{
+    uint8_t flashStat = eraseUpTo(bufAddr + bufLen);
+
+    if(flashStat == FLASH_SUCCESS)
+    {
+        flashStat = writeFlashPg(pageNum(bufAddr), bufAddr & (pageSize() - 1),
+                                 streamBuf, bufLen);
+    }
+    bufAddr += bufLen;
+    bufLen = 0;
+
+    return (flashStat);
+}
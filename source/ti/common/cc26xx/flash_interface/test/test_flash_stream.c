@@ -0,0 +1,312 @@
+/*******************************************************************************
+
+ @file  test_flash_stream.c
+
+ @brief Host test of flash_interface_stream.c on a RAM model of SPI flash.
+
+        Random streams of writes of random sizes go through
+        eraseFlashAhead(), writeFlashStream() and flushFlashStream(), and
+        the flash is compared with a model. A program over bytes which
+        were not erased fails the test. Then a 352 KB OAD image is
+        downloaded in 240 byte blocks, once programmed block by block
+        after erasing it all, and once through the stream, and the page
+        programs and the modelled flash busy time are printed. The model
+        costs 40 ms per sector erase and 0.85 ms per 256 byte program
+        page.
+
+ Group: WCS, BTS
+ Target Device: cc13x2_26x2
+
+ *******************************************************************************
+ 
+ Copyright (c) 2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ *******************************************************************************
+ 
+ 
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <common/cc26xx/flash_interface/flash_interface.h>
+
+/*******************************************************************************
+ * Constants and macros
+ */
+
+#define TEST_FLASH_SIZE     EFL_FLASH_SIZE
+#define TEST_STREAMS        300
+#define TEST_MAX_WRITE      300
+
+#define TEST_PROGRAM_PAGE   256
+#define TEST_ERASE_MS       40.0
+#define TEST_PROGRAM_MS     0.85
+
+#define TEST_IMAGE_ADDR     0x20000
+#define TEST_IMAGE_LEN      (352 * 1024)
+#define TEST_BLOCK_LEN      240
+
+/*******************************************************************************
+ * PRIVATE VARIABLES
+ */
+
+static uint8_t flash[TEST_FLASH_SIZE];
+static uint8_t model[TEST_FLASH_SIZE];
+
+static unsigned long unerased;      // bytes programmed without an erase
+static unsigned long pagePrograms;
+static unsigned long erases;
+static double busyMs;               // modelled flash time of the current call
+
+/*******************************************************************************
+ * FLASH INTERFACE
+ */
+
+bool hasExternalFlash(void)
+{
+    return (true);
+}
+
+uint8_t readFlash(uint_least32_t addr, uint8_t *pBuf, size_t len)
+{
+    if((addr + len) > TEST_FLASH_SIZE)
+    {
+        return (FLASH_FAILURE);
+    }
+    memcpy(pBuf, &flash[addr], len);
+
+    return (FLASH_SUCCESS);
+}
+
+uint8_t writeFlashPg(uint8_t page, uint32_t offset, uint8_t *pBuf,
+                     uint16_t len)
+{
+    uint_least32_t addr = EXT_FLASH_ADDRESS(page, offset);
+    unsigned long pages;
+    uint16_t i;
+
+    for(i = 0; i < len; i++)
+    {
+        if(flash[addr + i] != 0xFF)
+        {
+            unerased++;
+        }
+        flash[addr + i] &= pBuf[i];
+    }
+
+    // Every program page touched costs a program operation
+    pages = ((addr + len - 1) / TEST_PROGRAM_PAGE) -
+            (addr / TEST_PROGRAM_PAGE) + 1;
+    pagePrograms += pages;
+    busyMs += pages * TEST_PROGRAM_MS;
+
+    return (FLASH_SUCCESS);
+}
+
+uint8_t eraseFlashPg(uint8_t page)
+{
+    memset(&flash[EXT_FLASH_ADDRESS(page, 0)], 0xFF, EFL_PAGE_SIZE);
+    erases++;
+    busyMs += TEST_ERASE_MS;
+
+    return (FLASH_SUCCESS);
+}
+
+/*******************************************************************************
+ * TESTS
+ */
+
+/*********************************************************************
+ * @fn      testStreams
+ *
+ * @brief   Write random streams against the model.
+ *
+ * @return  0 if the flash matched the model, else -1
+ */
+static int testStreams(void)
+{
+    uint8_t data[TEST_MAX_WRITE];
+    uint_least32_t base;
+    uint_least32_t end;
+    size_t len;
+    size_t pos;
+    size_t n;
+    size_t i;
+    int stream;
+
+    memset(flash, 0, TEST_FLASH_SIZE);
+    memset(model, 0, TEST_FLASH_SIZE);
+
+    for(stream = 0; stream < TEST_STREAMS; stream++)
+    {
+        base = (rand() % 200) * EFL_PAGE_SIZE + (rand() % 2) * (rand() % 100);
+        len = 1 + rand() % 40000;
+        end = (base + len + EFL_PAGE_SIZE - 1) & ~(EFL_PAGE_SIZE - 1);
+
+        eraseFlashAhead(base, len);
+        memset(&model[base & ~(EFL_PAGE_SIZE - 1)], 0xFF,
+               end - (base & ~(EFL_PAGE_SIZE - 1)));
+
+        for(pos = 0; pos < len; pos += n)
+        {
+            n = 1 + rand() % TEST_MAX_WRITE;
+            if(n > (len - pos))
+            {
+                n = len - pos;
+            }
+            for(i = 0; i < n; i++)
+            {
+                data[i] = rand();
+            }
+            memcpy(&model[base + pos], data, n);
+
+            if(writeFlashStream(base + pos, data, n) != FLASH_SUCCESS)
+            {
+                printf("stream %d: writeFlashStream failed\n", stream);
+                return (-1);
+            }
+        }
+        if(flushFlashStream() != FLASH_SUCCESS)
+        {
+            printf("stream %d: flushFlashStream failed\n", stream);
+            return (-1);
+        }
+
+        if(memcmp(&flash[base], &model[base], len) != 0)
+        {
+            printf("stream %d: flash differs from the model\n", stream);
+            return (-1);
+        }
+    }
+
+    if(unerased != 0)
+    {
+        printf("%lu bytes programmed without an erase\n", unerased);
+        return (-1);
+    }
+
+    return (0);
+}
+
+/*********************************************************************
+ * @fn      downloadImage
+ *
+ * @brief   Model an OAD image download, with or without the stream, and
+ *          print its flash operations.
+ *
+ * @param   useStream - write the blocks through the stream
+ */
+static void downloadImage(bool useStream)
+{
+    uint8_t block[TEST_BLOCK_LEN];
+    uint_least32_t addr;
+    uint32_t offset;
+    uint32_t page;
+    double totalMs = 0;
+    double longestMs = 0;
+    uint16_t n;
+
+    memset(block, 0x5A, sizeof(block));
+    memset(flash, 0, TEST_FLASH_SIZE);
+    pagePrograms = 0;
+    erases = 0;
+
+    // The header block erases the whole image before it is written
+    busyMs = 0;
+    if(useStream)
+    {
+        eraseFlashAhead(TEST_IMAGE_ADDR, TEST_IMAGE_LEN);
+    }
+    else
+    {
+        for(page = 0; page < (TEST_IMAGE_LEN + EFL_PAGE_SIZE - 1) / EFL_PAGE_SIZE;
+            page++)
+        {
+            eraseFlashPg(EXT_FLASH_PAGE(TEST_IMAGE_ADDR) + page);
+        }
+    }
+    totalMs += busyMs;
+    longestMs = busyMs;
+
+    for(offset = 0; offset < TEST_IMAGE_LEN; offset += TEST_BLOCK_LEN)
+    {
+        n = (TEST_IMAGE_LEN - offset < TEST_BLOCK_LEN) ?
+            TEST_IMAGE_LEN - offset : TEST_BLOCK_LEN;
+        addr = TEST_IMAGE_ADDR + offset;
+
+        busyMs = 0;
+        if(useStream)
+        {
+            // The last block is followed by the flush, as in oad.c
+            writeFlashStream(addr, block, n);
+            if(offset + n == TEST_IMAGE_LEN)
+            {
+                flushFlashStream();
+            }
+        }
+        else
+        {
+            writeFlashPg(EXT_FLASH_PAGE(addr), addr & (EFL_PAGE_SIZE - 1),
+                         block, n);
+        }
+        totalMs += busyMs;
+        if(busyMs > longestMs)
+        {
+            longestMs = busyMs;
+        }
+    }
+
+    printf("%-9s: %u byte blocks, %lu page programs, %lu erases, "
+           "flash busy %.1f s, longest call %.0f ms\n",
+           useStream ? "stream" : "per-block", TEST_BLOCK_LEN, pagePrograms,
+           erases, totalMs / 1000, longestMs);
+}
+
+int main(void)
+{
+    srand(7);
+
+    if(testStreams() != 0)
+    {
+        return (1);
+    }
+    printf("%d random streams match the model\n", TEST_STREAMS);
+
+    downloadImage(false);
+    downloadImage(true);
+
+    return (0);
+}
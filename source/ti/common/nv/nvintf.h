@@ -155,6 +155,23 @@ typedef struct nvintf_nvproxy_t
     uint8_t  flag;    // User specifies requested operation by settings flags
 } NVINTF_nvProxy_t;
 
+// Proxy used by compactStep(), NVINTF_DOSTART in flag begins a new pass
+typedef struct nvintf_compactproxy_t
+{
+    uint32_t avail;    // API returns free bytes left for writes after the step
+    uint16_t minAvail; // User inputs free bytes wanted, see NVOCMP compactStep()
+    uint8_t  steps;    // API returns number of steps taken in this pass
+    uint8_t  flag;     // User specifies NVINTF_DOSTART to start a pass
+} NVINTF_compactProxy_t;
+
+// One item of the batch passed to writeItems()
+typedef struct nvintf_itemwrite_t
+{
+    NVINTF_itemID_t id;     // Item to write, at most once per batch
+    uint16_t        len;    // Size of item data in bytes
+    void *          buffer; // Item data to write
+} NVINTF_itemWrite_t;
+
 //! Function pointer definition for the NVINTF_initNV() function
 typedef uint8_t (*NVINTF_initNV)(void *param);
 
@@ -216,6 +233,13 @@ typedef uint8_t (*NVINTF_eraseNV)(void);
 //! Function pointer definition for the NVINTF_getFreeNV() function
 typedef uint32_t (*NVINTF_getFreeNV)(void);
 
+//! Function pointer definition for the NVINTF_compactStep() function
+typedef uint8_t (*NVINTF_compactStep)(NVINTF_compactProxy_t *cmpProxy);
+
+//! Function pointer definition for the NVINTF_writeItems() function
+typedef uint8_t (*NVINTF_writeItems)(NVINTF_itemWrite_t *items,
+                                     uint8_t numItems);
+
 //! Structure of NV API function pointers
 typedef struct nvintf_nvfuncts_t
 {
@@ -251,6 +275,17 @@ typedef struct nvintf_nvfuncts_t
     NVINTF_getFreeNV getFreeNV;
 } NVINTF_nvFuncts_t;
 
+//! Structure of additional NV API function pointers. These are kept out of
+//! NVINTF_nvFuncts_t, whose layout is fixed by prebuilt stack libraries that
+//! embed it (e.g. zstack_Config_t).
+typedef struct nvintf_nvfunctsext_t
+{
+    //! Incremental compaction function
+    NVINTF_compactStep compactStep;
+    //! Atomic multiple item write function
+    NVINTF_writeItems writeItems;
+} NVINTF_nvFunctsExt_t;
+
 //*****************************************************************************
 //*****************************************************************************
 
@@ -124,6 +124,43 @@ read, or delete items in one page traversal. However, this call requires the
 user to lock access to NV until the operation is complete so it should be used
 carefully and sparingly.
 
+Note: A write that finds no room compacts NV before it returns. To keep that
+cost off time-critical writers, the compactStep() API call compacts one page
+per call and can be called from an idle hook or a low priority task. It is
+loaded, with writeItems(), by NVOCMP_loadExtApiPtrs() into a separate
+NVINTF_nvFunctsExt_t structure:
+
+NVINTF_nvFunctsExt_t nvExtFps;
+NVOCMP_loadExtApiPtrs(&nvExtFps);
+
+NVINTF_compactProxy_t cmpProxy;
+cmpProxy.minAvail = 1024;
+cmpProxy.flag = NVINTF_DOSTART;
+// In the idle hook
+if(nvExtFps.compactStep(&cmpProxy) == NVINTF_NOTFOUND)
+{
+    // Enough room, or every page compacted once, start over next time
+    cmpProxy.flag = NVINTF_DOSTART;
+}
+
+Each step is a complete compaction of one page, so NV is left in a consistent
+state and other NV calls may run between steps. The compacted page takes over
+as the page being written. Unless the page being written is the oldest page,
+a step only runs once it has less than minAvail bytes left, so minAvail is
+best kept to a low-water mark around the size of the largest item written.
+With minAvail of 0, only the oldest page is ever compacted by a step.
+
+Note: Items that must change together, such as the several tables written for
+one network state change, can be passed to the writeItems() API call. The
+whole batch is written in one pass through the active page, after at most one
+compaction, and a commit record written after the last item makes it take
+effect. A reset before the commit record leaves every item as it was, a reset
+after it leaves every item written:
+
+NVINTF_itemWrite_t items[2] = {{id1, sizeof(tbl1), tbl1},
+                               {id2, sizeof(tbl2), tbl2}};
+status = nvExtFps.writeItems(items, 2);
+
 Note: The compile flag NVDEBUG can be passed to enable ASSERT and ALERT
 macros which provide assert and logging functionality. When this flag is used,
 a printf function of the form void nvprint(char * str) MUST be
@@ -134,6 +171,8 @@ Configuration:
 NVOCMP_STATS - Places a protected item with driver stats
 NVOCMP_CRCONREAD (on:1 off:0) - item crc is checked on read. Disabling this may
 increase driver speed but safety is reduced.
+CRC_SLICE_BY_4 - When defined for crc.c, the CRC is computed four bytes at a
+time. Results are unchanged, 768 bytes of tables are added.
 NVOCMP_NVS_INDEX - The index of the NVS_Config structure which describes the
 flash sector that NVOCMP should use. Default is 0.
 
@@ -187,6 +226,26 @@ Requires API's in a crc.h to implement CRC functionality.
 #define NVOCMP_NWSAMEITEM   0           // Not Write Same Item
 #endif
 
+// RAM item directory, maps compressed IDs to item header locations so that
+// strict lookups do not have to scan the NV pages. Set to the number of
+// directory entries (ideally the number of items in use), 0 to disable.
+#ifndef NVOCMP_RAMDIR
+#define NVOCMP_RAMDIR       0           // RAM Item Directory Entries
+#endif
+
+#ifndef NVOCMP_RAMDIRBKTS
+#define NVOCMP_RAMDIRBKTS   32          // RAM Item Directory Buckets (power of 2)
+#endif
+
+#if (NVOCMP_RAMDIRBKTS & (NVOCMP_RAMDIRBKTS - 1))
+#error "NVOCMP_RAMDIRBKTS should be a power of 2"
+#endif
+
+// Entry indexes are 16 bits wide and 0xFFFF ends a chain
+#if (NVOCMP_RAMDIR < 0) || (NVOCMP_RAMDIR >= 0xFFFF)
+#error "NVOCMP_RAMDIR should be less than 0xFFFF"
+#endif
+
 #define NVOCMP_NVONEP       1           // One Page NV
 #define NVOCMP_NVTWOP       2           // Two Page NV
 
@@ -231,6 +290,10 @@ Requires API's in a crc.h to implement CRC functionality.
 static const NVINTF_itemID_t diagId = NVOCMP_NVID_DIAG;
 #endif  // NVOCMP_STATS
 
+// NV item ID of the commit record written by writeItems()
+static const NVINTF_itemID_t txnId = NVOCMP_NVID_TXN;
+#define NVOCMP_TXNCMPID     NVOCMP_CMPRID(txnId.systemID, txnId.itemID, txnId.subID)
+
 // CRC options
 // When not NULL, reads will result in a CRC check before returning
 #define NVOCMP_CRCONREAD    1
@@ -550,6 +613,28 @@ typedef struct
   NVOCMP_compactInfo_t compactInfo;
   NVOCMP_pageInfo_t pageInfo[NVOCMP_NVPAGES];
 } NVOCMP_nvHandle_t;
+
+#if NVOCMP_RAMDIR
+// End of a directory chain
+#define NVOCMP_RAMDIRNULL     0xFFFF
+
+typedef struct
+{
+  uint32_t cmpid;       // compressed ID
+  uint16_t hofs;        // header offset
+  uint16_t next;        // next entry in bucket or free list
+  uint8_t  hpage;       // header page
+} NVOCMP_dirEntry_t;
+
+typedef struct
+{
+  bool valid;           // entries match NV contents
+  bool complete;        // every active item has an entry
+  uint16_t free;        // first free entry
+  uint16_t bucket[NVOCMP_RAMDIRBKTS];
+  NVOCMP_dirEntry_t entry[NVOCMP_RAMDIR];
+} NVOCMP_dir_t;
+#endif
 //*****************************************************************************
 // Local variables
 //*****************************************************************************
@@ -581,6 +666,10 @@ static uint8_t NVOCMP_failF = NVINTF_NOTREADY;
 // This flag is reset by any API calls that cause an erase/write to Flash.
 static uint8_t NVOCMP_failW;
 
+// Flag to indicate that a writeItems() commit record may be left to complete.
+// Set by writeItems() and at init, cleared once no record is found.
+static bool NVOCMP_txnPending;
+
 // TI-RTOS gateMutexPri for the NV driver API functions
 #ifdef NVOCMP_POSIX_MUTEX
 static pthread_mutex_t NVOCMP_gPosixMutex;
@@ -591,6 +680,11 @@ static GateMutexPri_Handle NVOCMP_gMutexPri;
 // Small NV Item Buffer, for item construction
 static uint8_t NVOCMP_itemBuffer[NVOCMP_SMALLITEM];
 
+#if NVOCMP_RAMDIR
+// RAM item directory, built on first use after init, erase or compaction
+static NVOCMP_dir_t NVOCMP_dir;
+#endif
+
 // Function Pointer to an optional user provided voltage check function
 static bool (*NVOCMP_voltCheckFptr)(void);
 // Diagnostic counter for bad CRCs
@@ -607,6 +701,7 @@ uint8_t NVOCMP_size;
 
 static uint8_t    NVOCMP_initNvApi(void *param);
 static uint8_t    NVOCMP_compactNvApi(uint16_t min);
+static uint8_t    NVOCMP_compactStepApi(NVINTF_compactProxy_t *prx);
 static uint8_t    NVOCMP_createItemApi(NVINTF_itemID_t id, uint32_t len, void *buf);
 static uint8_t    NVOCMP_updateItemApi(NVINTF_itemID_t id, uint32_t len, void *buf);
 static uint8_t    NVOCMP_deleteItemApi(NVINTF_itemID_t id);
@@ -617,6 +712,7 @@ static uint8_t    NVOCMP_readContItemApi(NVINTF_itemID_t id, uint16_t ofs,
                                       uint16_t rlen, void *rBuf,
                                       uint16_t clen, uint16_t coff, void *cBuf, uint16_t *pSubId);
 static uint8_t    NVOCMP_writeItemApi(NVINTF_itemID_t id, uint16_t len, void *buf);
+static uint8_t    NVOCMP_writeItemsApi(NVINTF_itemWrite_t *items, uint8_t numItems);
 static uint8_t    NVOCMP_doNextApi(NVINTF_nvProxy_t * prx);
 static int32_t    NVOCMP_lockNvApi(void);
 static void       NVOCMP_unlockNvApi(int32_t);
@@ -637,17 +733,22 @@ static int8_t     NVOCMP_findItem(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg, uint
 static uint8_t    NVOCMP_addItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *iHdr,
                                  uint8_t *pBuf, NVOCMP_writeMode_t wm);
 static void       NVOCMP_writeItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHdr,
-                                   uint8_t dstPg, uint16_t dstOff, uint8_t *pBuf);
+                                   uint8_t dstPg, uint16_t dstOff, uint8_t *pBuf,
+                                   bool pending);
 static uint8_t    NVOCMP_erase(NVOCMP_nvHandle_t *pNvHandle, uint8_t dstPg);
 static int16_t    NVOCMP_compactPage(NVOCMP_nvHandle_t *pNvHandle, uint16_t nBytes);
 static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle);
 static uint8_t    NVOCMP_getDstPage(NVOCMP_nvHandle_t *pNvHandle, uint16_t len);
+static bool       NVOCMP_hasInactive(NVOCMP_nvHandle_t *pNvHandle);
 static void       NVOCMP_changePageState(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg,
                                          NVOCMP_pageState_t state);
 static void       NVOCMP_setPageState(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg,
                                       NVOCMP_pageState_t state);
 static void       NVOCMP_setItemInactive(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg,
                                          uint16_t iOfs);
+static void       NVOCMP_setItemValid(uint8_t pg, uint16_t iOfs);
+static void       NVOCMP_setPageSomeInactive(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg);
+static void       NVOCMP_finishTxn(NVOCMP_nvHandle_t *pNvHandle);
 static uint8_t    NVOCMP_readItem(NVOCMP_itemHdr_t *iHdr, uint16_t ofs, uint16_t len,
                                   void *pBuf, bool flag);
 static uint8_t    NVOCMP_checkItem(NVINTF_itemID_t *id, uint16_t len, NVOCMP_itemHdr_t *iHdr,
@@ -665,8 +766,19 @@ static uint8_t    NVOCMP_doNVCRC(uint8_t pg, uint16_t ofs, uint16_t len, uint8_t
 static uint8_t    NVOCMP_doRAMCRC(uint8_t *input, uint16_t len, uint8_t crc);
 static uint8_t    NVOCMP_verifyCRC(uint16_t iOfs, uint16_t len, uint8_t crc, uint8_t pg, bool flag);
 static uint8_t    NVOCMP_readByte(uint8_t pg, uint16_t ofs);
+static bool       NVOCMP_isItemEnd(uint8_t pg, uint16_t ofs);
 static void       NVOCMP_writeByte(uint8_t pg, uint16_t ofs, uint8_t bwv);
 
+#if NVOCMP_RAMDIR
+static void       NVOCMP_dirBuild(NVOCMP_nvHandle_t *pNvHandle);
+static bool       NVOCMP_dirFind(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHdr,
+                                 int8_t *pStatus);
+static void       NVOCMP_dirSet(uint32_t cmpid, uint8_t pg, uint16_t ofs);
+static void       NVOCMP_dirRemove(uint8_t pg, uint16_t ofs);
+#define NVOCMP_DIRINVALIDATE() (NVOCMP_dir.valid = false)
+#else
+#define NVOCMP_DIRINVALIDATE()
+#endif
 #if (NVOCMP_NVPAGES != NVOCMP_NVONEP)
 static uint8_t    NVOCMP_cleanPage(NVOCMP_nvHandle_t *pNvHandle);
 static uint8_t    NVOCMP_findPage(NVOCMP_pageState_t state);
@@ -773,6 +885,24 @@ void NVOCMP_loadApiPtrsExt(NVINTF_nvFuncts_t *pfn)
     pfn->getFreeNV    = &NVOCMP_getFreeNvApi;
 }
 
+/**
+ * @fn      NVOCMP_loadExtApiPtrs
+ *
+ * @brief   Global function to return function pointers for the additional NV
+ *          driver API (compactStep, writeItems) supported by this module.
+ *
+ * @param   pfn - pointer to caller's structure of additional NV function
+ *                pointers
+ *
+ * @return  none
+ */
+void NVOCMP_loadExtApiPtrs(NVINTF_nvFunctsExt_t *pfn)
+{
+    // Load caller's structure with pointers to the additional NV API functions
+    pfn->compactStep = &NVOCMP_compactStepApi;
+    pfn->writeItems  = &NVOCMP_writeItemsApi;
+}
+
 /**
  * @fn      NVOCMP_setCheckVoltage
  *
@@ -1115,6 +1245,116 @@ static uint8_t NVOCMP_compactNvApi(uint16_t minAvail)
     NVOCMP_UNLOCK(err);
 }
 
+/******************************************************************************
+ * @fn      NVOCMP_compactStepApi
+ *
+ * @brief   API function to compact NV one page at a time
+ *
+ *          Each call compacts the oldest page into the transfer page, the
+ *          same unit of work a write does when it runs out of room, so the
+ *          power-loss recovery of a normal compaction applies unchanged.
+ *          A pass ends when 'minAvail' free bytes are reached or when every
+ *          storage page has been compacted once since NVINTF_DOSTART.
+ *          The compacted page takes over as the only active page, so no
+ *          step is taken while the current active page is a newer page
+ *          with 'minAvail' bytes or more left; its room would be lost.
+ *
+ * @param   prx - pointer to compaction proxy, see NVINTF_compactProxy_t
+ *
+ * @return  NVINTF_SUCCESS if a step was taken, NVINTF_NOTFOUND when the pass
+ *          is over, or specific failure code
+ */
+static uint8_t NVOCMP_compactStepApi(NVINTF_compactProxy_t *prx)
+{
+    uint8_t err = NVINTF_SUCCESS;
+
+    if(NULL == prx)
+    {
+      return(NVINTF_BADPARAM);
+    }
+
+    // Check voltage if possible
+    NVOCMP_FLASHACCESS(err)
+    if(err)
+    {
+      return(err);
+    }
+
+    // Prevent RTOS thread contention
+    NVOCMP_LOCK();
+    err = NVOCMP_failF;
+    // Check for a fatal error
+    if(err == NVINTF_SUCCESS)
+    {
+        if(prx->flag & NVINTF_DOSTART)
+        {
+            prx->flag &= ~NVINTF_DOSTART;
+            prx->steps = 0;
+        }
+
+        prx->avail = NVOCMP_getFreeNvApi();
+
+        if((prx->minAvail && (prx->avail >= prx->minAvail)) ||
+           (prx->steps >= ((NVOCMP_NVSIZE > 1) ? (NVOCMP_NVSIZE - 1) : 1)) ||
+           !NVOCMP_hasInactive(&NVOCMP_nvHandle))
+        {
+            // Nothing left to do in this pass
+            err = NVINTF_NOTFOUND;
+        }
+        else
+        {
+#if (NVOCMP_NVPAGES != NVOCMP_NVONEP)
+            uint8_t actPg = NVOCMP_nvHandle.actPage;
+
+            if((NVOCMP_nvHandle.pageInfo[actPg].state == NVOCMP_PGACT) &&
+               (actPg != NVOCMP_nvHandle.headPage))
+            {
+                if((FLASH_PAGE_SIZE - NVOCMP_nvHandle.pageInfo[actPg].offset) >=
+                   prx->minAvail)
+                {
+                    // The compacted page would become the active page and
+                    // the room left on the current one would be lost
+                    err = NVINTF_NOTFOUND;
+                }
+                else
+                {
+                    // Nearly full, close it so that a reset finds a single
+                    // active page
+                    NVOCMP_changePageState(&NVOCMP_nvHandle, actPg,
+                                           NVOCMP_PGFULL);
+                }
+            }
+
+            if(err == NVINTF_SUCCESS)
+#endif
+            {
+                // Smallest item size, compacts the oldest page only
+                if(NVOCMP_compactPage(&NVOCMP_nvHandle, NVOCMP_ITEMHDRLEN) > 0)
+                {
+                    prx->steps++;
+                    err = NVOCMP_failW;
+                }
+                else
+                {
+                    // Every page is all active, or flash access failed
+                    err = (NVOCMP_failW != NVINTF_SUCCESS) ?
+                            NVOCMP_failW : NVINTF_NOTFOUND;
+                }
+            }
+            prx->avail = NVOCMP_getFreeNvApi();
+        }
+    }
+
+#ifdef NV_LINUX
+    if(err == NVINTF_SUCCESS)
+    {
+        NV_LINUX_save();
+    }
+#endif
+
+    NVOCMP_UNLOCK(err);
+}
+
 //*****************************************************************************
 // API Functions - NV Data Items
 //*****************************************************************************
@@ -1527,6 +1767,145 @@ static uint8_t NVOCMP_writeItemApi(NVINTF_itemID_t id, uint16_t len, void *pBuf)
     NVOCMP_UNLOCK(err);
 }
 
+/******************************************************************************
+ * @fn      NVOCMP_writeItemsApi
+ *
+ * @brief   API function to write several items as one batch. The items are
+ *          written together on one page, followed by a commit record. After
+ *          a reset either every item or none of them has its new contents.
+ *          Items are written whether or not they exist, as by writeItem().
+ *
+ * @param   pItems - array of items to write, each ID at most once
+ * @param   numItems - number of items in the array (0 is illegal)
+ *
+ * @return  NVINTF_SUCCESS or specific failure code
+ */
+static uint8_t NVOCMP_writeItemsApi(NVINTF_itemWrite_t *pItems, uint8_t numItems)
+{
+    uint8_t err;
+    uint8_t i, j;
+    uint32_t total;
+    NVINTF_itemID_t rId = txnId;
+    NVOCMP_itemHdr_t iHdr;
+
+    // Parameter Sanity Check
+    if (pItems == NULL || numItems == 0)
+    {
+        return(NVINTF_BADPARAM);
+    }
+
+    // Room needed for the items and the commit record
+    total = NVOCMP_ITEMHDRLEN + sizeof(numItems);
+    for(i = 0; i < numItems; i++)
+    {
+        if (pItems[i].buffer == NULL || pItems[i].len == 0)
+        {
+            return(NVINTF_BADPARAM);
+        }
+
+        // Driver items are not written in batches
+        if(pItems[i].id.systemID == NVINTF_SYSID_NVDRVR)
+        {
+            return(NVINTF_BADSYSID);
+        }
+
+        err = NVOCMP_checkItem(&pItems[i].id, pItems[i].len, &iHdr, NVOCMP_FINDSTRICT);
+        if(err)
+        {
+            return(err);
+        }
+
+        for(j = 0; j < i; j++)
+        {
+            if((pItems[j].id.systemID == pItems[i].id.systemID) &&
+               (pItems[j].id.itemID == pItems[i].id.itemID) &&
+               (pItems[j].id.subID == pItems[i].id.subID))
+            {
+                return(NVINTF_BADPARAM);
+            }
+        }
+
+        total += NVOCMP_ITEMHDRLEN + pItems[i].len;
+    }
+
+    // Whole batch has to fit on one page
+    if(total > (FLASH_PAGE_SIZE - NVOCMP_PGDATAOFS))
+    {
+        return(NVINTF_BADLENGTH);
+    }
+
+    // Check voltage if possible
+    NVOCMP_FLASHACCESS(err)
+    if(err)
+    {
+      return(err);
+    }
+
+    // Prevent RTOS thread contention
+    NVOCMP_LOCK();
+
+    // Check for a fatal error
+    err = NVOCMP_failF;
+    if(err != NVINTF_SUCCESS)
+    {
+        NVOCMP_UNLOCK(err);
+    }
+
+    // 'failW' reports on this batch only
+    NVOCMP_failW = NVINTF_SUCCESS;
+
+    if(NVOCMP_getDstPage(&NVOCMP_nvHandle, (uint16_t)total) == NVOCMP_NULLPAGE)
+    {
+        // Won't fit on the active page, compact and check again
+        (void)NVOCMP_compactPage(&NVOCMP_nvHandle, (uint16_t)total);
+        if((NVOCMP_failW != NVINTF_SUCCESS) ||
+           (NVOCMP_getDstPage(&NVOCMP_nvHandle, (uint16_t)total) == NVOCMP_NULLPAGE))
+        {
+            // Failure means there's no place to put this batch
+            NVOCMP_ALERT(false, "Out of NV.")
+            err = (NVOCMP_failW != NVINTF_SUCCESS) ?
+                    NVOCMP_failW : NVINTF_BADLENGTH;
+            NVOCMP_UNLOCK(err);
+        }
+    }
+
+    // Stage the items, they stay invalid until committed
+    for(i = 0; i < numItems; i++)
+    {
+        (void)NVOCMP_checkItem(&pItems[i].id, pItems[i].len, &iHdr, NVOCMP_FINDSTRICT);
+        NVOCMP_writeItem(&NVOCMP_nvHandle, &iHdr, NVOCMP_nvHandle.actPage,
+                         NVOCMP_nvHandle.actOffset, pItems[i].buffer, true);
+        if(NVOCMP_failW != NVINTF_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    if(i == numItems)
+    {
+        // Commit record holds the number of items staged
+        (void)NVOCMP_checkItem(&rId, sizeof(numItems), &iHdr, NVOCMP_FINDSTRICT);
+        NVOCMP_txnPending = true;
+        NVOCMP_writeItem(&NVOCMP_nvHandle, &iHdr, NVOCMP_nvHandle.actPage,
+                         NVOCMP_nvHandle.actOffset, &numItems, false);
+        if(NVOCMP_failW == NVINTF_SUCCESS)
+        {
+            NVOCMP_finishTxn(&NVOCMP_nvHandle);
+        }
+    }
+
+    err = NVOCMP_failW;
+
+#ifdef NV_LINUX
+    if(err == NVINTF_SUCCESS)
+    {
+        NV_LINUX_save();
+    }
+#endif
+
+    NVOCMP_UNLOCK(err);
+}
+
 //*****************************************************************************
 // Extended API Functions
 //*****************************************************************************
@@ -2047,6 +2426,8 @@ static void NVOCMP_initNv(NVOCMP_nvHandle_t *pNvHandle)
   uint16_t cleanPages = 0;
 #endif
 
+  NVOCMP_DIRINVALIDATE();
+
   // Scan Pages
   for(pg = 0; pg < NVOCMP_NVSIZE; pg++)
   {
@@ -2142,23 +2523,23 @@ static void NVOCMP_initNv(NVOCMP_nvHandle_t *pNvHandle)
       {
         action = NVOCMP_RECOVER_COMPACT;
       }
+      // Power lost after compaction done, but before erasing PGXSRC page.
+      // A source page emptied by an earlier pass may be erased already,
+      // so this is checked first: compacting again would copy the items
+      // held by the destination page a second time.
+      else if(NVOCMP_findDstPage(pNvHandle) < NVOCMP_NVSIZE)
+      {
+        action = NVOCMP_RECOVER_ERASE;
+      }
       // Corrupted due to power lost while writing onto XDST page and erased the XDST page
       else if(noPgNact)
       {
         pgXdst = pgNact;
         action = NVOCMP_RECOVER_COMPACT;
       }
-      // Power lost after compaction done, but before erasing PGXSRC page
       else
       {
-        if(NVOCMP_findDstPage(pNvHandle) < NVOCMP_NVSIZE)
-        {
-          action = NVOCMP_RECOVER_ERASE;
-        }
-        else
-        {
-          action = NVOCMP_ERROR_UNKNOWN;
-        }
+        action = NVOCMP_ERROR_UNKNOWN;
       }
     }
     else if(noPgXdst)
@@ -2246,17 +2627,31 @@ static void NVOCMP_initNv(NVOCMP_nvHandle_t *pNvHandle)
         if(pNvHandle->actOffset > NVOCMP_PGDATAOFS + NVOCMP_ITEMHDRLEN)
         {
           NVOCMP_readHeader(pNvHandle->actPage, pNvHandle->actOffset - NVOCMP_ITEMHDRLEN , &iHdr, false);
-          if(iHdr.stats & NVOCMP_FOLLOWBIT)
+          // Data left without its header by a power loss may end with
+          // a signature byte, the CRC and the item below tell it from a
+          // complete item
+          if((iHdr.stats & NVOCMP_FOLLOWBIT) &&
+             (iHdr.hofs >= (iHdr.len + NVOCMP_PGDATAOFS)) &&
+             !NVOCMP_verifyCRC(iHdr.hofs - iHdr.len, iHdr.len, iHdr.crc8,
+                               pNvHandle->actPage, false) &&
+             NVOCMP_isItemEnd(pNvHandle->actPage, iHdr.hofs - iHdr.len))
           {
-            status = NVOCMP_findItem(pNvHandle, pNvHandle->actPage, pNvHandle->actOffset - NVOCMP_ITEMHDRLEN - iHdr.len,
-                            &iHdr, NVOCMP_FINDSTRICT, NULL);
-            if((status == NVINTF_SUCCESS) && (iHdr.hofs > 0))
+            // An uncommitted writeItems() item leaves the older copy current
+            if(!(iHdr.stats & NVOCMP_VALIDIDBIT))
             {
-              NVOCMP_setItemInactive(pNvHandle, iHdr.hpage, iHdr.hofs);
+              status = NVOCMP_findItem(pNvHandle, pNvHandle->actPage, pNvHandle->actOffset - NVOCMP_ITEMHDRLEN - iHdr.len,
+                              &iHdr, NVOCMP_FINDSTRICT, NULL);
+              if((status == NVINTF_SUCCESS) && (iHdr.hofs > 0))
+              {
+                NVOCMP_setItemInactive(pNvHandle, iHdr.hpage, iHdr.hofs);
+              }
             }
           }
           else
           {
+            // Power was lost while an item was written, the data left
+            // at the top of the page is dead space to compact away
+            NVOCMP_setPageSomeInactive(pNvHandle, pNvHandle->actPage);
             NVOCMP_compactPage(pNvHandle, 0);
           }
         }
@@ -2401,6 +2796,15 @@ static void NVOCMP_initNv(NVOCMP_nvHandle_t *pNvHandle)
       break;
   }
 #endif
+
+  // Complete a writeItems() batch cut short by a reset
+  NVOCMP_txnPending = true;
+  NVOCMP_finishTxn(pNvHandle);
+
+#if NVOCMP_RAMDIR
+  // Index the items found, so that first lookups do not scan
+  NVOCMP_dirBuild(pNvHandle);
+#endif
 }
 
 /******************************************************************************
@@ -2512,6 +2916,37 @@ static uint8_t NVOCMP_getDstPage(NVOCMP_nvHandle_t *pNvHandle, uint16_t len)
   return(dstPg);
 }
 
+/******************************************************************************
+ * @fn      NVOCMP_hasInactive
+ *
+ * @brief   Local function to check whether compaction can reclaim anything
+ *
+ * @param   pNvHandle - pointer to NV handle
+ *
+ * @return  true if a storage page holds inactive items
+ */
+static bool NVOCMP_hasInactive(NVOCMP_nvHandle_t *pNvHandle)
+{
+  uint8_t pg;
+  NVOCMP_pageHdr_t pageHdr;
+
+  for(pg = 0; pg < NVOCMP_NVSIZE; pg++)
+  {
+#if (NVOCMP_NVPAGES != NVOCMP_NVONEP)
+    if(pg == pNvHandle->tailPage)
+    {
+      continue;
+    }
+#endif
+    NVOCMP_read(pg, NVOCMP_PGHDROFS, (uint8_t *)&pageHdr, NVOCMP_PGHDRLEN);
+    if(!pageHdr.allActive)
+    {
+      return(true);
+    }
+  }
+  return(false);
+}
+
 /******************************************************************************
  * @fn      NVOCMP_addItem
  *
@@ -2596,7 +3031,8 @@ static uint8_t NVOCMP_addItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *iH
     if(changed)
     {
     // Create the new NV item
-      NVOCMP_writeItem(pNvHandle, iHdr, pNvHandle->actPage, pNvHandle->actOffset, pBuf);
+      NVOCMP_writeItem(pNvHandle, iHdr, pNvHandle->actPage, pNvHandle->actOffset, pBuf,
+                       false);
     }
     else
     {
@@ -2604,7 +3040,8 @@ static uint8_t NVOCMP_addItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *iH
     }
 #else
     // Create the new NV item
-    NVOCMP_writeItem(pNvHandle, iHdr, pNvHandle->actPage, pNvHandle->actOffset, pBuf);
+    NVOCMP_writeItem(pNvHandle, iHdr, pNvHandle->actPage, pNvHandle->actOffset, pBuf,
+                       false);
 #endif
 
     // Status of writing/erasing Flash
@@ -2695,6 +3132,9 @@ static uint8_t NVOCMP_erase(NVOCMP_nvHandle_t *pNvHandle, uint8_t dstPg)
     uint8_t err = NVINTF_SUCCESS;
     int_fast16_t nvsRes = 0;
 
+    // Directory may point into this page
+    NVOCMP_DIRINVALIDATE();
+
     // Check voltage if possible
     NVOCMP_FLASHACCESS(err)
 
@@ -2747,13 +3187,17 @@ static uint8_t NVOCMP_erase(NVOCMP_nvHandle_t *pNvHandle, uint8_t dstPg)
  * @param   dstPg - Destination NV Flash page
  * @param   dstOff - Destination offset
  * @param   pBuf  - Points to buffer which will be written to item
+ * @param   pending - true to write the item invalid, see NVOCMP_finishTxn()
  *
  * @return  none
  */
 static void NVOCMP_writeItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHdr,
-                             uint8_t dstPg, uint16_t dstOff, uint8_t *pBuf)
+                             uint8_t dstPg, uint16_t dstOff, uint8_t *pBuf,
+                             bool pending)
 {
     uint16_t iLen;
+    uint8_t marks = pending ? (NVOCMP_ACTIVEIDBIT | NVOCMP_VALIDIDBIT) :
+                              NVOCMP_ACTIVEIDBIT;
     NVOCMP_pageHdr_t pageHdr;
 
     NVOCMP_read(dstPg, NVOCMP_PGHDROFS, (uint8_t *)&pageHdr, NVOCMP_PGHDRLEN);
@@ -2814,13 +3258,13 @@ static void NVOCMP_writeItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHd
 #if NVOCMP_HDRLE
             // Insert CRC and last bytes
             cHdr[4] |= ((newCRC & 0x3) << 6);
-            // Note NVOCMP_VALIDIDBIT set implicitly zero
-            cHdr[5] = ((newCRC >> 2) & 0x3F) | (NVOCMP_ACTIVEIDBIT << 6);
+            // Note NVOCMP_VALIDIDBIT zero unless pending
+            cHdr[5] = ((newCRC >> 2) & 0x3F) | (marks << 6);
 #else
             // Insert CRC and last bytes
             cHdr[4] |= ((newCRC >> 6) & 0x3);
-            // Note NVOCMP_VALIDIDBIT set implicitly zero
-            cHdr[5] = ((newCRC & 0x3F) << 2) | NVOCMP_ACTIVEIDBIT;
+            // Note NVOCMP_VALIDIDBIT zero unless pending
+            cHdr[5] = ((newCRC & 0x3F) << 2) | marks;
 #endif
             cHdr[6] = NVOCMP_SIGNATURE;
             memcpy(NVOCMP_itemBuffer + dLen, (const void *)cHdr,
@@ -2844,13 +3288,13 @@ static void NVOCMP_writeItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHd
 #if NVOCMP_HDRLE
             // Insert CRC and last bytes
             cHdr[4] |= ((newCRC & 0x3) << 6);
-            // Note NVOCMP_VALIDIDBIT set implicitly zero
-            cHdr[5] = ((newCRC >> 2) & 0x3F) | (NVOCMP_ACTIVEIDBIT << 6);
+            // Note NVOCMP_VALIDIDBIT zero unless pending
+            cHdr[5] = ((newCRC >> 2) & 0x3F) | (marks << 6);
 #else
             // Insert CRC and last bytes
             cHdr[4] |= ((newCRC >> 6) & 0x3);
-            // Note NVOCMP_VALIDIDBIT set implicitly zero
-            cHdr[5] = ((newCRC & 0x3F) << 2) | NVOCMP_ACTIVEIDBIT;
+            // Note NVOCMP_VALIDIDBIT zero unless pending
+            cHdr[5] = ((newCRC & 0x3F) << 2) | marks;
 #endif
             cHdr[6] = NVOCMP_SIGNATURE;
             // Write data
@@ -2876,6 +3320,14 @@ static void NVOCMP_writeItem(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHd
         {
             NVOCMP_setItemInactive(pNvHandle, dstPg, hOfs);
         }
+#if NVOCMP_RAMDIR
+        else if(!pending)
+        {
+            // New copy supersedes any older one
+            NVOCMP_dirSet(NVOCMP_CMPRID(pHdr->sysid, pHdr->itemid, pHdr->subid),
+                          dstPg, hOfs);
+        }
+#endif
     }
     else
     {
@@ -3054,6 +3506,27 @@ static void NVOCMP_setItemInactive(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg,
 #endif
     // Mark the item as inactive
     NVOCMP_writeByte(pg, iOfs + NVOCMP_HDRVLDOFS, tmp);
+#if NVOCMP_RAMDIR
+    NVOCMP_dirRemove(pg, iOfs);
+#endif
+
+    NVOCMP_setPageSomeInactive(pNvHandle, pg);
+}
+
+/******************************************************************************
+ * @fn      NVOCMP_setPageSomeInactive
+ *
+ * @brief   Mark a page as holding space to reclaim, so that compaction
+ *          does not skip it
+ *
+ * @param   pNvHandle - pointer to NV handle
+ * @param   pg - page to mark
+ *
+ * @return  none
+ */
+static void NVOCMP_setPageSomeInactive(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg)
+{
+    uint8_t tmp;
 
     if(pNvHandle->pageInfo[pg].allActive)
     {
@@ -3064,6 +3537,128 @@ static void NVOCMP_setItemInactive(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg,
     }
 }
 
+/******************************************************************************
+ * @fn      NVOCMP_setItemValid
+ *
+ * @brief   Mark an item written by writeItems() as valid
+ *
+ * @param   pg - Valid NV page
+ * @param   iOfs - Offset to item header (lowest address) in given page
+ *
+ * @return  none
+ */
+static void NVOCMP_setItemValid(uint8_t pg, uint16_t iOfs)
+{
+    uint8_t tmp;
+
+    // Get byte with validity bit
+    tmp = NVOCMP_readByte(pg, iOfs + NVOCMP_HDRVLDOFS);
+
+    // Clear VALID_IDS_MARK
+#if NVOCMP_HDRLE
+    tmp &= ~(NVOCMP_VALIDIDBIT << 6);
+#else
+    tmp &= ~NVOCMP_VALIDIDBIT;
+#endif
+    // Mark the item as valid
+    NVOCMP_writeByte(pg, iOfs + NVOCMP_HDRVLDOFS, tmp);
+}
+
+/******************************************************************************
+ * @fn      NVOCMP_finishTxn
+ *
+ * @brief   Complete the writeItems() batch of a commit record, if there is
+ *          one. The items of the batch are right below the record, written
+ *          invalid. Each is marked valid and its older copy inactive, then
+ *          the record is marked inactive. Any of these steps can be done
+ *          twice, so a batch cut short by a reset is completed by calling
+ *          this again.
+ *
+ * @param   pNvHandle - pointer to NV handle
+ *
+ * @return  none
+ */
+static void NVOCMP_finishTxn(NVOCMP_nvHandle_t *pNvHandle)
+{
+    static bool busy = false;
+    NVOCMP_itemHdr_t rHdr;
+    uint16_t ofs;
+    uint8_t count;
+
+    // findItem() compacts on corruption, which calls back here. Without a
+    // record to look for, compaction must not search for one either, as
+    // such a nested compaction would run under the one calling here.
+    if(busy || !NVOCMP_txnPending || (pNvHandle->actPage == NVOCMP_NULLPAGE))
+    {
+        return;
+    }
+    busy = true;
+
+    rHdr.sysid  = txnId.systemID;
+    rHdr.itemid = txnId.itemID;
+    rHdr.subid  = txnId.subID;
+    if((NVOCMP_findItem(pNvHandle, pNvHandle->actPage, pNvHandle->actOffset, &rHdr,
+                        NVOCMP_FINDSTRICT, NULL) == NVINTF_SUCCESS) &&
+       (rHdr.len == sizeof(count)))
+    {
+        ofs = rHdr.hofs - rHdr.len;
+        NVOCMP_read(rHdr.hpage, ofs, &count, sizeof(count));
+        NVOCMP_failW = NVINTF_SUCCESS;
+
+        while(count-- && (ofs >= (NVOCMP_PGDATAOFS + NVOCMP_ITEMHDRLEN)))
+        {
+            NVOCMP_itemHdr_t iHdr;
+            NVOCMP_itemHdr_t oHdr;
+
+            // Align to start of item header
+            ofs -= NVOCMP_ITEMHDRLEN;
+
+            NVOCMP_readHeader(rHdr.hpage, ofs, &iHdr, false);
+            if(!(iHdr.stats & NVOCMP_FOLLOWBIT) || (iHdr.len >= ofs))
+            {
+                break;
+            }
+
+            if(iHdr.stats & NVOCMP_ACTIVEIDBIT)
+            {
+                if(iHdr.stats & NVOCMP_VALIDIDBIT)
+                {
+                    NVOCMP_setItemValid(rHdr.hpage, ofs);
+                }
+
+                // Older copy is below the batch
+                oHdr.sysid  = iHdr.sysid;
+                oHdr.itemid = iHdr.itemid;
+                oHdr.subid  = iHdr.subid;
+                if(NVOCMP_findItem(pNvHandle, rHdr.hpage, ofs - iHdr.len, &oHdr,
+                                   NVOCMP_FINDSTRICT, NULL) == NVINTF_SUCCESS)
+                {
+                    NVOCMP_setItemInactive(pNvHandle, oHdr.hpage, oHdr.hofs);
+                }
+#if NVOCMP_RAMDIR
+                NVOCMP_dirSet(iHdr.cmpid, rHdr.hpage, ofs);
+#endif
+            }
+
+            // Jump to next item
+            ofs -= iHdr.len;
+        }
+
+        // Batch is complete once the record is gone
+        if(NVOCMP_failW == NVINTF_SUCCESS)
+        {
+            NVOCMP_setItemInactive(pNvHandle, rHdr.hpage, rHdr.hofs);
+            NVOCMP_txnPending = false;
+        }
+    }
+    else
+    {
+        NVOCMP_txnPending = false;
+    }
+
+    busy = false;
+}
+
 /******************************************************************************
  * @fn      NVOCMP_setCompactHdr
  *
@@ -3259,6 +3854,243 @@ static uint16_t NVOCMP_findOffset(uint8_t pg, uint16_t ofs)
 }
 #endif
 
+#if NVOCMP_RAMDIR
+/******************************************************************************
+ * @fn      NVOCMP_dirLink
+ *
+ * @brief   Locate the directory link of an item
+ *
+ * @param   cmpid - compressed ID of the item
+ *
+ * @return  Pointer to the link referring to the item's entry, or to the
+ *          NVOCMP_RAMDIRNULL link ending its bucket if it has no entry
+ */
+static uint16_t *NVOCMP_dirLink(uint32_t cmpid)
+{
+    uint16_t *pLink;
+    uint32_t hash;
+
+    // Fold sub ID, item ID and system ID together
+    hash = cmpid ^ (cmpid >> NVOCMP_CMPSPACE) ^ (cmpid >> (2 * NVOCMP_CMPSPACE));
+    pLink = &NVOCMP_dir.bucket[hash & (NVOCMP_RAMDIRBKTS - 1)];
+
+    while((*pLink != NVOCMP_RAMDIRNULL) &&
+          (NVOCMP_dir.entry[*pLink].cmpid != cmpid))
+    {
+        pLink = &NVOCMP_dir.entry[*pLink].next;
+    }
+
+    return(pLink);
+}
+
+/******************************************************************************
+ * @fn      NVOCMP_dirSet
+ *
+ * @brief   Record the location of an item's header in the directory
+ *
+ * @param   cmpid - compressed ID of the item
+ * @param   pg    - page of the item header
+ * @param   ofs   - offset of the item header
+ *
+ * @return  none
+ */
+static void NVOCMP_dirSet(uint32_t cmpid, uint8_t pg, uint16_t ofs)
+{
+    uint16_t *pLink;
+    uint16_t idx;
+
+    if(!NVOCMP_dir.valid)
+    {
+        // Rebuild will pick the item up
+        return;
+    }
+
+    pLink = NVOCMP_dirLink(cmpid);
+    idx = *pLink;
+    if(idx == NVOCMP_RAMDIRNULL)
+    {
+        idx = NVOCMP_dir.free;
+        if(idx == NVOCMP_RAMDIRNULL)
+        {
+            // Directory full, misses must now be confirmed by a search
+            NVOCMP_dir.complete = false;
+            return;
+        }
+        NVOCMP_dir.free = NVOCMP_dir.entry[idx].next;
+        NVOCMP_dir.entry[idx].cmpid = cmpid;
+        NVOCMP_dir.entry[idx].next = NVOCMP_RAMDIRNULL;
+        *pLink = idx;
+    }
+    NVOCMP_dir.entry[idx].hpage = pg;
+    NVOCMP_dir.entry[idx].hofs = ofs;
+}
+
+/******************************************************************************
+ * @fn      NVOCMP_dirRemove
+ *
+ * @brief   Drop the directory entry of an item being set inactive
+ *
+ * @param   pg  - page of the item header
+ * @param   ofs - offset of the item header
+ *
+ * @return  none
+ */
+static void NVOCMP_dirRemove(uint8_t pg, uint16_t ofs)
+{
+    NVOCMP_itemHdr_t iHdr;
+    uint16_t *pLink;
+    uint16_t idx;
+
+    if(!NVOCMP_dir.valid)
+    {
+        return;
+    }
+
+    NVOCMP_readHeader(pg, ofs, &iHdr, false);
+    pLink = NVOCMP_dirLink(iHdr.cmpid);
+    idx = *pLink;
+
+    // Only when the entry refers to this copy of the item
+    if((idx != NVOCMP_RAMDIRNULL) &&
+       (NVOCMP_dir.entry[idx].hpage == pg) && (NVOCMP_dir.entry[idx].hofs == ofs))
+    {
+        *pLink = NVOCMP_dir.entry[idx].next;
+        NVOCMP_dir.entry[idx].next = NVOCMP_dir.free;
+        NVOCMP_dir.free = idx;
+    }
+}
+
+/******************************************************************************
+ * @fn      NVOCMP_dirBuild
+ *
+ * @brief   Build the directory from the active items in NV
+ *
+ *          Items are visited newest first, in the same order findItem()
+ *          searches them, so that each entry refers to the copy a search
+ *          would return. A corrupted page ends the walk and leaves the
+ *          directory incomplete, findItem() then finds and repairs it.
+ *
+ * @param   pNvHandle - pointer to NV handle
+ *
+ * @return  none
+ */
+static void NVOCMP_dirBuild(NVOCMP_nvHandle_t *pNvHandle)
+{
+    uint8_t p;
+    uint16_t i;
+    uint16_t ofs = pNvHandle->actOffset;
+    uint16_t nvSearched = 0;
+
+    for(i = 0; i < NVOCMP_RAMDIRBKTS; i++)
+    {
+        NVOCMP_dir.bucket[i] = NVOCMP_RAMDIRNULL;
+    }
+    for(i = 0; i < NVOCMP_RAMDIR; i++)
+    {
+        NVOCMP_dir.entry[i].next = (i + 1 < NVOCMP_RAMDIR) ? (i + 1) : NVOCMP_RAMDIRNULL;
+    }
+    NVOCMP_dir.free = 0;
+    NVOCMP_dir.complete = true;
+    NVOCMP_dir.valid = true;
+
+    if(pNvHandle->actPage == NVOCMP_NULLPAGE)
+    {
+        return;
+    }
+
+    for(p = pNvHandle->actPage; nvSearched < NVOCMP_NVSIZE; p = NVOCMP_DECPAGE(p), ofs = pNvHandle->pageInfo[p].offset)
+    {
+      nvSearched++;
+#if (NVOCMP_NVPAGES != NVOCMP_NVONEP)
+      if(p == pNvHandle->tailPage)
+      {
+        continue;
+      }
+#endif
+      while(ofs >= (NVOCMP_PGDATAOFS + NVOCMP_ITEMHDRLEN))
+      {
+          NVOCMP_itemHdr_t iHdr;
+
+          // Align to start of item header
+          ofs -= NVOCMP_ITEMHDRLEN;
+
+          // Read and decompress item header
+          NVOCMP_readHeader(p, ofs, &iHdr, false);
+
+          if((iHdr.stats & NVOCMP_ACTIVEIDBIT) &&
+            !(iHdr.stats & NVOCMP_VALIDIDBIT) &&
+            (*NVOCMP_dirLink(iHdr.cmpid) == NVOCMP_RAMDIRNULL))
+          {
+              NVOCMP_dirSet(iHdr.cmpid, p, ofs);
+          }
+
+          if((iHdr.stats & NVOCMP_FOLLOWBIT) && (iHdr.len < ofs))
+          {
+              // Jump to next item
+              ofs -= iHdr.len;
+          }
+          else
+          {
+              NVOCMP_dir.complete = false;
+              return;
+          }
+      }
+    }
+}
+
+/******************************************************************************
+ * @fn      NVOCMP_dirFind
+ *
+ * @brief   Look an item up in the directory
+ *
+ * @param   pNvHandle - pointer to NV handle
+ * @param   pHdr - pointer to item header, filled in when the item is found
+ * @param   pStatus - findItem() result when the directory has the answer
+ *
+ * @return  true if the directory answered, false if NV has to be searched
+ */
+static bool NVOCMP_dirFind(NVOCMP_nvHandle_t *pNvHandle, NVOCMP_itemHdr_t *pHdr,
+                           int8_t *pStatus)
+{
+    uint16_t idx;
+    uint32_t cid = NVOCMP_CMPRID(pHdr->sysid,pHdr->itemid,pHdr->subid);
+
+    if(!NVOCMP_dir.valid)
+    {
+        NVOCMP_dirBuild(pNvHandle);
+    }
+
+    idx = *NVOCMP_dirLink(cid);
+    if(idx != NVOCMP_RAMDIRNULL)
+    {
+        NVOCMP_itemHdr_t iHdr;
+
+        NVOCMP_readHeader(NVOCMP_dir.entry[idx].hpage, NVOCMP_dir.entry[idx].hofs,
+                          &iHdr, false);
+        if((iHdr.stats & NVOCMP_ACTIVEIDBIT) &&
+          !(iHdr.stats & NVOCMP_VALIDIDBIT) && (iHdr.cmpid == cid))
+        {
+            memcpy(pHdr, &iHdr, sizeof(NVOCMP_itemHdr_t));
+            *pStatus = NVINTF_SUCCESS;
+            return(true);
+        }
+
+        // Stale entry, search now and rebuild on next lookup
+        NVOCMP_DIRINVALIDATE();
+        return(false);
+    }
+
+    if(NVOCMP_dir.complete)
+    {
+        pHdr->hofs = 0;
+        *pStatus = NVINTF_NOTFOUND;
+        return(true);
+    }
+
+    return(false);
+}
+#endif
+
 /******************************************************************************
  * @fn      NVOCMP_findItem
  *
@@ -3291,6 +4123,21 @@ static int8_t NVOCMP_findItem(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg, uint16_t
 #endif
     uint32_t cid = NVOCMP_CMPRID(pHdr->sysid,pHdr->itemid,pHdr->subid);
 
+#if NVOCMP_RAMDIR
+    if(((flag & NVOCMP_FINDLMASK) == NVOCMP_FINDSTRICT) &&
+       !(flag & NVOCMP_FINDHMASK) &&
+       (pg == pNvHandle->actPage) && (ofs == pNvHandle->actOffset))
+    {
+        int8_t status;
+
+        // Exact item searched from the top of NV, try the directory first
+        if(NVOCMP_dirFind(pNvHandle, pHdr, &status))
+        {
+            return(status);
+        }
+    }
+#endif
+
 #ifdef NVOCMP_GPRAM
     NVOCMP_disableCache(&vm);
 #endif
@@ -3414,6 +4261,7 @@ static int8_t NVOCMP_findItem(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg, uint16_t
 #ifdef NVOCMP_GPRAM
               NVOCMP_restoreCache(vm);
 #endif
+              NVOCMP_setPageSomeInactive(pNvHandle, p);
               NVOCMP_compactPage(pNvHandle, 0);
               return(NVINTF_CORRUPT);
           }
@@ -3439,6 +4287,21 @@ static int8_t NVOCMP_findItem(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg, uint16_t
     uint16_t nvSearched = 0;
     uint32_t cid = NVOCMP_CMPRID(pHdr->sysid,pHdr->itemid,pHdr->subid);
 
+#if NVOCMP_RAMDIR
+    if(((flag & NVOCMP_FINDLMASK) == NVOCMP_FINDSTRICT) &&
+       !(flag & NVOCMP_FINDHMASK) &&
+       (pg == pNvHandle->actPage) && (ofs == pNvHandle->actOffset))
+    {
+        int8_t status;
+
+        // Exact item searched from the top of NV, try the directory first
+        if(NVOCMP_dirFind(pNvHandle, pHdr, &status))
+        {
+            return(status);
+        }
+    }
+#endif
+
     for(p = pg; nvSearched < NVOCMP_NVSIZE; p = NVOCMP_DECPAGE(p), ofs = pNvHandle->pageInfo[p].offset)
     {
       nvSearched++;
@@ -3541,6 +4404,7 @@ static int8_t NVOCMP_findItem(NVOCMP_nvHandle_t *pNvHandle, uint8_t pg, uint16_t
               // Something is corrupted, compact to fix
               NVOCMP_ALERT(false, "No item following current item, "
                       "compaction needed.")
+              NVOCMP_setPageSomeInactive(pNvHandle, p);
               NVOCMP_compactPage(pNvHandle, 0);
               return(NVINTF_CORRUPT);
           }
@@ -3664,6 +4528,12 @@ static int16_t NVOCMP_compactPage(NVOCMP_nvHandle_t *pNvHandle, uint16_t nBytes)
     return(0);
   }
 
+  // Staged items are not moved, complete a pending batch first
+  NVOCMP_finishTxn(pNvHandle);
+
+  // Items are about to move, directory is rebuilt on next lookup
+  NVOCMP_DIRINVALIDATE();
+
   srcPg = pNvHandle->headPage;
   dstPg = pNvHandle->tailPage;
   compactPages = NVOCMP_NVSIZE - 1;
@@ -3859,6 +4729,12 @@ static int16_t NVOCMP_compactPage(NVOCMP_nvHandle_t *pNvHandle, uint16_t nBytes)
   NVOCMP_pageHdr_t pageHdr;
   uint8_t allActivePages = 0;
 
+  // Staged items are not moved, complete a pending batch first
+  NVOCMP_finishTxn(pNvHandle);
+
+  // Items are about to move, directory is rebuilt on next lookup
+  NVOCMP_DIRINVALIDATE();
+
   srcPg = 0;
   dstPg = 0;
   pNvHandle->compactInfo.xSrcPages = 1;
@@ -3968,6 +4844,27 @@ static bool NVOCMP_findSignature(uint8_t pg, uint16_t *pSrcOff)
   return(false);
 }
 
+/******************************************************************************
+* @fn      NVOCMP_isItemEnd
+*
+* @brief   Local function to check that an item can end right below an offset,
+*          i.e. the offset is the start of page data or follows a signature
+*
+* @param   pg - page to check
+* @param   ofs - offset below which the item ends
+*
+* @return  true if an item header or the page data start is found there
+*/
+static bool NVOCMP_isItemEnd(uint8_t pg, uint16_t ofs)
+{
+  if(ofs == NVOCMP_PGDATAOFS)
+  {
+    return(true);
+  }
+  return((ofs >= NVOCMP_PGDATAOFS + NVOCMP_ITEMHDRLEN) &&
+         (NVOCMP_readByte(pg, ofs - 1) == NVOCMP_SIGNATURE));
+}
+
 #if (NVOCMP_NVPAGES != NVOCMP_NVONEP)
 /******************************************************************************
 * @fn      NVOCMP_compact
@@ -3982,6 +4879,7 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
 {
     bool needScan = false;
     bool needSkip = false;
+    bool needCheck = true;
     bool dstFull = false;
     uint16_t dstOff;
     uint16_t endOff;
@@ -4047,6 +4945,7 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
             srcPg = NVOCMP_INCPAGE(srcPg);
             srcOff = pNvHandle->pageInfo[srcPg].offset;
             aItem = 0;
+            needCheck = true;
             continue;
           }
         }
@@ -4073,7 +4972,10 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
             }
             else
             {
-              if(!(srcHdr.stats & NVOCMP_VALIDIDBIT) && srcHdr.stats & NVOCMP_ACTIVEIDBIT)
+              // A commit record left over by a write failure is dropped
+              // along with the staged items below it
+              if(!(srcHdr.stats & NVOCMP_VALIDIDBIT) && srcHdr.stats & NVOCMP_ACTIVEIDBIT &&
+                 (srcHdr.cmpid != NVOCMP_TXNCMPID))
               {
                 NVOCMP_ALERT(srcOff >= (dataLen + NVOCMP_PGDATAOFS),
                              "Item header corrupted, data length too long.")
@@ -4083,39 +4985,47 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
                   // Invalid CRC, corruption
                   NVOCMP_ALERT(false, "Item CRC incorrect!")
                   needScan = true;
-                  srcOff--;
                 }
                 else
                 {
-                  needScan = false;
+                  // A CRC match by chance is told apart by the item below
+                  needScan = needCheck && !NVOCMP_isItemEnd(srcPg, crcOff);
                   needSkip = false;
                 }
               }
               else
               {
-                needScan = false;
+                // The first header of a page, or one found by a scan, may
+                // be data left without its header by a power loss. Only
+                // skip its length once its CRC checks out.
+                needScan = needCheck &&
+                           (NVOCMP_verifyCRC(srcOff - dataLen, dataLen,
+                                             srcHdr.crc8, srcPg, false) ||
+                            !NVOCMP_isItemEnd(srcPg, srcOff - dataLen));
                 needSkip = true;
               }
             }
 
             if(needScan)
             {
-              // Detected a problem, find next header (scan for signature)
+              // Detected a problem, find next header (scan for signature).
+              // An item left without its header by a power loss may be
+              // shorter than a header, so the scan starts right below the
+              // rejected signature byte, not below the rejected header.
               NVOCMP_ALERT(false, "Attempting to find signature...")
-              bool foundSig = NVOCMP_findSignature(srcPg, &srcOff);
-              if(!foundSig)
+              srcOff += NVOCMP_ITEMHDRLEN - 1;
+              if(!NVOCMP_findSignature(srcPg, &srcOff))
               {
-#ifdef NVOCMP_GPRAM
-                NVOCMP_restoreCache(vm);
-#endif
-                // If we get here and foundSig is false, we never found another
-                // item in the page
-                NVOCMP_ALERT(foundSig, "Attempt to find signature failed.")
-                return(NVOCMP_COMPACT_FAILURE);
+                // No other item in the page, only data left by a power
+                // loss, go on with the next page
+                NVOCMP_ALERT(false, "Attempt to find signature failed.")
+                srcOff = NVOCMP_PGDATAOFS;
               }
+              needCheck = true;
             }
             else
             {
+              needCheck = false;
               if(!needSkip)
               {
                 if(dstOff + itemSize > FLASH_PAGE_SIZE)
@@ -4241,6 +5151,7 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
 {
     bool needScan = false;
     bool needSkip = false;
+    bool needCheck = true;
     bool dstFull = false;
     uint16_t dstOff;
     uint16_t endOff;
@@ -4310,7 +5221,10 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
             }
             else
             {
-              if(!(srcHdr.stats & NVOCMP_VALIDIDBIT) && srcHdr.stats & NVOCMP_ACTIVEIDBIT)
+              // A commit record left over by a write failure is dropped
+              // along with the staged items below it
+              if(!(srcHdr.stats & NVOCMP_VALIDIDBIT) && srcHdr.stats & NVOCMP_ACTIVEIDBIT &&
+                 (srcHdr.cmpid != NVOCMP_TXNCMPID))
               {
                 NVOCMP_ALERT(srcOff >= (dataLen + NVOCMP_PGDATAOFS),
                              "Item header corrupted, data length too long.")
@@ -4320,39 +5234,47 @@ static NVOCMP_compactStatus_t NVOCMP_compact(NVOCMP_nvHandle_t *pNvHandle)
                   // Invalid CRC, corruption
                   NVOCMP_ALERT(false, "Item CRC incorrect!")
                   needScan = true;
-                  srcOff--;
                 }
                 else
                 {
-                  needScan = false;
+                  // A CRC match by chance is told apart by the item below
+                  needScan = needCheck && !NVOCMP_isItemEnd(srcPg, crcOff);
                   needSkip = false;
                 }
               }
               else
               {
-                needScan = false;
+                // The first header of a page, or one found by a scan, may
+                // be data left without its header by a power loss. Only
+                // skip its length once its CRC checks out.
+                needScan = needCheck &&
+                           (NVOCMP_verifyCRC(srcOff - dataLen, dataLen,
+                                             srcHdr.crc8, srcPg, false) ||
+                            !NVOCMP_isItemEnd(srcPg, srcOff - dataLen));
                 needSkip = true;
               }
             }
 
             if(needScan)
             {
-              // Detected a problem, find next header (scan for signature)
+              // Detected a problem, find next header (scan for signature).
+              // An item left without its header by a power loss may be
+              // shorter than a header, so the scan starts right below the
+              // rejected signature byte, not below the rejected header.
               NVOCMP_ALERT(false, "Attempting to find signature...")
-              bool foundSig = NVOCMP_findSignature(srcPg, &srcOff);
-              if(!foundSig)
+              srcOff += NVOCMP_ITEMHDRLEN - 1;
+              if(!NVOCMP_findSignature(srcPg, &srcOff))
               {
-#ifdef NVOCMP_GPRAM
-                NVOCMP_restoreCache(vm);
-#endif
-                // If we get here and foundSig is false, we never found another
-                // item in the page
-                NVOCMP_ALERT(foundSig, "Attempt to find signature failed.")
-                return(NVOCMP_COMPACT_FAILURE);
+                // No other item in the page, only data left by a power
+                // loss, go on with the next page
+                NVOCMP_ALERT(false, "Attempt to find signature failed.")
+                srcOff = NVOCMP_PGDATAOFS;
               }
+              needCheck = true;
             }
             else
             {
+              needCheck = false;
               if(!needSkip)
               {
                 if(dstOff + itemSize > FLASH_PAGE_SIZE)
@@ -4557,18 +5479,17 @@ static uint8_t NVOCMP_doNVCRC(uint8_t pg, uint16_t ofs, uint16_t len, uint8_t cr
     uint8_t tmp[NVOCMP_XFERBLKMAX];
     crc_t newCRC = (crc_t)crc;
 
+    if(flag)
+    {
+        // Page copy is already in RAM, compute CRC in place
+        return(crc_update(newCRC, pTBuffer + ofs, len));
+    }
+
     // Read flash and compute CRC in blocks
     while(len > 0)
     {
         rdLen  = (len < NVOCMP_XFERBLKMAX ? len : NVOCMP_XFERBLKMAX);
-        if(flag)
-        {
-          memcpy((uint8_t *)tmp, (uint8_t *)(pTBuffer+ofs), rdLen);
-        }
-        else
-        {
-          NVOCMP_read(pg, ofs, tmp, rdLen);
-        }
+        NVOCMP_read(pg, ofs, tmp, rdLen);
         newCRC = crc_update(newCRC,tmp,rdLen);
         len   -= rdLen;
         ofs   += rdLen;
@@ -63,6 +63,7 @@ extern "C"
 
 // NV driver item ID definitions
 #define NVOCMP_NVID_DIAG {NVINTF_SYSID_NVDRVR, 1, 0}
+#define NVOCMP_NVID_TXN  {NVINTF_SYSID_NVDRVR, 2, 0}
 
 //*****************************************************************************
 // Typedefs
@@ -125,6 +126,19 @@ extern void NVOCMP_loadApiPtrsExt(NVINTF_nvFuncts_t *pfn);
  */
 extern void NVOCMP_loadApiPtrsMin(NVINTF_nvFuncts_t *pfn);
 
+/**
+ * @fn      NVOCMP_loadExtApiPtrs
+ *
+ * @brief   Global function to return function pointers for the additional NV
+ *          driver API (compactStep, writeItems) supported by this module.
+ *
+ * @param   pfn - pointer to caller's structure of additional NV function
+ *                pointers
+ *
+ * @return  none
+ */
+extern void NVOCMP_loadExtApiPtrs(NVINTF_nvFunctsExt_t *pfn);
+
 /**
  * @fn      NVOCMP_setCheckVoltage
  *
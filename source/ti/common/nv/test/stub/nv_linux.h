@@ -0,0 +1,171 @@
+/******************************************************************************
+
+ @file  nv_linux.h
+
+ @brief Host flash for the NVOCMP tests.
+
+        nvocmp.c includes this header when built with NV_LINUX. The NV
+        pages live in nvTestFlash, which a test may map shared so that a
+        forked child's writes survive it. Reads and erases are counted, and
+        power can be lost at a given write or erase: when nvTestCutAt is
+        reached, the process exits with NVTEST_CUT_STATUS. An erase or a
+        write in progress is left partly done: a random number of bytes
+        from its start are programmed.
+
+ Group: CMCU, LPC
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2019-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+#ifndef NV_LINUX_H
+#define NV_LINUX_H
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+// Exit status of a process stopped by a simulated power loss
+#define NVTEST_CUT_STATUS   7
+
+// FLASH_PAGE_SIZE of nvocmp.c, which is defined after this header
+#define NVTEST_PAGE_SIZE    0x2000
+
+#define NVS_HANDLE          ((NVS_Handle)1)
+
+#define NVOCMP_ASSERT(cond, message) \
+    if (!(cond)) { fprintf(stderr, "NVOCMP_ASSERT: %s\n", (message)); abort(); }
+#define NVOCMP_ALERT(cond, message)
+#define NVOCMP_FLASHACCESS(err)
+
+typedef void *NVS_Handle;
+
+typedef struct
+{
+    size_t regionSize;
+    size_t sectorSize;
+} NVS_Attrs;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+extern uint8_t *nvTestFlash;    // NVOCMP_NVPAGES pages of NVTEST_PAGE_SIZE
+extern unsigned long nvTestReads;
+extern unsigned long nvTestErases;
+extern long nvTestFlashOps;     // writes and erases so far
+extern long nvTestCutAt;        // operation to cut short, -1 for none
+
+//*****************************************************************************
+// Functions
+//*****************************************************************************
+
+static inline void NV_LINUX_init(void)
+{
+}
+
+static inline void NV_LINUX_save(void)
+{
+}
+
+// Bytes programmed by an operation of len bytes, fewer if power is lost
+static inline uint32_t nvTestCut(uint32_t len)
+{
+    if (nvTestCutAt >= 0 && nvTestFlashOps == nvTestCutAt)
+    {
+        return ((uint32_t)rand() % (len + 1));
+    }
+
+    return (len);
+}
+
+static inline void nvTestFlashOp(void)
+{
+    if (nvTestCutAt >= 0 && nvTestFlashOps++ == nvTestCutAt)
+    {
+        fflush(stdout);
+        _exit(NVTEST_CUT_STATUS);
+    }
+}
+
+static inline int NV_LINUX_read(uint8_t pg, uint16_t off, uint8_t *pBuf,
+                                uint16_t len)
+{
+    nvTestReads++;
+    memcpy(pBuf, &nvTestFlash[pg * NVTEST_PAGE_SIZE + off], len);
+
+    return (0);
+}
+
+static inline int NV_LINUX_write(uint8_t pg, uint16_t off, uint8_t *pBuf,
+                                 uint16_t len)
+{
+    uint32_t n = nvTestCut(len);
+    uint32_t i;
+
+    // Programming only clears bits
+    for (i = 0; i < n; i++)
+    {
+        nvTestFlash[pg * NVTEST_PAGE_SIZE + off + i] &= pBuf[i];
+    }
+
+    nvTestFlashOp();
+
+    return (0);
+}
+
+static inline int NV_LINUX_erase(uint8_t pg)
+{
+    nvTestErases++;
+    memset(&nvTestFlash[pg * NVTEST_PAGE_SIZE], 0xFF,
+           nvTestCut(NVTEST_PAGE_SIZE));
+    nvTestFlashOp();
+
+    return (0);
+}
+
+#endif /* NV_LINUX_H */
@@ -0,0 +1,157 @@
+/******************************************************************************
+
+ @file  test_crc.c
+
+ @brief Host test and benchmark of the NV item CRC.
+
+        Compares crc_update() with a bit by bit CRC over random buffers,
+        lengths, alignments and starting values, and fails on the first
+        difference. Then times crc_update() on item sized buffers. It is
+        built with and without CRC_SLICE_BY_4 so that the two builds can
+        be compared.
+
+ Group: CMCU, LPC
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2019-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "crc.h"
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define TEST_POLY       0x97    // Polynomial of crc.c
+#define TEST_CHECKS     100000
+#define TEST_BUFLEN     4096
+#define TEST_BYTES      (64UL * 1024 * 1024)
+
+#if defined(CRC_SLICE_BY_4)
+#define TEST_BUILD      "CRC_SLICE_BY_4"
+#else
+#define TEST_BUILD      "byte-wise"
+#endif
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+
+static uint8_t testBuf[TEST_BUFLEN];
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static crc_t testCrcBitwise(crc_t crc, const uint8_t *pData, size_t len)
+{
+    int bit;
+
+    while (len--)
+    {
+        crc ^= *pData++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (crc_t)((crc << 1) ^ TEST_POLY) : (crc_t)(crc << 1);
+        }
+    }
+
+    return (crc);
+}
+
+static double testSeconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+int main(void)
+{
+    static const size_t lens[] = { 16, 64, 256, 1024 };
+    volatile crc_t sink = 0;
+    unsigned int i;
+
+    srand(1);
+    for (i = 0; i < TEST_BUFLEN; i++)
+    {
+        testBuf[i] = (uint8_t)rand();
+    }
+
+    for (i = 0; i < TEST_CHECKS; i++)
+    {
+        size_t ofs = rand() % 64;
+        size_t len = rand() % 1024;
+        crc_t crc = (crc_t)rand();
+
+        if (crc_update(crc, &testBuf[ofs], len) !=
+            testCrcBitwise(crc, &testBuf[ofs], len))
+        {
+            printf("CRC of %zu bytes at offset %zu differs\n", len, ofs);
+            return (1);
+        }
+    }
+
+    printf("%s: %d CRCs checked\n", TEST_BUILD, TEST_CHECKS);
+
+    for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+    {
+        unsigned long n = TEST_BYTES / lens[i];
+        unsigned long j;
+        double start = testSeconds();
+
+        for (j = 0; j < n; j++)
+        {
+            sink = crc_update(sink, testBuf, lens[i]);
+        }
+
+        printf("  %4zu byte items: %.2f ns per byte\n", lens[i],
+               (testSeconds() - start) * 1e9 / TEST_BYTES);
+    }
+
+    return (0);
+}
@@ -0,0 +1,530 @@
+/******************************************************************************
+
+ @file  test_nvocmp_powercut.c
+
+ @brief Host test of NVOCMP compaction steps and power loss.
+
+        First checks that compactStep() leaves the page being written
+        alone while it still has room: with minAvail of 0 no step is
+        taken, and with a larger low-water mark the step runs.
+
+        Then runs a workload of item writes, deletes, compaction steps
+        and full compactions in forked children, each of which loses
+        power at a random flash write or erase. The next child
+        initialises NV from what is left and compares every item with a
+        RAM model, where only the item being written at the cut may hold
+        either its old or its new value. Build with TEST_NO_STEPS to run
+        the workload without compaction steps for comparison.
+
+        Item lengths run up to TEST_ITEMLEN, so that most items are
+        written as data, then header. A cut leaves the write in progress
+        partly programmed, which may leave data without its header on
+        top of the page, or a page copy half done.
+
+        Last, from a filled NV, sweeps a power loss over every flash
+        operation of a run of TEST_ITEMLEN item writes that ends in a
+        compaction, and of a full pass of compaction steps, with
+        TEST_SWEEP_SEEDS different torn lengths at each cut.
+
+ Group: CMCU, LPC
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2019-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "nvocmp.h"
+#include "nv_linux.h"
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define TEST_ITEMS      60
+#define TEST_ITEMLEN    40
+#define TEST_ROUNDS     300
+#define TEST_OPS        3000
+#define TEST_FILL_OPS   1000
+#define TEST_SWEEP_SEEDS 4
+
+// Exit status of a child that found NV different from the model
+#define TEST_BAD_STATUS 3
+
+typedef struct
+{
+    bool have[TEST_ITEMS];
+    uint8_t val[TEST_ITEMS][TEST_ITEMLEN];
+    uint32_t len[TEST_ITEMS];
+    int pend;                   // item being written or deleted, -1 for none
+    bool pendHave;
+    uint8_t pendVal[TEST_ITEMLEN];
+    uint32_t pendLen;
+    long ops;                   // flash operations of the last sweep step
+} testModel_t;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+uint8_t *nvTestFlash;
+unsigned long nvTestReads;
+unsigned long nvTestErases;
+long nvTestFlashOps;
+long nvTestCutAt = -1;
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+
+static testModel_t *model;
+static testModel_t sweepModel;
+static uint8_t sweepFlash[NVOCMP_NVPAGES * NVTEST_PAGE_SIZE];
+static NVINTF_nvFuncts_t nv;
+static NVINTF_nvFunctsExt_t nvExt;
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static NVINTF_itemID_t testId(int k)
+{
+    NVINTF_itemID_t id = { 1, (uint16_t)(k / 10 + 1), (uint16_t)(k % 10) };
+
+    return (id);
+}
+
+static uint32_t testRandomValue(uint8_t *pBuf)
+{
+    uint32_t len = 1 + rand() % TEST_ITEMLEN;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        pBuf[i] = (uint8_t)rand();
+    }
+
+    return (len);
+}
+
+static void testSteps(void)
+{
+    NVINTF_compactProxy_t prx = { 0 };
+    unsigned long erases;
+    uint8_t buf[TEST_ITEMLEN];
+    uint32_t len;
+    int k = 0;
+
+    memset(nvTestFlash, 0xFF, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE);
+    assert(nv.initNV(NULL) == NVINTF_SUCCESS);
+
+    // Rewrite items until a write has compacted the oldest page into the
+    // transfer page, which is then written with most of its room left
+    nvTestErases = 0;
+    while (nvTestErases < NVOCMP_NVPAGES)
+    {
+        len = testRandomValue(buf);
+        assert(nv.writeItem(testId(k), len, buf) == NVINTF_SUCCESS);
+        k = (k + 1) % TEST_ITEMS;
+    }
+
+    erases = nvTestErases;
+    prx.minAvail = 0;
+    prx.flag = NVINTF_DOSTART;
+    assert(nvExt.compactStep(&prx) == NVINTF_NOTFOUND);
+    assert(nvTestErases == erases);
+    assert(prx.steps == 0);
+
+    prx.minAvail = 0xFFFF;
+    prx.flag = NVINTF_DOSTART;
+    assert(nvExt.compactStep(&prx) == NVINTF_SUCCESS);
+    assert(prx.steps == 1);
+}
+
+static void testWrite(int k, const uint8_t *pBuf, uint32_t len)
+{
+    model->pendHave = true;
+    model->pendLen = len;
+    memcpy(model->pendVal, pBuf, len);
+    __sync_synchronize();
+    model->pend = k;
+
+    assert(nv.writeItem(testId(k), len, (void *)pBuf) == NVINTF_SUCCESS);
+    model->have[k] = true;
+    model->len[k] = len;
+    memcpy(model->val[k], pBuf, len);
+    model->pend = -1;
+}
+
+static void testDelete(int k)
+{
+    model->pendHave = false;
+    __sync_synchronize();
+    model->pend = k;
+
+    nv.deleteItem(testId(k));
+    model->have[k] = false;
+    model->pend = -1;
+}
+
+static void testWork(int seed, int ops)
+{
+    NVINTF_compactProxy_t prx = { 0 };
+    int it;
+
+    srand(seed);
+    prx.minAvail = 3000;
+    prx.flag = NVINTF_DOSTART;
+
+    for (it = 0; it < ops; it++)
+    {
+        int k = rand() % TEST_ITEMS;
+        int op = rand() % 12;
+        uint8_t buf[TEST_ITEMLEN];
+        uint32_t len = testRandomValue(buf);
+
+        if (op < 6)
+        {
+            testWrite(k, buf, len);
+        }
+        else if (op < 7)
+        {
+            testDelete(k);
+        }
+#ifndef TEST_NO_STEPS
+        else if (op < 11)
+        {
+            uint8_t status = nvExt.compactStep(&prx);
+
+            if (status == NVINTF_NOTFOUND)
+            {
+                prx.flag = NVINTF_DOSTART;
+            }
+            else
+            {
+                assert(status == NVINTF_SUCCESS);
+            }
+        }
+#endif
+        else if ((rand() % 8) == 0)
+        {
+            assert(nv.compactNV(0) == NVINTF_SUCCESS);
+        }
+    }
+}
+
+// Rewrites TEST_ITEMLEN items, each written as data, then header, until
+// one of the writes has compacted a page
+static void testStepWrite(void)
+{
+    unsigned long erases = nvTestErases;
+    uint8_t buf[TEST_ITEMLEN];
+    int i;
+
+    while (nvTestErases == erases)
+    {
+        for (i = 0; i < TEST_ITEMLEN; i++)
+        {
+            buf[i] = (uint8_t)rand();
+        }
+        testWrite(rand() % TEST_ITEMS, buf, TEST_ITEMLEN);
+    }
+}
+
+// Runs a full pass of compaction steps, each copying a page
+static void testStepCompact(void)
+{
+    NVINTF_compactProxy_t prx = { 0 };
+    uint8_t status;
+
+    prx.minAvail = 0xFFFF;
+    prx.flag = NVINTF_DOSTART;
+    while ((status = nvExt.compactStep(&prx)) == NVINTF_SUCCESS)
+    {
+    }
+    assert(status == NVINTF_NOTFOUND);
+}
+
+static bool testMatch(int k, bool have, const uint8_t *pVal, uint32_t len)
+{
+    uint8_t buf[TEST_ITEMLEN];
+    uint32_t nvLen = nv.getItemLen(testId(k));
+
+    if (nvLen != (have ? len : 0))
+    {
+        return (false);
+    }
+
+    return ((nvLen == 0) ||
+            ((nv.readItem(testId(k), 0, (uint16_t)nvLen, buf) == NVINTF_SUCCESS) &&
+             (memcmp(buf, pVal, nvLen) == 0)));
+}
+
+static int testVerify(void)
+{
+    int bad = 0;
+    int k;
+
+    for (k = 0; k < TEST_ITEMS; k++)
+    {
+        if (testMatch(k, model->have[k], model->val[k], model->len[k]))
+        {
+            continue;
+        }
+
+        if ((k == model->pend) &&
+            testMatch(k, model->pendHave, model->pendVal, model->pendLen))
+        {
+            // The interrupted write or delete went through
+            model->have[k] = model->pendHave;
+            model->len[k] = model->pendLen;
+            memcpy(model->val[k], model->pendVal, model->pendLen);
+            continue;
+        }
+
+        printf("item %d lost\n", k);
+        bad++;
+    }
+
+    model->pend = -1;
+
+    return (bad);
+}
+
+static int testRun(int round, long cutAt)
+{
+    pid_t pid = fork();
+    int status;
+
+    if (pid == 0)
+    {
+        srand(round * 7 + 1);
+        nvTestCutAt = cutAt;
+        nvTestFlashOps = 0;
+
+        if ((nv.initNV(NULL) != NVINTF_SUCCESS) || testVerify())
+        {
+            fflush(stdout);
+            _exit(TEST_BAD_STATUS);
+        }
+
+        testWork(round + 100, TEST_OPS);
+        _exit(0);
+    }
+
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status));
+
+    return (WEXITSTATUS(status));
+}
+
+// Runs a sweep step in a child from the current NV, with a power loss at
+// flash operation cutAt of the step, or none for cutAt of -1, after which
+// a second child checks that no item was lost
+static int testSweepRun(void (*step)(void), int seed, long cutAt)
+{
+    pid_t pid;
+    int status;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        if ((nv.initNV(NULL) != NVINTF_SUCCESS) || testVerify())
+        {
+            fflush(stdout);
+            _exit(TEST_BAD_STATUS);
+        }
+
+        srand(seed);
+        nvTestFlashOps = 0;
+        nvTestCutAt = (cutAt < 0) ? LONG_MAX : cutAt;
+        step();
+        model->ops = nvTestFlashOps;
+        _exit(0);
+    }
+
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status));
+    status = WEXITSTATUS(status);
+
+    if ((status == 0) || (status == NVTEST_CUT_STATUS))
+    {
+        pid = fork();
+        if (pid == 0)
+        {
+            _exit(((nv.initNV(NULL) != NVINTF_SUCCESS) || testVerify()) ?
+                  TEST_BAD_STATUS : 0);
+        }
+        assert(waitpid(pid, &status, 0) == pid);
+        assert(WIFEXITED(status));
+        status = WEXITSTATUS(status);
+    }
+
+    return (status);
+}
+
+static int testSweep(const char *name, void (*step)(void))
+{
+    long cuts = 0;
+    long ops;
+    long cut;
+    int seed;
+
+    memcpy(sweepFlash, nvTestFlash, sizeof(sweepFlash));
+    sweepModel = *model;
+
+    for (seed = 1; seed <= TEST_SWEEP_SEEDS; seed++)
+    {
+        if (testSweepRun(step, seed, -1) != 0)
+        {
+            printf("%s: NV differs from the model\n", name);
+            return (1);
+        }
+        ops = model->ops;
+
+        for (cut = 0; cut < ops; cut++)
+        {
+            memcpy(nvTestFlash, sweepFlash, sizeof(sweepFlash));
+            *model = sweepModel;
+
+            if (testSweepRun(step, seed, cut) != 0)
+            {
+                printf("%s: NV differs from the model after a power loss "
+                       "at operation %ld of %ld, seed %d\n",
+                       name, cut, ops, seed);
+                return (1);
+            }
+            cuts++;
+        }
+
+        memcpy(nvTestFlash, sweepFlash, sizeof(sweepFlash));
+        *model = sweepModel;
+    }
+
+    printf("%s: %ld power losses, no item lost\n", name, cuts);
+
+    return (0);
+}
+
+int main(void)
+{
+    int cuts = 0;
+    int round;
+    int status;
+
+    // Shared with the children, which lose power part way through
+    nvTestFlash = mmap(NULL, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE,
+                       PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    model = mmap(NULL, sizeof(testModel_t), PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert((nvTestFlash != MAP_FAILED) && (model != MAP_FAILED));
+
+    NVOCMP_loadApiPtrsExt(&nv);
+    NVOCMP_loadExtApiPtrs(&nvExt);
+
+    // NV is initialised once per process, each check runs in a child
+    if (fork() == 0)
+    {
+        testSteps();
+        _exit(0);
+    }
+    assert((wait(&status) > 0) && WIFEXITED(status) &&
+           (WEXITSTATUS(status) == 0));
+
+    memset(nvTestFlash, 0xFF, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE);
+    memset(model, 0, sizeof(testModel_t));
+    model->pend = -1;
+
+    for (round = 0; round < TEST_ROUNDS; round++)
+    {
+        srand(round * 7 + 1);
+        status = testRun(round, rand() % 20000);
+
+        if (status == NVTEST_CUT_STATUS)
+        {
+            cuts++;
+        }
+        else if (status != 0)
+        {
+            printf("round %d: NV differs from the model after a power loss\n",
+                   round);
+            return (1);
+        }
+    }
+
+    // No cut, only check what the last round left behind
+    if (testRun(round, -1) != 0)
+    {
+        printf("NV differs from the model\n");
+        return (1);
+    }
+
+    printf("%d rounds, %d power losses, no item lost\n", TEST_ROUNDS, cuts);
+
+    // Fill NV afresh with live and deleted items of all lengths
+    memset(nvTestFlash, 0xFF, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE);
+    memset(model, 0, sizeof(testModel_t));
+    model->pend = -1;
+    if (fork() == 0)
+    {
+        assert(nv.initNV(NULL) == NVINTF_SUCCESS);
+        testWork(1, TEST_FILL_OPS);
+        _exit(0);
+    }
+    assert((wait(&status) > 0) && WIFEXITED(status) &&
+           (WEXITSTATUS(status) == 0));
+
+    if (testSweep("item writes", testStepWrite) ||
+        testSweep("compaction steps", testStepCompact))
+    {
+        return (1);
+    }
+
+    return (0);
+}
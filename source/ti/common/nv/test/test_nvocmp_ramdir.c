@@ -0,0 +1,186 @@
+/******************************************************************************
+
+ @file  test_nvocmp_ramdir.c
+
+ @brief Host test of the NVOCMP item lookups and RAM item directory.
+
+        Runs random writes, deletes, length queries and reads of NV
+        items against a RAM model of their contents, with compactions
+        and a re-initialisation along the way, and fails on the first
+        difference. It is built without the directory and with
+        NVOCMP_RAMDIR set, and prints the flash reads each readItem
+        costs so that the two builds can be compared.
+
+ Group: CMCU, LPC
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2019-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvocmp.h"
+#include "nv_linux.h"
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define TEST_ITEMS      150
+#define TEST_ITEMLEN    20
+#define TEST_OPS        20000
+
+#ifndef NVOCMP_RAMDIR
+#define NVOCMP_RAMDIR   0
+#endif
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+static uint8_t testFlash[NVOCMP_NVPAGES * NVTEST_PAGE_SIZE];
+
+uint8_t *nvTestFlash = testFlash;
+unsigned long nvTestReads;
+unsigned long nvTestErases;
+long nvTestFlashOps;
+long nvTestCutAt = -1;
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+
+static bool modelHave[TEST_ITEMS];
+static uint8_t modelVal[TEST_ITEMS][TEST_ITEMLEN];
+static uint32_t modelLen[TEST_ITEMS];
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static NVINTF_itemID_t testId(int k)
+{
+    NVINTF_itemID_t id = { 1, (uint16_t)(k / 10 + 1), (uint16_t)(k % 10) };
+
+    return (id);
+}
+
+int main(void)
+{
+    NVINTF_nvFuncts_t nv;
+    unsigned long reads = 0;
+    unsigned long readItems = 0;
+    int it;
+
+    memset(testFlash, 0xFF, sizeof(testFlash));
+
+    NVOCMP_loadApiPtrs(&nv);
+    assert(nv.initNV(NULL) == NVINTF_SUCCESS);
+
+    srand(1);
+
+    for (it = 0; it < TEST_OPS; it++)
+    {
+        int k = rand() % TEST_ITEMS;
+        int op = rand() % 10;
+
+        if (it == TEST_OPS / 2)
+        {
+            // The directory is rebuilt from flash
+            assert(nv.initNV(NULL) == NVINTF_SUCCESS);
+        }
+
+        if (op < 4)
+        {
+            uint8_t buf[TEST_ITEMLEN];
+            uint32_t len = 1 + rand() % (TEST_ITEMLEN - 1);
+            uint32_t i;
+
+            for (i = 0; i < len; i++)
+            {
+                buf[i] = (uint8_t)rand();
+            }
+
+            assert(nv.writeItem(testId(k), len, buf) == NVINTF_SUCCESS);
+            modelHave[k] = true;
+            modelLen[k] = len;
+            memcpy(modelVal[k], buf, len);
+        }
+        else if (op < 5)
+        {
+            uint8_t status = nv.deleteItem(testId(k));
+
+            assert((status == NVINTF_SUCCESS) == modelHave[k]);
+            modelHave[k] = false;
+        }
+        else
+        {
+            uint32_t len = nv.getItemLen(testId(k));
+
+            assert(len == (modelHave[k] ? modelLen[k] : 0));
+
+            if (modelHave[k])
+            {
+                uint8_t buf[TEST_ITEMLEN];
+
+                nvTestReads = 0;
+                assert(nv.readItem(testId(k), 0, (uint16_t)len, buf) ==
+                       NVINTF_SUCCESS);
+                assert(memcmp(buf, modelVal[k], len) == 0);
+                reads += nvTestReads;
+                readItems++;
+            }
+        }
+
+        if ((it % 3000) == 0)
+        {
+            assert(nv.compactNV(0) >= 0);
+        }
+    }
+
+    printf("NVOCMP_RAMDIR %d: %lu readItem calls, %.1f flash reads each\n",
+           NVOCMP_RAMDIR, readItems, (double)reads / readItems);
+
+    return (0);
+}
@@ -0,0 +1,392 @@
+/******************************************************************************
+
+ @file  test_nvocmp_writeitems.c
+
+ @brief Host test of NVOCMP writeItems() batches and power loss.
+
+        First checks that writeItems() turns down empty batches, items
+        given twice and batches larger than a page.
+
+        Then runs a workload of batch writes, single item writes and
+        compactions in forked children, each of which loses power at a
+        random flash write or erase. The next child initialises NV from
+        what is left and compares every item with a RAM model. The batch
+        being written at the cut must hold either all of its old values
+        or all of its new values. Build with TEST_NO_BATCH to write the
+        batch one item at a time, which tears batches.
+
+        Items are kept to NVOCMP_SMALLITEM bytes with their header, see
+        test_nvocmp_powercut.c.
+
+ Group: CMCU, LPC
+ Target Device: cc13x2_26x2
+
+ ******************************************************************************
+ 
+ Copyright (c) 2019-2020, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ 
+ 
+ *****************************************************************************/
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "nvocmp.h"
+#include "nv_linux.h"
+
+//*****************************************************************************
+// Constants and Definitions
+//*****************************************************************************
+
+#define TEST_ITEMS      40
+#define TEST_ITEMLEN    5       // NVOCMP_SMALLITEM less the item header
+#define TEST_BATCH      4
+#define TEST_ROUNDS     300
+#define TEST_OPS        3000
+
+// Exit status of a child that found NV different from the model
+#define TEST_BAD_STATUS 3
+
+typedef struct
+{
+    bool have[TEST_ITEMS];
+    uint8_t val[TEST_ITEMS][TEST_ITEMLEN];
+    uint32_t len[TEST_ITEMS];
+    int pendNum;                // items being written, 0 for none
+    int pend[TEST_BATCH];
+    uint8_t pendVal[TEST_BATCH][TEST_ITEMLEN];
+    uint32_t pendLen[TEST_BATCH];
+} testModel_t;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+
+uint8_t *nvTestFlash;
+unsigned long nvTestReads;
+unsigned long nvTestErases;
+long nvTestFlashOps;
+long nvTestCutAt = -1;
+
+//*****************************************************************************
+// Local Variables
+//*****************************************************************************
+
+static testModel_t *model;
+static NVINTF_nvFuncts_t nv;
+static NVINTF_nvFunctsExt_t nvExt;
+
+//*****************************************************************************
+// Local Functions
+//*****************************************************************************
+
+static NVINTF_itemID_t testId(int k)
+{
+    NVINTF_itemID_t id = { 1, (uint16_t)(k / 10 + 1), (uint16_t)(k % 10) };
+
+    return (id);
+}
+
+static uint32_t testRandomValue(uint8_t *pBuf)
+{
+    uint32_t len = 1 + rand() % TEST_ITEMLEN;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        pBuf[i] = (uint8_t)rand();
+    }
+
+    return (len);
+}
+
+static void testParams(void)
+{
+    // Longest item, two do not fit on one page
+    static uint8_t big[0x0FFF];
+    NVINTF_itemWrite_t items[2];
+
+    memset(nvTestFlash, 0xFF, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE);
+    assert(nv.initNV(NULL) == NVINTF_SUCCESS);
+
+    items[0].id = testId(0);
+    items[0].len = sizeof(big);
+    items[0].buffer = big;
+    items[1] = items[0];
+
+    assert(nvExt.writeItems(items, 0) == NVINTF_BADPARAM);
+    assert(nvExt.writeItems(items, 2) == NVINTF_BADPARAM);
+
+    items[1].id = testId(1);
+    assert(nvExt.writeItems(items, 2) == NVINTF_BADLENGTH);
+    assert(nv.getItemLen(testId(0)) == 0);
+    assert(nv.getItemLen(testId(1)) == 0);
+
+    assert(nvExt.writeItems(items, 1) == NVINTF_SUCCESS);
+    assert(nv.getItemLen(testId(0)) == sizeof(big));
+}
+
+static void testWork(int seed, int ops)
+{
+    int it;
+
+    srand(seed);
+
+    for (it = 0; it < ops; it++)
+    {
+        int op = rand() % 10;
+        int n;
+        int i;
+
+        if (op < 5)
+        {
+            NVINTF_itemWrite_t items[TEST_BATCH];
+
+            // A batch of distinct items
+            n = 1 + rand() % TEST_BATCH;
+            for (i = 0; i < n; i++)
+            {
+                int j;
+
+                do
+                {
+                    model->pend[i] = rand() % TEST_ITEMS;
+                    for (j = 0; (j < i) && (model->pend[j] != model->pend[i]); j++);
+                } while (j < i);
+
+                model->pendLen[i] = testRandomValue(model->pendVal[i]);
+                items[i].id = testId(model->pend[i]);
+                items[i].len = model->pendLen[i];
+                items[i].buffer = model->pendVal[i];
+            }
+            __sync_synchronize();
+            model->pendNum = n;
+
+#ifdef TEST_NO_BATCH
+            for (i = 0; i < n; i++)
+            {
+                assert(nv.writeItem(items[i].id, items[i].len,
+                                    items[i].buffer) == NVINTF_SUCCESS);
+            }
+#else
+            assert(nvExt.writeItems(items, (uint8_t)n) == NVINTF_SUCCESS);
+#endif
+        }
+        else if (op < 9)
+        {
+            n = 1;
+            model->pend[0] = rand() % TEST_ITEMS;
+            model->pendLen[0] = testRandomValue(model->pendVal[0]);
+            __sync_synchronize();
+            model->pendNum = 1;
+
+            assert(nv.writeItem(testId(model->pend[0]), model->pendLen[0],
+                                model->pendVal[0]) == NVINTF_SUCCESS);
+        }
+        else
+        {
+            n = 0;
+            assert(nv.compactNV(0) == NVINTF_SUCCESS);
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            int k = model->pend[i];
+
+            model->have[k] = true;
+            model->len[k] = model->pendLen[i];
+            memcpy(model->val[k], model->pendVal[i], model->pendLen[i]);
+        }
+        model->pendNum = 0;
+    }
+}
+
+static bool testMatch(int k, bool have, const uint8_t *pVal, uint32_t len)
+{
+    uint8_t buf[TEST_ITEMLEN];
+    uint32_t nvLen = nv.getItemLen(testId(k));
+
+    if (nvLen != (have ? len : 0))
+    {
+        return (false);
+    }
+
+    return ((nvLen == 0) ||
+            ((nv.readItem(testId(k), 0, (uint16_t)nvLen, buf) == NVINTF_SUCCESS) &&
+             (memcmp(buf, pVal, nvLen) == 0)));
+}
+
+static int testVerify(void)
+{
+    int bad = 0;
+    int numOld = 0;
+    int numNew = 0;
+    int i;
+    int k;
+
+    for (k = 0; k < TEST_ITEMS; k++)
+    {
+        for (i = 0; (i < model->pendNum) && (model->pend[i] != k); i++);
+
+        if (testMatch(k, model->have[k], model->val[k], model->len[k]))
+        {
+            numOld += (i < model->pendNum);
+        }
+        else if ((i < model->pendNum) &&
+                 testMatch(k, true, model->pendVal[i], model->pendLen[i]))
+        {
+            numNew++;
+        }
+        else
+        {
+            printf("item %d lost\n", k);
+            bad++;
+        }
+    }
+
+    // A new value equal to the old one counts as old
+    if (numOld && numNew)
+    {
+        printf("batch torn, %d items old, %d new\n", numOld, numNew);
+        bad++;
+    }
+
+    if (!bad && numNew)
+    {
+        // The interrupted batch went through
+        for (i = 0; i < model->pendNum; i++)
+        {
+            k = model->pend[i];
+            model->have[k] = true;
+            model->len[k] = model->pendLen[i];
+            memcpy(model->val[k], model->pendVal[i], model->pendLen[i]);
+        }
+    }
+
+    model->pendNum = 0;
+
+    return (bad);
+}
+
+static int testRun(int round, long cutAt)
+{
+    pid_t pid = fork();
+    int status;
+
+    if (pid == 0)
+    {
+        nvTestCutAt = cutAt;
+        nvTestFlashOps = 0;
+
+        if ((nv.initNV(NULL) != NVINTF_SUCCESS) || testVerify())
+        {
+            fflush(stdout);
+            _exit(TEST_BAD_STATUS);
+        }
+
+        testWork(round + 100, TEST_OPS);
+        _exit(0);
+    }
+
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status));
+
+    return (WEXITSTATUS(status));
+}
+
+int main(void)
+{
+    int cuts = 0;
+    int round;
+    int status;
+
+    // Shared with the children, which lose power part way through
+    nvTestFlash = mmap(NULL, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE,
+                       PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    model = mmap(NULL, sizeof(testModel_t), PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert((nvTestFlash != MAP_FAILED) && (model != MAP_FAILED));
+
+    NVOCMP_loadApiPtrsExt(&nv);
+    NVOCMP_loadExtApiPtrs(&nvExt);
+
+    // NV is initialised once per process, each check runs in a child
+    if (fork() == 0)
+    {
+        testParams();
+        _exit(0);
+    }
+    assert((wait(&status) > 0) && WIFEXITED(status) &&
+           (WEXITSTATUS(status) == 0));
+
+    memset(nvTestFlash, 0xFF, NVOCMP_NVPAGES * NVTEST_PAGE_SIZE);
+    memset(model, 0, sizeof(testModel_t));
+
+    for (round = 0; round < TEST_ROUNDS; round++)
+    {
+        srand(round * 7 + 1);
+        status = testRun(round, rand() % 20000);
+
+        if (status == NVTEST_CUT_STATUS)
+        {
+            cuts++;
+        }
+        else if (status != 0)
+        {
+            printf("round %d: NV differs from the model after a power loss\n",
+                   round);
+            return (1);
+        }
+    }
+
+    // No cut, only check what the last round left behind
+    if (testRun(round, -1) != 0)
+    {
+        printf("NV differs from the model\n");
+        return (1);
+    }
+
+    printf("%d rounds, %d power losses, no item lost or batch torn\n",
+           TEST_ROUNDS, cuts);
+
+    return (0);
+}
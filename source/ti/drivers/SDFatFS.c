@@ -33,6 +33,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 /*
  * By default disable both asserts and log for this module.
@@ -47,6 +48,7 @@
 
 #include <ti/drivers/dpl/DebugP.h>
 #include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
 #include <ti/drivers/SD.h>
 #include <ti/drivers/SDFatFS.h>
 
@@ -76,6 +78,12 @@ DSTATUS SDFatFS_diskStatus(BYTE drive);
 DRESULT SDFatFS_diskWrite(BYTE drive, const BYTE *buffer,
     DWORD sector, UINT secCount);
 
+#if SDFatFS_CACHE_SECTORS > 0
+static DRESULT readCached(SDFatFS_Object *obj, BYTE *buffer, DWORD sector);
+static void writeCached(SDFatFS_Object *obj, const BYTE *buffer,
+    DWORD sector, UINT secCount);
+#endif
+
 /*
  *  ======== SDFatFS_close ========
  */
@@ -94,6 +102,10 @@ void SDFatFS_close(SDFatFS_Handle handle)
     /* Close the SD driver */
     SD_close(obj->sdHandle);
 
+#if SDFatFS_CACHE_SECTORS > 0
+    SemaphoreP_destruct(&(obj->cacheSem));
+#endif
+
     /* Unmount the FatFs drive */
     fresult = f_mount(NULL, path, 0);
     if (fresult != FR_OK) {
@@ -125,6 +137,12 @@ DSTATUS SDFatFS_diskInitialize(BYTE drive)
     /* Convert lower level driver status code */
     if (result == SD_STATUS_SUCCESS) {
         obj->diskState = ((DSTATUS) obj->diskState) & ~((DSTATUS)STA_NOINIT);
+
+#if SDFatFS_CACHE_SECTORS > 0
+        /* The card may have changed, start with an empty cache */
+        obj->numSectors = (uint32_t)SD_getNumSectors(obj->sdHandle);
+        obj->cacheCount = 0;
+#endif
     }
 
     return (obj->diskState);
@@ -146,10 +164,10 @@ DRESULT SDFatFS_diskIOctrl(BYTE drive, BYTE ctrl, void *buffer)
             break;
 
         case (BYTE)GET_SECTOR_COUNT:
-            *(uint32_t*)buffer = (uint32_t)SD_getNumSectors(obj->sdHandle);
+            *(DWORD*)buffer = (DWORD)SD_getNumSectors(obj->sdHandle);
 
             DebugP_log1("SDFatFS: Disk IO control: sector count: %d",
-                *(uint32_t*)buffer);
+                *(DWORD*)buffer);
             fatfsRes = RES_OK;
             break;
 
@@ -191,6 +209,11 @@ DRESULT SDFatFS_diskRead(BYTE drive, BYTE *buffer,
     if ((obj->diskState & (DSTATUS)STA_NOINIT) != 0) {
         fatfsRes = RES_PARERR;
     }
+#if SDFatFS_CACHE_SECTORS > 0
+    else if (secCount == 1) {
+        fatfsRes = readCached(obj, buffer, sector);
+    }
+#endif
     else {
         result = SD_read(obj->sdHandle, (uint_least8_t *)buffer,
             (int_least32_t)sector, (uint_least32_t)secCount);
@@ -240,10 +263,103 @@ DRESULT SDFatFS_diskWrite(BYTE drive, const BYTE *buffer, DWORD sector,
         if (result == SD_STATUS_SUCCESS) {
             fatfsRes = RES_OK;
         }
+
+#if SDFatFS_CACHE_SECTORS > 0
+        /* Contents of the card are unknown after a failed write */
+        writeCached(obj, (fatfsRes == RES_OK) ? buffer : NULL, sector,
+            secCount);
+#endif
+    }
+
+    return (fatfsRes);
+}
+#endif
+
+#if SDFatFS_CACHE_SECTORS > 0
+/*
+ *  ======== readCached ========
+ *  Reads a single sector from the sector cache. On a miss, the cache is
+ *  refilled with the requested sector. If it directly follows the sectors in
+ *  the cache, the sectors after it are read ahead as well, twice as many as
+ *  the last time.
+ */
+static DRESULT readCached(SDFatFS_Object *obj, BYTE *buffer, DWORD sector)
+{
+    int_fast32_t   result;
+    uint_least32_t count;
+    DRESULT        fatfsRes = RES_OK;
+
+    if ((uint32_t)sector >= obj->numSectors) {
+        return (RES_PARERR);
+    }
+
+    SemaphoreP_pend(&(obj->cacheSem), SemaphoreP_WAIT_FOREVER);
+
+    if ((uint32_t)sector - obj->cacheSector >= obj->cacheCount) {
+        count = 1;
+        if ((obj->cacheCount > 0) &&
+            ((uint32_t)sector == obj->cacheSector + obj->cacheCount)) {
+            /* Sequential access, double the read-ahead up to the cache size */
+            count = obj->cacheCount * 2;
+            if (count > SDFatFS_CACHE_SECTORS) {
+                count = SDFatFS_CACHE_SECTORS;
+            }
+            if (count > obj->numSectors - (uint32_t)sector) {
+                count = obj->numSectors - (uint32_t)sector;
+            }
+        }
+
+        obj->cacheCount = 0;
+        result = SD_read(obj->sdHandle, (uint_least8_t *)obj->cache,
+            (int_least32_t)sector, count);
+        if (result == SD_STATUS_SUCCESS) {
+            obj->cacheSector = (uint32_t)sector;
+            obj->cacheCount = count;
+        }
+        else {
+            fatfsRes = RES_ERROR;
+        }
+    }
+
+    if (fatfsRes == RES_OK) {
+        memcpy(buffer, (uint8_t *)obj->cache +
+            ((uint32_t)sector - obj->cacheSector) * SDFatFS_SECTOR_SIZE,
+            SDFatFS_SECTOR_SIZE);
     }
 
+    SemaphoreP_post(&(obj->cacheSem));
+
     return (fatfsRes);
 }
+
+/*
+ *  ======== writeCached ========
+ *  Updates the sectors held in the sector cache after they were written, or
+ *  empties the cache if buffer is NULL.
+ */
+static void writeCached(SDFatFS_Object *obj, const BYTE *buffer,
+    DWORD sector, UINT secCount)
+{
+    UINT     i;
+    uint32_t offset;
+
+    SemaphoreP_pend(&(obj->cacheSem), SemaphoreP_WAIT_FOREVER);
+
+    if (buffer == NULL) {
+        obj->cacheCount = 0;
+        secCount = 0;
+    }
+
+    for (i = 0; i < secCount; i++) {
+        offset = (uint32_t)sector + i - obj->cacheSector;
+        if (offset < obj->cacheCount) {
+            memcpy((uint8_t *)obj->cache + offset * SDFatFS_SECTOR_SIZE,
+                buffer + i * SDFatFS_SECTOR_SIZE, SDFatFS_SECTOR_SIZE);
+        }
+    }
+
+    SemaphoreP_post(&(obj->cacheSem));
+}
 #endif
 
 /*
@@ -266,6 +382,9 @@ void SDFatFS_init(void)
 
             obj->diskState = STA_NOINIT;
             obj->driveNum = DRIVE_NOT_MOUNTED;
+#if SDFatFS_CACHE_SECTORS > 0
+            obj->cacheCount = 0;
+#endif
         }
 
         /* Initialize the SD Driver */
@@ -317,6 +436,14 @@ SDFatFS_Handle SDFatFS_open(uint_least8_t idx, uint_least8_t drive)
             }
             else {
 
+#if SDFatFS_CACHE_SECTORS > 0
+                /*
+                 * FatFs may call the disk functions from several tasks at
+                 * once, see FF_FS_UNLOCKED_IO.
+                 */
+                SemaphoreP_constructBinary(&(obj->cacheSem), 1);
+#endif
+
                 /* Register FATFS Functions */
                 dresult = disk_register(obj->driveNum,
                     SDFatFS_diskInitialize,
@@ -367,3 +494,34 @@ SDFatFS_Handle SDFatFS_open(uint_least8_t idx, uint_least8_t drive)
 
     return (handle);
 }
+
+/*
+ *  ======== SDFatFS_openFastSeek ========
+ */
+FRESULT SDFatFS_openFastSeek(FIL *file, const TCHAR *path, BYTE mode,
+    DWORD *linkMap, UINT linkMapSize)
+{
+    FRESULT fresult;
+
+    fresult = f_open(file, path, mode);
+
+#if FF_USE_FASTSEEK
+    /*
+     * A file with a link map cannot grow, so only set up fast seeking for
+     * files that are opened for reading only.
+     */
+    if ((fresult == FR_OK) && ((mode & FA_WRITE) == 0) &&
+        (linkMap != NULL) && (linkMapSize > 0)) {
+        linkMap[0] = linkMapSize;
+        file->cltbl = linkMap;
+
+        if (f_lseek(file, CREATE_LINKMAP) != FR_OK) {
+            /* Map is too small, follow the FAT chain instead */
+            DebugP_log1("SDFatFS: Link map needs %d entries", linkMap[0]);
+            file->cltbl = NULL;
+        }
+    }
+#endif
+
+    return (fresult);
+}
@@ -86,6 +86,7 @@
 #include <stdint.h>
 
 #include <ti/drivers/SD.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
 
 #include <third_party/fatfs/ff.h>
 #include <third_party/fatfs/diskio.h>
@@ -94,6 +95,27 @@
 extern "C" {
 #endif
 
+/*!
+ *  @brief Number of sectors read ahead into the SDFatFS sector cache
+ *
+ *  FatFs reads the FAT, directories and partial file sectors one sector at a
+ *  time. With a non-zero #SDFatFS_CACHE_SECTORS, these reads go through a
+ *  cache of consecutive sectors. When a read misses the cache but directly
+ *  follows the sectors in it, the sectors after it are read ahead in one
+ *  multi-block SD_read(), twice as many as last time and up to this many,
+ *  and the following reads are served from RAM.
+ *  Writes update the cache, and multi-sector reads bypass it.
+ *
+ *  The cache takes #SDFatFS_CACHE_SECTORS times #SDFatFS_SECTOR_SIZE bytes of
+ *  RAM in every #SDFatFS_Object. The driver must be recompiled to change it.
+ */
+#ifndef SDFatFS_CACHE_SECTORS
+#define SDFatFS_CACHE_SECTORS       0
+#endif
+
+/*! @brief Sector size the SDFatFS sector cache is sized for, in bytes */
+#define SDFatFS_SECTOR_SIZE         FF_MAX_SS
+
 /*!
  *  @brief SDFatFS Object
  *  The application must not access any member variables of this structure!
@@ -103,6 +125,14 @@ typedef struct {
     DSTATUS       diskState;
     FATFS         filesystem; /* FATFS data object */
     SD_Handle     sdHandle;
+#if SDFatFS_CACHE_SECTORS > 0
+    SemaphoreP_Struct cacheSem; /* Guards the cache */
+    uint32_t      numSectors;  /* Number of sectors on the card */
+    uint32_t      cacheSector; /* First sector held in the cache */
+    uint32_t      cacheCount;  /* Number of valid sectors in the cache */
+    uint32_t      cache[SDFatFS_CACHE_SECTORS * SDFatFS_SECTOR_SIZE /
+                        sizeof(uint32_t)];
+#endif
 } SDFatFS_Object;
 
 /*!
@@ -159,6 +189,37 @@ extern void SDFatFS_close(SDFatFS_Handle handle);
  */
 extern void SDFatFS_init(void);
 
+/*!
+ *  @brief  Function to open a file and set it up for fast seeking.
+ *
+ *  Opens the file with f_open() and, unless it is opened for writing,
+ *  builds a cluster link map of the file in @p linkMap. FatFs then looks up
+ *  clusters in the map instead of following the FAT chain, so that f_lseek()
+ *  and f_read() at random offsets of large files take no extra disk reads.
+ *
+ *  A file made of N fragments needs a map of 2 * N + 2 entries. If
+ *  @p linkMap is too small, the file is left open without the map and
+ *  FatFs follows the FAT chain as usual. The map must stay valid until the
+ *  file is closed.
+ *
+ *  Fast seeking is only available when FF_USE_FASTSEEK is defined to 1,
+ *  which the prebuilt libraries are not built with. Otherwise this is the
+ *  same as f_open(). To opt in, define FF_USE_FASTSEEK to 1 for the
+ *  application and build ff.c and SDFatFS.c from source.
+ *
+ *  @pre    SDFatFS_open() had to be called first.
+ *
+ *  @param  file        File object to open
+ *  @param  path        Path of the file
+ *  @param  mode        FatFs access mode flags (FA_READ, FA_WRITE, ...)
+ *  @param  linkMap     Memory for the cluster link map
+ *  @param  linkMapSize Number of entries in @p linkMap
+ *
+ *  @return The result of f_open().
+ */
+extern FRESULT SDFatFS_openFastSeek(FIL *file, const TCHAR *path, BYTE mode,
+    DWORD *linkMap, UINT linkMapSize);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2019, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  ======== NVSQueue.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/drivers/utils/List.h>
+
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/nvs/NVSQueue.h>
+
+static int_fast16_t eraseAheadFor(NVSQueue_Object *object, size_t offset,
+    size_t end, bool selfErase);
+static int_fast16_t eraseAheadTo(NVSQueue_Object *object, size_t end);
+static size_t gatherWrites(NVSQueue_Object *object, NVSQueue_Op *op,
+    size_t *count);
+
+/* Default NVSQueue parameters structure */
+const NVSQueue_Params NVSQueue_defaultParams = {
+    NULL,   /* pageBuf */
+    0       /* pageSize */
+};
+
+/*
+ *  ======== NVSQueue_construct ========
+ */
+NVSQueue_Handle NVSQueue_construct(NVSQueue_Object *object,
+    NVS_Handle nvsHandle, const NVSQueue_Params *params)
+{
+    NVS_Attrs attrs;
+
+    if (params == NULL) {
+        params = &NVSQueue_defaultParams;
+    }
+
+    if (nvsHandle == NULL ||
+        (params->pageBuf != NULL && params->pageSize == 0)) {
+        return (NULL);
+    }
+
+    NVS_getAttrs(nvsHandle, &attrs);
+
+    object->nvsHandle = nvsHandle;
+    object->pageBuf = params->pageBuf;
+    object->pageSize = params->pageSize;
+    object->sectorSize = attrs.sectorSize;
+    object->regionSize = attrs.regionSize;
+    object->eraseNext = 0;
+    object->eraseEnd = 0;
+
+    List_clearList(&object->queue);
+
+    if (SemaphoreP_constructBinary(&object->workSem, 0) == NULL) {
+        return (NULL);
+    }
+
+    return (object);
+}
+
+/*
+ *  ======== NVSQueue_destruct ========
+ */
+void NVSQueue_destruct(NVSQueue_Handle handle)
+{
+    SemaphoreP_destruct(&handle->workSem);
+}
+
+/*
+ *  ======== NVSQueue_eraseAhead ========
+ */
+int_fast16_t NVSQueue_eraseAhead(NVSQueue_Handle handle, size_t offset,
+    size_t size)
+{
+    uintptr_t key;
+
+    if (offset % handle->sectorSize != 0) {
+        return (NVS_STATUS_INV_ALIGNMENT);
+    }
+
+    if (size % handle->sectorSize != 0 || offset > handle->regionSize ||
+        size > handle->regionSize - offset) {
+        return (NVS_STATUS_INV_SIZE);
+    }
+
+    key = HwiP_disable();
+
+    if (handle->eraseNext < handle->eraseEnd) {
+        if (offset != handle->eraseEnd) {
+            /* another range is still pending */
+            HwiP_restore(key);
+
+            return (NVS_STATUS_ERROR);
+        }
+    }
+    else {
+        handle->eraseNext = offset;
+    }
+    handle->eraseEnd = offset + size;
+
+    HwiP_restore(key);
+
+    SemaphoreP_post(&handle->workSem);
+
+    return (NVS_STATUS_SUCCESS);
+}
+
+/*
+ *  ======== NVSQueue_Params_init ========
+ */
+void NVSQueue_Params_init(NVSQueue_Params *params)
+{
+    *params = NVSQueue_defaultParams;
+}
+
+/*
+ *  ======== NVSQueue_process ========
+ */
+bool NVSQueue_process(NVSQueue_Handle handle, uint32_t timeout)
+{
+    NVSQueue_Op  *op;
+    void         *buffer;
+    size_t        size;
+    size_t        count;
+    int_fast16_t  status;
+
+    if (List_empty(&handle->queue) && handle->eraseNext >= handle->eraseEnd) {
+        /* a stale post from work done already only costs an idle pass */
+        SemaphoreP_pend(&handle->workSem, timeout);
+    }
+
+    op = (NVSQueue_Op *)List_head(&handle->queue);
+
+    if (op == NULL) {
+        if (handle->eraseNext >= handle->eraseEnd) {
+            return (false);
+        }
+
+        /* nothing queued, erase the next sector ahead of time */
+        eraseAheadTo(handle, handle->eraseNext + handle->sectorSize);
+
+        return (true);
+    }
+
+    count = 1;
+
+    if (op->type == NVSQueue_OP_ERASE) {
+        status = eraseAheadFor(handle, op->offset, op->offset + op->size,
+            true);
+        if (status == NVS_STATUS_SUCCESS) {
+            status = NVS_erase(handle->nvsHandle, op->offset, op->size);
+        }
+    }
+    else {
+        buffer = op->buffer;
+        size = op->size;
+
+        if (handle->pageBuf != NULL && !(op->flags & NVS_WRITE_ERASE)) {
+            size = gatherWrites(handle, op, &count);
+            if (count > 1) {
+                buffer = handle->pageBuf;
+            }
+            else {
+                count = 1;
+                size = op->size;
+            }
+        }
+
+        /*
+         *  NVS_WRITE_ERASE erases size bytes from the start of the first
+         *  sector, which need not cover the write, so it is not relied on.
+         */
+        status = eraseAheadFor(handle, op->offset, op->offset + size, false);
+        if (status == NVS_STATUS_SUCCESS) {
+            status = NVS_write(handle->nvsHandle, op->offset, buffer, size,
+                op->flags);
+        }
+    }
+
+    /* submitters only append, so the first count ops are the ones done */
+    while (count-- > 0) {
+        op = (NVSQueue_Op *)List_get(&handle->queue);
+
+        if (op->callbackFxn != NULL) {
+            op->callbackFxn(handle, op, status);
+        }
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== NVSQueue_submit ========
+ */
+int_fast16_t NVSQueue_submit(NVSQueue_Handle handle, NVSQueue_Op *op)
+{
+    if (op->offset > handle->regionSize ||
+        op->size > handle->regionSize - op->offset) {
+        return (NVS_STATUS_INV_OFFSET);
+    }
+
+    List_put(&handle->queue, &op->elem);
+
+    SemaphoreP_post(&handle->workSem);
+
+    return (NVS_STATUS_SUCCESS);
+}
+
+/*
+ *  ======== eraseAheadFor ========
+ *  Erases the pending erase ahead sectors which must be erased before an
+ *  operation on offset to end. If the operation erases its sectors itself,
+ *  only the pending sectors in front of it are erased, and the ones it
+ *  covers are dropped from the range.
+ */
+static int_fast16_t eraseAheadFor(NVSQueue_Object *object, size_t offset,
+    size_t end, bool selfErase)
+{
+    uintptr_t    key;
+    size_t       limit;
+    int_fast16_t status;
+
+    if (offset >= object->eraseEnd || end <= object->eraseNext) {
+        /* no pending sector is touched */
+        return (NVS_STATUS_SUCCESS);
+    }
+
+    limit = selfErase ? offset - offset % object->sectorSize : end;
+
+    status = eraseAheadTo(object, limit);
+
+    if (selfErase && status == NVS_STATUS_SUCCESS) {
+        end += object->sectorSize - 1;
+        end -= end % object->sectorSize;
+
+        key = HwiP_disable();
+
+        if (object->eraseNext < end) {
+            object->eraseNext = (end < object->eraseEnd) ? end :
+                object->eraseEnd;
+        }
+
+        HwiP_restore(key);
+    }
+
+    return (status);
+}
+
+/*
+ *  ======== eraseAheadTo ========
+ *  Erases the pending erase ahead sectors which start below end.
+ */
+static int_fast16_t eraseAheadTo(NVSQueue_Object *object, size_t end)
+{
+    uintptr_t    key;
+    size_t       offset;
+    int_fast16_t status = NVS_STATUS_SUCCESS;
+
+    while (status == NVS_STATUS_SUCCESS) {
+        key = HwiP_disable();
+
+        offset = object->eraseNext;
+        if (offset >= end || offset >= object->eraseEnd) {
+            HwiP_restore(key);
+            break;
+        }
+
+        /* a failed sector is not retried */
+        object->eraseNext = offset + object->sectorSize;
+
+        HwiP_restore(key);
+
+        status = NVS_erase(object->nvsHandle, offset, object->sectorSize);
+    }
+
+    return (status);
+}
+
+/*
+ *  ======== gatherWrites ========
+ *  Copies op and the queued writes which continue it within the same page
+ *  into the page buffer. Returns the number of bytes gathered, and the
+ *  number of writes in count; count is 0 if op itself crosses a page.
+ */
+static size_t gatherWrites(NVSQueue_Object *object, NVSQueue_Op *op,
+    size_t *count)
+{
+    uintptr_t      key;
+    size_t         offset = op->offset;
+    size_t         page = op->offset / object->pageSize;
+    size_t         size = 0;
+    uint_fast16_t  flags = op->flags;
+
+    *count = 0;
+
+    while (op != NULL && op->type == NVSQueue_OP_WRITE &&
+        op->flags == flags && op->offset == offset + size && op->size > 0 &&
+        (op->offset + op->size - 1) / object->pageSize == page) {
+        memcpy(object->pageBuf + size, op->buffer, op->size);
+        size += op->size;
+        (*count)++;
+
+        /* List_put() may be linking a new op behind this one */
+        key = HwiP_disable();
+        op = (NVSQueue_Op *)List_next(&op->elem);
+        HwiP_restore(key);
+    }
+
+    return (size);
+}
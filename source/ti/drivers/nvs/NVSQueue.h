@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2019, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/** ============================================================================
+ *  @file       NVSQueue.h
+ *
+ *  @brief      Queued, asynchronous operations on an NVS region
+ *
+ *  NVSQueue lets threads queue NVS writes and erases instead of blocking
+ *  in NVS_write() and NVS_erase() until the FLASH device has finished.
+ *  The operations are carried out in order by a worker thread which calls
+ *  NVSQueue_process(), and each operation's callback is called with its
+ *  status once it is done. NVSQueue works on top of any NVS driver
+ *  implementation (NVSCC26XX, NVSSPI25X, NVSRAM).
+ *
+ *  While the worker is busy, queued writes pile up, and NVSQueue uses
+ *  that to save FLASH operations:
+ *  - Adjacent queued writes which fall into the same program page of the
+ *    FLASH device are gathered in the page buffer given in #NVSQueue_Params
+ *    and programmed with a single NVS_write(). On SPI NOR FLASH each
+ *    NVS_write() costs at least one page program and busy poll, no matter
+ *    how few bytes are written.
+ *  - NVSQueue_eraseAhead() names sectors which are going to be written.
+ *    They are erased one at a time whenever the queue is empty, so that
+ *    the long sector erases are out of the way before the data arrives.
+ *    A sector which has not been erased yet when a write to it is
+ *    processed is erased first.
+ *
+ *  The NVS header files should be included in an application as follows:
+ *  @code
+ *  #include <ti/drivers/NVS.h>
+ *  #include <ti/drivers/nvs/NVSQueue.h>
+ *  @endcode
+ *
+ *  ## Example ##
+ *  @code
+ *  static NVSQueue_Object queueObject;
+ *  static uint8_t pageBuf[256];
+ *
+ *  // Worker thread
+ *  void *nvsThread(void *arg)
+ *  {
+ *      while (1) {
+ *          NVSQueue_process(&queueObject, NVSQueue_WAIT_FOREVER);
+ *      }
+ *  }
+ *
+ *  void logWritten(NVSQueue_Handle handle, NVSQueue_Op *op,
+ *      int_fast16_t status)
+ *  {
+ *      // op->buffer may be reused now
+ *  }
+ *
+ *  NVSQueue_Params params;
+ *  NVSQueue_Params_init(&params);
+ *  params.pageBuf = pageBuf;
+ *  params.pageSize = sizeof(pageBuf);
+ *  NVSQueue_construct(&queueObject, NVS_open(CONFIG_NVS0, NULL), &params);
+ *
+ *  // erase the log sectors while nothing else is going on
+ *  NVSQueue_eraseAhead(&queueObject, 0, 4 * 4096);
+ *
+ *  op.type = NVSQueue_OP_WRITE;
+ *  op.offset = logOffset;
+ *  op.buffer = record;
+ *  op.size = sizeof(record);
+ *  op.flags = 0;
+ *  op.callbackFxn = logWritten;
+ *  NVSQueue_submit(&queueObject, &op);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+
+#ifndef ti_drivers_nvs_NVSQueue__include
+#define ti_drivers_nvs_NVSQueue__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/drivers/utils/List.h>
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ *  @brief    NVSQueue_process() wait forever define
+ */
+#define NVSQueue_WAIT_FOREVER   (~(0U))
+
+/*!
+ *  @brief    NVSQueue_process() no wait define
+ */
+#define NVSQueue_NO_WAIT        (0U)
+
+/*!
+ *  @brief    Type of a queued operation
+ */
+typedef enum {
+    NVSQueue_OP_WRITE,  /*!< NVS_write() of buffer, size bytes, with flags */
+    NVSQueue_OP_ERASE   /*!< NVS_erase() of size bytes */
+} NVSQueue_OpType;
+
+/*!
+ *  @brief    A handle that is returned from a NVSQueue_construct() call.
+ */
+typedef struct NVSQueue_Object_ *NVSQueue_Handle;
+
+typedef struct NVSQueue_Op_ NVSQueue_Op;
+
+/*!
+ *  @brief    Completion callback of a queued operation
+ *
+ *  Called from NVSQueue_process() once the operation is done.
+ *
+ *  @param    handle    The NVSQueue the operation was submitted to
+ *  @param    op        The completed operation; it may be reused now
+ *  @param    status    The status NVS_write() or NVS_erase() returned
+ */
+typedef void (*NVSQueue_CallbackFxn)(NVSQueue_Handle handle, NVSQueue_Op *op,
+    int_fast16_t status);
+
+/*!
+ *  @brief    A queued NVS operation
+ *
+ *  The operation and the buffer it writes are owned by NVSQueue from
+ *  NVSQueue_submit() until the callback is called.
+ */
+struct NVSQueue_Op_ {
+    List_Elem             elem;        /*!< Used internally */
+    NVSQueue_OpType       type;        /*!< Write or erase */
+    size_t                offset;      /*!< Offset into the NVS region */
+    void                 *buffer;      /*!< Data to write */
+    size_t                size;        /*!< Number of bytes to write or erase */
+    uint_fast16_t         flags;       /*!< NVS_write() flags */
+    NVSQueue_CallbackFxn  callbackFxn; /*!< Completion callback, or NULL */
+    void                 *arg;         /*!< For use by the application */
+};
+
+/*!
+ *  @brief    NVSQueue Parameters
+ *
+ *  @sa       NVSQueue_Params_init()
+ */
+typedef struct {
+    /*!
+     *  Buffer adjacent writes are gathered in, or NULL to process every
+     *  write on its own. It must hold pageSize bytes.
+     */
+    void   *pageBuf;
+    /*!
+     *  Program page size of the FLASH device, e.g. 256 for SPI NOR FLASH.
+     *  Only writes which fall into the same page are gathered.
+     */
+    size_t  pageSize;
+} NVSQueue_Params;
+
+/*!
+ *  @brief      NVSQueue Object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct NVSQueue_Object_ {
+    NVS_Handle         nvsHandle;
+    List_List          queue;
+    SemaphoreP_Struct  workSem;
+    uint8_t           *pageBuf;
+    size_t             pageSize;
+    size_t             sectorSize;
+    size_t             regionSize;
+    size_t             eraseNext;   /* Next sector to erase ahead */
+    size_t             eraseEnd;    /* End of the erase ahead range */
+} NVSQueue_Object;
+
+/*!
+ *  @brief  Default NVSQueue_Params structure
+ *
+ *  @sa     NVSQueue_Params_init()
+ */
+extern const NVSQueue_Params NVSQueue_defaultParams;
+
+/*!
+ *  @brief  Function to initialize a NVSQueue_Params struct to its defaults
+ *
+ *  Defaults: no page buffer, so writes are not gathered.
+ *
+ *  @param  params  A pointer to NVSQueue_Params structure for
+ *                  initialization
+ */
+extern void NVSQueue_Params_init(NVSQueue_Params *params);
+
+/*!
+ *  @brief  Constructs a queue for an open NVS region
+ *
+ *  @param  object     Object to construct the queue in
+ *  @param  nvsHandle  A handle returned from NVS_open()
+ *  @param  params     Parameters, or NULL for the defaults
+ *
+ *  @return A handle on success or NULL if the parameters are invalid
+ */
+extern NVSQueue_Handle NVSQueue_construct(NVSQueue_Object *object,
+    NVS_Handle nvsHandle, const NVSQueue_Params *params);
+
+/*!
+ *  @brief  Destructs a queue
+ *
+ *  The queue must be empty. The NVS region is not closed.
+ *
+ *  @param  handle  A handle returned from NVSQueue_construct()
+ */
+extern void NVSQueue_destruct(NVSQueue_Handle handle);
+
+/*!
+ *  @brief  Queues a write or erase
+ *
+ *  May be called from any thread or from a Swi or Hwi.
+ *
+ *  @param  handle  A handle returned from NVSQueue_construct()
+ *  @param  op      The operation, see #NVSQueue_Op
+ *
+ *  @return #NVS_STATUS_SUCCESS or #NVS_STATUS_INV_OFFSET if the operation
+ *          does not fit into the region
+ */
+extern int_fast16_t NVSQueue_submit(NVSQueue_Handle handle, NVSQueue_Op *op);
+
+/*!
+ *  @brief  Erases sectors in the background
+ *
+ *  The sectors from offset to offset + size are erased one at a time while
+ *  the queue is empty. Any write processed after this call which falls
+ *  into a sector that has not been erased yet causes that sector, and the
+ *  ones before it in the range, to be erased first. Writes to the range
+ *  should therefore only be submitted after this call.
+ *
+ *  Only one range is pending at a time; it may be extended by calling
+ *  this function with the sectors following it.
+ *
+ *  @param  handle  A handle returned from NVSQueue_construct()
+ *  @param  offset  Sector aligned offset into the NVS region
+ *  @param  size    Multiple of the sector size
+ *
+ *  @return #NVS_STATUS_SUCCESS, #NVS_STATUS_INV_ALIGNMENT,
+ *          #NVS_STATUS_INV_SIZE, or #NVS_STATUS_ERROR if a range which
+ *          does not end at offset is still pending
+ */
+extern int_fast16_t NVSQueue_eraseAhead(NVSQueue_Handle handle, size_t offset,
+    size_t size);
+
+/*!
+ *  @brief  Carries out queued work
+ *
+ *  Processes the next queued operation, together with the writes gathered
+ *  with it, and calls their callbacks. If the queue is empty, erases the
+ *  next erase ahead sector instead. If there is nothing to do, waits up to
+ *  timeout system ticks for an operation to be submitted.
+ *
+ *  Must be called from a single thread.
+ *
+ *  @param  handle   A handle returned from NVSQueue_construct()
+ *  @param  timeout  #NVSQueue_WAIT_FOREVER, #NVSQueue_NO_WAIT or ticks
+ *
+ *  @return true if work was done, false if the queue was idle
+ */
+extern bool NVSQueue_process(NVSQueue_Handle handle, uint32_t timeout);
+
+#if defined (__cplusplus)
+}
+#endif /* defined (__cplusplus) */
+
+#endif /* ti_drivers_nvs_NVSQueue__include */
@@ -38,6 +38,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <ti/drivers/dpl/ClockP.h>
 #include <ti/drivers/dpl/HwiP.h>
 #include <ti/drivers/dpl/SemaphoreP.h>
 
@@ -297,7 +298,7 @@ int_fast16_t NVSRAM_write(NVS_Handle handle, size_t offset, void *buffer,
          *  this is satisfied by the following test:
          *     src == (src & dst)
          */
-        dstBuf = (uint8_t *)((uint32_t)(hwAttrs->regionBase) + offset);
+        dstBuf = (uint8_t *)((uintptr_t)(hwAttrs->regionBase) + offset);
         srcBuf = buffer;
         for (i = 0; i < bufferSize; i++) {
             if (srcBuf[i] != (srcBuf[i] & dstBuf[i])) {
@@ -307,10 +308,20 @@ int_fast16_t NVSRAM_write(NVS_Handle handle, size_t offset, void *buffer,
         }
     }
 
-    dstBuf = (uint8_t *)((uint32_t)(hwAttrs->regionBase) + offset);
+    dstBuf = (uint8_t *)((uintptr_t)(hwAttrs->regionBase) + offset);
     srcBuf = buffer;
     memcpy((void *) dstBuf, (void *) srcBuf, bufferSize);
 
+    /* Emulate the time taken to program each page touched */
+    if (hwAttrs->pageProgramTime != 0 && bufferSize != 0) {
+        size = 1;
+        if (hwAttrs->pageSize != 0) {
+            size += (offset + bufferSize - 1) / hwAttrs->pageSize -
+                offset / hwAttrs->pageSize;
+        }
+        ClockP_usleep(size * hwAttrs->pageProgramTime);
+    }
+
     SemaphoreP_post(writeSem);
 
     return (NVS_STATUS_SUCCESS);
@@ -362,9 +373,15 @@ static int_fast16_t doErase(NVS_Handle handle, size_t offset, size_t size)
         return (rangeStatus);
     }
 
-    sectorBase = (void *) ((uint32_t) hwAttrs->regionBase + offset);
+    sectorBase = (void *) ((uintptr_t) hwAttrs->regionBase + offset);
 
     memset(sectorBase, 0xFF, size);
 
+    /* Emulate the time taken to erase each sector */
+    if (hwAttrs->sectorEraseTime != 0) {
+        ClockP_usleep((size / hwAttrs->sectorSize) *
+            hwAttrs->sectorEraseTime);
+    }
+
     return (NVS_STATUS_SUCCESS);
 }
@@ -127,12 +127,37 @@ extern const NVS_FxnTable NVSRAM_fxnTable;
  *
  *
  *  @endcode
+ *
+ *  The optional 'pageProgramTime' and 'sectorEraseTime' fields make writes
+ *  and erases take about as long as they would on FLASH memory, so that the
+ *  timing of code built on the NVS driver can be evaluated on any target,
+ *  including a workstation. A write is delayed by 'pageProgramTime'
+ *  microseconds for each 'pageSize' page it touches, and an erase by
+ *  'sectorEraseTime' microseconds for each sector. The delays are made with
+ *  ClockP_usleep() while the region is locked, like a busy FLASH device.
+ *  The fields default to 0, which disables the emulation.
+ *
+ *  @code
+ *  NVSRAM_HWAttrs NVSRAMHWAttrs[1] = {
+ *      {
+ *          .regionBase = (void *) ramBuf,
+ *          .regionSize = SECTORSIZE * 4,
+ *          .sectorSize = SECTORSIZE,
+ *          .pageSize = 256,           // SPI NOR FLASH program page
+ *          .pageProgramTime = 700,    // 0.7 ms per page program
+ *          .sectorEraseTime = 45000   // 45 ms per 4 KB sector erase
+ *      }
+ *  };
+ *  @endcode
  */
 typedef struct
 {
-    void   *regionBase;    /*!< Base address of RAM region */
-    size_t  regionSize;    /*!< The size of the region in bytes */
-    size_t  sectorSize;    /*!< Sector size in bytes */
+    void     *regionBase;      /*!< Base address of RAM region */
+    size_t    regionSize;      /*!< The size of the region in bytes */
+    size_t    sectorSize;      /*!< Sector size in bytes */
+    size_t    pageSize;        /*!< Emulated program page size in bytes */
+    uint32_t  pageProgramTime; /*!< Emulated page program time in usec */
+    uint32_t  sectorEraseTime; /*!< Emulated sector erase time in usec */
 } NVSRAM_HWAttrs;
 
 /*
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  ======== bench_nvsqueue.c ========
+ *  Host benchmark of NVSQueue on NVSRAM with SPI NOR FLASH timings: 256
+ *  byte pages programmed in 0.7 ms and 4 KB sectors erased in 45 ms.
+ *
+ *  A producer logs 16 byte records at a fixed period, first with
+ *  NVS_erase() and NVS_write() called directly, then through NVSQueue with
+ *  the region erased ahead. Time is virtual: the worker runs between
+ *  records for as long as the emulated FLASH takes. Prints the driver
+ *  calls, the FLASH busy time, how long the producer was blocked and the
+ *  latency from a record's arrival to its write, for three record periods.
+ *  The region is compared with the records after each run.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/nvs/NVSQueue.h>
+#include <ti/drivers/nvs/NVSRAM.h>
+
+#include "dpl_stub.h"
+
+#define SECTOR_SIZE 4096
+#define REGION_SIZE (64 * SECTOR_SIZE)
+#define RECORD_SIZE 16
+#define RECORDS     (REGION_SIZE / RECORD_SIZE)
+#define PAGE_SIZE   256
+
+/* NVSRAM needs a sector aligned region */
+static char region[REGION_SIZE] __attribute__((aligned(SECTOR_SIZE)));
+static unsigned char records[REGION_SIZE];
+static NVSQueue_Op ops[RECORDS];
+static double arrival[RECORDS];
+static double written[RECORDS];
+static unsigned long writes;
+static unsigned long erases;
+static double workerTime;
+static int done;
+static int failed;
+
+static int_fast16_t countingWrite(NVS_Handle handle, size_t offset,
+    void *buffer, size_t bufferSize, uint_fast16_t flags);
+static int_fast16_t countingErase(NVS_Handle handle, size_t offset,
+    size_t size);
+
+static NVS_FxnTable countingFxnTable;
+static NVSRAM_Object nvsRAMObject;
+static const NVSRAM_HWAttrs nvsRAMHWAttrs = {
+    .regionBase = region,
+    .regionSize = REGION_SIZE,
+    .sectorSize = SECTOR_SIZE,
+    .pageSize = PAGE_SIZE,
+    .pageProgramTime = 700,
+    .sectorEraseTime = 45000
+};
+
+NVS_Config NVS_config[] = {
+    {
+        .fxnTablePtr = &countingFxnTable,
+        .object = &nvsRAMObject,
+        .hwAttrs = &nvsRAMHWAttrs
+    }
+};
+
+const uint8_t NVS_count = 1;
+
+static int_fast16_t countingWrite(NVS_Handle handle, size_t offset,
+    void *buffer, size_t bufferSize, uint_fast16_t flags)
+{
+    writes++;
+    return (NVSRAM_write(handle, offset, buffer, bufferSize, flags));
+}
+
+static int_fast16_t countingErase(NVS_Handle handle, size_t offset,
+    size_t size)
+{
+    erases++;
+    return (NVSRAM_erase(handle, offset, size));
+}
+
+/*
+ *  ======== recordWritten ========
+ *  Records the virtual time at which the worker finished the op.
+ */
+static void recordWritten(NVSQueue_Handle handle, NVSQueue_Op *op,
+    int_fast16_t status)
+{
+    if (status != NVS_STATUS_SUCCESS) {
+        failed++;
+    }
+    written[(intptr_t)op->arg] = workerTime + dplTime;
+    done++;
+}
+
+/*
+ *  ======== report ========
+ */
+static void report(const char *what, double period, double blocked)
+{
+    double latency;
+    double sum = 0;
+    double max = 0;
+    int i;
+
+    for (i = 0; i < RECORDS; i++) {
+        latency = written[i] - arrival[i];
+        sum += latency;
+        if (latency > max) {
+            max = latency;
+        }
+    }
+
+    printf("%s, record every %4.0f us: %5lu writes, %2lu erases, "
+        "FLASH busy %5.0f ms, producer blocked %5.0f ms, "
+        "latency mean %6.1f ms max %6.1f ms\n", what, period, writes, erases,
+        dplTime / 1000, blocked / 1000, sum / RECORDS / 1000, max / 1000);
+}
+
+/*
+ *  ======== runDirect ========
+ *  The producer erases and writes itself, and is blocked meanwhile.
+ */
+static int runDirect(NVS_Handle nvs, double period)
+{
+    double now = 0;
+    double start;
+    int i;
+
+    memset(region, 0, REGION_SIZE);
+    dplTime = 0;
+    writes = 0;
+    erases = 0;
+
+    for (i = 0; i < RECORDS; i++) {
+        arrival[i] = i * period;
+        if (now < arrival[i]) {
+            now = arrival[i];
+        }
+        start = dplTime;
+        if ((i * RECORD_SIZE) % SECTOR_SIZE == 0) {
+            NVS_erase(nvs, i * RECORD_SIZE, SECTOR_SIZE);
+        }
+        NVS_write(nvs, i * RECORD_SIZE, &records[i * RECORD_SIZE],
+            RECORD_SIZE, 0);
+        now += dplTime - start;
+        written[i] = now;
+    }
+
+    if (memcmp(region, records, REGION_SIZE) != 0) {
+        printf("direct: region differs\n");
+        return (-1);
+    }
+    report("direct", period, dplTime);
+
+    return (0);
+}
+
+/*
+ *  ======== runQueued ========
+ *  The producer only submits; the worker runs until the next record
+ *  arrives, or until the queue is empty.
+ */
+static int runQueued(NVS_Handle nvs, double period)
+{
+    static uint8_t pageBuf[PAGE_SIZE];
+    NVSQueue_Object queueObject;
+    NVSQueue_Handle queue;
+    NVSQueue_Params params;
+    NVSQueue_Op *op;
+    double next;
+    int i;
+
+    memset(region, 0, REGION_SIZE);
+    dplTime = 0;
+    writes = 0;
+    erases = 0;
+    done = 0;
+    workerTime = 0;
+
+    NVSQueue_Params_init(&params);
+    params.pageBuf = pageBuf;
+    params.pageSize = sizeof(pageBuf);
+    queue = NVSQueue_construct(&queueObject, nvs, &params);
+    if (queue == NULL ||
+        NVSQueue_eraseAhead(queue, 0, REGION_SIZE) != NVS_STATUS_SUCCESS) {
+        printf("queued: setup failed\n");
+        return (-1);
+    }
+
+    for (i = 0; ; i++) {
+        next = i < RECORDS ? i * period : 1e18;
+        while (workerTime + dplTime < next) {
+            if (!NVSQueue_process(queue, NVSQueue_NO_WAIT)) {
+                break;
+            }
+        }
+        if (i == RECORDS) {
+            break;
+        }
+        /* An idle worker waits for the record */
+        if (workerTime + dplTime < next) {
+            workerTime = next - dplTime;
+        }
+
+        op = &ops[i];
+        op->type = NVSQueue_OP_WRITE;
+        op->offset = i * RECORD_SIZE;
+        op->buffer = &records[i * RECORD_SIZE];
+        op->size = RECORD_SIZE;
+        op->flags = 0;
+        op->callbackFxn = recordWritten;
+        op->arg = (void *)(intptr_t)i;
+        arrival[i] = next;
+        if (NVSQueue_submit(queue, op) != NVS_STATUS_SUCCESS) {
+            printf("queued: NVSQueue_submit failed\n");
+            return (-1);
+        }
+    }
+    NVSQueue_destruct(queue);
+
+    if (done != RECORDS || failed != 0) {
+        printf("queued: %d records written, %d failed\n", done, failed);
+        return (-1);
+    }
+    if (memcmp(region, records, REGION_SIZE) != 0) {
+        printf("queued: region differs\n");
+        return (-1);
+    }
+    report("queued", period, 0);
+
+    return (0);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(void)
+{
+    static const double periods[] = {2000, 500, 100};
+    NVS_Handle nvs;
+    unsigned i;
+
+    countingFxnTable = NVSRAM_fxnTable;
+    countingFxnTable.writeFxn = countingWrite;
+    countingFxnTable.eraseFxn = countingErase;
+
+    NVS_init();
+    nvs = NVS_open(0, NULL);
+    if (nvs == NULL) {
+        printf("NVS_open failed\n");
+        return (1);
+    }
+
+    srand(1);
+    for (i = 0; i < REGION_SIZE; i++) {
+        records[i] = rand();
+    }
+
+    printf("%d records of %d bytes\n", RECORDS, RECORD_SIZE);
+    for (i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+        if (runDirect(nvs, periods[i]) != 0 ||
+            runQueued(nvs, periods[i]) != 0) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
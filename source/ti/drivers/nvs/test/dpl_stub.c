@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  ======== dpl_stub.c ========
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "dpl_stub.h"
+
+typedef struct {
+    unsigned int count;
+} Semaphore;
+
+double dplTime;
+
+void ClockP_usleep(uint32_t usec)
+{
+    dplTime += usec;
+}
+
+uintptr_t HwiP_disable(void)
+{
+    return (0);
+}
+
+void HwiP_restore(uintptr_t key)
+{
+}
+
+SemaphoreP_Handle SemaphoreP_createBinary(unsigned int count)
+{
+    Semaphore *sem = malloc(sizeof(Semaphore));
+
+    if (sem != NULL) {
+        sem->count = count;
+    }
+
+    return ((SemaphoreP_Handle)sem);
+}
+
+SemaphoreP_Handle SemaphoreP_constructBinary(SemaphoreP_Struct *handle,
+    unsigned int count)
+{
+    ((Semaphore *)handle)->count = count;
+
+    return ((SemaphoreP_Handle)handle);
+}
+
+void SemaphoreP_delete(SemaphoreP_Handle handle)
+{
+    free(handle);
+}
+
+void SemaphoreP_destruct(SemaphoreP_Struct *handle)
+{
+}
+
+/*
+ *  ======== SemaphoreP_pend ========
+ *  Nothing else runs, so a semaphore which is not available times out.
+ */
+SemaphoreP_Status SemaphoreP_pend(SemaphoreP_Handle handle, uint32_t timeout)
+{
+    Semaphore *sem = (Semaphore *)handle;
+
+    if (sem->count == 0) {
+        return (SemaphoreP_TIMEOUT);
+    }
+    sem->count = 0;
+
+    return (SemaphoreP_OK);
+}
+
+void SemaphoreP_post(SemaphoreP_Handle handle)
+{
+    ((Semaphore *)handle)->count = 1;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  ======== test_nvsqueue.c ========
+ *  Host test of NVSQueue on NVSRAM.
+ *
+ *  Random sequences of queued writes, NVS_WRITE_ERASE writes, erase ops
+ *  and erase-ahead ranges are submitted while the worker runs now and then,
+ *  and the region is compared with a model of the expected contents once
+ *  the queue is drained. Half of the seeds use a page buffer, so that
+ *  adjacent writes are gathered. Every callback must report success.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/nvs/NVSQueue.h>
+#include <ti/drivers/nvs/NVSRAM.h>
+
+#define SECTOR_SIZE 1024
+#define SECTORS     16
+#define REGION_SIZE (SECTORS * SECTOR_SIZE)
+#define SEEDS       500
+#define ROUNDS      400
+
+/* NVSRAM needs a sector aligned region */
+static char region[REGION_SIZE] __attribute__((aligned(SECTOR_SIZE)));
+static unsigned char model[REGION_SIZE];
+static int pending;
+static int failed;
+
+static NVSRAM_Object nvsRAMObject;
+static const NVSRAM_HWAttrs nvsRAMHWAttrs = {
+    .regionBase = region,
+    .regionSize = REGION_SIZE,
+    .sectorSize = SECTOR_SIZE
+};
+
+NVS_Config NVS_config[] = {
+    {
+        .fxnTablePtr = &NVSRAM_fxnTable,
+        .object = &nvsRAMObject,
+        .hwAttrs = &nvsRAMHWAttrs
+    }
+};
+
+const uint8_t NVS_count = 1;
+
+/*
+ *  ======== opDone ========
+ */
+static void opDone(NVSQueue_Handle handle, NVSQueue_Op *op,
+    int_fast16_t status)
+{
+    if (status != NVS_STATUS_SUCCESS) {
+        printf("op at %u failed with %d\n", (unsigned)op->offset, (int)status);
+        failed++;
+    }
+    pending--;
+    free(op->buffer);
+    free(op);
+}
+
+/*
+ *  ======== clip ========
+ */
+static size_t clip(size_t offset, size_t size)
+{
+    return (offset + size > REGION_SIZE ? REGION_SIZE - offset : size);
+}
+
+/*
+ *  ======== newOp ========
+ *  Makes a random op and applies it to the model.
+ */
+static NVSQueue_Op *newOp(size_t *nextOffset)
+{
+    NVSQueue_Op *op = calloc(1, sizeof(NVSQueue_Op));
+    unsigned char *data;
+    size_t start;
+    size_t end;
+    size_t i;
+    int kind = rand() % 10;
+
+    op->type = NVSQueue_OP_WRITE;
+    op->callbackFxn = opDone;
+
+    if (kind < 6) {
+        /* Appends, as a log writes them */
+        op->size = rand() % 40;
+        if (*nextOffset + op->size > REGION_SIZE) {
+            *nextOffset = 0;
+        }
+        op->offset = *nextOffset;
+        *nextOffset += op->size;
+    }
+    else if (kind < 8) {
+        op->offset = rand() % REGION_SIZE;
+        op->size = clip(op->offset, rand() % 200);
+    }
+    else if (kind < 9) {
+        op->offset = rand() % REGION_SIZE;
+        op->size = clip(op->offset, 1 + rand() % 1500);
+        op->flags = NVS_WRITE_ERASE;
+    }
+    else {
+        op->type = NVSQueue_OP_ERASE;
+        op->offset = (rand() % SECTORS) * SECTOR_SIZE;
+        op->size = clip(op->offset, SECTOR_SIZE * (1 + rand() % 2));
+        memset(&model[op->offset], 0xFF, op->size);
+        return (op);
+    }
+
+    data = malloc(op->size + 1);
+    for (i = 0; i < op->size; i++) {
+        data[i] = rand();
+    }
+    op->buffer = data;
+
+    if (op->flags & NVS_WRITE_ERASE) {
+        /* The drivers erase the write size rounded up to whole sectors */
+        start = op->offset - op->offset % SECTOR_SIZE;
+        end = start + (op->size + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE;
+        memset(&model[start], 0xFF, clip(start, end - start));
+    }
+    memcpy(&model[op->offset], data, op->size);
+
+    return (op);
+}
+
+/*
+ *  ======== runSeed ========
+ */
+static int runSeed(NVS_Handle nvs, int seed)
+{
+    static uint8_t pageBuf[64];
+    NVSQueue_Object queueObject;
+    NVSQueue_Handle queue;
+    NVSQueue_Params params;
+    NVSQueue_Op *op;
+    size_t nextOffset = 0;
+    size_t start;
+    size_t size;
+    int round;
+    int n;
+    int i;
+
+    srand(seed);
+    memset(region, 0xFF, REGION_SIZE);
+    memset(model, 0xFF, REGION_SIZE);
+
+    NVSQueue_Params_init(&params);
+    if (seed & 1) {
+        params.pageBuf = pageBuf;
+        params.pageSize = sizeof(pageBuf);
+    }
+    queue = NVSQueue_construct(&queueObject, nvs, &params);
+    if (queue == NULL) {
+        printf("NVSQueue_construct failed\n");
+        return (-1);
+    }
+
+    for (round = 0; round < ROUNDS; round++) {
+        if (rand() % 4 == 0) {
+            /* Drain, erase a range ahead and run part of the erase */
+            while (NVSQueue_process(queue, NVSQueue_NO_WAIT)) {
+            }
+            start = (rand() % SECTORS) * SECTOR_SIZE;
+            size = clip(start, (1 + rand() % 4) * SECTOR_SIZE);
+            if (NVSQueue_eraseAhead(queue, start, size) == NVS_STATUS_SUCCESS) {
+                memset(&model[start], 0xFF, size);
+            }
+            for (i = rand() % 3; i > 0; i--) {
+                NVSQueue_process(queue, NVSQueue_NO_WAIT);
+            }
+            nextOffset = start;
+        }
+
+        for (n = 1 + rand() % 20; n > 0; n--) {
+            op = newOp(&nextOffset);
+            if (NVSQueue_submit(queue, op) != NVS_STATUS_SUCCESS) {
+                printf("seed %d: NVSQueue_submit failed\n", seed);
+                return (-1);
+            }
+            pending++;
+            if (rand() % 3 == 0) {
+                NVSQueue_process(queue, NVSQueue_NO_WAIT);
+            }
+        }
+        if (rand() % 2) {
+            NVSQueue_process(queue, NVSQueue_NO_WAIT);
+        }
+    }
+    while (NVSQueue_process(queue, NVSQueue_NO_WAIT)) {
+    }
+
+    if (pending != 0 || failed != 0) {
+        printf("seed %d: %d ops pending, %d failed\n", seed, pending, failed);
+        return (-1);
+    }
+    for (i = 0; i < REGION_SIZE; i++) {
+        if ((unsigned char)region[i] != model[i]) {
+            printf("seed %d: region differs at %d\n", seed, i);
+            return (-1);
+        }
+    }
+
+    NVSQueue_destruct(queue);
+
+    return (0);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(void)
+{
+    static NVSQueue_Object queueObject;
+    NVSQueue_Handle queue;
+    NVSQueue_Op op;
+    NVS_Handle nvs;
+    int seed;
+
+    NVS_init();
+    nvs = NVS_open(0, NULL);
+    if (nvs == NULL) {
+        printf("NVS_open failed\n");
+        return (1);
+    }
+
+    for (seed = 0; seed < SEEDS; seed++) {
+        if (runSeed(nvs, seed) != 0) {
+            return (1);
+        }
+    }
+
+    queue = NVSQueue_construct(&queueObject, nvs, NULL);
+    memset(&op, 0, sizeof(op));
+    op.offset = REGION_SIZE;
+    op.size = 1;
+    if (NVSQueue_submit(queue, &op) != NVS_STATUS_INV_OFFSET ||
+        NVSQueue_eraseAhead(queue, 1, SECTOR_SIZE) !=
+            NVS_STATUS_INV_ALIGNMENT) {
+        printf("invalid arguments accepted\n");
+        return (1);
+    }
+    NVSQueue_destruct(queue);
+
+    printf("%d seeds of %d rounds, region matches the model\n", SEEDS, ROUNDS);
+
+    return (0);
+}
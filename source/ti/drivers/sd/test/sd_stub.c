@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  ======== sd_stub.c ========
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/SD.h>
+
+#include "sd_stub.h"
+
+static void SDStub_close(SD_Handle handle)
+{
+}
+
+static int_fast16_t SDStub_control(SD_Handle handle, uint_fast16_t cmd,
+    void *arg)
+{
+    return (SD_STATUS_UNDEFINEDCMD);
+}
+
+static uint_fast32_t SDStub_getNumSectors(SD_Handle handle)
+{
+    return (((SDStub_Object *)handle->object)->numSectors);
+}
+
+static uint_fast32_t SDStub_getSectorSize(SD_Handle handle)
+{
+    return (SDSTUB_SECTOR_SIZE);
+}
+
+static void SDStub_init(SD_Handle handle)
+{
+}
+
+static int_fast16_t SDStub_initialize(SD_Handle handle)
+{
+    return (SD_STATUS_SUCCESS);
+}
+
+static SD_Handle SDStub_open(SD_Handle handle, SD_Params *params)
+{
+    return (handle);
+}
+
+static int_fast16_t SDStub_read(SD_Handle handle, void *buf,
+    int_fast32_t sector, uint_fast32_t secCount)
+{
+    SDStub_Object *obj = handle->object;
+
+    if (sector < 0 || (uint_fast32_t)sector + secCount > obj->numSectors) {
+        return (SD_STATUS_ERROR);
+    }
+
+    obj->reads++;
+    obj->readSectors += secCount;
+    memcpy(buf, obj->card + sector * SDSTUB_SECTOR_SIZE,
+        secCount * SDSTUB_SECTOR_SIZE);
+
+    return (SD_STATUS_SUCCESS);
+}
+
+/*
+ *  ======== SDStub_write ========
+ *  A failed write leaves the first sector half programmed.
+ */
+static int_fast16_t SDStub_write(SD_Handle handle, const void *buf,
+    int_fast32_t sector, uint_fast32_t secCount)
+{
+    SDStub_Object *obj = handle->object;
+
+    if (sector < 0 || (uint_fast32_t)sector + secCount > obj->numSectors) {
+        return (SD_STATUS_ERROR);
+    }
+
+    obj->writes++;
+    if (obj->failWrites) {
+        memcpy(obj->card + sector * SDSTUB_SECTOR_SIZE, buf,
+            SDSTUB_SECTOR_SIZE / 2);
+        return (SD_STATUS_ERROR);
+    }
+    memcpy(obj->card + sector * SDSTUB_SECTOR_SIZE, buf,
+        secCount * SDSTUB_SECTOR_SIZE);
+
+    return (SD_STATUS_SUCCESS);
+}
+
+const SD_FxnTable SDStub_fxnTable = {
+    SDStub_close,
+    SDStub_control,
+    SDStub_getNumSectors,
+    SDStub_getSectorSize,
+    SDStub_init,
+    SDStub_initialize,
+    SDStub_open,
+    SDStub_read,
+    SDStub_write
+};
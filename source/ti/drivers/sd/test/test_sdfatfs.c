@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2020, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *  ======== test_sdfatfs.c ========
+ *  Host test of SDFatFS on a card held in RAM.
+ *
+ *  Reads single sectors through the disk functions SDFatFS registers with
+ *  FatFs and checks what reaches the card: a sequential miss reads ahead
+ *  twice as many sectors as the last one, up to SDFatFS_CACHE_SECTORS and
+ *  the end of the card, and hits cost no SD_read(). Writes to sectors held
+ *  by the read-ahead must be seen by later hits, and a failed write must
+ *  empty the cache so that the card is read again. Then formats the card,
+ *  writes a file and reads it back with small reads, at random offsets
+ *  after SDFatFS_openFastSeek().
+ *
+ *  Built with SDFatFS_CACHE_SECTORS 8 and FF_USE_FASTSEEK 1, and with both
+ *  0 as test_sdfatfs_0.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/drivers/SD.h>
+#include <ti/drivers/SDFatFS.h>
+
+#include <third_party/fatfs/diskio.h>
+#include <third_party/fatfs/ff.h>
+
+#include "sd_stub.h"
+
+#define CARD_SECTORS 4096
+#define SECTOR_SIZE  SDSTUB_SECTOR_SIZE
+#define FILE_SIZE    (64 * 1024)
+#define READS        500
+#define READ_SIZE    100
+#define MAP_SIZE     64
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("line %d: %s\n", __LINE__, #cond); \
+            return (1); \
+        } \
+    } while (0)
+
+static uint8_t card[CARD_SECTORS * SECTOR_SIZE];
+static uint8_t model[FILE_SIZE];
+
+static SDStub_Object sdStubObject = {
+    .card = card,
+    .numSectors = CARD_SECTORS
+};
+
+const SD_Config SD_config[] = {
+    {
+        .fxnTablePtr = &SDStub_fxnTable,
+        .object = &sdStubObject,
+        .hwAttrs = NULL
+    }
+};
+
+const uint_least8_t SD_count = 1;
+
+static SDFatFS_Object sdfatfsObject;
+
+const SDFatFS_Config SDFatFS_config[] = {
+    {
+        .object = &sdfatfsObject
+    }
+};
+
+const uint_least8_t SDFatFS_count = 1;
+
+/*
+ *  ======== ff_cre_syncobj ========
+ *  No other task uses the volume, the sync functions always succeed.
+ */
+int ff_cre_syncobj(BYTE vol, FF_SYNC_t *sobj)
+{
+    *sobj = (FF_SYNC_t)1;
+    return (1);
+}
+
+int ff_del_syncobj(FF_SYNC_t sobj)
+{
+    return (1);
+}
+
+int ff_req_grant(FF_SYNC_t sobj)
+{
+    return (1);
+}
+
+void ff_rel_grant(FF_SYNC_t sobj)
+{
+}
+
+int32_t fatfs_getFatTime(void)
+{
+    return (0);
+}
+
+/*
+ *  ======== readSector ========
+ *  Reads a sector through SDFatFS and compares it with the card. Returns
+ *  the number of SD_read() calls it took, or -1.
+ */
+static int readSector(DWORD sector)
+{
+    uint8_t buf[SECTOR_SIZE];
+    unsigned long reads = sdStubObject.reads;
+
+    if (disk_read(0, buf, sector, 1) != RES_OK ||
+        memcmp(buf, &card[sector * SECTOR_SIZE], SECTOR_SIZE) != 0) {
+        printf("sector %lu differs from the card\n", (unsigned long)sector);
+        return (-1);
+    }
+
+    return ((int)(sdStubObject.reads - reads));
+}
+
+/*
+ *  ======== readAhead ========
+ *  Reads a sector that misses the cache, and returns the number of
+ *  sectors read from the card with it, or -1.
+ */
+static int readAhead(DWORD sector)
+{
+    unsigned long sectors = sdStubObject.readSectors;
+
+    if (readSector(sector) != 1) {
+        return (-1);
+    }
+
+    return ((int)(sdStubObject.readSectors - sectors));
+}
+
+/*
+ *  ======== fillSectors ========
+ */
+static void fillSectors(uint8_t *buf, UINT count, int seed)
+{
+    UINT i;
+
+    srand(seed);
+    for (i = 0; i < count * SECTOR_SIZE; i++) {
+        buf[i] = (uint8_t)rand();
+    }
+}
+
+/*
+ *  ======== testCache ========
+ */
+static int testCache(void)
+{
+    uint8_t buf[4 * SECTOR_SIZE];
+    int hits = (SDFatFS_CACHE_SECTORS > 0) ? 0 : 1;
+    DWORD sector;
+
+    fillSectors(card, CARD_SECTORS, 1);
+    CHECK(disk_initialize(0) == 0);
+
+#if SDFatFS_CACHE_SECTORS > 0
+    /* Each sequential miss doubles the read-ahead, up to the cache size */
+    CHECK(readAhead(100) == 1);
+    CHECK(readAhead(101) == 2);
+    CHECK(readAhead(103) == 4);
+    CHECK(readAhead(107) == SDFatFS_CACHE_SECTORS);
+    CHECK(readAhead(115) == SDFatFS_CACHE_SECTORS);
+
+    /* A jump starts over with a single sector */
+    CHECK(readAhead(50) == 1);
+    CHECK(readAhead(51) == 2);
+
+    /* Read-ahead stops at the end of the card */
+    CHECK(readAhead(CARD_SECTORS - 4) == 1);
+    CHECK(readAhead(CARD_SECTORS - 3) == 2);
+    CHECK(readAhead(CARD_SECTORS - 1) == 1);
+#endif
+    CHECK(disk_read(0, buf, CARD_SECTORS, 1) != RES_OK);
+
+    /* Reads of several sectors go to the card */
+    CHECK(disk_read(0, buf, 200, 4) == RES_OK);
+    CHECK(memcmp(buf, &card[200 * SECTOR_SIZE], 4 * SECTOR_SIZE) == 0);
+
+    /* Every sector read in one go is then a hit */
+    CHECK(readSector(300) == 1);
+    CHECK(readSector(301) == 1);
+    CHECK(readSector(303) == 1);
+    for (sector = 303; sector < 307; sector++) {
+        CHECK(readSector(sector) == hits);
+    }
+
+    /* Writes across either end of the cached sectors 303 to 306 */
+    fillSectors(buf, 4, 2);
+    CHECK(disk_write(0, buf, 305, 4) == RES_OK);
+    CHECK(memcmp(&card[305 * SECTOR_SIZE], buf, 4 * SECTOR_SIZE) == 0);
+    fillSectors(buf, 2, 3);
+    CHECK(disk_write(0, buf, 302, 2) == RES_OK);
+    for (sector = 303; sector < 307; sector++) {
+        CHECK(readSector(sector) == hits);
+    }
+
+    /* A failed write leaves the card unknown, which must be read again */
+    fillSectors(buf, 1, 4);
+    sdStubObject.failWrites = true;
+    CHECK(disk_write(0, buf, 304, 1) != RES_OK);
+    sdStubObject.failWrites = false;
+    CHECK(memcmp(&card[304 * SECTOR_SIZE], buf, SECTOR_SIZE / 2) == 0);
+    CHECK(readSector(304) == 1);
+    CHECK(readSector(305) == 1);
+    CHECK(readSector(305) == hits);
+
+    /* The card may have been swapped when it is initialized again */
+    CHECK(disk_initialize(0) == 0);
+    CHECK(readSector(305) == 1);
+
+    printf("cache of %d sectors: %lu SD_read calls for %lu sectors\n",
+        SDFatFS_CACHE_SECTORS, sdStubObject.reads, sdStubObject.readSectors);
+
+    return (0);
+}
+
+/*
+ *  ======== testFile ========
+ */
+static int testFile(void)
+{
+    static uint8_t work[FF_MAX_SS];
+    static DWORD linkMap[MAP_SIZE];
+    unsigned long reads;
+    uint8_t buf[READ_SIZE];
+    UINT bytes;
+    FIL file;
+    int offset;
+    int i;
+
+    CHECK(f_mkfs("0:", FM_ANY, 0, work, sizeof(work)) == FR_OK);
+
+    srand(5);
+    for (i = 0; i < FILE_SIZE; i++) {
+        model[i] = (uint8_t)rand();
+    }
+    CHECK(f_open(&file, "0:data.bin", FA_WRITE | FA_CREATE_ALWAYS) == FR_OK);
+    for (offset = 0; offset < FILE_SIZE; offset += 1000) {
+        bytes = (FILE_SIZE - offset < 1000) ? FILE_SIZE - offset : 1000;
+        CHECK(f_write(&file, &model[offset], bytes, &bytes) == FR_OK);
+    }
+    CHECK(f_close(&file) == FR_OK);
+
+    reads = sdStubObject.reads;
+    CHECK(f_open(&file, "0:data.bin", FA_READ) == FR_OK);
+    for (offset = 0; offset < FILE_SIZE; offset += 64) {
+        CHECK(f_read(&file, buf, 64, &bytes) == FR_OK && bytes == 64);
+        CHECK(memcmp(buf, &model[offset], 64) == 0);
+    }
+    CHECK(f_close(&file) == FR_OK);
+    printf("sequential 64 byte reads: %lu SD_read calls\n",
+        sdStubObject.reads - reads);
+
+    /* A map too small for the file leaves it on the FAT chain */
+    CHECK(SDFatFS_openFastSeek(&file, "0:data.bin", FA_READ, linkMap, 2) ==
+        FR_OK);
+#if FF_USE_FASTSEEK
+    CHECK(file.cltbl == NULL);
+#endif
+    CHECK(f_close(&file) == FR_OK);
+
+    /* A file opened for writing gets no map */
+    CHECK(SDFatFS_openFastSeek(&file, "0:data.bin", FA_READ | FA_WRITE,
+        linkMap, MAP_SIZE) == FR_OK);
+#if FF_USE_FASTSEEK
+    CHECK(file.cltbl == NULL);
+#endif
+    CHECK(f_close(&file) == FR_OK);
+
+    CHECK(SDFatFS_openFastSeek(&file, "0:data.bin", FA_READ, linkMap,
+        MAP_SIZE) == FR_OK);
+#if FF_USE_FASTSEEK
+    CHECK(file.cltbl == linkMap);
+#endif
+    reads = sdStubObject.reads;
+    srand(7);
+    for (i = 0; i < READS; i++) {
+        offset = rand() % (FILE_SIZE - READ_SIZE);
+        CHECK(f_lseek(&file, offset) == FR_OK);
+        CHECK(f_read(&file, buf, READ_SIZE, &bytes) == FR_OK &&
+            bytes == READ_SIZE);
+        CHECK(memcmp(buf, &model[offset], READ_SIZE) == 0);
+    }
+    CHECK(f_close(&file) == FR_OK);
+    printf("%d random %d byte reads: %lu SD_read calls\n", READS, READ_SIZE,
+        sdStubObject.reads - reads);
+
+    return (0);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(void)
+{
+    SDFatFS_Handle handle;
+
+    SDFatFS_init();
+    handle = SDFatFS_open(0, 0);
+    if (handle == NULL) {
+        printf("SDFatFS_open failed\n");
+        return (1);
+    }
+
+    if (testCache() != 0 || testFile() != 0) {
+        return (1);
+    }
+
+    SDFatFS_close(handle);
+
+    return (0);
+}
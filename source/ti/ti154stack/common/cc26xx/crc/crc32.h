@@ -58,6 +58,7 @@ extern "C"
 #include <stdbool.h>
 
 extern uint32_t CRC32_value(uint32_t inCRC);
+extern uint32_t CRC32_update(uint32_t crc, const uint8_t *pBuf, uint32_t len);
 extern uint32_t CRC32_calc(uint8_t page, uint32_t pageSize, uint16_t offset, uint32_t len, bool useExtFl);
 extern void *CRC32_memCpy(void *dest, const void *src, uint16_t len);
 
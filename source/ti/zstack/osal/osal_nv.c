@@ -81,6 +81,9 @@ extern zstack_Config_t *pZStackCfg;
  * LOCAL VARIABLES
  */
 
+// Additional NV driver functions, kept apart from zstack_Config_t's nvFps
+static NVINTF_nvFunctsExt_t *pNvExtFps = NULL;
+
 
 /******************************************************************************
  * LOCAL FUNCTIONS
@@ -104,6 +107,21 @@ void osal_nv_init( void *p )
   }
 }
 
+/******************************************************************************
+ * @fn      osal_nv_register_ext
+ *
+ * @brief   Register the additional NV driver functions. Without them,
+ *          osal_nv_write_multi() writes its items one at a time.
+ *
+ * @param   pfn - Additional NV function pointers, NULL to unregister.
+ *
+ * @return  none
+ */
+void osal_nv_register_ext( NVINTF_nvFunctsExt_t *pfn )
+{
+  pNvExtFps = pfn;
+}
+
 /******************************************************************************
  * @fn      osal_nv_item_init_ex
  *
@@ -264,6 +282,60 @@ uint8_t osal_nv_write_ex( uint16_t id, uint16_t subId, uint16_t len, void *buf )
   return rtrn;
 }
 
+/******************************************************************************
+ * @fn      osal_nv_write_multi
+ *
+ * @brief   Write several data items to NV as one batch. If the NV driver
+ *          supports writeItems, the batch is written in one pass and after
+ *          a reset either all or none of the items hold the new data.
+ *          Otherwise the items are written one at a time.
+ *
+ * @param  *items - Items to write, each Id/sub Id at most once.
+ * @param   numItems - Number of items, 1 to OSAL_NV_MULTI_MAX.
+ *
+ * @return  SUCCESS if successful, NV_ITEM_UNINIT if an item did not
+ *          exist in NV (item by item only), NV_OPER_FAILED if failure.
+ */
+uint8_t osal_nv_write_multi( osal_nv_item_t *items, uint8_t numItems )
+{
+  uint8_t rtrn = SUCCESS;
+  uint8_t i;
+
+  if ( (items == NULL) || (numItems == 0) || (numItems > OSAL_NV_MULTI_MAX) )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  if ( pNvExtFps && pNvExtFps->writeItems )
+  {
+    NVINTF_itemWrite_t nvItems[OSAL_NV_MULTI_MAX];
+
+    for ( i = 0; i < numItems; i++ )
+    {
+      nvItems[i].id.systemID = NVINTF_SYSID_ZSTACK;
+      nvItems[i].id.itemID = items[i].id;
+      nvItems[i].id.subID = items[i].subId;
+      nvItems[i].len = items[i].len;
+      nvItems[i].buffer = items[i].buf;
+    }
+
+    if ( pNvExtFps->writeItems( nvItems, numItems ) != NVINTF_SUCCESS )
+    {
+      rtrn = NV_OPER_FAILED;
+    }
+  }
+  else
+  {
+    for ( i = 0; (i < numItems) && (rtrn == SUCCESS); i++ )
+    {
+      rtrn = osal_nv_write_ex( items[i].id, items[i].subId,
+                               items[i].len, items[i].buf );
+    }
+  }
+
+  return rtrn;
+}
+
 /******************************************************************************
  * @fn      osal_nv_write
  *
@@ -57,11 +57,17 @@ extern "C"
  */
 
 #include "hal_types.h"
+#include "nvintf.h"
 
 /*********************************************************************
  * CONSTANTS
  */
 
+// Maximum number of items in one osal_nv_write_multi() call
+#if !defined ( OSAL_NV_MULTI_MAX )
+  #define OSAL_NV_MULTI_MAX  8
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -70,6 +76,15 @@ extern "C"
  * TYPEDEFS
  */
 
+// One item written by osal_nv_write_multi() (extended format)
+typedef struct
+{
+  uint16_t id;
+  uint16_t subId;
+  uint16_t len;
+  void *buf;
+} osal_nv_item_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -83,6 +98,11 @@ extern "C"
  */
 extern void osal_nv_init( void *p );
 
+/*
+ * Register the additional NV driver functions (writeItems)
+ */
+extern void osal_nv_register_ext( NVINTF_nvFunctsExt_t *pfn );
+
 /*
  * Initialize an item in NV
  */
@@ -128,6 +148,11 @@ extern uint8_t osal_nv_read_match_entry( uint16_t id, uint16_t *subId, uint16_t
  */
 extern uint8_t osal_nv_write_ex( uint16_t id, uint16_t subId, uint16_t len, void *buf );
 
+/*
+ * Write several NV attributes together (extended format)
+ */
+extern uint8_t osal_nv_write_multi( osal_nv_item_t *items, uint8_t numItems );
+
 /*
  * Get the length of an NV item (extended format).
  */
@@ -85,6 +85,7 @@
 #include "cpu.h"
 
 #include "nvocmp.h"
+#include "osal_nv.h"
 
 #include "zstackconfig.h"
 
@@ -170,6 +171,9 @@ zstack_Config_t zstack_user0Cfg =
     MAC_USER_CFG
 };
 
+/* Additional NV function pointers, not part of zstack_Config_t */
+static NVINTF_nvFunctsExt_t nvExtFps;
+
 /* Stack TIRTOS Task semaphore */
 Semaphore_Struct npiInitializationMutex;
 Semaphore_Handle npiInitializationMutexHandle;
@@ -325,6 +329,8 @@ Void main()
 
     /* Setup the NV driver */
     NVOCMP_loadApiPtrs(&zstack_user0Cfg.nvFps);
+    NVOCMP_loadExtApiPtrs(&nvExtFps);
+    osal_nv_register_ext(&nvExtFps);
 #ifdef NVOCMP_MIN_VDD_FLASH_MV
     NVOCMP_setLowVoltageCb(&Main_lowVoltageCb);
 #endif